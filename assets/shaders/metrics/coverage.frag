@@ -0,0 +1,26 @@
+#version 330 core
+// 覆盖掩码打包：每个输出像素对应一行中连续 32 个源像素，第 k 位 = 第 k 个像素被模型覆盖
+layout (location = 0) out uint Coverage;
+
+uniform sampler2D depthMap;
+uniform int sourceWidth;   // 回读区域的宽度
+uniform ivec2 sourceOrigin; // 回读区域在深度图中的起点 (屏幕空间 ROI，整幅画面时为 0)
+
+// 与 C++ 中 PSNR 阶段的背景判定保持一致 (深度趋近于 1.0 的必定是背景或天空盒)
+bool IsBackgroundDepth(float d) {
+    return d >= 0.9999;
+}
+
+void main() {
+    int y = int(gl_FragCoord.y);
+    int x0 = int(gl_FragCoord.x) * 32;
+
+    uint bits = 0u;
+    for (int k = 0; k < 32; ++k) {
+        int x = x0 + k;
+        if (x >= sourceWidth) break;
+        float d = texelFetch(depthMap, sourceOrigin + ivec2(x, y), 0).r;
+        if (!IsBackgroundDepth(d)) bits |= (1u << uint(k));
+    }
+    Coverage = bits;
+}
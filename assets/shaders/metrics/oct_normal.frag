@@ -0,0 +1,25 @@
+#version 330 core
+// 将 G-buffer 中的法线 (N*0.5+0.5, RGB16F) 转为八面体编码，写入 RG16 (每像素 4 字节)
+layout (location = 0) out vec2 OctNormal;
+
+uniform sampler2D normalMap;
+uniform ivec2 sourceOrigin; // 回读区域在法线图中的起点 (屏幕空间 ROI，整幅画面时为 0)
+
+vec2 SignNotZero(vec2 v) {
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+void main() {
+    vec3 enc = texelFetch(normalMap, sourceOrigin + ivec2(gl_FragCoord.xy), 0).rgb;
+
+    // 背景 (0,0,0) 由覆盖掩码判定，这里输出任意值即可
+    if (enc == vec3(0.0)) {
+        OctNormal = vec2(0.0);
+        return;
+    }
+
+    vec3 n = enc * 2.0 - 1.0;
+    n /= (abs(n.x) + abs(n.y) + abs(n.z));
+    vec2 o = (n.z >= 0.0) ? n.xy : (1.0 - abs(n.yx)) * SignNotZero(n.xy);
+    OctNormal = o * 0.5 + 0.5;
+}
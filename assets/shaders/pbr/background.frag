@@ -2,6 +2,11 @@
 layout (location = 0) out vec4 FragColor;
 // 注意：背景通常不需要输出法线信息，或者输出 0 向量
 layout (location = 1) out vec3 FragNormal;
+// 色调映射之前的环境辐射度 (与 pbr.frag 的 FragLinear 对应)
+layout (location = 2) out vec4 FragLinear;
+// 延迟着色的 G-buffer: 背景不写材质，着色模型 0 表示背景 (与清屏值一致)
+layout (location = 3) out vec4 FragMaterial;
+layout (location = 4) out vec2 FragSurface;
 
 in vec3 WorldPos;
 
@@ -10,6 +15,7 @@ uniform samplerCube environmentMap;
 void main()
 {
     vec3 envColor = texture(environmentMap, WorldPos).rgb;
+    FragLinear = vec4(envColor, 1.0);
 
     // --- 色调映射 (Tone Mapping) ---
     // 必须与 pbr.frag 中的算法保持一致，否则物体和背景亮度会脱节
@@ -22,4 +28,6 @@ void main()
 
     // 背景没有法线，输出黑色或默认值即可
     FragNormal = vec3(0.0, 0.0, 0.0);
+    FragMaterial = vec4(0.0);
+    FragSurface = vec2(0.0);
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#version 330 core
+layout (location = 0) out vec4 FragColor;
+
+in vec2 TexCoords;
+
+// --- G-buffer (由 DeferredShading::Capture 从前向通道拷贝，按像素取值不做过滤) ---
+uniform sampler2D gMaterial; // Slot 3: 线性反照率 + 金属度
+uniform sampler2D gSurface;  // Slot 4: 粗糙度, 着色模型 (1.0 = Lit, 0.5 = Unlit, 0 = 背景)
+uniform sampler2D gNormal;   // Slot 5: (N + 1) / 2
+uniform sampler2D gDepth;    // Slot 6
+
+// --- IBL (当前评估的环境) ---
+uniform samplerCube irradianceMap;  // Slot 0
+uniform samplerCube prefilterMap;   // Slot 1
+uniform sampler2D   brdfLUT;        // Slot 2
+uniform samplerCube environmentMap; // Slot 7 (天空盒)
+
+uniform mat4 invViewProj;    // 深度 -> 世界坐标
+uniform mat4 invSkyViewProj; // 去掉位移的视图 (与 background.vert 一致)，屏幕 -> 天空盒方向
+uniform vec3 camPos;
+uniform mat3 envRotation;    // 世界方向 -> 环境贴图方向 (环境绕 Y 轴旋转)
+uniform vec2 invSize;
+
+uniform float u_Exposure;
+uniform bool u_Skybox;
+uniform vec3 u_Background;
+
+// 以下着色与 pbr.frag / background.frag 保持一致
+vec3 fresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness) {
+    return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+vec3 ACESFilmicToneMapping(vec3 x) {
+    float a = 2.51f; float b = 0.03f; float c = 2.43f; float d = 0.59f; float e = 0.14f;
+    return clamp((x*(a*x+b))/(x*(c*x+d)+e), 0.0, 1.0);
+}
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    vec2 ndc = gl_FragCoord.xy * invSize * 2.0 - 1.0;
+    vec2 surface = texelFetch(gSurface, texel, 0).rg;
+
+    // --- 背景 ---
+    if (surface.g < 0.25) {
+        if (u_Skybox) {
+            vec4 dir = invSkyViewProj * vec4(ndc, 1.0, 1.0);
+            vec3 envColor = texture(environmentMap, envRotation * (dir.xyz / dir.w)).rgb;
+            envColor = envColor / (envColor + vec3(1.0)); // Reinhard
+            FragColor = vec4(pow(envColor, vec3(1.0/2.2)), 1.0);
+        } else {
+            FragColor = vec4(u_Background, 1.0);
+        }
+        return;
+    }
+
+    vec4 material = texelFetch(gMaterial, texel, 0);
+    vec3 albedo = material.rgb;
+    vec3 finalColor;
+
+    // --- Unlit ---
+    if (surface.g < 0.75) {
+        finalColor = albedo;
+    }
+    // --- Lit ---
+    else {
+        float metallic = material.a;
+        float roughness = surface.r;
+        vec3 N = normalize(texelFetch(gNormal, texel, 0).rgb * 2.0 - 1.0);
+
+        float depth = texelFetch(gDepth, texel, 0).r;
+        vec4 world = invViewProj * vec4(ndc, depth * 2.0 - 1.0, 1.0);
+        vec3 V = normalize(camPos - world.xyz / world.w);
+        vec3 R = reflect(-V, N);
+        vec3 F0 = vec3(0.04);
+        F0 = mix(F0, albedo, metallic);
+
+        vec3 F = fresnelSchlickRoughness(max(dot(N, V), 0.0), F0, roughness);
+        vec3 kS = F;
+        vec3 kD = 1.0 - kS;
+        kD *= 1.0 - metallic;
+
+        vec3 irradiance = texture(irradianceMap, envRotation * N).rgb;
+        vec3 diffuse    = irradiance * albedo;
+
+        const float MAX_REFLECTION_LOD = 4.0;
+        vec3 prefilteredColor = textureLod(prefilterMap, envRotation * R, roughness * MAX_REFLECTION_LOD).rgb;
+        vec2 brdf  = texture(brdfLUT, vec2(max(dot(N, V), 0.0), roughness)).rg;
+        vec3 specular = prefilteredColor * (F * brdf.x + brdf.y);
+
+        finalColor = (kD * diffuse + specular);
+    }
+
+    // --- Post Process ---
+    finalColor *= u_Exposure;
+    finalColor = ACESFilmicToneMapping(finalColor);
+    finalColor = pow(finalColor, vec3(1.0/2.2));
+    FragColor = vec4(finalColor, 1.0);
+}
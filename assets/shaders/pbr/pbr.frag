@@ -1,6 +1,11 @@
 #version 330 core
 layout (location = 0) out vec4 FragColor;
 layout (location = 1) out vec3 FragNormalMap;
+// 曝光与色调映射之前的线性辐射度 (仅在渲染器启用线性捕获时有对应附件，曝光 / 色调映射扫描使用)
+layout (location = 2) out vec4 FragLinear;
+// 延迟着色的 G-buffer (仅在渲染器启用 G-buffer 捕获时有对应附件，多环境评估使用；法线沿用 FragNormalMap)
+layout (location = 3) out vec4 FragMaterial; // 线性反照率 + 金属度
+layout (location = 4) out vec2 FragSurface;  // 粗糙度, 着色模型 (1.0 = Lit, 0.5 = Unlit，背景清为 0)
 
 in VS_OUT {
     vec3 WorldPos;
@@ -87,6 +92,8 @@ void main()
     if (u_ShadingModel == 1) {
         finalColor = albedo;
         N_out = normalize(fs_in.Normal);
+        FragMaterial = vec4(albedo, 0.0);
+        FragSurface = vec2(0.0, 0.5);
     }
     // --- Mode 0: Lit ---
     else {
@@ -109,6 +116,8 @@ void main()
             N = normalize(fs_in.Normal);
         }
         N_out = N;
+        FragMaterial = vec4(albedo, metallic);
+        FragSurface = vec2(roughness, 1.0);
 
         vec3 V = normalize(camPos - fs_in.WorldPos);
         vec3 R = reflect(-V, N);
@@ -132,6 +141,7 @@ void main()
     }
 
     // --- Post Process ---
+    FragLinear = vec4(finalColor, 1.0);
     finalColor *= u_Exposure;
     finalColor = ACESFilmicToneMapping(finalColor);
     finalColor = pow(finalColor, vec3(1.0/2.2));
@@ -0,0 +1,468 @@
+#include "Metrics/Evaluator.h"
+#include "Metrics/SimdKernels.h"
+#include "Scene/CameraSampler.h"
+#include "Scene/Model.h"
+#include "Utils/ImageWriter.h"
+#include "Utils/ParallelUtils.h"
+
+#include <nlohmann/json.hpp>
+
+/**
+ * VisualMetricsBench: 评估内核、截图编码、相机采样与模型导入的微基准
+ *
+ * 用法: VisualMetricsBench [--json <path>] [--baseline <path>] [--filter <子串>]
+ *                          [--sizes 256,1024,2048] [--min-time <秒>] [--repeat <次>]
+ *                          [--triangles 10000,100000] [--samples 64,1024]
+ *                          [--simd scalar|sse2|avx2|avx512] [--label <文本>] [--no-gl]
+ *
+ * 每个基准先预热一次，再把迭代次数倍增到单次测量不短于 min-time，重复 repeat 次取中位数。
+ * 结果以 JSON 输出 (默认 stdout)：每项给出 ns/单位 (像素 / 采样点 / 三角形) 与按读写字节数折算的 GB/s。
+ * 指定 --baseline 时按名称与上一次的 JSON 对比并打印相对变化，便于在提交之间发现性能回退。
+ */
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using json = nlohmann::json;
+
+    struct BenchOptions {
+        std::string jsonPath;
+        std::string baselinePath;
+        std::string filter;
+        std::string label;
+        std::vector<int> sizes = { 256, 1024, 2048 };
+        std::vector<int> meshTriangles = { 10000, 100000, 1000000 };
+        std::vector<int> sampleCounts = { 64, 1024, 16384 };
+        double minTime = 0.2;
+        int repeat = 5;
+        bool gl = true;
+    };
+
+    struct BenchResult {
+        std::string name;
+        std::string unit;          // 每次迭代处理的单位 (pixel / sample / triangle)
+        size_t unitsPerIter = 0;
+        size_t bytesPerIter = 0;   // 每次迭代读写的字节数 (输入 + 输出)
+        size_t iterations = 0;     // 单次测量的迭代次数
+        double nsPerIterMedian = 0.0;
+        double nsPerIterMin = 0.0;
+
+        double NsPerUnit() const { return unitsPerIter ? nsPerIterMedian / unitsPerIter : 0.0; }
+        double GBPerSecond() const { return nsPerIterMedian > 0.0 ? bytesPerIter / nsPerIterMedian : 0.0; }
+    };
+
+    // 防止编译器把基准体中的计算结果当作无用代码消除
+    volatile double g_sink = 0.0;
+
+    class BenchRunner {
+    public:
+        explicit BenchRunner(const BenchOptions& opts) : options(opts) {}
+
+        bool Selected(const std::string& name) const {
+            return options.filter.empty() || name.find(options.filter) != std::string::npos;
+        }
+
+        template<typename Fn>
+        void Run(const std::string& name, const std::string& unit, size_t unitsPerIter, size_t bytesPerIter, Fn&& fn) {
+            if (!Selected(name)) return;
+
+            fn(); // 预热 (缓存、线程池、查找表)
+
+            // 倍增迭代次数直到单次测量足够长
+            size_t iterations = 1;
+            for (;;) {
+                double seconds = Measure(fn, iterations);
+                if (seconds >= options.minTime || iterations >= (size_t(1) << 30)) break;
+                size_t scale = seconds > 0.0 ? static_cast<size_t>(options.minTime / seconds * 1.2) + 1 : 10;
+                iterations *= std::min<size_t>(std::max<size_t>(scale, 2), 10);
+            }
+
+            std::vector<double> samples;
+            for (int r = 0; r < std::max(options.repeat, 1); ++r) {
+                samples.push_back(Measure(fn, iterations) * 1e9 / static_cast<double>(iterations));
+            }
+            std::sort(samples.begin(), samples.end());
+
+            BenchResult result;
+            result.name = name;
+            result.unit = unit;
+            result.unitsPerIter = unitsPerIter;
+            result.bytesPerIter = bytesPerIter;
+            result.iterations = iterations;
+            result.nsPerIterMedian = samples[samples.size() / 2];
+            result.nsPerIterMin = samples.front();
+            results.push_back(result);
+
+            std::cerr << std::left << std::setw(40) << name << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(12) << result.NsPerUnit() << " ns/" << std::setw(9) << std::left << unit
+                      << std::right << std::setprecision(2) << std::setw(9) << result.GBPerSecond() << " GB/s"
+                      << "  (" << iterations << " iters)" << std::endl;
+        }
+
+        const std::vector<BenchResult>& Results() const { return results; }
+
+    private:
+        template<typename Fn>
+        static double Measure(Fn& fn, size_t iterations) {
+            auto begin = Clock::now();
+            for (size_t i = 0; i < iterations; ++i) fn();
+            return std::chrono::duration<double>(Clock::now() - begin).count();
+        }
+
+        const BenchOptions& options;
+        std::vector<BenchResult> results;
+    };
+
+    // ---------------------------------------------------------
+    // 合成图像: 中心圆盘为"模型"，其余为背景；优化图在参考图上叠加小幅噪声并扰动轮廓边缘
+    // ---------------------------------------------------------
+    struct SyntheticFrame {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> refColor, optColor;   // RGB8
+        std::vector<float> refNormal, optNormal;         // RGB32F，背景为 (0,0,0)
+        std::vector<unsigned char> refSil, optSil;       // R8，0 / 255
+        std::vector<unsigned char> heatmap;              // RGBA8 输出
+
+        void Generate(int w, int h, uint32_t seed) {
+            width = w;
+            height = h;
+            const size_t pixels = static_cast<size_t>(w) * h;
+            refColor.resize(pixels * 3);
+            optColor.resize(pixels * 3);
+            refNormal.assign(pixels * 3, 0.0f);
+            optNormal.assign(pixels * 3, 0.0f);
+            refSil.assign(pixels, 0);
+            optSil.assign(pixels, 0);
+            heatmap.resize(pixels * 4);
+
+            std::mt19937 rng(seed);
+            std::uniform_int_distribution<int> noise(-6, 6);
+            std::uniform_real_distribution<float> jitter(-0.02f, 0.02f);
+            const float cx = 0.5f * w, cy = 0.5f * h, radius = 0.4f * std::min(w, h);
+
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    const size_t i = static_cast<size_t>(y) * w + x;
+                    const float dx = (x + 0.5f - cx) / radius, dy = (y + 0.5f - cy) / radius;
+                    const float r2 = dx * dx + dy * dy;
+                    const bool inRef = r2 < 1.0f;
+                    // 优化模型的轮廓略有起伏 (模拟简化后的边缘偏移)
+                    const float wobble = 0.02f * std::sin(12.0f * std::atan2(dy, dx));
+                    const bool inOpt = r2 < (1.0f + wobble) * (1.0f + wobble);
+
+                    for (int c = 0; c < 3; ++c) {
+                        int base = inRef ? static_cast<int>(64 + 160 * (1.0f - r2) * (c + 1) / 3.0f) : 255;
+                        refColor[i * 3 + c] = static_cast<unsigned char>(base);
+                        optColor[i * 3 + c] = static_cast<unsigned char>(std::clamp(base + (inOpt ? noise(rng) : 0), 0, 255));
+                    }
+
+                    refSil[i] = inRef ? 255 : 0;
+                    optSil[i] = inOpt ? 255 : 0;
+
+                    if (inRef) {
+                        const float nz = std::sqrt(std::max(0.0f, 1.0f - r2));
+                        refNormal[i * 3 + 0] = dx * 0.5f + 0.5f;
+                        refNormal[i * 3 + 1] = dy * 0.5f + 0.5f;
+                        refNormal[i * 3 + 2] = nz * 0.5f + 0.5f;
+                    }
+                    if (inOpt) {
+                        for (int c = 0; c < 3; ++c) {
+                            float base = inRef ? refNormal[i * 3 + c] : 0.5f;
+                            optNormal[i * 3 + c] = std::clamp(base + jitter(rng), 0.001f, 1.0f);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    void RunImageBenchmarks(BenchRunner& runner, const BenchOptions& options) {
+        using namespace Metrics;
+
+        for (int size : options.sizes) {
+            SyntheticFrame frame;
+            frame.Generate(size, size, 1234u + static_cast<uint32_t>(size));
+            const int w = frame.width, h = frame.height;
+            const size_t pixels = static_cast<size_t>(w) * h;
+            const std::string suffix = "/" + std::to_string(w) + "x" + std::to_string(h);
+
+            ImageView refColor(frame.refColor, w, h, PixelFormat::RGB8);
+            ImageView optColor(frame.optColor, w, h, PixelFormat::RGB8);
+            ImageView refNormal(frame.refNormal, w, h, PixelFormat::RGB32F);
+            ImageView optNormal(frame.optNormal, w, h, PixelFormat::RGB32F);
+            ImageView refSil(frame.refSil, w, h, PixelFormat::R8);
+            ImageView optSil(frame.optSil, w, h, PixelFormat::R8);
+            MutableImageView heatmap(frame.heatmap, w, h, PixelFormat::RGBA8);
+
+            runner.Run("ComputePSNR" + suffix, "pixel", pixels, pixels * 3 * 2, [&]() {
+                g_sink = Evaluator::ComputePSNR(refColor, optColor).first;
+            });
+
+            runner.Run("ComputeNormalError" + suffix, "pixel", pixels, pixels * 12 * 2, [&]() {
+                g_sink = Evaluator::ComputeNormalError(refNormal, optNormal);
+            });
+
+            runner.Run("ComputeSilhouetteError" + suffix, "pixel", pixels, pixels * 2, [&]() {
+                g_sink = Evaluator::ComputeSilhouetteError(refSil, optSil);
+            });
+
+            PackedMask refMask, optMask;
+            runner.Run("PackSilhouette" + suffix, "pixel", pixels, pixels + pixels / 8, [&]() {
+                Evaluator::PackSilhouette(refSil, refMask);
+                g_sink = static_cast<double>(refMask.words[0]);
+            });
+            Evaluator::PackSilhouette(refSil, refMask);
+            Evaluator::PackSilhouette(optSil, optMask);
+            runner.Run("ComputeSilhouetteError.Packed" + suffix, "pixel", pixels, (pixels / 8) * 2, [&]() {
+                g_sink = Evaluator::ComputeSilhouetteError(refMask, optMask);
+            });
+
+            const Color8 background = Color8::FromFloat(glm::vec3(1.0f));
+            runner.Run("GenerateHeatmap.Color" + suffix, "pixel", pixels, pixels * (3 * 2 + 4), [&]() {
+                Evaluator::GenerateHeatmap(refColor, optColor, 0, heatmap, background, 2.5f);
+                g_sink = frame.heatmap[0];
+            });
+            runner.Run("GenerateHeatmap.Normal" + suffix, "pixel", pixels, pixels * (12 * 2 + 4), [&]() {
+                Evaluator::GenerateHeatmap(refNormal, optNormal, 1, heatmap, background);
+                g_sink = frame.heatmap[0];
+            });
+            runner.Run("GenerateHeatmap.Silhouette" + suffix, "pixel", pixels, pixels * (1 * 2 + 4), [&]() {
+                Evaluator::GenerateHeatmap(refSil, optSil, 2, heatmap, background);
+                g_sink = frame.heatmap[0];
+            });
+
+            // 截图编码 (output 策略)，只编码到内存不写盘
+            Utils::ImageWriter writer;
+            for (Utils::ImageFormat format : { Utils::ImageFormat::Png, Utils::ImageFormat::FastPng,
+                                               Utils::ImageFormat::Qoi, Utils::ImageFormat::Raw }) {
+                runner.Run(std::string("ImageWriter.Encode.") + Utils::ImageFormatName(format) + suffix, "pixel", pixels, pixels * 3, [&]() {
+                    writer.Encode(format, w, h, 3, frame.refColor.data(), true);
+                    g_sink = static_cast<double>(writer.Buffer().size());
+                });
+            }
+        }
+    }
+
+    void RunSamplerBenchmarks(BenchRunner& runner, const BenchOptions& options) {
+        for (int count : options.sampleCounts) {
+            runner.Run("CameraSampler::GenerateSamples/" + std::to_string(count), "sample",
+                       static_cast<size_t>(count), static_cast<size_t>(count) * sizeof(Scene::CameraSample), [&]() {
+                auto samples = Scene::CameraSampler::GenerateSamples(count, 2.0f, 1.0f, 0.1f);
+                g_sink = samples.back().position.x;
+            });
+        }
+    }
+
+    // ---------------------------------------------------------
+    // 生成网格: 经纬球 (rings x 2*rings 个四边形，每个拆成两个三角形)，写成 OBJ 供 Assimp 导入
+    // ---------------------------------------------------------
+    size_t WriteSphereObj(const std::filesystem::path& path, int targetTriangles) {
+        const int rings = std::max(4, static_cast<int>(std::sqrt(targetTriangles / 4.0)));
+        const int segments = rings * 2;
+        const float pi = 3.14159265358979f;
+
+        std::ofstream out(path);
+        out << std::fixed << std::setprecision(6);
+        for (int r = 0; r <= rings; ++r) {
+            const float theta = pi * r / rings;
+            for (int s = 0; s <= segments; ++s) {
+                const float phi = 2.0f * pi * s / segments;
+                out << "v " << std::sin(theta) * std::cos(phi) << ' ' << std::cos(theta) << ' '
+                    << std::sin(theta) * std::sin(phi) << '\n';
+            }
+        }
+        size_t triangles = 0;
+        for (int r = 0; r < rings; ++r) {
+            for (int s = 0; s < segments; ++s) {
+                const int a = r * (segments + 1) + s + 1; // OBJ 索引从 1 开始
+                const int b = a + segments + 1;
+                out << "f " << a << ' ' << b << ' ' << a + 1 << '\n';
+                out << "f " << a + 1 << ' ' << b << ' ' << b + 1 << '\n';
+                triangles += 2;
+            }
+        }
+        return triangles;
+    }
+
+    void ReleaseModel(Scene::Model& model) {
+        for (auto& mesh : model.meshes) mesh.Release();
+    }
+
+    void RunModelBenchmarks(BenchRunner& runner, const BenchOptions& options) {
+        namespace fs = std::filesystem;
+
+        // Model 构造时直接上传 VBO/EBO，需要一个 (隐藏的) GL 上下文
+        if (!glfwInit()) {
+            std::cerr << "[Bench] GLFW init failed, skipping model benchmarks." << std::endl;
+            return;
+        }
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow* window = glfwCreateWindow(64, 64, "VisualMetricsBench", NULL, NULL);
+        if (!window) {
+            std::cerr << "[Bench] No GL context available, skipping model benchmarks." << std::endl;
+            glfwTerminate();
+            return;
+        }
+        glfwMakeContextCurrent(window);
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+            std::cerr << "[Bench] Failed to load GL functions, skipping model benchmarks." << std::endl;
+            glfwDestroyWindow(window);
+            glfwTerminate();
+            return;
+        }
+
+        const fs::path dir = fs::temp_directory_path() / "VisualMetricsBench";
+        fs::create_directories(dir);
+
+        for (int target : options.meshTriangles) {
+            const fs::path path = dir / ("sphere_" + std::to_string(target) + ".obj");
+            const size_t triangles = WriteSphereObj(path, target);
+            const size_t fileBytes = static_cast<size_t>(fs::file_size(path));
+            const std::string suffix = "/" + std::to_string(triangles) + "tri";
+
+            for (bool streaming : { false, true }) {
+                const std::string name = std::string(streaming ? "Model.LoadStreaming" : "Model.Load") + suffix;
+                Scene::ModelLoadOptions loadOptions;
+                loadOptions.streaming = streaming;
+                // 导入速率按 OBJ 文件字节数折算
+                runner.Run(name, "triangle", triangles, fileBytes, [&]() {
+                    Scene::Model model(path.string(), loadOptions);
+                    g_sink = model.boundsMax.x;
+                    ReleaseModel(model);
+                    glFinish();
+                });
+            }
+            fs::remove(path);
+        }
+
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+
+    std::vector<int> ParseIntList(const std::string& text) {
+        std::vector<int> values;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            if (!item.empty()) values.push_back(std::stoi(item));
+        }
+        return values;
+    }
+
+    bool ParseArgs(int argc, char** argv, BenchOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> std::string { return (i + 1 < argc) ? argv[++i] : std::string(); };
+            if (arg == "--json") options.jsonPath = next();
+            else if (arg == "--baseline") options.baselinePath = next();
+            else if (arg == "--filter") options.filter = next();
+            else if (arg == "--label") options.label = next();
+            else if (arg == "--sizes") options.sizes = ParseIntList(next());
+            else if (arg == "--triangles") options.meshTriangles = ParseIntList(next());
+            else if (arg == "--samples") options.sampleCounts = ParseIntList(next());
+            else if (arg == "--min-time") options.minTime = std::stod(next());
+            else if (arg == "--repeat") options.repeat = std::stoi(next());
+            else if (arg == "--no-gl") options.gl = false;
+            else if (arg == "--simd") {
+                const std::string level = next();
+                if (level == "scalar") Metrics::Simd::SetLevel(Metrics::Simd::Level::Scalar);
+                else if (level == "sse2") Metrics::Simd::SetLevel(Metrics::Simd::Level::SSE2);
+                else if (level == "avx2") Metrics::Simd::SetLevel(Metrics::Simd::Level::AVX2);
+                else if (level == "avx512") Metrics::Simd::SetLevel(Metrics::Simd::Level::AVX512);
+                else {
+                    std::cerr << "[Bench] Unknown SIMD level: " << level << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "[Bench] Unknown argument: " << arg << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    json ToJson(const BenchOptions& options, const std::vector<BenchResult>& results) {
+        json root;
+        root["label"] = options.label;
+        root["simd"] = Metrics::Simd::LevelName(Metrics::Simd::GetLevel());
+        root["threads"] = Utils::WorkerPool::Instance().Size();
+        root["min_time_s"] = options.minTime;
+        root["repeat"] = options.repeat;
+        root["timestamp"] = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+
+        json list = json::array();
+        for (const BenchResult& r : results) {
+            list.push_back({
+                    { "name", r.name },
+                    { "unit", r.unit },
+                    { "units_per_iter", r.unitsPerIter },
+                    { "bytes_per_iter", r.bytesPerIter },
+                    { "iterations", r.iterations },
+                    { "ns_per_iter", r.nsPerIterMedian },
+                    { "ns_per_iter_min", r.nsPerIterMin },
+                    { "ns_per_unit", r.NsPerUnit() },
+                    { "gb_per_s", r.GBPerSecond() }
+            });
+        }
+        root["benchmarks"] = list;
+        return root;
+    }
+
+    // 与基线 JSON 按名称对比 ns/单位 (正值表示变慢)
+    void CompareWithBaseline(const std::string& path, const std::vector<BenchResult>& results) {
+        std::ifstream in(path);
+        if (!in.is_open()) {
+            std::cerr << "[Bench] Cannot open baseline " << path << std::endl;
+            return;
+        }
+        json baseline = json::parse(in, nullptr, false);
+        if (baseline.is_discarded() || !baseline.contains("benchmarks")) {
+            std::cerr << "[Bench] Invalid baseline " << path << std::endl;
+            return;
+        }
+
+        std::unordered_map<std::string, double> previous;
+        for (const auto& entry : baseline["benchmarks"]) {
+            previous[entry.value("name", std::string())] = entry.value("ns_per_unit", 0.0);
+        }
+
+        std::cerr << "\n[Bench] Compared with " << path << " (" << baseline.value("label", std::string()) << ")" << std::endl;
+        for (const BenchResult& r : results) {
+            auto it = previous.find(r.name);
+            if (it == previous.end() || it->second <= 0.0) continue;
+            double change = (r.NsPerUnit() / it->second - 1.0) * 100.0;
+            std::cerr << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(8) << std::showpos << change << std::noshowpos << " %" << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!ParseArgs(argc, argv, options)) return -1;
+
+    std::cerr << "[Bench] SIMD: " << Metrics::Simd::LevelName(Metrics::Simd::GetLevel())
+              << ", threads: " << Utils::WorkerPool::Instance().Size() << std::endl;
+
+    BenchRunner runner(options);
+    RunImageBenchmarks(runner, options);
+    RunSamplerBenchmarks(runner, options);
+    if (options.gl) RunModelBenchmarks(runner, options);
+
+    json report = ToJson(options, runner.Results());
+    if (options.jsonPath.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    } else {
+        std::ofstream out(options.jsonPath);
+        out << report.dump(2) << std::endl;
+        std::cerr << "[Bench] Results written to " << options.jsonPath << std::endl;
+    }
+
+    if (!options.baselinePath.empty()) CompareWithBaseline(options.baselinePath, runner.Results());
+    return 0;
+}
@@ -1,11 +1,20 @@
 #include "Application.h"
 #include "Metrics/Evaluator.h"
+#include "Metrics/HausdorffEvaluator.h"
 #include "Metrics/MetricVisualizer.h"
+#include "Metrics/PixelPasses.h"
+#include "Metrics/SimdKernels.h"
+#include "Renderer/DeferredShading.h"
 #include "Renderer/IBLBaker.h"
 #include "Renderer/PBRRenderer.h"
 #include "Resources/ResourceManager.h"
 #include "Scene/CameraSampler.h"
+#include "Utils/AllocationCounter.h"
 #include "Utils/FileSystemUtils.h"
+#include "Utils/GeometryUtils.h"
+#include "Utils/MemoryTracker.h"
+#include "Utils/ParallelUtils.h"
+#include "Utils/Profiler.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
@@ -16,117 +25,37 @@ void Application::SetupOutputDirectories(const std::string& modelName) {
     fs::path base = root / modelName;
     if (!fs::exists(base)) fs::create_directories(base);
 
-    // 局部目录生成闭包，顺便初始化局部 CSV 和它的表头
-    auto initLocalDir = [&](const std::string& dirName) {
+    // 局部目录生成闭包，顺便声明局部 CSV 和它的表头 (模型结束时随逐视角结果一起写出)
+    auto initLocalDir = [&](const std::string& dirName, const std::string& header) {
         fs::path dir = base / dirName;
         if (!fs::exists(dir)) fs::create_directories(dir);
 
         fs::path csvPath = dir / (modelName + "_metrics_" + dirName + ".csv");
-        std::ofstream f(csvPath);
-        if (f.is_open()) {
-            f << "ViewIndex,ErrorValue\n";
-        }
+        results.DeclareTable(csvPath, header, ResultSink::TableScope::Model);
     };
 
-    initLocalDir("psnr");
-    initLocalDir("normal");
-    initLocalDir("silhouette");
+    initLocalDir("psnr", "ViewIndex,ErrorValue");
+    if (config.render.ssim) initLocalDir("ssim", "ViewIndex,SSIM,MSSSIM,TimeMs");
+    if (config.render.flip) initLocalDir("flip", "ViewIndex,FLIP,TimeMs");
+    initLocalDir("normal", "ViewIndex,ErrorValue");
+    initLocalDir("silhouette", "ViewIndex,ErrorValue");
+    if (config.toneSweep.enabled) initLocalDir("tonemap", "ViewIndex,PSNR,Operator,Exposure");
+    if (!environmentSettings.empty()) initLocalDir("environment", "ViewIndex,PSNR,Environment,Rotation");
+    // 各阶段耗时明细 (ReportProfile 填写)，与逐视角结果一起原子写出
+    if (config.profiling.enabled) {
+        results.DeclareTable(base / "profile_stages.csv", "Stage,Track,Count,TotalMs,MeanMs,Share", ResultSink::TableScope::Model);
+    }
 
     // ================= 根据 Config 分别生成三个图例 =================
-    // 提取一个通用的生成图例的 Lambda 表达式
-    auto generateLegend = [&](const std::string& filename, const std::string& topText, const std::string& midText, const std::string& bottomText) {
-        fs::path legendPath = root / filename;
-        if (!fs::exists(legendPath)) {
-            int legW = 120;  // 拓宽图像以容纳文字
-            int legH = 600;
-            int barW = 40;   // 左侧颜色条的宽度
-
-            // 初始化背景为暗灰色 (RGB: 40,40,40)，使白色文字和高对比度热力图更加清晰
-            std::vector<unsigned char> pixels(legW * legH * 3, 40);
-
-            // 【黑科技】内置 3x5 像素的点阵字体，支持数字 0-9 和小数点
-            const char* font[11] = {
-                    "111101101101111", // 0
-                    "010110010010111", // 1
-                    "111001111100111", // 2
-                    "111001111001111", // 3
-                    "101101111001001", // 4
-                    "111100111001111", // 5
-                    "111100111101111", // 6
-                    "111001010010010", // 7
-                    "111101111101111", // 8
-                    "111101111001111", // 9
-                    "000000000000010"  // .
-            };
-
-            // 绘制文字的 Lambda 闭包
-            auto drawText = [&](int startX, int startY, const std::string& text, int scale) {
-                for (char c : text) {
-                    int idx = -1;
-                    if (c >= '0' && c <= '9') idx = c - '0';
-                    else if (c == '.') idx = 10;
-
-                    if (idx >= 0) {
-                        const char* bitmap = font[idx];
-                        for (int py = 0; py < 5; ++py) {
-                            for (int px = 0; px < 3; ++px) {
-                                if (bitmap[py * 3 + px] == '1') {
-                                    // 放大像素点
-                                    for(int sy = 0; sy < scale; ++sy) {
-                                        for(int sx = 0; sx < scale; ++sx) {
-                                            int drawX = startX + px * scale + sx;
-                                            int drawY = startY + py * scale + sy;
-                                            if(drawX >= 0 && drawX < legW && drawY >= 0 && drawY < legH) {
-                                                int pIdx = (drawY * legW + drawX) * 3;
-                                                pixels[pIdx+0] = 255; // 文字颜色：纯白
-                                                pixels[pIdx+1] = 255;
-                                                pixels[pIdx+2] = 255;
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    // 移动光标，准备画下一个字符 (字符宽 3 + 间距 1 = 4)
-                    startX += 4 * scale;
-                }
-            };
-
-            // 1. 绘制左侧的颜色渐变条
-            for (int y = 0; y < legH; ++y) {
-                float value = 1.0f - static_cast<float>(y) / static_cast<float>(legH - 1);
-                auto smoothstep = [](float edge0, float edge1, float x) {
-                    float t = std::max(0.0f, std::min(1.0f, (x - edge0) / (edge1 - edge0)));
-                    return t * t * (3.0f - 2.0f * t);
-                };
-                float pi = 3.1415926f;
-                float r = smoothstep(0.5f, 0.8f, value);
-                float g = std::sin(value * pi);
-                float b = smoothstep(0.5f, 0.2f, value);
-                unsigned char cR = static_cast<unsigned char>(r * 255.0f);
-                unsigned char cG = static_cast<unsigned char>(g * 255.0f);
-                unsigned char cB = static_cast<unsigned char>(b * 255.0f);
-
-                for (int x = 0; x < barW; ++x) {
-                    int idx = (y * legW + x) * 3;
-                    pixels[idx + 0] = cR;
-                    pixels[idx + 1] = cG;
-                    pixels[idx + 2] = cB;
-                }
-            }
-
-            // 2. 绘制右侧的数值标签
-            int textX = barW + 15;
-            int textScale = 3;  // 字体放大倍数
-            int charH = 5 * textScale;
-
-            drawText(textX, 10, topText, textScale);                              // 顶部 (红色/最大误差)
-            drawText(textX, (legH - charH) / 2, midText, textScale);              // 中部 (绿色/中等误差)
-            drawText(textX, legH - 10 - charH, bottomText, textScale);            // 底部 (蓝色/最小误差)
-
-            // 写入本地 PNG 文件
-            stbi_write_png(legendPath.string().c_str(), legW, legH, 3, pixels.data(), legW * 3);
+    // 图例按对应阶段的截图格式写出 (扩展名随格式替换，None 不输出)，统计计入本模型首个阶段的输出统计
+    auto generateLegend = [&](const std::string& filename, Utils::ImageFormat format, const std::string& topText, const std::string& midText, const std::string& bottomText) {
+        if (format == Utils::ImageFormat::None) return;
+        const std::string legendBase = (root / filename).replace_extension().string();
+        if (!fs::exists(legendBase + Utils::ImageFormatExtension(format))) {
+            std::vector<unsigned char> pixels;
+            Metrics::Evaluator::RenderLegend(Metrics::Evaluator::HeatmapLUT(), topText, midText, bottomText, pixels);
+            imageWriter.Write(legendBase, format, Metrics::Evaluator::LEGEND_WIDTH, Metrics::Evaluator::LEGEND_HEIGHT, 3,
+                              pixels.data(), false, &outputStats);
         }
     };
 
@@ -143,115 +72,365 @@ void Application::SetupOutputDirectories(const std::string& modelName) {
     std::string psnrTopStr = formatFloat(psnrMax);
     std::string psnrMidStr = formatFloat(psnrMax / 2.0f);
 
-    generateLegend(config.paths.legendPsnr, psnrTopStr, psnrMidStr, "0.0");
-    generateLegend(config.paths.legendNormal, "1.0", "0.5", "0.0");
-    generateLegend(config.paths.legendSilhouette, "1.0", "0.5", "0.0");
+    generateLegend(config.paths.legendPsnr, config.output.psnr, psnrTopStr, psnrMidStr, "0.0");
+
+    // SSIM 热力图的刻度为 1 - SSIM，最大值 = 1.0 / 倍率
+    if (config.render.ssim) {
+        float ssimMax = 1.0f / config.render.ssimErrorMultiplier;
+        generateLegend(config.paths.legendSsim, config.output.ssim, formatFloat(ssimMax), formatFloat(ssimMax / 2.0f), "0.0");
+    }
+    // FLIP 误差本身位于 [0, 1]，热力图不做放大
+    if (config.render.flip) generateLegend(config.paths.legendFlip, config.output.flip, "1.0", "0.5", "0.0");
+    generateLegend(config.paths.legendNormal, config.output.normal, "1.0", "0.5", "0.0");
+    generateLegend(config.paths.legendSilhouette, config.output.silhouette, "1.0", "0.5", "0.0");
     // ====================================================================
 }
 
-void Application::AppendToGlobalCSV(const std::string& metricType, double avgError) {
+void Application::AppendToGlobalCSV(const std::string& metricType, double avgError, const std::string& extraColumns,
+                                    const std::string& keyColumns) {
     std::string filename;
     if (metricType == "PSNR") filename = "metrics_psnr.csv";
+    else if (metricType == "SSIM") filename = "metrics_ssim.csv";
+    else if (metricType == "FLIP") filename = "metrics_flip.csv";
+    else if (metricType == "Hausdorff") filename = "metrics_hausdorff.csv";
+    else if (metricType == "MultiRes") filename = "metrics_multires.csv";
+    else if (metricType == "Profile") filename = "metrics_profile.csv";
     else if (metricType == "Normal") filename = "metrics_normal.csv";
     else if (metricType == "Silhouette") filename = "metrics_silhouette.csv";
+    else if (metricType == "Memory") filename = "metrics_memory.csv";
+    else if (metricType == "Output") filename = "metrics_output.csv";
+    else if (metricType == "ToneSweep") filename = "metrics_tonemap.csv";
+    else if (metricType == "Environment") filename = "metrics_environment.csv";
     else return;
 
-    fs::path csvPath = fs::path(config.paths.outputRoot) / filename;
-    std::ofstream csv(csvPath, std::ios::app);
-    if (csv.is_open()) {
-        csv << currentModelName << "," << avgError << "\n";
+    Utils::CpuProfileScope scope("CsvWrite");
+    std::ostringstream row;
+    row << currentModelName << keyColumns << "," << avgError << extraColumns;
+    // 内存记账开启时，其余表末尾追加截至此刻的主机 / 显存峰值
+    if (config.memory.enabled && metricType != "Memory") {
+        const Utils::MemoryTracker& memory = Utils::MemoryTracker::Instance();
+        row << "," << memory.PeakHostBytes() / (1024.0 * 1024.0) << "," << memory.PeakGpuBytes() / (1024.0 * 1024.0);
     }
+    results.AppendRow(fs::path(config.paths.outputRoot) / filename, row.str());
 }
 
-void Application::AppendToLocalCSV(const std::string& metricType, int viewIdx, double error) {
+void Application::AppendToLocalCSV(const std::string& metricType, int viewIdx, double error, const std::string& extraColumns) {
     std::string dirName;
     if (metricType == "PSNR") dirName = "psnr";
+    else if (metricType == "SSIM") dirName = "ssim";
+    else if (metricType == "FLIP") dirName = "flip";
     else if (metricType == "Normal") dirName = "normal";
     else if (metricType == "Silhouette") dirName = "silhouette";
+    else if (metricType == "ToneSweep") dirName = "tonemap";
+    else if (metricType == "Environment") dirName = "environment";
     else return;
 
+    Utils::CpuProfileScope scope("CsvWrite");
     fs::path csvPath = fs::path(config.paths.outputRoot) / currentModelName / dirName / (currentModelName + "_metrics_" + dirName + ".csv");
-    std::ofstream csv(csvPath, std::ios::app);
-    if (csv.is_open()) {
-        csv << viewIdx << "," << error << "\n";
+    std::ostringstream row;
+    row << viewIdx << "," << error << extraColumns;
+    results.AppendRow(csvPath, row.str());
+}
+
+Utils::ImageFormat Application::OutputFormat(RenderPhase phase) const {
+    switch (phase) {
+        case RenderPhase::PHASE_IBL_PSNR:   return config.output.psnr;
+        case RenderPhase::PHASE_SSIM:       return config.output.ssim;
+        case RenderPhase::PHASE_FLIP:       return config.output.flip;
+        case RenderPhase::PHASE_SILHOUETTE: return config.output.silhouette;
+        case RenderPhase::PHASE_NORMAL:     return config.output.normal;
+        default:                            return Utils::ImageFormat::None;
     }
 }
 
+bool Application::VisualizationNeeded() const {
+    return config.render.display || OutputFormat(currentPhase) != Utils::ImageFormat::None;
+}
+
+bool Application::WindowCompositeNeeded() const {
+    return config.render.display || (!readback.Ready() && OutputFormat(currentPhase) != Utils::ImageFormat::None);
+}
+
 void Application::SaveScreenshot(int viewIdx) {
+    const Utils::ImageFormat format = OutputFormat(currentPhase);
+    if (format == Utils::ImageFormat::None) return;
+    if (readback.Ready()) {
+        SaveOffscreen(viewIdx, format);
+        return;
+    }
+
     int w = config.window.width;
     int h = config.window.height;
-    std::vector<unsigned char> pixels(w * h * 3);
-    glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    std::vector<unsigned char>& pixels = frame.screenshot;
+    pixels.resize(w * h * 3);
+    {
+        Utils::CpuProfileScope scope("ScreenshotReadback");
+        glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+        Utils::Profiler::Instance().AddReadback(pixels.size());
+    }
 
-    // 开启 stbi 的垂直翻转，直接存 pixels 即可
-    stbi_flip_vertically_on_write(true);
-    std::string filename = currentOutputDir + "/view_" + std::to_string(viewIdx) + ".png";
-    stbi_write_png(filename.c_str(), w, h, 3, pixels.data(), w * 3);
+    // 窗口回读为自底向上的行序，由编码器逐行翻转
+    Utils::CpuProfileScope scope("ScreenshotWrite");
+    imageWriter.Write(currentOutputDir + "/view_" + std::to_string(viewIdx), format, w, h, 3, pixels.data(), true, &outputStats);
 }
 
-std::vector<float> Application::ReadTextureFloat(unsigned int texID, int w, int h) {
-    std::vector<float> data(w * h * 3);
-    glBindTexture(GL_TEXTURE_2D, texID);
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_FLOAT, data.data());
-    return data;
+float Application::ErrorMultiplier(RenderPhase phase) const {
+    switch (phase) {
+        case RenderPhase::PHASE_IBL_PSNR: return config.render.colorErrorMultiplier;
+        case RenderPhase::PHASE_SSIM:     return config.render.ssimErrorMultiplier;
+        default:                          return 1.0f;
+    }
 }
 
-std::vector<unsigned char> Application::ReadTextureByte(unsigned int texID, int w, int h) {
-    std::vector<unsigned char> data(w * h * 3);
-    glBindTexture(GL_TEXTURE_2D, texID);
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGB, GL_UNSIGNED_BYTE, data.data());
-    return data;
+void Application::RecordErrorMap(int viewIndex) {
+    const Metrics::PixelPassOutput& out = frame.passOutput;
+    const Metrics::FrameRegion& region = viewRegion;
+    if (out.errorMap.size() < region.PixelCount()) return;
+
+    Utils::CpuProfileScope scope("ErrorMapWrite");
+    const std::string path = currentOutputDir + "/errors.vmerr";
+    if (errorMaps.Path() != path) {
+        CloseErrorMaps();
+        if (!errorMaps.Open(path, PhaseName(currentPhase), ErrorMultiplier(currentPhase))) return;
+    }
+    errorMaps.Append(viewIndex, region, Metrics::ImageView(out.errorMap, region.width, region.height, Metrics::PixelFormat::R16F));
 }
 
-std::vector<float> Application::ReadTextureDepth(unsigned int texID, int w, int h) {
-    std::vector<float> data(w * h);
-    glBindTexture(GL_TEXTURE_2D, texID);
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, GL_FLOAT, data.data());
-    return data;
+void Application::CloseErrorMaps() {
+    if (!errorMaps.IsOpen()) return;
+    std::cout << "[RESULT] Error maps: " << errorMaps.Path() << ", " << errorMaps.BytesWritten() / 1024.0 << " KB ("
+              << (errorMaps.RawBytes() > 0 ? 100.0 * errorMaps.BytesWritten() / errorMaps.RawBytes() : 0.0) << "% of raw half)" << std::endl;
+    errorMaps.Close();
 }
 
-void Application::UploadGrayscaleToTexture(unsigned int texID, const std::vector<unsigned char>& data, int w, int h) {
-    std::vector<unsigned char> rgba(w * h * 4);
+void Application::SaveOffscreen(int viewIdx, Utils::ImageFormat format) {
+    if (!shownTargets) return;
+    const RenderTargets& tg = *shownTargets;
+    const std::string base = currentOutputDir + "/view_" + std::to_string(viewIdx);
+    Utils::CpuProfileScope scope("OffscreenOutput");
+
+    if (config.output.composite) {
+        Utils::GpuProfileScope gpuScope("OffscreenComposite");
+        glBindFramebuffer(GL_FRAMEBUFFER, compositeFBO);
+        glViewport(0, 0, compositeWidth, compositeHeight);
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        visualizer->RenderComparison(tg.texRef, tg.texOpt, tg.texHeatmap, compositeWidth, compositeHeight);
+        readback.Enqueue(0, 0, compositeWidth, compositeHeight, base, static_cast<int>(format));
+    }
+    if (config.output.panels) {
+        // 面板直接读目标纹理，保持渲染分辨率 (ROI 裁剪时区域外已在上传阶段清为背景色)
+        const std::pair<unsigned int, const char*> panels[] = {
+            { tg.texRef, "_ref" }, { tg.texOpt, "_opt" }, { tg.texHeatmap, "_heatmap" }
+        };
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, silFBO);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        for (const auto& panel : panels) {
+            glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, panel.first, 0);
+            readback.Enqueue(0, 0, tg.width, tg.height, base + panel.second, static_cast<int>(format));
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
-    // 获取 Config 中设置的纯色背景
-    unsigned char bgR = static_cast<unsigned char>(config.render.background.r * 255.0f);
-    unsigned char bgG = static_cast<unsigned char>(config.render.background.g * 255.0f);
-    unsigned char bgB = static_cast<unsigned char>(config.render.background.b * 255.0f);
+bool Application::InitOffscreenOutput() {
+    compositeWidth = config.output.width > 0 ? config.output.width : targets.width * 3;
+    compositeHeight = config.output.height > 0 ? config.output.height : targets.height;
 
-    // 取 Config 中设置的模型轮廓色
-    unsigned char silR = static_cast<unsigned char>(config.render.silhouetteColor.r * 255.0f);
-    unsigned char silG = static_cast<unsigned char>(config.render.silhouetteColor.g * 255.0f);
-    unsigned char silB = static_cast<unsigned char>(config.render.silhouetteColor.b * 255.0f);
+    glGenTextures(1, &compositeTex);
+    glBindTexture(GL_TEXTURE_2D, compositeTex);
+    Utils::TrackedTexImage2D(Utils::MemoryCategory::FrameBuffer, GL_TEXTURE_2D, 0, GL_RGBA8, compositeWidth, compositeHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-    for (int i = 0; i < w * h; ++i) {
-        unsigned char val = data[i];
-        if (val == 0) {
-            // 若为剪影背景，则填入 config 的颜色
-            rgba[i * 4 + 0] = bgR;
-            rgba[i * 4 + 1] = bgG;
-            rgba[i * 4 + 2] = bgB;
-        } else {
-            // 值不为0，代表识别到了模型轮廓，填入我们指定的轮廓颜色
-            rgba[i * 4 + 0] = silR;
-            rgba[i * 4 + 1] = silG;
-            rgba[i * 4 + 2] = silB;
-        }
-        rgba[i * 4 + 3] = 255;
+    glGenFramebuffers(1, &compositeFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, compositeFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, compositeTex, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[Error] Offscreen composite framebuffer incomplete (" << compositeWidth << "x" << compositeHeight
+                  << "), falling back to window readback" << std::endl;
+        return false;
+    }
+
+    readback.Init(static_cast<size_t>(std::max(config.output.readbackDepth, 1)),
+                  [this](const Renderer::AsyncReadback::Request& request, const unsigned char* pixels) {
+                      Utils::CpuProfileScope scope("ScreenshotWrite");
+                      imageWriter.Write(request.name, static_cast<Utils::ImageFormat>(request.tag), request.width, request.height, 3,
+                                        pixels, true, &outputStats);
+                  });
+    std::cout << "[System] Offscreen output: composite " << compositeWidth << "x" << compositeHeight
+              << (config.output.panels ? " + panels" : "") << ", " << std::max(config.output.readbackDepth, 1)
+              << " async readbacks in flight" << std::endl;
+    return true;
+}
+
+// 从当前绑定的读帧缓冲回读 region 内的像素到已按区域大小准备好的 out
+// (RGB8 / R8 的行宽不一定是 4 的倍数，临时改为紧密排列)
+template<typename T>
+static void ReadPixelsInRegion(const Metrics::FrameRegion& region, GLenum format, GLenum type, std::vector<T>& out) {
+    Utils::CpuProfileScope scope("Readback");
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(region.x, region.y, region.width, region.height, format, type, out.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    Utils::Profiler::Instance().AddReadback(out.size() * sizeof(T));
+}
+
+void Application::ReadTextureByte(unsigned int texID, const Metrics::FrameRegion& region, std::vector<unsigned char>& out) {
+    out.resize(region.PixelCount() * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, silFBO);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texID, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    ReadPixelsInRegion(region, GL_RGB, GL_UNSIGNED_BYTE, out);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void Application::ReadNormals(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, std::vector<float>& out) {
+    out.resize(region.PixelCount() * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, pbr.GetFBO());
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+    ReadPixelsInRegion(region, GL_RGB, GL_FLOAT, out);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void Application::ReadLinear(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, std::vector<uint16_t>& out) {
+    out.resize(region.PixelCount() * 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, pbr.GetFBO());
+    glReadBuffer(GL_COLOR_ATTACHMENT2);
+    ReadPixelsInRegion(region, GL_RGBA, GL_HALF_FLOAT, out);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void Application::ReadDepth(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, std::vector<float>& out) {
+    out.resize(region.PixelCount());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, pbr.GetFBO());
+    ReadPixelsInRegion(region, GL_DEPTH_COMPONENT, GL_FLOAT, out);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void Application::ReadCoverage(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, Metrics::CoverageMask& out) {
+    const int w = region.width, h = region.height;
+    if (!config.render.compactReadback) {
+        ReadDepth(pbr, region, frame.depth);
+        Metrics::Evaluator::BuildCoverage(Metrics::ImageView(frame.depth, w, h, Metrics::PixelFormat::R32F), out);
+        return;
+    }
+
+    // GPU 端把深度打包成 1 bit/像素，回读量为深度图的 1/32
+    out.Resize(w, h);
+    glBindFramebuffer(GL_FRAMEBUFFER, silFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, coverageTex, 0);
+    glViewport(0, 0, out.rowWords, h);
+
+    coverageShader->use();
+    coverageShader->setInt("depthMap", 0);
+    coverageShader->setInt("sourceWidth", w);
+    glUniform2i(glGetUniformLocation(coverageShader->ID, "sourceOrigin"), region.x, region.y);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, pbr.GetDepthTex());
+
+    {
+        Utils::GpuProfileScope gpuScope("PackCoverage");
+        RenderQuad();
+    }
+
+    Utils::CpuProfileScope scope("Readback");
+    glReadPixels(0, 0, out.rowWords, h, GL_RED_INTEGER, GL_UNSIGNED_INT, out.words.data());
+    Utils::Profiler::Instance().AddReadback(static_cast<size_t>(out.rowWords) * h * sizeof(uint32_t));
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Application::ReadOctNormals(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, std::vector<uint16_t>& out) {
+    const int w = region.width, h = region.height;
+    out.resize(static_cast<size_t>(w) * h * 2);
+    glBindFramebuffer(GL_FRAMEBUFFER, silFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, octNormalTex, 0);
+    glViewport(0, 0, w, h);
+
+    octNormalShader->use();
+    octNormalShader->setInt("normalMap", 0);
+    glUniform2i(glGetUniformLocation(octNormalShader->ID, "sourceOrigin"), region.x, region.y);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, pbr.GetNormalTex());
+
+    {
+        Utils::GpuProfileScope gpuScope("PackOctNormals");
+        RenderQuad();
     }
-    glBindTexture(GL_TEXTURE_2D, texID);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+
+    Utils::CpuProfileScope scope("Readback");
+    glReadPixels(0, 0, w, h, GL_RG, GL_UNSIGNED_SHORT, out.data());
+    Utils::Profiler::Instance().AddReadback(out.size() * sizeof(uint16_t));
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void Application::UpdateHeatmapTexture(const std::vector<unsigned char>& data) {
-    glBindTexture(GL_TEXTURE_2D, targets.texHeatmap);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, targets.width, targets.height, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+void Application::UploadDisplay(const RenderTargets& tg, const Metrics::FrameRegion& region,
+                                Metrics::Color8 displayBg, Metrics::Color8 heatmapBg) {
+    Utils::CpuProfileScope scope("UploadDisplay");
+    const Metrics::PixelPassOutput& out = frame.passOutput;
+    if (!region.IsFull()) {
+        // 区域外只有背景，直接在 GPU 端清屏，无需上传整幅画面
+        const float display[4] = { displayBg.r / 255.0f, displayBg.g / 255.0f, displayBg.b / 255.0f, 1.0f };
+        const float heatmap[4] = { heatmapBg.r / 255.0f, heatmapBg.g / 255.0f, heatmapBg.b / 255.0f, 1.0f };
+        glBindFramebuffer(GL_FRAMEBUFFER, silFBO);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tg.texRef, 0);
+        glClearBufferfv(GL_COLOR, 0, display);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tg.texOpt, 0);
+        glClearBufferfv(GL_COLOR, 0, display);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tg.texHeatmap, 0);
+        glClearBufferfv(GL_COLOR, 0, heatmap);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, tg.texRef);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.width, region.height, GL_RGBA, GL_UNSIGNED_BYTE, out.refDisplay.data());
+    glBindTexture(GL_TEXTURE_2D, tg.texOpt);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.width, region.height, GL_RGBA, GL_UNSIGNED_BYTE, out.optDisplay.data());
+    glBindTexture(GL_TEXTURE_2D, tg.texHeatmap);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.width, region.height, GL_RGBA, GL_UNSIGNED_BYTE, out.heatmap.data());
+}
+
+const unsigned char* Application::SweepHeatmap(const Metrics::FrameRegion& region, Metrics::Color8 heatmapBg) {
+    const Metrics::PixelPassOutput& out = frame.sweepOutput;
+    if (region.IsFull()) return out.heatmap.data();
+    frame.sweepHeatmap.resize(static_cast<size_t>(region.frameWidth) * region.frameHeight * 4);
+    Metrics::PixelPasses::PadToFrame(Metrics::ImageView(out.heatmap, region.width, region.height, Metrics::PixelFormat::RGBA8), region, heatmapBg,
+                                     Metrics::MutableImageView(frame.sweepHeatmap, region.frameWidth, region.frameHeight, Metrics::PixelFormat::RGBA8));
+    return frame.sweepHeatmap.data();
 }
 
 Application::Application(const AppConfig& cfg) : config(cfg) {}
 
 Application::~Application() {
+    readback.Release();
+    if (compositeTex) Utils::TrackedDeleteTextures(1, &compositeTex);
+    if (compositeFBO) glDeleteFramebuffers(1, &compositeFBO);
     targets.Cleanup();
+    coarseTargets.Cleanup();
+    if (coverageTex) Utils::TrackedDeleteTextures(1, &coverageTex);
+    if (octNormalTex) Utils::TrackedDeleteTextures(1, &octNormalTex);
+    Utils::Profiler::Instance().ReleaseGpu();
+    Utils::GeometryUtils::Release();
     scene.Cleanup();
+    for (Renderer::IBLMaps& maps : environmentMaps) {
+        Utils::TrackedDeleteTextures(1, &maps.envCubemap);
+        Utils::TrackedDeleteTextures(1, &maps.irradianceMap);
+        Utils::TrackedDeleteTextures(1, &maps.prefilterMap);
+        Utils::TrackedDeleteTextures(1, &maps.brdfLUT);
+    }
+    environmentMaps.clear();
+    // 持有 GL 对象的子模块须在上下文销毁前析构 (基准模式会在同一进程内反复创建 Application)
+    renderer.reset();
+    coarseRenderer.reset();
+    deferred.reset();
+    coarseDeferred.reset();
+    visualizer.reset();
+    silhouetteShader.reset();
+    coverageShader.reset();
+    octNormalShader.reset();
     if (window) glfwDestroyWindow(window);
     glfwTerminate();
 }
@@ -271,61 +450,233 @@ bool Application::InitSystem() {
     window = glfwCreateWindow(config.window.width, config.window.height, config.window.title.c_str(), NULL, NULL);
     if (!window) return false;
     glfwMakeContextCurrent(window);
+    // 无窗口运行时不等待垂直同步，渲染循环的吞吐只受 GPU / CPU 限制
+    if (!config.render.display) glfwSwapInterval(0);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return false;
 
+    // 显存记账须在第一次 Tracked* 分配之前配置 (未启用时包装函数不记账)
+    const uint64_t MB = 1024ull * 1024ull;
+    Utils::MemoryTracker::Instance().Configure(config.memory.enabled, config.memory.hostBudgetMB * MB,
+                                               config.memory.gpuBudgetMB * MB, config.memory.sampleIntervalMs);
+    if (config.memory.enabled) {
+        std::cout << "[System] Memory accounting enabled (host budget "
+                  << (config.memory.hostBudgetMB ? std::to_string(config.memory.hostBudgetMB) + " MB" : "unlimited") << ", GPU budget "
+                  << (config.memory.gpuBudgetMB ? std::to_string(config.memory.gpuBudgetMB) + " MB" : "unlimited") << ")" << std::endl;
+    }
+
     targets.Init(config.render.width, config.render.height);
     visualizer = std::make_unique<Metrics::MetricVisualizer>(config.window.width, config.window.height);
     renderer = std::make_unique<Renderer::PBRRenderer>(targets.width, targets.height);
     renderer->SetExposure(config.render.exposure);
     renderer->SetBackground(config.render.background);
 
+    if (config.render.multiResolution) {
+        int divisor = std::max(config.render.multiResDivisor, 2);
+        coarseTargets.Init(std::max(targets.width / divisor, 16), std::max(targets.height / divisor, 16));
+        coarseRenderer = std::make_unique<Renderer::PBRRenderer>(coarseTargets.width, coarseTargets.height);
+        coarseRenderer->SetExposure(config.render.exposure);
+        coarseRenderer->SetBackground(config.render.background);
+        std::cout << "[System] Multi-resolution evaluation: coarse level " << coarseTargets.width << "x" << coarseTargets.height << std::endl;
+    }
+
+    if (config.toneSweep.enabled) {
+        renderer->EnableLinearCapture();
+        if (coarseRenderer) coarseRenderer->EnableLinearCapture();
+        for (Metrics::ToneOperator op : config.toneSweep.operators) {
+            for (float exposure : config.toneSweep.exposures) {
+                std::ostringstream name;
+                name << "PSNR_" << Metrics::ToneOperatorName(op) << "_x" << std::fixed << std::setprecision(2) << exposure;
+                toneSettings.push_back({ exposure, op, name.str() });
+            }
+        }
+        toneAccumulator.assign(toneSettings.size(), 0.0);
+        std::cout << "[System] Tone sweep: " << toneSettings.size() << " exposure / operator settings per view (PSNR phase)" << std::endl;
+    }
+    if (config.environmentSweep.enabled) InitEnvironments();
+
     silhouetteShader = std::make_unique<Renderer::Shader>(
             (config.paths.assetsRoot + "/shaders/metrics/quad.vert").c_str(),
             (config.paths.assetsRoot + "/shaders/metrics/silhouette.frag").c_str()
     );
     glGenFramebuffers(1, &silFBO);
+    if (config.output.offscreen) InitOffscreenOutput();
+
+    if (config.render.compactReadback) {
+        coverageShader = std::make_unique<Renderer::Shader>(
+                (config.paths.assetsRoot + "/shaders/metrics/quad.vert").c_str(),
+                (config.paths.assetsRoot + "/shaders/metrics/coverage.frag").c_str()
+        );
+        octNormalShader = std::make_unique<Renderer::Shader>(
+                (config.paths.assetsRoot + "/shaders/metrics/quad.vert").c_str(),
+                (config.paths.assetsRoot + "/shaders/metrics/oct_normal.frag").c_str()
+        );
+
+        glGenTextures(1, &coverageTex);
+        glBindTexture(GL_TEXTURE_2D, coverageTex);
+        Utils::TrackedTexImage2D(Utils::MemoryCategory::FrameBuffer, GL_TEXTURE_2D, 0, GL_R32UI, (targets.width + 31) / 32, targets.height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glGenTextures(1, &octNormalTex);
+        glBindTexture(GL_TEXTURE_2D, octNormalTex);
+        Utils::TrackedTexImage2D(Utils::MemoryCategory::FrameBuffer, GL_TEXTURE_2D, 0, GL_RG16, targets.width, targets.height, 0, GL_RG, GL_UNSIGNED_SHORT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        std::cout << "[System] Compact readback: RG16 octahedral normals + 1-bit coverage" << std::endl;
+    }
+
+    std::cout << "[System] Metric kernels: " << Metrics::Simd::LevelName(Metrics::Simd::GetLevel()) << std::endl;
 
+    Utils::Profiler::Instance().Configure(config.profiling.enabled, config.profiling.gpuTimers, config.profiling.maxEvents);
+    if (config.profiling.enabled) std::cout << "[System] Profiling enabled (trace.json per model)" << std::endl;
+
+    // 预留逐视角缓冲区，并提前创建常驻线程池与热力图查找表，避免它们落入渲染循环
+    frame.Init(config);
+    Utils::WorkerPool::Instance();
+    Metrics::Evaluator::HeatmapLUT();
+    std::cout << "[System] Frame buffers: " << frame.ReservedBytes() / (1024 * 1024) << " MB reserved" << std::endl;
     return true;
 }
 
+void Application::EvaluateGeometry() {
+    if (!scene.refModel || !scene.optModel) return;
+    Utils::CpuProfileScope scope("Hausdorff");
+
+    // 流式加载的网格没有主机端副本，CollectTriangles 会从显存回读 (需在 GL 线程调用)
+    std::vector<glm::vec3> refPositions, optPositions;
+    std::vector<unsigned int> refIndices, optIndices;
+    scene.refModel->CollectTriangles(refPositions, refIndices);
+    scene.optModel->CollectTriangles(optPositions, optIndices);
+
+    Metrics::HausdorffOptions options;
+    options.surfaceSamples = config.geometry.samples;
+    options.alignCenters = config.geometry.alignCenters;
+    Metrics::HausdorffResult result = Metrics::HausdorffEvaluator::Compute(
+            refPositions, refIndices, optPositions, optIndices, options);
+
+    std::cout << "  [Metric] Hausdorff: " << result.hausdorff
+              << " (opt->ref max " << result.optToRef.max << " mean " << result.optToRef.mean
+              << ", ref->opt max " << result.refToOpt.max << " mean " << result.refToOpt.mean
+              << ", " << result.timeMs << " ms)" << std::endl;
+
+    // 距离可能远小于 1e-6，使用有效数字格式而不是 std::to_string 的定点格式
+    std::ostringstream extra;
+    extra << std::setprecision(9)
+          << "," << result.optToRef.max << "," << result.optToRef.mean << "," << result.optToRef.rms
+          << "," << result.refToOpt.max << "," << result.refToOpt.mean << "," << result.refToOpt.rms
+          << "," << result.diagonal << "," << result.timeMs;
+    AppendToGlobalCSV("Hausdorff", result.hausdorff, extra.str());
+    results.Record(-1, "Hausdorff", result.hausdorff, result.timeMs);
+}
+
 void Application::ProcessSingleModel(const std::string& refPath, const std::string& optPath, const std::string& modelName) {
     currentModelName = modelName;
+    results.BeginModel(modelName, fs::path(optPath).stem().string());
+    outputStats.Reset();
     SetupOutputDirectories(modelName);
+    Utils::Profiler& profiler = Utils::Profiler::Instance();
+    profiler.BeginModel();
+    lastProfile = Utils::ProfileSummary();
+    Utils::MemoryTracker& memory = Utils::MemoryTracker::Instance();
+    memory.BeginModel();
 
-    scene.Cleanup();
     std::cout << "  [System] Loading..." << std::endl;
-    scene.refModel = Resources::ResourceManager::GetInstance().LoadModel(refPath);
-    scene.optModel = Resources::ResourceManager::GetInstance().LoadModel(optPath);
+    Scene::ModelLoadOptions loadOptions;
+    loadOptions.texture.maxSize = config.texture.maxSize;
+    if (loadOptions.texture.maxSize == 0) {
+        int maxDim = std::max(config.render.width, config.render.height);
+        int pot = 1;
+        while (pot < maxDim) pot <<= 1;
+        loadOptions.texture.maxSize = pot * 2;
+    }
+    loadOptions.texture.useCache = config.texture.useCache;
+    loadOptions.texture.compress = config.texture.compress;
+    loadOptions.texture.cacheDir = config.texture.cacheDir;
+    loadOptions.streaming = config.loading.streaming;
+    loadOptions.chunkVertices = config.loading.chunkVertices;
+
+    {
+        Utils::CpuProfileScope scope("LoadModels");
+        scene.refModel = Resources::ResourceManager::GetInstance().LoadModel(refPath, loadOptions);
+        scene.optModel = Resources::ResourceManager::GetInstance().LoadModel(optPath, loadOptions);
+    }
+    if (config.geometry.hausdorff && !memory.OverBudget()) EvaluateGeometry();
 
     fs::path assets = config.paths.assetsRoot;
     std::string hdrPath = Utils::FindFirstFileByExt((assets / config.paths.hdrDir).string(), {".hdr"});
-    if (!hdrPath.empty()) {
+    if (!hdrPath.empty() && !memory.OverBudget()) {
         if (scene.envMaps.envCubemap == 0) {
             std::cout << "  [System] Baking IBL..." << std::endl;
+            Utils::CpuProfileScope scope("BakeIBL");
             scene.envMaps = Renderer::IBLBaker::BakeIBL(hdrPath);
         }
     }
 
     float aspect = (float)targets.width / (float)targets.height;
     views = Scene::CameraSampler::GenerateSamples(config.sampling.viewCount, config.sampling.radius, aspect, 0.0f);
+    if (config.sampling.progressive) views = Scene::CameraSampler::ProgressiveOrder(views);
 
     currentViewIdx = 0;
     lastTime = (float)glfwGetTime();
     accumulatorError = 0.0;
+    accumulatorMsSsim = 0.0;
+    accumulatorCostMs = 0.0;
+    viewStats.Reset();
+    multiRes.Reset();
+    multiResView = -1;
+    std::fill(toneAccumulator.begin(), toneAccumulator.end(), 0.0);
+    toneSweepMs = 0.0;
+    linearCaptured = false;
+    std::fill(environmentAccumulator.begin(), environmentAccumulator.end(), 0.0);
+    environmentSweepMs = 0.0;
+    gbufferSource = nullptr;
     currentPhase = RenderPhase::PHASE_IBL_PSNR;
     lastSavedView = -1;
 
     fs::path outRoot = config.paths.outputRoot;
     currentOutputDir = (outRoot / modelName / "psnr").string();
 
-    while (!glfwWindowShouldClose(window) && currentPhase != RenderPhase::FINISHED) {
-        ProcessInput();
-        UpdateState();
-        RenderPasses();
+    // 超出内存预算时跳过剩余阶段 (采样线程置位，每帧检查一次)
+    while (!glfwWindowShouldClose(window) && currentPhase != RenderPhase::FINISHED && !memory.OverBudget()) {
+        {
+            Utils::CpuProfileScope scope("Frame");
+            ProcessInput();
+            UpdateState();
+            RenderPasses();
+            RecordView();
+            if (readback.Pending() > 0) readback.Poll();
+
+            Utils::CpuProfileScope swapScope("SwapBuffers");
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+        profiler.AddFrame();
+        profiler.CollectGpu();
+    }
+    readback.Drain();
+    CloseErrorMaps();
+    if (profiler.Enabled()) {
+        lastProfile = profiler.EndModel((outRoot / modelName / "trace.json").string());
+        ReportProfile(lastProfile);
+    }
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+    // 释放本模型的网格与纹理，批处理中显存与主机内存不随模型数累积
+    scene.refModel.reset();
+    scene.optModel.reset();
+    Resources::ResourceManager::GetInstance().Unload(refPath);
+    Resources::ResourceManager::GetInstance().Unload(optPath);
+
+    Utils::MemoryReport memoryReport = memory.EndModel();
+    if (memory.Enabled()) ReportMemory(memoryReport);
+    {
+        Utils::CpuProfileScope scope("ResultsFlush");
+        results.FlushModel();
+    }
+    if (memoryReport.overBudget) {
+        std::cerr << "[Memory] " << modelName << " aborted: " << memoryReport.budgetReason << std::endl;
+        return;
     }
     std::cout << "[System] Finished " << modelName << std::endl;
 }
@@ -334,10 +685,10 @@ void Application::RenderTargets::Init(int w, int h) {
     width = w;
     height = h;
     auto createTex = [&](unsigned int& tex, bool isFloat) {
-        if (tex) glDeleteTextures(1, &tex);
+        if (tex) Utils::TrackedDeleteTextures(1, &tex);
         glGenTextures(1, &tex);
         glBindTexture(GL_TEXTURE_2D, tex);
-        glTexImage2D(GL_TEXTURE_2D, 0, isFloat ? GL_RGBA16F : GL_RGBA, width, height, 0, GL_RGBA, isFloat ? GL_FLOAT : GL_UNSIGNED_BYTE, NULL);
+        Utils::TrackedTexImage2D(Utils::MemoryCategory::FrameBuffer, GL_TEXTURE_2D, 0, isFloat ? GL_RGBA16F : GL_RGBA, width, height, 0, GL_RGBA, isFloat ? GL_FLOAT : GL_UNSIGNED_BYTE, NULL);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -349,9 +700,75 @@ void Application::RenderTargets::Init(int w, int h) {
 }
 
 void Application::RenderTargets::Cleanup() {
-    if (texRef) glDeleteTextures(1, &texRef);
-    if (texOpt) glDeleteTextures(1, &texOpt);
-    if (texHeatmap) glDeleteTextures(1, &texHeatmap);
+    if (texRef) Utils::TrackedDeleteTextures(1, &texRef);
+    if (texOpt) Utils::TrackedDeleteTextures(1, &texOpt);
+    if (texHeatmap) Utils::TrackedDeleteTextures(1, &texHeatmap);
+}
+
+void Application::FrameBuffers::Init(const AppConfig& config) {
+    const int w = config.render.width;
+    const int h = config.render.height;
+    const size_t pixels = static_cast<size_t>(w) * h;
+
+    // 只为当前回读模式实际会用到的缓冲区预留空间
+    if (config.render.compactReadback) {
+        refOct.reserve(pixels * 2);
+        optOct.reserve(pixels * 2);
+    } else {
+        refNormals.reserve(pixels * 3);
+        optNormals.reserve(pixels * 3);
+        depth.reserve(pixels);
+    }
+    refBytes.reserve(pixels * 3);
+    optBytes.reserve(pixels * 3);
+    silReadback.reserve(pixels);
+    refCoverage.Resize(w, h);
+    optCoverage.Resize(w, h);
+    refSil.words.reserve((pixels + 63) / 64);
+    optSil.words.reserve((pixels + 63) / 64);
+    passOutput.Prepare(w, h, config.output.errorMaps);
+    if (config.render.ssim) ssim.Reserve(w, h);
+    if (config.render.flip) flip.Reserve(w, h, config.render.flipPixelsPerDegree);
+    if (config.render.multiResolution) {
+        // 粗层级复用上面的全分辨率缓冲 (容量足够)，只需额外预留其 2x 降采样与两个观察条件下的 FLIP
+        const int divisor = std::max(config.render.multiResDivisor, 2);
+        const int cw = std::max(w / divisor, 16), ch = std::max(h / divisor, 16);
+        refHalf.reserve(static_cast<size_t>(cw / 2) * (ch / 2) * 3);
+        optHalf.reserve(static_cast<size_t>(cw / 2) * (ch / 2) * 3);
+        if (config.render.flip) {
+            coarseFlip.Reserve(cw, ch, config.render.flipPixelsPerDegree / divisor);
+            halfFlip.Reserve(cw / 2, ch / 2, config.render.flipPixelsPerDegree / (2.0f * divisor));
+        }
+    }
+    screenshot.reserve(static_cast<size_t>(config.window.width) * config.window.height * 3);
+    if (config.toneSweep.enabled) {
+        refLinear.reserve(pixels * 4);
+        optLinear.reserve(pixels * 4);
+        refToned.reserve(pixels * 3);
+        optToned.reserve(pixels * 3);
+        sweepOutput.Prepare(w, h);
+        if (config.toneSweep.heatmaps) sweepHeatmap.reserve(pixels * 4);
+    }
+    if (config.environmentSweep.enabled) {
+        refShaded.reserve(pixels * 3);
+        optShaded.reserve(pixels * 3);
+        sweepOutput.Prepare(w, h);
+        if (config.environmentSweep.heatmaps) sweepHeatmap.reserve(pixels * 4);
+    }
+}
+
+size_t Application::FrameBuffers::ReservedBytes() const {
+    return (refNormals.capacity() + optNormals.capacity() + depth.capacity()) * sizeof(float) +
+           (refOct.capacity() + optOct.capacity()) * sizeof(uint16_t) +
+           refBytes.capacity() + optBytes.capacity() + silReadback.capacity() + screenshot.capacity() +
+           (refCoverage.words.capacity() + optCoverage.words.capacity()) * sizeof(uint32_t) +
+           (refSil.words.capacity() + optSil.words.capacity()) * sizeof(uint64_t) +
+           passOutput.refDisplay.capacity() + passOutput.optDisplay.capacity() + passOutput.heatmap.capacity() +
+           refHalf.capacity() + optHalf.capacity() +
+           (refLinear.capacity() + optLinear.capacity()) * sizeof(uint16_t) + refToned.capacity() + optToned.capacity() +
+           refShaded.capacity() + optShaded.capacity() +
+           sweepOutput.refDisplay.capacity() + sweepOutput.optDisplay.capacity() + sweepOutput.heatmap.capacity() + sweepHeatmap.capacity() +
+           ssim.ReservedBytes() + flip.ReservedBytes() + coarseFlip.ReservedBytes() + halfFlip.ReservedBytes();
 }
 
 void Application::ProcessInput() {
@@ -367,10 +784,13 @@ void Application::UpdateState() {
         lastTime = currentTime;
         currentViewIdx++;
 
-        if (currentViewIdx >= views.size()) {
+        if (currentViewIdx >= views.size() || PhaseConverged()) {
             currentViewIdx = 0;
 
-            double avgError = accumulatorError / (double)views.size();
+            // 渐进式评估提前结束时，只对已渲染的视角求平均
+            double viewsUsed = (double)std::max<size_t>(viewStats.Count(), 1);
+            double errorBound = viewStats.HalfWidth(config.sampling.confidenceZ);
+            double avgError = accumulatorError / viewsUsed;
 
             std::string metricName;
             std::string shortName;
@@ -379,6 +799,14 @@ void Application::UpdateState() {
                 metricName = "Average PSNR (dB)";
                 shortName = "PSNR";
             }
+            else if (currentPhase == RenderPhase::PHASE_SSIM) {
+                metricName = "Average SSIM";
+                shortName = "SSIM";
+            }
+            else if (currentPhase == RenderPhase::PHASE_FLIP) {
+                metricName = "Average FLIP";
+                shortName = "FLIP";
+            }
             else if (currentPhase == RenderPhase::PHASE_NORMAL) {
                 metricName = "Normal Error (MSE)";
                 shortName = "Normal";
@@ -390,17 +818,120 @@ void Application::UpdateState() {
 
             std::cout << "\n========================================" << std::endl;
             std::cout << "[RESULT] " << metricName << ": " << avgError << std::endl;
+
+            std::string extraColumns;
+            double avgCostMs = std::numeric_limits<double>::quiet_NaN();
+            if (currentPhase == RenderPhase::PHASE_SSIM) {
+                double avgMsSsim = accumulatorMsSsim / viewsUsed;
+                avgCostMs = accumulatorCostMs / viewsUsed;
+                std::cout << "[RESULT] Average MS-SSIM: " << avgMsSsim << " (" << avgCostMs << " ms/view)" << std::endl;
+                extraColumns = "," + std::to_string(avgMsSsim) + "," + std::to_string(avgCostMs);
+                results.Record(-1, "MS-SSIM", avgMsSsim, avgCostMs);
+            }
+            else if (currentPhase == RenderPhase::PHASE_FLIP) {
+                avgCostMs = accumulatorCostMs / viewsUsed;
+                std::cout << "[RESULT] FLIP cost: " << avgCostMs << " ms/view" << std::endl;
+                extraColumns = "," + std::to_string(avgCostMs);
+            }
+            std::cout << "[RESULT] Views used: " << viewStats.Count() << "/" << views.size()
+                      << ", " << config.sampling.confidenceZ << "-sigma bound: +/-" << errorBound << std::endl;
             std::cout << "========================================\n" << std::endl;
 
-            AppendToGlobalCSV(shortName, avgError);
+            std::ostringstream boundText;  // 法线/轮廓 MSE 的区间半宽可能远小于 1e-6，不使用定点格式
+            boundText << errorBound;
+            extraColumns += "," + std::to_string(viewStats.Count()) + "," + boundText.str();
+            AppendToGlobalCSV(shortName, avgError, extraColumns);
+            results.Record(-1, shortName, avgError, avgCostMs);
+
+            if (multiRes.views > 0) {
+                // 节省的时间 = 全部视角按全分辨率评估的估计耗时 - 实际耗时；
+                // 全分辨率单视角耗时取细化视角的实测均值 (没有细化视角时按像素数比例由粗层级外推)
+                double coarsePerView = multiRes.coarseMs / (double)multiRes.views;
+                double fullPerView = (multiRes.refined > 0) ? multiRes.fullMs / (double)multiRes.refined :
+                                     coarsePerView * ((double)targets.width * targets.height) / ((double)coarseTargets.width * coarseTargets.height);
+                double fullOnlyMs = fullPerView * (double)multiRes.views;
+                double savedMs = fullOnlyMs - (multiRes.coarseMs + multiRes.fullMs);
+                std::cout << "[RESULT] Multi-resolution: " << multiRes.refined << "/" << multiRes.views
+                          << " views refined, saved " << savedMs << " ms (" << fullOnlyMs << " ms at full resolution)" << std::endl;
+                AppendToGlobalCSV("MultiRes", savedMs, "," + std::to_string(multiRes.coarseMs) + "," +
+                                  std::to_string(multiRes.fullMs) + "," + std::to_string(fullOnlyMs),
+                                  "," + shortName + "," + std::to_string(multiRes.views) + "," + std::to_string(multiRes.refined));
+            }
+
+            if (currentPhase == RenderPhase::PHASE_IBL_PSNR && !toneSettings.empty()) {
+                std::cout << "[RESULT] Tone sweep (" << toneSweepMs / viewsUsed << " ms/view):" << std::endl;
+                for (size_t i = 0; i < toneSettings.size(); ++i) {
+                    const ToneSetting& setting = toneSettings[i];
+                    const double avgPsnr = toneAccumulator[i] / viewsUsed;
+                    std::cout << "           " << std::setw(8) << Metrics::ToneOperatorName(setting.op) << " x" << setting.exposure
+                              << ": " << avgPsnr << " dB" << std::endl;
+                    AppendToGlobalCSV("ToneSweep", avgPsnr, "," + std::string(Metrics::ToneOperatorName(setting.op)) + "," +
+                                      std::to_string(setting.exposure) + "," + std::to_string(viewStats.Count()) + "," +
+                                      std::to_string(toneSweepMs));
+                    results.Record(-1, setting.name, avgPsnr);
+                }
+                std::fill(toneAccumulator.begin(), toneAccumulator.end(), 0.0);
+                toneSweepMs = 0.0;
+            }
+
+            if (currentPhase == RenderPhase::PHASE_IBL_PSNR && !environmentSettings.empty()) {
+                std::cout << "[RESULT] Environment sweep (deferred, " << environmentSweepMs / viewsUsed << " ms/view):" << std::endl;
+                for (size_t i = 0; i < environmentSettings.size(); ++i) {
+                    const EnvironmentSetting& setting = environmentSettings[i];
+                    const std::string& envName = environmentNames[setting.environment];
+                    const double avgPsnr = environmentAccumulator[i] / viewsUsed;
+                    std::cout << "           " << std::setw(12) << envName << " r" << setting.rotation << ": " << avgPsnr << " dB" << std::endl;
+                    AppendToGlobalCSV("Environment", avgPsnr, "," + envName + "," + std::to_string(setting.rotation) + "," +
+                                      std::to_string(viewStats.Count()) + "," + std::to_string(environmentSweepMs));
+                    results.Record(-1, setting.name, avgPsnr);
+                }
+                std::fill(environmentAccumulator.begin(), environmentAccumulator.end(), 0.0);
+                environmentSweepMs = 0.0;
+            }
+
+            // 截图输出: 本阶段的张数、字节数与编码 / 写盘耗时 (仅指标模式下全为 0)；离屏输出先取回本阶段全部在途回读
+            readback.Drain();
+            const Utils::ImageFormat format = OutputFormat(currentPhase);
+            if (outputStats.images > 0) {
+                std::cout << "[RESULT] Screenshots: " << outputStats.images << " x " << Utils::ImageFormatName(format) << ", "
+                          << outputStats.bytes / (1024.0 * 1024.0) << " MB, encode " << outputStats.encodeMs / outputStats.images
+                          << " ms/view, write " << outputStats.writeMs / outputStats.images << " ms/view";
+                if (readback.Ready()) std::cout << ", " << readback.Stalls() << " readback stalls";
+                std::cout << std::endl;
+            }
+            readback.ResetStats();
+            CloseErrorMaps();
+            AppendToGlobalCSV("Output", outputStats.encodeMs, "," + std::to_string(outputStats.writeMs),
+                              "," + shortName + "," + Utils::ImageFormatName(format) + "," +
+                              std::to_string(outputStats.images) + "," + std::to_string(outputStats.bytes));
+            outputStats.Reset();
 
             accumulatorError = 0.0;
+            accumulatorMsSsim = 0.0;
+            accumulatorCostMs = 0.0;
+            viewStats.Reset();
+            multiRes.Reset();
+            multiResView = -1;
 
             fs::path outRoot = config.paths.outputRoot;
-            if (currentPhase == RenderPhase::PHASE_IBL_PSNR) {
+            if (currentPhase == RenderPhase::PHASE_IBL_PSNR && config.render.ssim) {
+                currentPhase = RenderPhase::PHASE_SSIM;
+                currentOutputDir = (outRoot / currentModelName / "ssim").string();
+                std::cout << ">>> Phase Switch: IBL -> SSIM" << std::endl;
+                lastSavedView = -1;
+            }
+            else if ((currentPhase == RenderPhase::PHASE_IBL_PSNR || currentPhase == RenderPhase::PHASE_SSIM) && config.render.flip) {
+                std::cout << ">>> Phase Switch: " << (currentPhase == RenderPhase::PHASE_SSIM ? "SSIM" : "IBL") << " -> FLIP" << std::endl;
+                currentPhase = RenderPhase::PHASE_FLIP;
+                currentOutputDir = (outRoot / currentModelName / "flip").string();
+                lastSavedView = -1;
+            }
+            else if (currentPhase == RenderPhase::PHASE_IBL_PSNR || currentPhase == RenderPhase::PHASE_SSIM ||
+                     currentPhase == RenderPhase::PHASE_FLIP) {
+                std::cout << ">>> Phase Switch: " << (currentPhase == RenderPhase::PHASE_FLIP ? "FLIP" :
+                                                      currentPhase == RenderPhase::PHASE_SSIM ? "SSIM" : "IBL") << " -> Silhouette" << std::endl;
                 currentPhase = RenderPhase::PHASE_SILHOUETTE;
                 currentOutputDir = (outRoot / currentModelName / "silhouette").string();
-                std::cout << ">>> Phase Switch: IBL -> Silhouette" << std::endl;
                 lastSavedView = -1;
             }
             else if (currentPhase == RenderPhase::PHASE_SILHOUETTE) {
@@ -417,16 +948,96 @@ void Application::UpdateState() {
     }
 }
 
+bool Application::PhaseConverged() const {
+    if (!config.sampling.progressive) return false;
+    if (viewStats.Count() < (size_t)std::max(2, config.sampling.minViews)) return false;
+
+    double tolerance = std::max((double)config.sampling.relativeTolerance * std::abs(viewStats.Mean()),
+                                (double)config.sampling.absoluteTolerance);
+    return viewStats.HalfWidth(config.sampling.confidenceZ) <= tolerance;
+}
+
 void Application::RenderPasses() {
     if (views.empty() || currentPhase == RenderPhase::FINISHED) return;
 
-    RenderPhase phaseToDraw = currentPhase;
+    // 调试构建中断言: 除每个阶段的首帧外，整个渲染-回读-计算-上传过程不发生堆分配
+    Utils::ZeroAllocationScope allocScope("RenderPasses", currentPhase == lastDrawnPhase);
+    lastDrawnPhase = currentPhase;
+
     const auto& cam = views[currentViewIdx];
+    Utils::Profiler::Instance().SetContext(cam.index, PhaseName(currentPhase));
+    RenderTargets* shown = &targets;
+    const bool colorPhase = currentPhase == RenderPhase::PHASE_IBL_PSNR || currentPhase == RenderPhase::PHASE_SSIM ||
+                            currentPhase == RenderPhase::PHASE_FLIP;
+
+    if (coarseRenderer && colorPhase) {
+        const float coarsePpd = config.render.flipPixelsPerDegree / (float)config.render.multiResDivisor;
+        if (currentViewIdx != multiResView) {
+            // 视角首帧: 粗层级评估 + 稳定性检查，据此决定是否以全分辨率重新评估
+            auto start = std::chrono::steady_clock::now();
+            double coarseValue = EvaluateView(cam, *coarseRenderer, coarseTargets, frame.coarseFlip, coarsePpd);
+            double coarseError = ErrorMagnitude(coarseValue);
+            double halfError = 0.0;
+            {
+                Utils::CpuProfileScope scope("HalfResolutionCheck");
+                halfError = HalfResolutionError();
+            }
+            auto coarseEnd = std::chrono::steady_clock::now();
+
+            Metrics::RunningStats& dist = multiRes.coarseError;
+            bool high = dist.Count() < 2 ||
+                        coarseError > dist.Mean() + config.render.refineSigma * std::sqrt(dist.Variance());
+            bool unstable = std::abs(coarseError - halfError) >
+                            config.render.refineTolerance * std::max(std::abs(coarseError), 1e-12);
+            dist.Add(coarseError);
+
+            multiResView = currentViewIdx;
+            multiResRefined = high || unstable;
+            multiRes.views++;
+            multiRes.coarseMs += std::chrono::duration<double, std::milli>(coarseEnd - start).count();
+            if (multiResRefined) {
+                currentViewError = EvaluateView(cam, *renderer, targets, frame.flip, config.render.flipPixelsPerDegree);
+                multiRes.refined++;
+                multiRes.fullMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - coarseEnd).count();
+            } else {
+                currentViewError = coarseValue;
+            }
+        }
+        else if (multiResRefined) {
+            currentViewError = EvaluateView(cam, *renderer, targets, frame.flip, config.render.flipPixelsPerDegree);
+        }
+        else {
+            currentViewError = EvaluateView(cam, *coarseRenderer, coarseTargets, frame.coarseFlip, coarsePpd);
+        }
+        if (!multiResRefined) shown = &coarseTargets;
+    }
+    else {
+        currentViewError = EvaluateView(cam, *renderer, targets, frame.flip, config.render.flipPixelsPerDegree);
+    }
+
+    // --- Pass 3: Visualization ---
+    shownTargets = shown;
+    if (!WindowCompositeNeeded()) return;
+    Utils::CpuProfileScope scope("Visualize");
+    Utils::GpuProfileScope gpuScope("Visualize");
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, config.window.width, config.window.height);
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    visualizer->RenderComparison(shown->texRef, shown->texOpt, shown->texHeatmap);
+}
+
+double Application::EvaluateView(const Scene::CameraSample& cam, Renderer::PBRRenderer& pbr, RenderTargets& tg,
+                                 Metrics::FlipEvaluator& flipEval, float pixelsPerDegree) {
+    Utils::CpuProfileScope evaluateScope("EvaluateView");
+    RenderPhase phaseToDraw = currentPhase;
     bool drawSkybox = false;
     int renderMode = 0;
 
     switch (phaseToDraw) {
         case RenderPhase::PHASE_IBL_PSNR:
+        case RenderPhase::PHASE_SSIM:
+        case RenderPhase::PHASE_FLIP:
             drawSkybox = config.render.showSkyboxPSNR;
             renderMode = 0;
             break;
@@ -440,13 +1051,43 @@ void Application::RenderPasses() {
             break;
     }
 
+    // 屏幕空间 ROI: 外扩量取决于当前阶段逐像素计算的邻域大小
+    Metrics::FrameRegion region = Metrics::FrameRegion::Full(tg.width, tg.height);
+    if (config.render.screenSpaceRoi && !drawSkybox) {
+        int margin = 1, alignment = 1;
+        if (phaseToDraw == RenderPhase::PHASE_SSIM) {
+            margin = Metrics::SsimEvaluator::CropMargin(config.render.msssimScales);
+            alignment = Metrics::SsimEvaluator::CropAlignment(config.render.msssimScales);
+        }
+        else if (phaseToDraw == RenderPhase::PHASE_FLIP) {
+            margin = flipEval.FilterRadius(pixelsPerDegree) + 1;
+        }
+        else if (phaseToDraw == RenderPhase::PHASE_SILHOUETTE) {
+            margin = 2; // 轮廓着色器采样相邻像素
+        }
+        region = ViewRegion(cam, tg.width, tg.height, margin, alignment);
+    }
+    viewRegion = region;
+    if (region.IsFull()) {
+        pbr.SetScissor(0, 0, 0, 0);
+    } else {
+        // 渲染区域比回读区域多 1 像素，轮廓着色器在区域边缘采样的相邻像素也是本视角的内容
+        int x0 = std::max(0, region.x - 1), y0 = std::max(0, region.y - 1);
+        int x1 = std::min(tg.width, region.x + region.width + 1), y1 = std::min(tg.height, region.y + region.height + 1);
+        pbr.SetScissor(x0, y0, x1 - x0, y1 - y0);
+    }
+
     // --- Pass 1: RefModel ---
-    renderer->BeginScene(cam.viewMatrix, cam.projMatrix, cam.position);
-    renderer->RenderScene(scene, true, config, renderMode);
-    if (drawSkybox) renderer->RenderSkybox(scene.envMaps.envCubemap);
-    renderer->EndScene();
+    {
+        Utils::CpuProfileScope scope("DrawRef");
+        Utils::GpuProfileScope gpuScope("DrawRef");
+        pbr.BeginScene(cam.viewMatrix, cam.projMatrix, cam.position);
+        pbr.RenderScene(scene, true, config, renderMode);
+        if (drawSkybox) pbr.RenderSkybox(scene.envMaps.envCubemap);
+        pbr.EndScene();
+    }
 
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, renderer->GetFBO());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, pbr.GetFBO());
 
     // [修改点2]：在 Normal 模式下，需要读取 Attachment 1 (法线)，否则会读到黑色的 Color Attachment
     if (currentPhase == RenderPhase::PHASE_NORMAL) {
@@ -455,55 +1096,82 @@ void Application::RenderPasses() {
         glReadBuffer(GL_COLOR_ATTACHMENT0);
     }
 
-    glBindTexture(GL_TEXTURE_2D, targets.texRef);
-    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, targets.width, targets.height);
+    glBindTexture(GL_TEXTURE_2D, tg.texRef);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.x, region.y, region.width, region.height);
 
     // 恢复读取缓冲区，以免影响后续操作
     glReadBuffer(GL_COLOR_ATTACHMENT0);
 
-    std::vector<float> refDepth, refNormals;
-    std::vector<unsigned char> refSil;
+    // 曝光 / 色调映射扫描: 每个视角只在首帧回读一次线性辐射度
+    const bool captureLinear = !toneSettings.empty() && phaseToDraw == RenderPhase::PHASE_IBL_PSNR && currentViewIdx != lastSavedView;
+    if (captureLinear) ReadLinear(pbr, region, frame.refLinear);
+
+    // 多环境评估: 同样只在首帧保存两个模型的 G-buffer 快照，延迟着色在 RecordView 中进行
+    Renderer::DeferredShading* gbuffer = (&pbr == coarseRenderer.get()) ? coarseDeferred.get() : deferred.get();
+    const bool captureGBuffer = gbuffer && phaseToDraw == RenderPhase::PHASE_IBL_PSNR && currentViewIdx != lastSavedView;
+    if (captureGBuffer) {
+        if (region.IsFull()) gbuffer->SetScissor(0, 0, 0, 0);
+        else gbuffer->SetScissor(region.x, region.y, region.width, region.height);
+        gbuffer->Capture(pbr, 0);
+    }
+
+    Metrics::CoverageMask& refCoverage = frame.refCoverage;
+    Metrics::PackedMask& refSil = frame.refSil;
+    std::vector<unsigned char>& silReadback = frame.silReadback;
 
     // 【GPU 加速提取参考模型轮廓】
     if (currentPhase == RenderPhase::PHASE_SILHOUETTE) {
         glBindFramebuffer(GL_FRAMEBUFFER, silFBO);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, targets.texRef, 0);
-        glViewport(0, 0, targets.width, targets.height);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tg.texRef, 0);
+        glViewport(0, 0, tg.width, tg.height);
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(region.x, region.y, region.width, region.height);
         glClear(GL_COLOR_BUFFER_BIT);
 
         silhouetteShader->use();
         silhouetteShader->setInt("depthMap", 0);
         silhouetteShader->setInt("normalMap", 1);
-        silhouetteShader->setVec2("texelSize", glm::vec2(1.0f / targets.width, 1.0f / targets.height));
+        silhouetteShader->setVec2("texelSize", glm::vec2(1.0f / tg.width, 1.0f / tg.height));
 
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, renderer->GetDepthTex());
+        glBindTexture(GL_TEXTURE_2D, pbr.GetDepthTex());
         glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, renderer->GetNormalTex());
+        glBindTexture(GL_TEXTURE_2D, pbr.GetNormalTex());
 
-        RenderQuad();
+        {
+            Utils::GpuProfileScope gpuScope("SilhouetteExtract");
+            RenderQuad();
+        }
+        glDisable(GL_SCISSOR_TEST);
 
-        // 直接从 GPU 读回算好的黑白轮廓图 (只读 R 通道)
-        refSil.resize(targets.width * targets.height);
-        glReadPixels(0, 0, targets.width, targets.height, GL_RED, GL_UNSIGNED_BYTE, refSil.data());
+        // 直接从 GPU 读回算好的黑白轮廓图 (只读 R 通道)，随即打包为按位掩码
+        silReadback.resize(region.PixelCount());
+        ReadPixelsInRegion(region, GL_RED, GL_UNSIGNED_BYTE, silReadback);
+        Metrics::Evaluator::PackSilhouette(Metrics::ImageView(silReadback, region.width, region.height, Metrics::PixelFormat::R8), refSil);
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
     else {
         // 只有在非 Silhouette 阶段，才需要将笨重的深度或法线数据搬运给 CPU
-        refDepth = ReadTextureDepth(renderer->GetDepthTex(), targets.width, targets.height);
-        if (currentPhase == RenderPhase::PHASE_NORMAL) {
-            refNormals = ReadTextureFloat(renderer->GetNormalTex(), targets.width, targets.height);
+        if (currentPhase == RenderPhase::PHASE_NORMAL && !config.render.compactReadback) {
+            ReadNormals(pbr, region, frame.refNormals);
+        } else {
+            if (currentPhase == RenderPhase::PHASE_NORMAL) ReadOctNormals(pbr, region, frame.refOct);
+            ReadCoverage(pbr, region, refCoverage);
         }
     }
 
     // --- Pass 2: OptModel ---
-    renderer->BeginScene(cam.viewMatrix, cam.projMatrix, cam.position);
-    renderer->RenderScene(scene, false, config, renderMode);
-    if (drawSkybox) renderer->RenderSkybox(scene.envMaps.envCubemap);
-    renderer->EndScene();
+    {
+        Utils::CpuProfileScope scope("DrawOpt");
+        Utils::GpuProfileScope gpuScope("DrawOpt");
+        pbr.BeginScene(cam.viewMatrix, cam.projMatrix, cam.position);
+        pbr.RenderScene(scene, false, config, renderMode);
+        if (drawSkybox) pbr.RenderSkybox(scene.envMaps.envCubemap);
+        pbr.EndScene();
+    }
 
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, renderer->GetFBO());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, pbr.GetFBO());
 
     if (currentPhase == RenderPhase::PHASE_NORMAL) {
         glReadBuffer(GL_COLOR_ATTACHMENT1);
@@ -511,195 +1179,485 @@ void Application::RenderPasses() {
         glReadBuffer(GL_COLOR_ATTACHMENT0);
     }
 
-    glBindTexture(GL_TEXTURE_2D, targets.texOpt);
-    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, targets.width, targets.height);
+    glBindTexture(GL_TEXTURE_2D, tg.texOpt);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.x, region.y, region.width, region.height);
 
     // 恢复
     glReadBuffer(GL_COLOR_ATTACHMENT0);
 
-    std::vector<float> optDepth, optNormals;
-    std::vector<unsigned char> optSil;
+    if (captureLinear) {
+        ReadLinear(pbr, region, frame.optLinear);
+        linearCaptured = true;
+        linearRegion = region;
+        linearSkybox = drawSkybox;
+    }
+    if (captureGBuffer) {
+        gbuffer->Capture(pbr, 1);
+        gbufferSource = gbuffer;
+        gbufferRegion = region;
+        gbufferView = cam.viewMatrix;
+        gbufferProjection = cam.projMatrix;
+        gbufferCamPos = cam.position;
+        gbufferSkybox = drawSkybox;
+    }
+
+    Metrics::CoverageMask& optCoverage = frame.optCoverage;
+    Metrics::PackedMask& optSil = frame.optSil;
 
     // 【GPU 加速提取优化模型轮廓】
     if (currentPhase == RenderPhase::PHASE_SILHOUETTE) {
         glBindFramebuffer(GL_FRAMEBUFFER, silFBO);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, targets.texOpt, 0);
-        glViewport(0, 0, targets.width, targets.height);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tg.texOpt, 0);
+        glViewport(0, 0, tg.width, tg.height);
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(region.x, region.y, region.width, region.height);
         glClear(GL_COLOR_BUFFER_BIT);
 
         silhouetteShader->use();
         silhouetteShader->setInt("depthMap", 0);
         silhouetteShader->setInt("normalMap", 1);
-        silhouetteShader->setVec2("texelSize", glm::vec2(1.0f / targets.width, 1.0f / targets.height));
+        silhouetteShader->setVec2("texelSize", glm::vec2(1.0f / tg.width, 1.0f / tg.height));
 
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, renderer->GetDepthTex());
+        glBindTexture(GL_TEXTURE_2D, pbr.GetDepthTex());
         glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, renderer->GetNormalTex());
+        glBindTexture(GL_TEXTURE_2D, pbr.GetNormalTex());
 
-        RenderQuad();
+        {
+            Utils::GpuProfileScope gpuScope("SilhouetteExtract");
+            RenderQuad();
+        }
+        glDisable(GL_SCISSOR_TEST);
 
-        optSil.resize(targets.width * targets.height);
-        glReadPixels(0, 0, targets.width, targets.height, GL_RED, GL_UNSIGNED_BYTE, optSil.data());
+        silReadback.resize(region.PixelCount());
+        ReadPixelsInRegion(region, GL_RED, GL_UNSIGNED_BYTE, silReadback);
+        Metrics::Evaluator::PackSilhouette(Metrics::ImageView(silReadback, region.width, region.height, Metrics::PixelFormat::R8), optSil);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
     else {
-        optDepth = ReadTextureDepth(renderer->GetDepthTex(), targets.width, targets.height);
-        if (currentPhase == RenderPhase::PHASE_NORMAL) {
-            optNormals = ReadTextureFloat(renderer->GetNormalTex(), targets.width, targets.height);
+        if (currentPhase == RenderPhase::PHASE_NORMAL && !config.render.compactReadback) {
+            ReadNormals(pbr, region, frame.optNormals);
+        } else {
+            if (currentPhase == RenderPhase::PHASE_NORMAL) ReadOctNormals(pbr, region, frame.optOct);
+            ReadCoverage(pbr, region, optCoverage);
         }
     }
 
     // =========================================================
-    // 核心: CPU 计算误差 + 生成热力图
+    // 核心: CPU 计算误差 + 生成热力图 (每个阶段一个融合内核，逐像素只读一次)
     // =========================================================
-    std::vector<unsigned char> refBytes, optBytes;
-    std::vector<float> refFloats, optFloats;
+    Metrics::Color8 background = Metrics::Color8::FromFloat(config.render.background);
+    Metrics::Color8 heatmapBg = Metrics::Color8::FromFloat(config.render.heatmapBackground);
+    Metrics::PixelPassOutput& passOutput = frame.passOutput;
+    Metrics::PixelPassTargets passTargets = passOutput.Prepare(region.width, region.height, config.output.errorMaps);
+    const int w = region.width, h = region.height;
+    const size_t backgroundPixels = region.BackgroundPixels();
+
+    if (currentPhase == RenderPhase::PHASE_NORMAL && config.render.compactReadback) {
+        // 紧凑回读：展示用的法线颜色也由八面体编码即时解码得到，无需再回读 texRef/texOpt
+        Utils::CpuProfileScope scope("NormalPass");
+        passOutput.error = Metrics::PixelPasses::NormalPassCompact(
+                Metrics::ImageView(frame.refOct, w, h, Metrics::PixelFormat::RG16), refCoverage,
+                Metrics::ImageView(frame.optOct, w, h, Metrics::PixelFormat::RG16), optCoverage,
+                background, heatmapBg, passTargets);
+    }
+    else if (currentPhase == RenderPhase::PHASE_NORMAL) {
+        // 之前我们将 Normal 数据 copy 到了 texRef/texOpt，所以现在 ReadTextureByte 读到的也是法线颜色，用于展示
+        ReadTextureByte(tg.texRef, region, frame.refBytes);
+        ReadTextureByte(tg.texOpt, region, frame.optBytes);
+
+        Utils::CpuProfileScope scope("NormalPass");
+        passOutput.error = Metrics::PixelPasses::NormalPass(
+                Metrics::ImageView(frame.refNormals, w, h, Metrics::PixelFormat::RGB32F), Metrics::ImageView(frame.refBytes, w, h, Metrics::PixelFormat::RGB8),
+                Metrics::ImageView(frame.optNormals, w, h, Metrics::PixelFormat::RGB32F), Metrics::ImageView(frame.optBytes, w, h, Metrics::PixelFormat::RGB8),
+                background, heatmapBg, passTargets);
+    }
+    else if (currentPhase == RenderPhase::PHASE_SILHOUETTE) {
+        Metrics::Color8 silColor = Metrics::Color8::FromFloat(config.render.silhouetteColor);
+        Utils::CpuProfileScope scope("SilhouettePass");
+        passOutput.error = Metrics::PixelPasses::SilhouettePass(refSil, optSil, background, silColor, heatmapBg,
+                                                                passTargets, backgroundPixels);
+    }
+    else if (currentPhase == RenderPhase::PHASE_SSIM) {
+        // SSIM 与 PSNR 一样在包含背景的原始画面上计算，另外记录每个视角的计算耗时
+        ReadTextureByte(tg.texRef, region, frame.refBytes);
+        ReadTextureByte(tg.texOpt, region, frame.optBytes);
+        Metrics::ImageView refView(frame.refBytes, w, h, Metrics::PixelFormat::RGB8);
+        Metrics::ImageView optView(frame.optBytes, w, h, Metrics::PixelFormat::RGB8);
+
+        auto start = std::chrono::steady_clock::now();
+        Metrics::SsimResult result = frame.ssim.Compute(refView, optView, config.render.msssimScales, &region);
+        auto end = std::chrono::steady_clock::now();
+        currentViewCostMs = std::chrono::duration<double, std::milli>(end - start).count();
+        Utils::Profiler::Instance().AddCpuEvent("SSIM", start, end);
+
+        Utils::CpuProfileScope scope("ErrorMapPass");
+        Metrics::PixelPasses::ErrorMapPass(refView, refCoverage, optView, optCoverage, frame.ssim.SsimMap(), true,
+                                           heatmapBg, heatmapBg, config.render.ssimErrorMultiplier, passTargets);
+        passOutput.error = result.ssim;
+        currentViewMsSsim = result.msssim;
+    }
+    else if (currentPhase == RenderPhase::PHASE_FLIP) {
+        // FLIP 同样作用于包含背景的原始画面，误差图直接作为热力图
+        ReadTextureByte(tg.texRef, region, frame.refBytes);
+        ReadTextureByte(tg.texOpt, region, frame.optBytes);
+        Metrics::ImageView refView(frame.refBytes, w, h, Metrics::PixelFormat::RGB8);
+        Metrics::ImageView optView(frame.optBytes, w, h, Metrics::PixelFormat::RGB8);
+
+        auto start = std::chrono::steady_clock::now();
+        passOutput.error = flipEval.Compute(refView, optView, pixelsPerDegree, backgroundPixels);
+        auto end = std::chrono::steady_clock::now();
+        currentViewCostMs = std::chrono::duration<double, std::milli>(end - start).count();
+        Utils::Profiler::Instance().AddCpuEvent("FLIP", start, end);
+
+        Utils::CpuProfileScope scope("ErrorMapPass");
+        Metrics::PixelPasses::ErrorMapPass(refView, refCoverage, optView, optCoverage, flipEval.ErrorMap(), false,
+                                           heatmapBg, heatmapBg, 1.0f, passTargets);
+    }
+    else {
+        // PSNR: 使用原始包含背景的画面计算，展示图背景填入 heatmapBackground
+        ReadTextureByte(tg.texRef, region, frame.refBytes);
+        ReadTextureByte(tg.texOpt, region, frame.optBytes);
+
+        Utils::CpuProfileScope scope("ColorPass");
+        passOutput.error = Metrics::PixelPasses::ColorPass(
+                Metrics::ImageView(frame.refBytes, w, h, Metrics::PixelFormat::RGB8), refCoverage,
+                Metrics::ImageView(frame.optBytes, w, h, Metrics::PixelFormat::RGB8), optCoverage,
+                heatmapBg, heatmapBg, config.render.colorErrorMultiplier, passTargets, backgroundPixels);
+    }
 
-    if (currentPhase == RenderPhase::PHASE_NORMAL) {
-        // Normal Mode: Float Data for Calculation, Byte Data for background checking (Ref=Black?)
-        refFloats = refNormals;
-        optFloats = optNormals;
-
-        // 之前我们将 Normal 数据 copy 到了 texRef/texOpt，所以现在 ReadTextureByte 读到的也是法线颜色
-        // 这是正确的，因为法线 (0,0,0) 是非法的，可以用来判断背景（如果 Shader 清屏是 0）
-        refBytes = ReadTextureByte(targets.texRef, targets.width, targets.height);
-        optBytes = ReadTextureByte(targets.texOpt, targets.width, targets.height);
-
-        // 为了使展示和保存的图片具备设定的背景色，我们对用于展示的纹理背景进行染色
-        unsigned char bgR = static_cast<unsigned char>(config.render.background.r * 255.0f);
-        unsigned char bgG = static_cast<unsigned char>(config.render.background.g * 255.0f);
-        unsigned char bgB = static_cast<unsigned char>(config.render.background.b * 255.0f);
-
-        std::vector<unsigned char> refUpload(targets.width * targets.height * 4);
-        std::vector<unsigned char> optUpload(targets.width * targets.height * 4);
-
-        for (int i = 0; i < targets.width * targets.height; ++i) {
-            // 利用准确的浮点精度判断是否为清屏背景色 (0, 0, 0)
-            bool refIsBg = (refFloats[i*3] == 0.0f && refFloats[i*3+1] == 0.0f && refFloats[i*3+2] == 0.0f);
-            if (refIsBg) {
-                refUpload[i*4+0] = bgR; refUpload[i*4+1] = bgG; refUpload[i*4+2] = bgB;
-            } else {
-                refUpload[i*4+0] = refBytes[i*3+0]; refUpload[i*4+1] = refBytes[i*3+1]; refUpload[i*4+2] = refBytes[i*3+2];
-            }
-            refUpload[i*4+3] = 255;
+    // 将上了背景色的图片重新覆盖至 GPU，供下方的 Visualizer 渲染以及保存截图时使用
+    // (PSNR / SSIM / FLIP 阶段的展示图背景为 heatmapBackground)
+    const bool colorPhase = currentPhase == RenderPhase::PHASE_IBL_PSNR || currentPhase == RenderPhase::PHASE_SSIM ||
+                            currentPhase == RenderPhase::PHASE_FLIP;
+    if (VisualizationNeeded()) UploadDisplay(tg, region, colorPhase ? heatmapBg : background, heatmapBg);
 
-            bool optIsBg = (optFloats[i*3] == 0.0f && optFloats[i*3+1] == 0.0f && optFloats[i*3+2] == 0.0f);
-            if (optIsBg) {
-                optUpload[i*4+0] = bgR; optUpload[i*4+1] = bgG; optUpload[i*4+2] = bgB;
-            } else {
-                optUpload[i*4+0] = optBytes[i*3+0]; optUpload[i*4+1] = optBytes[i*3+1]; optUpload[i*4+2] = optBytes[i*3+2];
-            }
-            optUpload[i*4+3] = 255;
-        }
+    return passOutput.error;
+}
 
-        // 将上了背景色的图片重新覆盖至 GPU，供下方的 Visualizer 渲染以及保存截图时使用
-        glBindTexture(GL_TEXTURE_2D, targets.texRef);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, targets.width, targets.height, GL_RGBA, GL_UNSIGNED_BYTE, refUpload.data());
+double Application::ErrorMagnitude(double value) const {
+    switch (currentPhase) {
+        case RenderPhase::PHASE_IBL_PSNR: return std::pow(10.0, -value / 10.0); // MSE / 255²
+        case RenderPhase::PHASE_SSIM:     return 1.0 - value;
+        default:                          return value;
+    }
+}
 
-        glBindTexture(GL_TEXTURE_2D, targets.texOpt);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, targets.width, targets.height, GL_RGBA, GL_UNSIGNED_BYTE, optUpload.data());
+Metrics::FrameRegion Application::ViewRegion(const Scene::CameraSample& cam, int w, int h, int margin, int alignment) const {
+    const Metrics::FrameRegion full = Metrics::FrameRegion::Full(w, h);
+    const glm::mat4 viewProj = cam.projMatrix * cam.viewMatrix;
+    float minX = std::numeric_limits<float>::max(), minY = std::numeric_limits<float>::max();
+    float maxX = -std::numeric_limits<float>::max(), maxY = -std::numeric_limits<float>::max();
+
+    for (const Scene::Model* model : { scene.refModel.get(), scene.optModel.get() }) {
+        if (!model) continue;
+        const glm::mat4 mvp = viewProj * model->GetNormalizationMatrix();
+        for (int c = 0; c < 8; ++c) {
+            glm::vec3 corner((c & 1) ? model->boundsMax.x : model->boundsMin.x,
+                             (c & 2) ? model->boundsMax.y : model->boundsMin.y,
+                             (c & 4) ? model->boundsMax.z : model->boundsMin.z);
+            glm::vec4 clip = mvp * glm::vec4(corner, 1.0f);
+            // 包围盒跨过相机平面时投影无界，退回整幅画面
+            if (clip.w <= 1e-6f) return full;
+            float px = (clip.x / clip.w * 0.5f + 0.5f) * w;
+            float py = (clip.y / clip.w * 0.5f + 0.5f) * h;
+            minX = std::min(minX, px);
+            minY = std::min(minY, py);
+            maxX = std::max(maxX, px);
+            maxY = std::max(maxY, py);
+        }
     }
-    else if(currentPhase == RenderPhase::PHASE_SILHOUETTE){
-        currentViewError = Metrics::Evaluator::ComputeSilhouetteError(refSil, optSil, targets.width, targets.height);
+    if (minX > maxX) return full;
+
+    // 只有中心落在投影矩形内的像素会被光栅化，另加 1 像素吸收投影的浮点误差
+    const float limit = static_cast<float>(std::max(w, h)) * 4.0f;
+    int x0 = static_cast<int>(std::floor(std::max(minX, -limit))) - 1 - margin;
+    int y0 = static_cast<int>(std::floor(std::max(minY, -limit))) - 1 - margin;
+    int x1 = static_cast<int>(std::ceil(std::min(maxX, limit))) + 1 + margin;
+    int y1 = static_cast<int>(std::ceil(std::min(maxY, limit))) + 1 + margin;
+    x0 = std::max(0, x0);
+    y0 = std::max(0, y0);
+    x1 = std::min(w, x1);
+    y1 = std::min(h, y1);
+    if (x1 <= x0 || y1 <= y0) return full; // 模型完全在画面之外 (相机采样异常)，不做裁剪
+
+    alignment = std::max(1, alignment);
+    x0 -= x0 % alignment;
+    y0 -= y0 % alignment;
+    x1 = (x1 + alignment - 1) / alignment * alignment;
+    y1 = (y1 + alignment - 1) / alignment * alignment;
+    // 终点对齐后越过画面边缘时该方向不裁剪，保证各尺度的下采样网格与整幅画面一致
+    if (x1 > w) { x0 = 0; x1 = w; }
+    if (y1 > h) { y0 = 0; y1 = h; }
+    return { w, h, x0, y0, x1 - x0, y1 - y0 };
+}
 
-        UploadGrayscaleToTexture(targets.texRef, refSil, targets.width, targets.height);
-        UploadGrayscaleToTexture(targets.texOpt, optSil, targets.width, targets.height);
+double Application::HalfResolutionError() {
+    // frame.refBytes / optBytes 中仍是刚评估过的粗层级画面 (viewRegion 内的部分)
+    const Metrics::FrameRegion& r = viewRegion;
+    const Metrics::FrameRegion half = { r.frameWidth / 2, r.frameHeight / 2, r.x / 2, r.y / 2, r.width / 2, r.height / 2 };
+    Metrics::Evaluator::Downsample2x(Metrics::ImageView(frame.refBytes, r.width, r.height, Metrics::PixelFormat::RGB8), frame.refHalf);
+    Metrics::Evaluator::Downsample2x(Metrics::ImageView(frame.optBytes, r.width, r.height, Metrics::PixelFormat::RGB8), frame.optHalf);
+    Metrics::ImageView refView(frame.refHalf, half.width, half.height, Metrics::PixelFormat::RGB8);
+    Metrics::ImageView optView(frame.optHalf, half.width, half.height, Metrics::PixelFormat::RGB8);
+
+    double value = 0.0;
+    if (currentPhase == RenderPhase::PHASE_SSIM) {
+        value = frame.ssim.Compute(refView, optView, config.render.msssimScales, &half).ssim;
+    }
+    else if (currentPhase == RenderPhase::PHASE_FLIP) {
+        value = frame.halfFlip.Compute(refView, optView, config.render.flipPixelsPerDegree / (2.0f * config.render.multiResDivisor),
+                                       half.BackgroundPixels());
+    }
+    else {
+        // 区域外的背景差值为 0，MSE 按整幅画面的像素数重新归一化
+        double mse = Metrics::Evaluator::ComputePSNR(refView, optView).first *
+                     static_cast<double>(half.PixelCount()) / static_cast<double>(half.PixelCount() + half.BackgroundPixels());
+        value = (mse < 1e-10) ? 99.99 : 10.0 * std::log10((255.0 * 255.0) / mse);
+    }
+    return ErrorMagnitude(value);
+}
 
-        refBytes.resize(targets.width * targets.height * 3);
-        optBytes.resize(targets.width * targets.height * 3);
-        for(size_t i=0; i<refSil.size(); ++i) {
-            refBytes[i*3+0] = refSil[i]; refBytes[i*3+1] = refSil[i]; refBytes[i*3+2] = refSil[i];
-            optBytes[i*3+0] = optSil[i]; optBytes[i*3+1] = optSil[i]; optBytes[i*3+2] = optSil[i];
+void Application::RecordView() {
+    if (views.empty() || currentPhase == RenderPhase::FINISHED) return;
+
+    if (currentViewIdx != lastSavedView) {
+        // 渐进式评估会重排视角，文件名与 CSV 使用视角的原始编号
+        const int viewIndex = views[currentViewIdx].index;
+        SaveScreenshot(viewIndex);
+        if (config.output.errorMaps) RecordErrorMap(viewIndex);
+        std::string mName = PhaseName(currentPhase);
+        // 1. 写入当前视角的误差到单独的 CSV (SSIM 阶段追加 MS-SSIM 与耗时，FLIP 阶段追加耗时)
+        std::string extraColumns;
+        if (currentPhase == RenderPhase::PHASE_SSIM) {
+            extraColumns = "," + std::to_string(currentViewMsSsim) + "," + std::to_string(currentViewCostMs);
+            accumulatorMsSsim += currentViewMsSsim;
+            accumulatorCostMs += currentViewCostMs;
         }
+        else if (currentPhase == RenderPhase::PHASE_FLIP) {
+            extraColumns = "," + std::to_string(currentViewCostMs);
+            accumulatorCostMs += currentViewCostMs;
+        }
+        AppendToLocalCSV(mName, viewIndex, currentViewError, extraColumns);
+        const bool timed = (currentPhase == RenderPhase::PHASE_SSIM || currentPhase == RenderPhase::PHASE_FLIP);
+        results.Record(viewIndex, mName, currentViewError, timed ? currentViewCostMs : std::numeric_limits<double>::quiet_NaN());
+        if (currentPhase == RenderPhase::PHASE_SSIM) results.Record(viewIndex, "MS-SSIM", currentViewMsSsim, currentViewCostMs);
+        if (linearCaptured && currentPhase == RenderPhase::PHASE_IBL_PSNR) ToneSweepView(viewIndex);
+        linearCaptured = false;
+        if (gbufferSource && currentPhase == RenderPhase::PHASE_IBL_PSNR) EnvironmentSweepView(viewIndex);
+        gbufferSource = nullptr;
+
+        // 2. 在这里进行累加！确保每个视角只累加一次！
+        accumulatorError += currentViewError;
+        viewStats.Add(currentViewError);
+        lastSavedView = currentViewIdx;
+        Utils::Profiler::Instance().AddView();
     }
-    else {
-        // PSNR
-        refBytes = ReadTextureByte(targets.texRef, targets.width, targets.height);
-        optBytes = ReadTextureByte(targets.texOpt, targets.width, targets.height);
-
-        // 1. 先使用原始包含背景的画面计算出正确的 PSNR
-        auto res = Metrics::Evaluator::ComputePSNR(refBytes, optBytes, targets.width, targets.height);
-        currentViewError = res.second;
-
-        // ================= PSNR 背景色替换逻辑 =================
-        unsigned char bgR = static_cast<unsigned char>(config.render.heatmapBackground.r * 255.0f);
-        unsigned char bgG = static_cast<unsigned char>(config.render.heatmapBackground.g * 255.0f);
-        unsigned char bgB = static_cast<unsigned char>(config.render.heatmapBackground.b * 255.0f);
-
-        std::vector<unsigned char> refUpload(targets.width * targets.height * 4);
-        std::vector<unsigned char> optUpload(targets.width * targets.height * 4);
-
-        for (int i = 0; i < targets.width * targets.height; ++i) {
-            // 利用深度缓冲识别背景（深度趋近于 1.0 的必定是背景或天空盒）
-            bool refIsBg = (refDepth[i] >= 0.9999f);
-            if (refIsBg) {
-                // 上传用的展示图填入 Config 背景色
-                refUpload[i*4+0] = bgR; refUpload[i*4+1] = bgG; refUpload[i*4+2] = bgB;
-                // 将 refBytes 置黑，确保下方的 GenerateHeatmap 能成功判定 isBackground = true
-                refBytes[i*3+0] = 0; refBytes[i*3+1] = 0; refBytes[i*3+2] = 0;
-            } else {
-                refUpload[i*4+0] = refBytes[i*3+0]; refUpload[i*4+1] = refBytes[i*3+1]; refUpload[i*4+2] = refBytes[i*3+2];
-            }
-            refUpload[i*4+3] = 255;
+}
 
-            bool optIsBg = (optDepth[i] >= 0.9999f);
-            if (optIsBg) {
-                optUpload[i*4+0] = bgR; optUpload[i*4+1] = bgG; optUpload[i*4+2] = bgB;
-                optBytes[i*3+0] = 0; optBytes[i*3+1] = 0; optBytes[i*3+2] = 0;
-            } else {
-                optUpload[i*4+0] = optBytes[i*3+0]; optUpload[i*4+1] = optBytes[i*3+1]; optUpload[i*4+2] = optBytes[i*3+2];
-            }
-            optUpload[i*4+3] = 255;
+void Application::ToneSweepView(int viewIndex) {
+    Utils::CpuProfileScope scope("ToneSweep");
+    auto start = std::chrono::steady_clock::now();
+
+    // 覆盖掩码与线性辐射度来自同一次 EvaluateView (多分辨率评估时为最后评估的层级)
+    const Metrics::FrameRegion& region = linearRegion;
+    const int w = region.width, h = region.height;
+    const glm::vec3& bg = config.render.background;
+    // 清屏色经 GPU 按四舍五入量化为 8bit
+    const Metrics::Color8 background = { static_cast<unsigned char>(bg.r * 255.0f + 0.5f),
+                                         static_cast<unsigned char>(bg.g * 255.0f + 0.5f),
+                                         static_cast<unsigned char>(bg.b * 255.0f + 0.5f) };
+    const Metrics::Color8 heatmapBg = Metrics::Color8::FromFloat(config.render.heatmapBackground);
+
+    frame.refToned.resize(region.PixelCount() * 3);
+    frame.optToned.resize(region.PixelCount() * 3);
+    const Metrics::MutableImageView refToned(frame.refToned, w, h, Metrics::PixelFormat::RGB8);
+    const Metrics::MutableImageView optToned(frame.optToned, w, h, Metrics::PixelFormat::RGB8);
+    const Metrics::ImageView refLinear(frame.refLinear, w, h, Metrics::PixelFormat::RGBA16F);
+    const Metrics::ImageView optLinear(frame.optLinear, w, h, Metrics::PixelFormat::RGBA16F);
+    const Metrics::PixelPassTargets passTargets = frame.sweepOutput.Prepare(w, h);
+
+    const Utils::ImageFormat heatmapFormat = config.toneSweep.heatmaps ? config.output.psnr : Utils::ImageFormat::None;
+    const std::string heatmapBase = (fs::path(config.paths.outputRoot) / currentModelName / "tonemap" / ("view_" + std::to_string(viewIndex) + "_")).string();
+
+    for (size_t i = 0; i < toneSettings.size(); ++i) {
+        const ToneSetting& setting = toneSettings[i];
+        Metrics::PixelPasses::ToneMapPass(refLinear, frame.refCoverage, setting.exposure, setting.op, linearSkybox, background, refToned);
+        Metrics::PixelPasses::ToneMapPass(optLinear, frame.optCoverage, setting.exposure, setting.op, linearSkybox, background, optToned);
+        const double psnr = Metrics::PixelPasses::ColorPass(refToned, frame.refCoverage, optToned, frame.optCoverage,
+                                                            heatmapBg, heatmapBg, config.render.colorErrorMultiplier, passTargets,
+                                                            region.BackgroundPixels());
+        toneAccumulator[i] += psnr;
+        AppendToLocalCSV("ToneSweep", viewIndex, psnr, "," + std::string(Metrics::ToneOperatorName(setting.op)) + "," + std::to_string(setting.exposure));
+        results.Record(viewIndex, setting.name, psnr);
+
+        if (heatmapFormat != Utils::ImageFormat::None) {
+            // 补齐为整幅画面 (与 PSNR 阶段的热力图面板同尺寸)，行序自底向上
+            imageWriter.Write(heatmapBase + setting.name, heatmapFormat, region.frameWidth, region.frameHeight, 4,
+                              SweepHeatmap(region, heatmapBg), true, &outputStats);
         }
+    }
+    toneSweepMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
 
-        // 将上了背景色的纯净模型图片重新覆盖至 GPU
-        glBindTexture(GL_TEXTURE_2D, targets.texRef);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, targets.width, targets.height, GL_RGBA, GL_UNSIGNED_BYTE, refUpload.data());
+void Application::InitEnvironments() {
+    const fs::path hdrDir = fs::path(config.paths.assetsRoot) / config.paths.hdrDir;
+    std::vector<std::string> files;
+    if (config.environmentSweep.environments.empty()) {
+        files = Utils::FindFilesByExt(hdrDir.string(), { ".hdr" });
+    } else {
+        for (const std::string& name : config.environmentSweep.environments) files.push_back((hdrDir / name).string());
+    }
 
-        glBindTexture(GL_TEXTURE_2D, targets.texOpt);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, targets.width, targets.height, GL_RGBA, GL_UNSIGNED_BYTE, optUpload.data());
+    for (const std::string& file : files) {
+        std::cout << "[System] Baking IBL for environment " << fs::path(file).filename().string() << "..." << std::endl;
+        Renderer::IBLMaps maps = Renderer::IBLBaker::BakeIBL(file);
+        if (maps.envCubemap == 0) continue; // BakeIBL 已输出错误信息
+        environmentNames.push_back(fs::path(file).stem().string());
+        environmentMaps.push_back(maps);
+    }
+    if (environmentMaps.empty()) {
+        std::cerr << "[Warning] Environment sweep disabled: no HDR environments found in " << hdrDir.string() << std::endl;
+        return;
     }
 
-    int modeIdx = 0;
-    if (currentPhase == RenderPhase::PHASE_IBL_PSNR) modeIdx = 0;
-    else if (currentPhase == RenderPhase::PHASE_NORMAL) modeIdx = 1;
-    else if (currentPhase == RenderPhase::PHASE_SILHOUETTE) modeIdx = 2;
+    renderer->EnableGBufferCapture();
+    deferred = std::make_unique<Renderer::DeferredShading>(targets.width, targets.height);
+    deferred->SetExposure(config.render.exposure);
+    deferred->SetBackground(config.render.background);
+    if (coarseRenderer) {
+        coarseRenderer->EnableGBufferCapture();
+        coarseDeferred = std::make_unique<Renderer::DeferredShading>(coarseTargets.width, coarseTargets.height);
+        coarseDeferred->SetExposure(config.render.exposure);
+        coarseDeferred->SetBackground(config.render.background);
+    }
 
-    // 获取 Config 中设置的背景色（如果上方代码已经声明过 bgR, bgG, bgB，可以直接复用）
-    unsigned char heatmapBgR = static_cast<unsigned char>(config.render.heatmapBackground.r * 255.0f);
-    unsigned char heatmapBgG = static_cast<unsigned char>(config.render.heatmapBackground.g * 255.0f);
-    unsigned char heatmapBgB = static_cast<unsigned char>(config.render.heatmapBackground.b * 255.0f);
+    for (size_t e = 0; e < environmentMaps.size(); ++e) {
+        for (float rotation : config.environmentSweep.rotations) {
+            std::ostringstream name;
+            name << "PSNR_" << environmentNames[e] << "_r" << rotation;
+            environmentSettings.push_back({ e, rotation, name.str() });
+        }
+    }
+    environmentAccumulator.assign(environmentSettings.size(), 0.0);
+    std::cout << "[System] Environment sweep: " << environmentMaps.size() << " environments x " << config.environmentSweep.rotations.size()
+              << " rotations, " << environmentSettings.size() << " deferred shading passes per model and view (PSNR phase)" << std::endl;
+}
 
-    std::vector<unsigned char> heatmapData = Metrics::Evaluator::GenerateHeatmap(
-            refBytes, refFloats,
-            optBytes, optFloats,
-            targets.width, targets.height,
-            modeIdx,
-            heatmapBgR, heatmapBgG, heatmapBgB,
-            config.render.colorErrorMultiplier
-    );
+void Application::EnvironmentSweepView(int viewIndex) {
+    Utils::CpuProfileScope scope("EnvironmentSweep");
+    auto start = std::chrono::steady_clock::now();
+
+    // G-buffer 快照与覆盖掩码来自同一次 EvaluateView (多分辨率评估时为最后评估的层级)
+    Renderer::DeferredShading& shading = *gbufferSource;
+    const Metrics::FrameRegion& region = gbufferRegion;
+    const int w = region.width, h = region.height;
+    const Metrics::Color8 heatmapBg = Metrics::Color8::FromFloat(config.render.heatmapBackground);
+
+    frame.refShaded.resize(region.PixelCount() * 3);
+    frame.optShaded.resize(region.PixelCount() * 3);
+    const Metrics::ImageView refShaded(frame.refShaded, w, h, Metrics::PixelFormat::RGB8);
+    const Metrics::ImageView optShaded(frame.optShaded, w, h, Metrics::PixelFormat::RGB8);
+    const Metrics::PixelPassTargets passTargets = frame.sweepOutput.Prepare(w, h);
+
+    const Utils::ImageFormat heatmapFormat = config.environmentSweep.heatmaps ? config.output.psnr : Utils::ImageFormat::None;
+    const std::string heatmapBase = (fs::path(config.paths.outputRoot) / currentModelName / "environment" / ("view_" + std::to_string(viewIndex) + "_")).string();
+
+    for (size_t i = 0; i < environmentSettings.size(); ++i) {
+        const EnvironmentSetting& setting = environmentSettings[i];
+        const Renderer::IBLMaps& env = environmentMaps[setting.environment];
+        {
+            Utils::GpuProfileScope gpuScope("DeferredShade");
+            shading.Shade(0, env, setting.rotation, gbufferView, gbufferProjection, gbufferCamPos, gbufferSkybox);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, shading.GetFBO());
+            ReadPixelsInRegion(region, GL_RGB, GL_UNSIGNED_BYTE, frame.refShaded);
+            shading.Shade(1, env, setting.rotation, gbufferView, gbufferProjection, gbufferCamPos, gbufferSkybox);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, shading.GetFBO());
+            ReadPixelsInRegion(region, GL_RGB, GL_UNSIGNED_BYTE, frame.optShaded);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        }
 
-    UpdateHeatmapTexture(heatmapData);
+        const double psnr = Metrics::PixelPasses::ColorPass(refShaded, frame.refCoverage, optShaded, frame.optCoverage,
+                                                            heatmapBg, heatmapBg, config.render.colorErrorMultiplier, passTargets,
+                                                            region.BackgroundPixels());
+        environmentAccumulator[i] += psnr;
+        AppendToLocalCSV("Environment", viewIndex, psnr, "," + environmentNames[setting.environment] + "," + std::to_string(setting.rotation));
+        results.Record(viewIndex, setting.name, psnr);
+
+        if (heatmapFormat != Utils::ImageFormat::None) {
+            // 补齐为整幅画面 (与 PSNR 阶段的热力图面板同尺寸)，行序自底向上
+            imageWriter.Write(heatmapBase + setting.name, heatmapFormat, region.frameWidth, region.frameHeight, 4,
+                              SweepHeatmap(region, heatmapBg), true, &outputStats);
+        }
+    }
+    environmentSweepMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
 
-    // --- Pass 3: Visualization ---
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, config.window.width, config.window.height);
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    visualizer->RenderComparison(targets.texRef, targets.texOpt, targets.texHeatmap);
+const char* Application::PhaseName(RenderPhase phase) {
+    switch (phase) {
+        case RenderPhase::PHASE_IBL_PSNR:   return "PSNR";
+        case RenderPhase::PHASE_SSIM:       return "SSIM";
+        case RenderPhase::PHASE_FLIP:       return "FLIP";
+        case RenderPhase::PHASE_SILHOUETTE: return "Silhouette";
+        case RenderPhase::PHASE_NORMAL:     return "Normal";
+        default:                            return "Finished";
+    }
+}
 
-    if (currentViewIdx != lastSavedView) {
-        SaveScreenshot(currentViewIdx);
-        std::string mName = (currentPhase == RenderPhase::PHASE_IBL_PSNR) ? "PSNR" :
-                            (currentPhase == RenderPhase::PHASE_SILHOUETTE ? "Silhouette" : "Normal");
-        // 1. 写入当前视角的误差到单独的 CSV
-        AppendToLocalCSV(mName, currentViewIdx, currentViewError);
+void Application::ReportMemory(const Utils::MemoryReport& report) {
+    const double MB = 1024.0 * 1024.0;
+    std::cout << std::fixed << std::setprecision(1)
+              << "  [Memory] Peak host " << report.peakHostBytes / MB << " MB, peak GPU " << report.peakGpuBytes / MB << " MB (";
+    for (int c = 0; c < (int)Utils::MemoryCategory::Count; ++c) {
+        std::cout << (c ? ", " : "") << Utils::MemoryCategoryName((Utils::MemoryCategory)c) << " "
+                  << report.peakGpuBytesByCategory[c] / MB;
+    }
+    std::cout << ")" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+
+    // 各类别为各自的峰值 (不一定出现在同一时刻)，之和可超过 PeakGpuMB
+    std::ostringstream extra;
+    extra << "," << report.peakGpuBytes / MB;
+    for (int c = 0; c < (int)Utils::MemoryCategory::Count; ++c) extra << "," << report.peakGpuBytesByCategory[c] / MB;
+    extra << "," << (report.overBudget ? "Aborted" : "OK");
+    AppendToGlobalCSV("Memory", report.peakHostBytes / MB, extra.str());
+}
 
-        // 2. 在这里进行累加！确保每个视角只累加一次！
-        accumulatorError += currentViewError;
-        lastSavedView = currentViewIdx;
+void Application::ReportProfile(const Utils::ProfileSummary& summary) {
+    const double readbackMB = summary.readbackBytes / (1024.0 * 1024.0);
+    const double bytesPerView = summary.views ? (double)summary.readbackBytes / summary.views : 0.0;
+    std::cout << std::fixed << std::setprecision(2)
+              << "  [Profile] " << summary.views << " views / " << summary.frames << " frames in " << summary.wallMs / 1000.0
+              << " s (" << summary.ViewsPerSecond() << " views/s), read back " << readbackMB << " MB ("
+              << bytesPerView / (1024.0 * 1024.0) << " MB/view)";
+    if (summary.droppedEvents) std::cout << ", " << summary.droppedEvents << " events dropped";
+    std::cout << std::endl;
+    std::cout << "  " << std::left << std::setw(22) << "Stage" << std::setw(6) << "Track" << std::right
+              << std::setw(9) << "Count" << std::setw(12) << "Total ms" << std::setw(10) << "Mean ms" << std::setw(8) << "Share" << std::endl;
+    for (const auto& stage : summary.stages) {
+        std::cout << "  " << std::left << std::setw(22) << stage.name << std::setw(6) << (stage.gpu ? "GPU" : "CPU") << std::right
+                  << std::setw(9) << stage.count << std::setw(12) << stage.totalMs
+                  << std::setw(10) << stage.totalMs / stage.count
+                  << std::setw(7) << 100.0 * stage.totalMs / std::max(summary.wallMs, 1e-9) << "%" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+
+    // 各阶段明细 (按总耗时降序)；Share 为占模型墙钟时间的比例，嵌套阶段之和可超过 1
+    // 表在 SetupOutputDirectories 中声明，随 FlushModel 落盘
+    const fs::path stagePath = fs::path(config.paths.outputRoot) / currentModelName / "profile_stages.csv";
+    for (const auto& stage : summary.stages) {
+        std::ostringstream row;
+        row << stage.name << "," << (stage.gpu ? "GPU" : "CPU") << "," << stage.count << "," << stage.totalMs << ","
+            << stage.totalMs / stage.count << "," << stage.totalMs / std::max(summary.wallMs, 1e-9);
+        results.AppendRow(stagePath, row.str());
     }
+
+    std::ostringstream extra;
+    extra << "," << summary.views << "," << summary.frames << "," << summary.wallMs << "," << summary.readbackBytes
+          << "," << bytesPerView << "," << summary.events << "," << summary.droppedEvents;
+    AppendToGlobalCSV("Profile", summary.ViewsPerSecond(), extra.str());
 }
 
 void Application::RenderQuad() {
@@ -715,7 +1673,7 @@ void Application::RenderQuad() {
         glGenBuffers(1, &quadVBO);
         glBindVertexArray(quadVAO);
         glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+        Utils::TrackedBufferData(Utils::MemoryCategory::Other, GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(1);
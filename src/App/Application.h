@@ -1,10 +1,21 @@
 #pragma once
 #include "App/Config.h"
+#include "App/ResultSink.h"
 #include "Scene/Scene.h"
 #include "Renderer/Shader.h"
+#include "Renderer/AsyncReadback.h"
+#include "Metrics/ErrorMapFile.h"
+#include "Metrics/Evaluator.h"
+#include "Metrics/PixelPasses.h"
+#include "Metrics/RunningStats.h"
+#include "Metrics/SsimEvaluator.h"
+#include "Metrics/FlipEvaluator.h"
+#include "Utils/ImageWriter.h"
+#include "Utils/MemoryTracker.h"
+#include "Utils/Profiler.h"
 
 // 前置声明
-namespace Renderer { class PBRRenderer; }
+namespace Renderer { class PBRRenderer; class DeferredShading; }
 namespace Metrics { class MetricVisualizer; }
 namespace Scene { class Model; struct CameraSample; }
 struct GLFWwindow;
@@ -22,19 +33,27 @@ public:
     bool InitSystem();
     // 处理单个模型的全流程 (加载 -> 渲染循环 -> 保存 -> 卸载)
     void ProcessSingleModel(const std::string & refPath, const std::string &optPath, const std::string& modelName);
+    // 最近一次 ProcessSingleModel 的性能剖析汇总 (未启用 profiling 时为空)
+    const Utils::ProfileSummary& LastProfile() const { return lastProfile; }
+    // CSV 与列式结果的输出缓冲 (每个模型结束时落盘一次)
+    ResultSink& Results() { return results; }
 
 private:
     enum class RenderPhase {
         PHASE_IBL_PSNR = 0,
-        PHASE_SILHOUETTE = 1,
-        PHASE_NORMAL = 2,
-        FINISHED = 3
+        PHASE_SSIM = 1,
+        PHASE_FLIP = 2,
+        PHASE_SILHOUETTE = 3,
+        PHASE_NORMAL = 4,
+        FINISHED = 5
     };
 
     // --- 配置与状态 ---
     AppConfig config;
     std::string currentModelName;   // 当前处理的模型名
     std::string currentOutputDir;   // 当前输出目录
+    Utils::ProfileSummary lastProfile;
+    ResultSink results;
 
     // --- 窗口与系统 ---
     GLFWwindow* window = nullptr;
@@ -55,12 +74,76 @@ private:
         void Cleanup();
     } targets;
 
+    // ============ 多分辨率评估 (config.render.multiResolution) ============
+    // 粗层级使用独立的渲染器与目标纹理 (1/multiResDivisor 分辨率)，展示时直接由 Visualizer 放大绘制
+    std::unique_ptr<Renderer::PBRRenderer> coarseRenderer;
+    RenderTargets coarseTargets;
+    struct MultiResStats {
+        size_t views = 0;              // 本阶段以多分辨率方式评估的视角数
+        size_t refined = 0;            // 其中以全分辨率重新评估的视角数
+        double coarseMs = 0.0;         // 粗层级评估总耗时 (含渲染、回读与降采样稳定性检查)
+        double fullMs = 0.0;           // 全分辨率评估总耗时
+        Metrics::RunningStats coarseError; // 粗层级误差 (统一为越大越差) 的分布，用于判断"误差偏高"
+        void Reset() { *this = MultiResStats(); }
+    } multiRes;
+    int multiResView = -1;             // 已完成粗/细决策的视角 (同一视角的后续帧沿用决策)
+    bool multiResRefined = false;
+
+    // ============ 屏幕空间 ROI (config.render.screenSpaceRoi) ============
+    // 最近一次 EvaluateView 的回读区域 (未启用或绘制天空盒时为整幅画面)，frame 中的画面缓冲均为该区域大小
+    Metrics::FrameRegion viewRegion;
+
     // ============ GPU轮廓提取所需资源 ============
     std::unique_ptr<Renderer::Shader> silhouetteShader;
     unsigned int silFBO = 0;
     unsigned int quadVAO = 0, quadVBO = 0;
     void RenderQuad(); // 渲染全屏四边形的方法
 
+    // ============ 紧凑 G-buffer 回读 (config.render.compactReadback) ============
+    std::unique_ptr<Renderer::Shader> coverageShader;
+    std::unique_ptr<Renderer::Shader> octNormalShader;
+    unsigned int coverageTex = 0;   // GL_R32UI，每个 texel 打包一行中的 32 个像素
+    unsigned int octNormalTex = 0;  // GL_RG16，八面体编码法线
+    void ReadCoverage(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, Metrics::CoverageMask& out); // 覆盖掩码 (默认路径由深度图在 CPU 端生成)
+    void ReadOctNormals(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, std::vector<uint16_t>& out); // RG16 八面体法线
+
+    // ============ 曝光 / 色调映射扫描 (config.toneSweep) ============
+    struct ToneSetting {
+        float exposure = 1.0f;
+        Metrics::ToneOperator op = Metrics::ToneOperator::Aces;
+        std::string name;   // 列式结果的指标名与热力图文件名，如 PSNR_ACES_x1.00
+    };
+    std::vector<ToneSetting> toneSettings;
+    std::vector<double> toneAccumulator;  // 当前阶段各组合的逐视角 PSNR 之和
+    double toneSweepMs = 0.0;             // 当前阶段扫描后处理的总耗时
+    bool linearCaptured = false;          // 本帧已回读当前视角的线性辐射度 (frame.refLinear / optLinear)
+    bool linearSkybox = false;
+    Metrics::FrameRegion linearRegion;
+    void ReadLinear(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, std::vector<uint16_t>& out); // RGBA16F 线性辐射度
+    void ToneSweepView(int viewIndex);    // 对当前视角逐个组合做色调映射并计算 PSNR
+
+    // ============ 多环境延迟着色评估 (config.environmentSweep) ============
+    struct EnvironmentSetting {
+        size_t environment = 0; // environmentMaps / environmentNames 的下标
+        float rotation = 0.0f;  // 环境绕 Y 轴的旋转角 (度)
+        std::string name;       // 列式结果的指标名与热力图文件名，如 PSNR_studio_r90
+    };
+    std::vector<std::string> environmentNames;      // HDR 文件名 (不含扩展名)
+    std::vector<Renderer::IBLMaps> environmentMaps; // 启动时各烘焙一次，跨模型复用
+    std::vector<EnvironmentSetting> environmentSettings;
+    std::vector<double> environmentAccumulator;     // 当前阶段各组合的逐视角 PSNR 之和
+    double environmentSweepMs = 0.0;                // 当前阶段延迟着色与指标计算的总耗时
+    // 与 renderer / coarseRenderer 同尺寸的 G-buffer 快照与着色目标
+    std::unique_ptr<Renderer::DeferredShading> deferred, coarseDeferred;
+    // 本帧已捕获当前视角 G-buffer 的一组 (未捕获时为空)，以及捕获时的相机与回读区域
+    Renderer::DeferredShading* gbufferSource = nullptr;
+    Metrics::FrameRegion gbufferRegion;
+    glm::mat4 gbufferView = glm::mat4(1.0f), gbufferProjection = glm::mat4(1.0f);
+    glm::vec3 gbufferCamPos = glm::vec3(0.0f);
+    bool gbufferSkybox = false;
+    void InitEnvironments();               // 烘焙各环境并为渲染器启用 G-buffer 输出
+    void EnvironmentSweepView(int viewIndex); // 对当前视角逐个组合延迟着色并计算 PSNR
+
     // --- 逻辑状态 ---
     std::vector<Scene::CameraSample> views;
     int currentViewIdx = 0;
@@ -68,24 +151,101 @@ private:
 
     RenderPhase currentPhase = RenderPhase::PHASE_IBL_PSNR;
     double accumulatorError = 0.0;      // 累加误差 (用于计算平均值)
+    Metrics::RunningStats viewStats;    // 当前阶段逐视角误差的均值/方差 (渐进式评估的停止判据)
     double currentViewError = 0.0;      // 当前视角误差 (用于写入 CSV)
+    double currentViewMsSsim = 0.0;     // SSIM 阶段: 当前视角的 MS-SSIM
+    double currentViewCostMs = 0.0;     // SSIM / FLIP 阶段: 当前视角指标的计算耗时
+    double accumulatorMsSsim = 0.0;
+    double accumulatorCostMs = 0.0;
     int lastSavedView = -1;             // 防止同一视角重复保存
 
+    // --- 截图输出 (config.output) ---
+    Utils::ImageWriter imageWriter;     // 编码缓冲跨视角复用
+    Utils::ImageWriteStats outputStats; // 当前阶段的截图张数、字节数与耗时
+    // 离屏输出 (config.output.offscreen): 合成图绘制到专用 FBO，与面板一起经 PBO 异步回读
+    unsigned int compositeFBO = 0;
+    unsigned int compositeTex = 0;
+    int compositeWidth = 0;
+    int compositeHeight = 0;
+    Renderer::AsyncReadback readback;
+    const RenderTargets* shownTargets = nullptr; // 当前视角展示的目标纹理 (多分辨率评估时可能是粗层级)
+    // 逐像素误差图 (config.output.errorMaps): 每个阶段一个 <阶段目录>/errors.vmerr，供离线重新着色
+    Metrics::ErrorMapWriter errorMaps;
+    float ErrorMultiplier(RenderPhase phase) const; // 热力图倍率 (热力图值 = 误差 * 倍率)
+    void RecordErrorMap(int viewIndex);
+    void CloseErrorMaps();
+
+    // --- 逐视角复用的缓冲区 ---
+    // 按 config.render 的分辨率在 InitSystem 中一次性预留，跨视角、阶段与模型复用，稳态下不再分配
+    struct FrameBuffers {
+        std::vector<float> refNormals, optNormals;      // RGB32F 法线 (默认回读)
+        std::vector<uint16_t> refOct, optOct;           // RG16 八面体法线 (紧凑回读)
+        std::vector<unsigned char> refBytes, optBytes;  // RGB8 画面
+        std::vector<float> depth;                       // 深度 (CPU 端生成覆盖掩码)
+        std::vector<unsigned char> silReadback;         // R8 轮廓
+        Metrics::CoverageMask refCoverage, optCoverage;
+        Metrics::PackedMask refSil, optSil;
+        Metrics::PixelPassOutput passOutput;            // 融合内核的输出 (展示图 + 热力图)
+        Metrics::SsimEvaluator ssim;                    // SSIM / MS-SSIM 的中间缓冲
+        Metrics::FlipEvaluator flip;                    // FLIP 的中间缓冲与误差图
+        // 多分辨率评估: 粗层级与其 2x 降采样层级的 FLIP (观察条件不同，各自保留滤波核，避免交替时重建)
+        Metrics::FlipEvaluator coarseFlip, halfFlip;
+        std::vector<unsigned char> refHalf, optHalf;    // 粗层级画面的 2x 降采样
+        std::vector<unsigned char> screenshot;          // 窗口截图 RGB8
+        std::vector<uint16_t> refLinear, optLinear;     // 色调映射前的线性辐射度 RGBA16F (曝光 / 色调映射扫描)
+        std::vector<unsigned char> refToned, optToned;  // 扫描中按某一组合映射后的 RGB8 画面
+        Metrics::PixelPassOutput sweepOutput;           // 色调映射 / 多环境扫描共用的融合内核输出 (不覆盖刚记录视角的 passOutput)
+        std::vector<unsigned char> sweepHeatmap;        // 扫描热力图补齐到整幅画面后的 RGBA8 (仅裁剪时使用)
+        std::vector<unsigned char> refShaded, optShaded; // 多环境评估中按某一环境延迟着色后的 RGB8 画面
+
+        void Init(const AppConfig& config);
+        size_t ReservedBytes() const;
+    } frame;
+    RenderPhase lastDrawnPhase = RenderPhase::FINISHED; // 每个阶段的首帧视为预热，不做分配检查
+
     // --- 辅助函数 ---
     void SetupOutputDirectories(const std::string& modelName);
-    void AppendToGlobalCSV(const std::string& metricType, double avgError);
-    void AppendToLocalCSV(const std::string& metricType, int viewIdx, double error);
+    // extraColumns: 追加在误差值之后的列 (以逗号开头)，用于 SSIM / FLIP 阶段的 MS-SSIM 与耗时
+    // keyColumns: 插在模型名与误差值之间的键列 (以逗号开头)，用于每个模型多行的表 (阶段、格式等)
+    // 两者都只追加到 results 的内存表，模型结束时统一落盘
+    void AppendToGlobalCSV(const std::string& metricType, double avgError, const std::string& extraColumns = "",
+                           const std::string& keyColumns = "");
+    void AppendToLocalCSV(const std::string& metricType, int viewIdx, double error, const std::string& extraColumns = "");
     void SaveScreenshot(int viewIdx);
+    Utils::ImageFormat OutputFormat(RenderPhase phase) const;
+    // 是否需要展示纹理 (显示窗口或当前阶段需要截图)；仅指标模式下跳过可视化绘制与展示纹理上传
+    bool VisualizationNeeded() const;
+    // 是否需要在窗口中绘制分屏合成图 (显示窗口，或截图仍从窗口回读)
+    bool WindowCompositeNeeded() const;
+    bool InitOffscreenOutput();
+    void SaveOffscreen(int viewIdx, Utils::ImageFormat format);
+    void EvaluateGeometry(); // 双向 Hausdorff 距离，写入 metrics_hausdorff.csv
+    // 性能剖析: 控制台汇总表 + 模型目录下的 profile_stages.csv + metrics_profile.csv
+    void ReportProfile(const Utils::ProfileSummary& summary);
+    // 打印并写入 metrics_memory.csv (超出预算时 Status = Aborted)
+    void ReportMemory(const Utils::MemoryReport& report);
 
-    // --- 纹理读取 ---
-    std::vector<float> ReadTextureFloat(unsigned int texID, int w, int h);
-    std::vector<unsigned char> ReadTextureByte(unsigned int texID, int w, int h);
-    std::vector<float> ReadTextureDepth(unsigned int texID, int w, int h);
-    void UploadGrayscaleToTexture(unsigned int texID, const std::vector<unsigned char>& data, int w, int h);
-    void UpdateHeatmapTexture(const std::vector<unsigned char>& data);
+    // --- 区域回读 (写入调用方复用的缓冲区，行紧密排列) ---
+    void ReadTextureByte(unsigned int texID, const Metrics::FrameRegion& region, std::vector<unsigned char>& out); // 目标纹理 (经 silFBO)
+    void ReadNormals(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, std::vector<float>& out);      // G-buffer 法线 (RGB32F)
+    void ReadDepth(Renderer::PBRRenderer& pbr, const Metrics::FrameRegion& region, std::vector<float>& out);
+    // 把 frame.passOutput 上传到 tg 的对应区域；裁剪时区域外先清为展示背景色 / 热力图背景色
+    void UploadDisplay(const RenderTargets& tg, const Metrics::FrameRegion& region, Metrics::Color8 displayBg, Metrics::Color8 heatmapBg);
+    // 把 frame.sweepOutput 的区域热力图补齐为整幅画面 (区域外为热力图背景色，与热力图面板一致)，行序自底向上
+    const unsigned char* SweepHeatmap(const Metrics::FrameRegion& region, Metrics::Color8 heatmapBg);
 
     // --- 渲染流程 ---
     void ProcessInput();
-    void UpdateState();  // 状态机流转 (PSNR->Sil->Normal->Finished)
+    void UpdateState();  // 状态机流转 (PSNR->[SSIM]->[FLIP]->Sil->Normal->Finished)
+    bool PhaseConverged() const; // 渐进式评估: 当前阶段的置信区间是否已达到容差
     void RenderPasses(); // 渲染、计算误差、更新热力图
+    // 以指定层级 (渲染器 + 目标纹理) 渲染当前阶段的一个视角，计算误差并把展示图/热力图上传到 tg，返回指标值
+    double EvaluateView(const Scene::CameraSample& cam, Renderer::PBRRenderer& pbr, RenderTargets& tg,
+                        Metrics::FlipEvaluator& flipEval, float pixelsPerDegree);
+    // 两个模型包围盒投影矩形的并集，外扩 margin 像素、起止点按 alignment 对齐后裁剪到画面内
+    Metrics::FrameRegion ViewRegion(const Scene::CameraSample& cam, int w, int h, int margin, int alignment) const;
+    double HalfResolutionError(); // 粗层级画面 (viewRegion) 再 2x 降采样后的误差 (越大越差)
+    double ErrorMagnitude(double value) const; // 当前阶段指标值 -> 误差量 (越大越差，PSNR 换算为相对 MSE)
+    void RecordView();   // 保存截图并记录当前视角的误差 (每个视角一次)
+    static const char* PhaseName(RenderPhase phase); // CSV 与性能剖析使用的阶段名
 };
\ No newline at end of file
@@ -7,21 +7,50 @@ namespace fs = std::filesystem;
 BatchProcessor::BatchProcessor(const AppConfig& cfg, Application& application)
         : config(cfg), app(application) {}
 
-void BatchProcessor::InitSingleCSV(const fs::path& path) {
-    std::ofstream f(path);
-    if (f.is_open()) {
-        f << "ModelName,AverageError\n";
-        f.close();
-    }
+void BatchProcessor::InitSingleCSV(const fs::path& path, const std::string& header) {
+    app.Results().DeclareTable(path, header, ResultSink::TableScope::Batch);
 }
 
 void BatchProcessor::InitReportTables() {
     fs::path outRoot = config.paths.outputRoot;
     if (!fs::exists(outRoot)) fs::create_directories(outRoot);
+    app.Results().BeginBatch(config.paths.resultsFile.empty() ? fs::path() : outRoot / config.paths.resultsFile);
+
+    // 内存记账开启时，各表末尾追加截至该行写出时的主机 / 显存峰值
+    const std::string memoryColumns = config.memory.enabled ? ",PeakHostMB,PeakGpuMB" : "";
+
+    // 逐视角指标的汇总表末尾两列: 实际渲染的视角数与均值的置信区间半宽 (渐进式评估的停止依据)
+    InitSingleCSV(outRoot / "metrics_psnr.csv", "ModelName,AverageError,ViewsUsed,ErrorBound" + memoryColumns);
+    if (config.render.ssim) InitSingleCSV(outRoot / "metrics_ssim.csv", "ModelName,AverageSSIM,AverageMSSSIM,AverageTimeMs,ViewsUsed,ErrorBound" + memoryColumns);
+    if (config.render.flip) InitSingleCSV(outRoot / "metrics_flip.csv", "ModelName,AverageFLIP,AverageTimeMs,ViewsUsed,ErrorBound" + memoryColumns);
+    if (config.geometry.hausdorff) {
+        InitSingleCSV(outRoot / "metrics_hausdorff.csv",
+                      "ModelName,Hausdorff,MaxOptToRef,MeanOptToRef,RmsOptToRef,MaxRefToOpt,MeanRefToOpt,RmsRefToOpt,Diagonal,TimeMs" + memoryColumns);
+    }
+    if (config.render.multiResolution) {
+        InitSingleCSV(outRoot / "metrics_multires.csv", "ModelName,Phase,Views,RefinedViews,SavedMs,CoarseMs,FullMs,FullOnlyMs" + memoryColumns);
+    }
+    InitSingleCSV(outRoot / "metrics_silhouette.csv", "ModelName,AverageError,ViewsUsed,ErrorBound" + memoryColumns);
+    InitSingleCSV(outRoot / "metrics_normal.csv", "ModelName,AverageError,ViewsUsed,ErrorBound" + memoryColumns);
+    // 截图输出策略: 每个模型的每个阶段一行 (EncodeMs / WriteMs 为该阶段所有截图的总耗时)
+    InitSingleCSV(outRoot / "metrics_output.csv", "ModelName,Phase,Format,Images,Bytes,EncodeMs,WriteMs" + memoryColumns);
+    if (config.toneSweep.enabled) {
+        // 曝光 / 色调映射扫描: 每个模型的每个 (算子, 曝光) 组合一行 (SweepMs 为 PSNR 阶段扫描后处理的总耗时)
+        InitSingleCSV(outRoot / "metrics_tonemap.csv", "ModelName,AveragePSNR,Operator,Exposure,Views,SweepMs" + memoryColumns);
+    }
+    if (config.environmentSweep.enabled) {
+        // 多环境评估: 每个模型的每个 (环境, 旋转) 组合一行 (SweepMs 为 PSNR 阶段延迟着色与指标计算的总耗时)
+        InitSingleCSV(outRoot / "metrics_environment.csv", "ModelName,AveragePSNR,Environment,Rotation,Views,SweepMs" + memoryColumns);
+    }
+    if (config.profiling.enabled) {
+        InitSingleCSV(outRoot / "metrics_profile.csv",
+                      "ModelName,ViewsPerSec,Views,Frames,WallMs,ReadbackBytes,ReadbackBytesPerView,TraceEvents,DroppedEvents" + memoryColumns);
+    }
 
-    InitSingleCSV(outRoot / "metrics_psnr.csv");
-    InitSingleCSV(outRoot / "metrics_silhouette.csv");
-    InitSingleCSV(outRoot / "metrics_normal.csv");
+    if (config.memory.enabled) {
+        InitSingleCSV(outRoot / "metrics_memory.csv",
+                      "ModelName,PeakHostMB,PeakGpuMB,TextureMB,MeshMB,FrameBufferMB,IBLMB,OtherMB,Status");
+    }
 
     std::cout << "[Batch] Report tables initialized." << std::endl;
 }
@@ -66,5 +95,6 @@ void BatchProcessor::RunBatch() {
         }
     }
 
+    app.Results().EndBatch();
     std::cout << "[BatchProcessor] All tasks finished." << std::endl;
 }
\ No newline at end of file
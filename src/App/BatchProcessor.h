@@ -10,13 +10,13 @@ public:
     // 执行批量处理的主入口
     void RunBatch();
 
+    // 开始一个结果批次并初始化各指标的 CSV 表格 (基准模式按分辨率分别调用)
+    void InitReportTables();
+
 private:
     const AppConfig& config;
     Application& app;
 
-    // 辅助：初始化三个 CSV 表格
-    void InitReportTables();
-
     // 辅助：初始化单个 CSV
-    void InitSingleCSV(const std::filesystem::path& path);
+    void InitSingleCSV(const std::filesystem::path& path, const std::string& header = "ModelName,AverageError");
 };
\ No newline at end of file
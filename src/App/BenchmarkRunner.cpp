@@ -0,0 +1,142 @@
+#include "BenchmarkRunner.h"
+#include "Application.h"
+#include "BatchProcessor.h"
+#include "Resources/ResourceManager.h"
+#include "Scene/ProceduralModels.h"
+
+
+namespace fs = std::filesystem;
+
+BenchmarkRunner::BenchmarkRunner(const AppConfig& cfg) : config(cfg) {}
+
+AppConfig BenchmarkRunner::ConfigForResolution(int resolution) const {
+    AppConfig cfg = config;
+    cfg.render.width = resolution;
+    cfg.render.height = resolution;
+    cfg.render.display = false;
+    cfg.render.delayTime = 0.0f;
+    cfg.sampling.viewCount = config.benchmark.viewCount;
+    cfg.profiling.enabled = true;
+    cfg.paths.outputRoot = (fs::path(config.benchmark.outputRoot) / ("res_" + std::to_string(resolution))).string();
+    return cfg;
+}
+
+void BenchmarkRunner::Run() {
+    const auto& bench = config.benchmark;
+    fs::create_directories(bench.outputRoot);
+
+    std::vector<Scene::ProceduralShape> shapes;
+    if (bench.spheres) shapes.push_back(Scene::ProceduralShape::Sphere);
+    if (bench.greebledBoxes) shapes.push_back(Scene::ProceduralShape::GreebledBox);
+
+    std::cout << "==================================================" << std::endl;
+    std::cout << "[Benchmark] " << shapes.size() << " shapes x " << bench.triangleCounts.size() << " triangle counts x "
+              << bench.resolutions.size() << " resolutions, " << bench.viewCount << " views, simplify ratio "
+              << bench.simplifyRatio << std::endl;
+    std::cout << "==================================================\n" << std::endl;
+
+    Resources::ResourceManager& resources = Resources::ResourceManager::GetInstance();
+
+    // 每个分辨率单独创建 Application (离屏目标、渲染器与逐视角缓冲都按分辨率一次性分配)
+    for (int resolution : bench.resolutions) {
+        AppConfig cfg = ConfigForResolution(resolution);
+        Application app(cfg);
+        if (!app.InitSystem()) {
+            std::cerr << "[Benchmark] System init failed at " << resolution << "x" << resolution << std::endl;
+            return;
+        }
+        BatchProcessor batch(cfg, app);
+        batch.InitReportTables();
+
+        for (Scene::ProceduralShape shape : shapes) {
+            for (size_t target : bench.triangleCounts) {
+                CaseResult result;
+                result.shape = Scene::ProceduralModels::ShapeName(shape);
+                result.resolution = resolution;
+
+                const std::string name = result.shape + "_" + std::to_string(target);
+                const std::string refKey = "procedural/" + name + "_ref.ply";
+                const std::string optKey = "procedural/" + name + "_opt.ply";
+
+                {
+                    auto begin = std::chrono::steady_clock::now();
+                    Scene::ProceduralMesh ref = Scene::ProceduralModels::Generate(shape, target, bench.seed);
+                    Scene::ProceduralMesh opt = Scene::ProceduralModels::Simplify(ref, bench.simplifyRatio);
+                    result.refTriangles = ref.TriangleCount();
+                    result.optTriangles = opt.TriangleCount();
+                    resources.RegisterMemoryModel(refKey, Scene::ProceduralModels::ToBinaryPly(ref), "ply");
+                    resources.RegisterMemoryModel(optKey, Scene::ProceduralModels::ToBinaryPly(opt), "ply");
+                    result.generateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+                }
+
+                std::cout << ">>> Benchmark: " << name << " (" << result.refTriangles << " -> " << result.optTriangles
+                          << " triangles) at " << resolution << "x" << resolution << std::endl;
+                app.ProcessSingleModel(refKey, optKey, name);
+                result.profile = app.LastProfile();
+
+                resources.Unload(refKey);
+                resources.Unload(optKey);
+
+                results.push_back(std::move(result));
+                WriteReports();
+            }
+        }
+    }
+
+    PrintSummary();
+}
+
+void BenchmarkRunner::WriteReports() const {
+    const fs::path root = config.benchmark.outputRoot;
+
+    std::ofstream summary(root / "benchmark_summary.csv");
+    if (summary.is_open()) {
+        summary << "Shape,RefTriangles,OptTriangles,Resolution,Views,Frames,WallMs,ModelsPerHour,ViewsPerSec,ReadbackBytesPerView,GenerateMs\n";
+        for (const CaseResult& r : results) {
+            const double bytesPerView = r.profile.views ? (double)r.profile.readbackBytes / r.profile.views : 0.0;
+            summary << r.shape << "," << r.refTriangles << "," << r.optTriangles << "," << r.resolution << ","
+                    << r.profile.views << "," << r.profile.frames << "," << r.profile.wallMs << "," << r.ModelsPerHour() << ","
+                    << r.profile.ViewsPerSecond() << "," << bytesPerView << "," << r.generateMs << "\n";
+        }
+    }
+
+    // 长表: 每个组合的每个阶段一行，便于按三角形数 / 分辨率透视
+    std::ofstream stages(root / "benchmark_stages.csv");
+    if (stages.is_open()) {
+        stages << "Shape,RefTriangles,Resolution,Stage,Track,Count,TotalMs,MeanMs,Share\n";
+        for (const CaseResult& r : results) {
+            for (const auto& stage : r.profile.stages) {
+                stages << r.shape << "," << r.refTriangles << "," << r.resolution << "," << stage.name << ","
+                       << (stage.gpu ? "GPU" : "CPU") << "," << stage.count << "," << stage.totalMs << ","
+                       << stage.totalMs / stage.count << "," << stage.totalMs / std::max(r.profile.wallMs, 1e-9) << "\n";
+            }
+        }
+    }
+}
+
+void BenchmarkRunner::PrintSummary() const {
+    std::cout << "\n==================================================" << std::endl;
+    std::cout << "[Benchmark] Scaling summary" << std::endl;
+    std::cout << std::left << std::setw(13) << "Shape" << std::right << std::setw(11) << "RefTris" << std::setw(10) << "OptTris"
+              << std::setw(7) << "Res" << std::setw(10) << "Views/s" << std::setw(10) << "Models/h" << "  Top CPU stages" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const CaseResult& r : results) {
+        std::cout << std::left << std::setw(13) << r.shape << std::right << std::setw(11) << r.refTriangles
+                  << std::setw(10) << r.optTriangles << std::setw(7) << r.resolution
+                  << std::setw(10) << r.profile.ViewsPerSecond() << std::setw(10) << r.ModelsPerHour() << " ";
+
+        // 外层的 Frame 阶段包含其余渲染阶段，不参与排名
+        int shown = 0;
+        for (const auto& stage : r.profile.stages) {
+            if (stage.gpu || stage.name == "Frame") continue;
+            std::cout << " " << stage.name << " " << 100.0 * stage.totalMs / std::max(r.profile.wallMs, 1e-9) << "%";
+            if (++shown == 3) break;
+        }
+        std::cout << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+    std::cout << "  Reports: " << (fs::path(config.benchmark.outputRoot) / "benchmark_summary.csv").string()
+              << ", benchmark_stages.csv" << std::endl;
+    std::cout << "==================================================" << std::endl;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "Config.h"
+#include "Utils/Profiler.h"
+
+// 端到端吞吐基准 (config.benchmark)：程序化模型对在内存中生成，逐分辨率以无窗口方式跑完整流程，
+// 输出三角形数 x 分辨率的扩展曲线
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(const AppConfig& config);
+
+    void Run();
+
+private:
+    struct CaseResult {
+        std::string shape;
+        size_t refTriangles = 0;
+        size_t optTriangles = 0;
+        int resolution = 0;
+        double generateMs = 0.0;        // 生成 + 简化 + 序列化 (不计入吞吐)
+        Utils::ProfileSummary profile;  // 单个模型的全流程 (加载 -> 几何评估 -> 渲染循环)
+
+        double ModelsPerHour() const { return profile.wallMs > 0.0 ? 3600.0 * 1000.0 / profile.wallMs : 0.0; }
+    };
+
+    const AppConfig& config;
+    std::vector<CaseResult> results;
+
+    // 单个分辨率的运行配置: 无窗口、无帧间延迟、强制启用 profiling，输出写入 <benchmark.outputRoot>/res_<N>
+    AppConfig ConfigForResolution(int resolution) const;
+
+    // 每个组合完成后重写一次 (中途中断时保留已完成的结果)
+    void WriteReports() const;
+    void PrintSummary() const;
+};
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <string>
+#include "Metrics/HeatmapPalette.h"
+#include "Metrics/ToneMapping.h"
+#include "Utils/ImageWriter.h"
 
 struct AppConfig {
     // 窗口显示配置
@@ -34,14 +37,197 @@ struct AppConfig {
         // 倍数为 2.5 时，意味着 40% 的 RGB 相对颜色差异就会在热力图上显示为最高误差(纯红)。
         // 调大此值会让微小的误差显得更严重(飘红)，调小则会增加视觉宽容度。
         float colorErrorMultiplier = 2.5f;
+
+        // SSIM / MS-SSIM 阶段 (可选，紧随 PSNR 阶段，使用相同的 IBL 画面；开启后每个视角多一次渲染与回读)
+        // BT.601 亮度上的 11x11 高斯窗口 (σ=1.5)；MS-SSIM 最多 5 个尺度，分辨率不足时自动减少
+        bool ssim = false;
+        int msssimScales = 5;
+        // SSIM 热力图放大倍率: 热力图显示 (1 - SSIM) * 倍率，2.0 表示局部 SSIM 降到 0.5 即显示为最高误差(纯红)
+        float ssimErrorMultiplier = 2.0f;
+
+        // FLIP 风格感知色差阶段 (可选，紧随 PSNR / SSIM 阶段，使用相同的 IBL 画面)
+        // CSF 空间滤波 + 边缘/点特征项，逐像素误差范围 [0, 1]，热力图直接显示误差值
+        // 单线程约 250 ms / 1024² 视角，开启后每个模型明显变慢
+        bool flip = false;
+        // 观察条件 (每度视角对应的像素数)，默认 0.7 m 观看 0.7 m 宽的 4K 显示器
+        float flipPixelsPerDegree = 67.0206f;
+
+        // 紧凑 G-buffer 回读 (可选)：
+        // 法线以 RG16 八面体编码回读 (4 B/像素，替代 12 B/像素的 RGB float)，
+        // 背景判定改用 GPU 打包的 1 bit 覆盖掩码 (替代 4 B/像素的深度回读)。
+        // 容差: 逐分量误差 < 5e-4 (RGB16F 与 RG16 的量化)，单视角法线 MSE 的绝对差异 < 1e-6
+        bool compactReadback = false;
+
+        // 多分辨率评估 (可选，仅 PSNR / SSIM / FLIP 阶段)：
+        // 每个视角先以 1/multiResDivisor 的分辨率渲染并评估，只有以下视角才以完整 width/height 重新渲染:
+        //   误差偏高 — 超过本阶段已评估视角 (粗层级) 的均值 + refineSigma 个标准差；
+        //   估计不稳定 — 再 2x 降采样后的误差与粗层级误差的相对差异超过 refineTolerance。
+        // 未细化的视角直接采用粗层级的指标值。轮廓与法线 MSE 依赖像素尺度 (边缘像素占比随分辨率变化)，始终以全分辨率评估
+        bool multiResolution = false;
+        int multiResDivisor = 4;
+        float refineSigma = 1.0f;
+        float refineTolerance = 0.25f;
+
+        // 屏幕空间 ROI (可选)：
+        // 两个模型包围盒投影矩形的并集 (按各阶段滤波窗口外扩) 之外必为纯色背景且两侧相同，
+        // 清屏、回读与逐像素计算只作用于该矩形，区域外的背景像素按数量解析地计入指标。
+        // PSNR / 轮廓误差结果逐位一致，法线 MSE / SSIM / FLIP 仅有求和顺序带来的舍入差异 (相对 < 1e-12)。
+        // 绘制天空盒的阶段自动退回整幅画面
+        bool screenSpaceRoi = false;
     } render;
 
+    // 逐视角截图的输出策略 (每个阶段单独设置)：
+    //   None    — 仅指标: 不写截图；未显示窗口 (render.display = false) 时同时跳过分屏可视化绘制、
+    //             展示纹理上传与窗口回读
+    //   Png     — stb PNG，zlib 级别 8 (原有行为)
+    //   FastPng — stb PNG，zlib 取 stb 允许的最低级别 5 并固定 Sub 行滤波器
+    //   Qoi     — QOI 无损，单遍编码 (1800x600 截图的编码比 PNG 快一个数量级以上，体积相近)
+    //   Raw     — 未压缩 PPM (P6)
+    // 每个阶段的截图张数、字节数与编码 / 写盘耗时写入 metrics_output.csv
+    //
+    // 离屏输出 (offscreen = true)：截图不再回读窗口，而是每个视角把合成图绘制到专用 FBO
+    // (width x height，0 = 3 * render.width x render.height，面板保持目标纹理的原始分辨率、不经窗口缩放)，
+    // 经 PBO 异步回读，在之后的帧中取回并编码；输出与窗口大小和是否显示无关，窗口只在 render.display 时绘制。
+    // panels = true 时另外直接回读参考 / 优化 / 热力图三张目标纹理 (view_N_ref / _opt / _heatmap)，
+    // composite = false 时只输出面板。readbackDepth 为同时在途的回读请求数 (写满时同步等待最旧一项)
+    //
+    // 逐像素误差图 (errorMaps = true)：热力图所用的误差 (乘倍率之前) 以 half 精度、游程编码写入
+    // <模型>/<阶段>/errors.vmerr (格式见 Metrics/ErrorMapFile.h)，与截图格式无关 (仅指标模式下同样写出)；
+    // 之后可用 --recolor 以新的倍率 / 调色板离线重新生成热力图与图例 (见 recolor)
+    struct Output {
+        Utils::ImageFormat psnr = Utils::ImageFormat::Png;
+        Utils::ImageFormat ssim = Utils::ImageFormat::Png;
+        Utils::ImageFormat flip = Utils::ImageFormat::Png;
+        Utils::ImageFormat silhouette = Utils::ImageFormat::Png;
+        Utils::ImageFormat normal = Utils::ImageFormat::Png;
+
+        bool offscreen = false;
+        int width = 0;
+        int height = 0;
+        bool composite = true;
+        bool panels = false;
+        int readbackDepth = 4;
+        bool errorMaps = false;
+    } output;
+
+    // 曝光 / 色调映射扫描 (可选，仅 PSNR 阶段)：
+    // PBR 着色器额外输出曝光与色调映射之前的线性辐射度 (RGBA16F 附件)，每个视角回读一次参考 / 优化两幅，
+    // 之后对 exposures x operators 的每个组合在 CPU 端重新做色调映射与 gamma 并计算 PSNR，无需重新渲染几何。
+    // 每个组合一行写入 metrics_tonemap.csv，逐视角结果写入 <模型>/tonemap/；heatmaps = true 时按 output.psnr 的格式
+    // 另存每个组合的热力图 (整幅画面，与 PSNR 阶段的热力图面板一致)。曝光 1.0 + ACES 即默认渲染路径 (舍入边界附近的像素可能相差 1 个量化级)
+    struct ToneSweep {
+        bool enabled = false;
+        std::vector<float> exposures = { 0.25f, 0.5f, 1.0f, 2.0f, 4.0f };
+        std::vector<Metrics::ToneOperator> operators = { Metrics::ToneOperator::Aces, Metrics::ToneOperator::Reinhard };
+        bool heatmaps = false;
+    } toneSweep;
+
+    // 多环境评估 (可选，仅 PSNR 阶段)：延迟着色
+    // PBR 着色器另外输出 G-buffer (反照率 / 金属度、粗糙度 / 着色模型；法线与深度沿用已有附件)，每个视角的首帧把参考 / 优化
+    // 两组 G-buffer 各拷贝一份快照，之后每个 (环境, 旋转) 组合只对两份快照各做一次全屏延迟着色并计算 PSNR，不重新绘制几何。
+    // environments 为 paths.hdrDir 下的 .hdr 文件名 (留空 = 目录中的全部 .hdr)，每个环境在启动时烘焙一次 IBL 并跨模型复用；
+    // rotations 为环境绕 Y 轴的旋转角 (度)。每个组合一行写入 metrics_environment.csv，逐视角结果写入 <模型>/environment/；
+    // heatmaps = true 时按 output.psnr 的格式另存每个组合的热力图 (整幅画面，与 PSNR 阶段的热力图面板一致)。
+    // 与主渲染同一环境、旋转 0 的组合即默认前向路径 (仅有 16 位浮点 G-buffer 带来的个别量化差异)
+    struct EnvironmentSweep {
+        bool enabled = false;
+        std::vector<std::string> environments;
+        std::vector<float> rotations = { 0.0f };
+        bool heatmaps = false;
+    } environmentSweep;
+
+    // 纹理管线配置
+    struct Texture {
+        // 基础层最大边长，超出的顶层 Mip 在上传前直接丢弃
+        // -1 = 不限制 (默认，保持原始分辨率，采样到的纹素与未裁剪时一致)
+        // 0 = 自动: 渲染分辨率向上取 2 的幂后再放大 2 倍 (1024 -> 2048)。该余量不考虑 UV 密度，
+        //     大图集上被局部放大的 UV 岛会采样到降采样后的纹素，误差指标随之改变，仅在显存受限时使用
+        int maxSize = -1;
+        bool useCache = false;   // 磁盘缓存 (预构建 Mip 链，二次运行跳过 PNG/JPEG 解码)
+        // GPU 块压缩 (S3TC / RGTC)。有损：首次构建缓存时会回读并报告最差 PSNR
+        bool compress = false;
+        std::string cacheDir = "output/cache/textures";
+    } texture;
+
+    // 模型加载配置
+    struct Loading {
+        // 流式导入 (适用于超出主机内存的摄影测量参考模型)：
+        // 网格分块转换并直接上传显存，主机端峰值内存与 chunkVertices 成正比
+        bool streaming = false;
+        size_t chunkVertices = 65536;
+    } loading;
+
     // 采样配置
     struct Sampling {
         int viewCount = 64;   // 斐波那契采样点数量
         float radius = 2.0f;  // 摄像机球体半径
+
+        // 渐进式评估 (可选)：视角按低差异顺序渲染，每个阶段在线统计逐视角误差的均值与方差，
+        // 均值的置信区间半宽 z * s / sqrt(n) 不超过 max(relativeTolerance * |均值|, absoluteTolerance) 时提前结束该阶段。
+        // 每个阶段至少渲染 minViews 个视角 (过少的样本方差估计不可靠)
+        bool progressive = false;
+        int minViews = 16;
+        float confidenceZ = 1.96f;        // 95% 置信度
+        float relativeTolerance = 0.01f;
+        float absoluteTolerance = 0.0f;   // 误差接近 0 的指标 (法线/轮廓 MSE) 建议设置绝对容差
     } sampling;
 
+    // 几何偏差 (双向 Hausdorff 距离，可选)，模型加载后在渲染前计算一次
+    // 流式加载的网格需从显存回读并在主机端重建全部三角形，开启后不再受流式导入的主机内存上限约束
+    struct Geometry {
+        bool hausdorff = false;
+        size_t samples = 1000000;  // 每个方向的表面采样点数 (另加全部顶点)
+        bool alignCenters = true;  // 两个模型各自平移到包围盒中心后再比较 (与原 PyMeshLab 脚本一致)
+    } geometry;
+
+    // 性能剖析 (可选)：阶段级 CPU 计时 + GL_TIMESTAMP GPU 计时
+    // 每个模型写出 <outputRoot>/<模型名>/trace.json (Chrome trace，可用 chrome://tracing 或 Perfetto 打开)
+    // 与 profile_stages.csv (各阶段次数与耗时)，全局汇总 (视角/秒、回读字节数) 写入 metrics_profile.csv
+    struct Profiling {
+        bool enabled = false;
+        bool gpuTimers = true;          // GPU 区间计时 (查询结果延后取回，不阻塞 CPU)
+        size_t maxEvents = 1 << 20;     // 每个模型的事件缓冲上限 (预先分配，写满后丢弃并计数)
+    } profiling;
+
+    // 内存记账 (可选)：所有 GL 分配按类别 (纹理 / 网格 / 帧缓冲 / IBL / 其他) 统计显存字节数，
+    // 后台线程按 sampleIntervalMs 采样进程常驻内存 (RSS)；每个模型的峰值写入 metrics_memory.csv，
+    // 并作为 PeakHostMB,PeakGpuMB 两列追加到其余全局 CSV (截至该行写出时的峰值)。
+    // 预算 (MB，0 = 不限制)：超出后取消正在进行的 Assimp 导入、跳过剩余阶段，模型记为 Aborted 并继续下一个模型
+    struct Memory {
+        bool enabled = false;
+        size_t hostBudgetMB = 0;
+        size_t gpuBudgetMB = 0;
+        int sampleIntervalMs = 10;
+    } memory;
+
+    // 端到端吞吐基准 (可选，命令行参数 --benchmark 启用，不需要任何资产文件)：
+    // 在内存中生成程序化的参考模型 (细分球、greeble 方盒)，优化模型由顶点聚类按 simplifyRatio 简化，
+    // 以无窗口方式对每个 (形状, 三角形数, 分辨率) 组合跑完整的 ProcessSingleModel 流程 (强制启用 profiling)，
+    // 汇总 模型/小时、视角/秒 与各阶段耗时到 <outputRoot>/benchmark_summary.csv 与 benchmark_stages.csv
+    struct Benchmark {
+        bool enabled = false;
+        std::vector<size_t> triangleCounts = { 10000, 100000, 1000000, 10000000 };
+        std::vector<int> resolutions = { 512, 1024, 2048 };  // 正方形离屏分辨率
+        bool spheres = true;
+        bool greebledBoxes = true;
+        float simplifyRatio = 0.1f;   // 优化模型三角形数 / 参考模型三角形数
+        int viewCount = 16;           // 覆盖 sampling.viewCount
+        uint32_t seed = 7;
+        std::string outputRoot = "output/benchmark";
+    } benchmark;
+
+    // 离线重新着色 (命令行 --recolor <文件或目录> [--multiplier X] [--palette default|gray|viridis])：
+    // 读取 output.errorMaps 写出的 .vmerr (目录时递归查找)，不创建窗口、不加载模型，
+    // 在每个文件旁的 recolor_<调色板>_x<倍率>/ 下重新生成 view_N 热力图 (整幅画面，背景填 render.heatmapBackground) 与图例。
+    // multiplier = 0 时沿用文件中记录的运行时倍率
+    struct Recolor {
+        bool enabled = false;
+        std::string input;
+        float multiplier = 0.0f;
+        Metrics::HeatmapPalette palette = Metrics::HeatmapPalette::Default;
+        Utils::ImageFormat format = Utils::ImageFormat::Png;
+    } recolor;
+
     // 路径配置
     struct Paths {
         std::string assetsRoot = "assets";
@@ -58,7 +244,12 @@ struct AppConfig {
 
         // 指定三个热力图标签的输出文件名 (将存放在 outputRoot 目录下)
         std::string legendPsnr = "legend_psnr.png";
+        std::string legendSsim = "legend_ssim.png";
+        std::string legendFlip = "legend_flip.png";
         std::string legendNormal = "legend_normal.png";
         std::string legendSilhouette = "legend_silhouette.png";
+
+        // 批次的列式二进制结果 (模型, 方法, 视角, 指标, 数值, 耗时)，位于 outputRoot 下；留空则不写
+        std::string resultsFile = "results.vmcol";
     } paths;
 };
\ No newline at end of file
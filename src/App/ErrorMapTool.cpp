@@ -0,0 +1,110 @@
+#include "ErrorMapTool.h"
+#include "Metrics/ErrorMapFile.h"
+#include "Metrics/Evaluator.h"
+#include "Metrics/PixelPasses.h"
+#include "Metrics/SimdKernels.h"
+
+namespace fs = std::filesystem;
+
+ErrorMapTool::ErrorMapTool(const AppConfig& cfg) : config(cfg) {}
+
+int ErrorMapTool::Run() {
+    const fs::path input = config.recolor.input;
+    std::vector<fs::path> files;
+    std::error_code ec;
+    if (fs::is_directory(input, ec)) {
+        for (const auto& entry : fs::recursive_directory_iterator(input, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".vmerr") files.push_back(entry.path());
+        }
+        std::sort(files.begin(), files.end());
+    }
+    else if (fs::exists(input, ec)) {
+        files.push_back(input);
+    }
+    if (files.empty()) {
+        std::cerr << "[Recolor] No .vmerr files found at " << input.string() << std::endl;
+        return 0;
+    }
+
+    std::cout << "[Recolor] " << files.size() << " error map files, palette "
+              << Metrics::HeatmapPaletteName(config.recolor.palette) << ", multiplier "
+              << (config.recolor.multiplier > 0.0f ? std::to_string(config.recolor.multiplier) : std::string("from file")) << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    int succeeded = 0;
+    for (const fs::path& file : files) {
+        if (RecolorFile(file)) succeeded++;
+    }
+    double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[Recolor] Done: " << succeeded << "/" << files.size() << " files, " << stats.images << " images in "
+              << totalMs << " ms (encode " << stats.encodeMs << " ms, write " << stats.writeMs << " ms)" << std::endl;
+    return succeeded;
+}
+
+void ErrorMapTool::BuildColorTable(float multiplier, const unsigned char* lut) {
+    // 误差以 half 存储，65536 种位模式各查一次表，之后逐像素只剩一次间接寻址
+    const Metrics::Color8 background = Metrics::Color8::FromFloat(config.render.heatmapBackground);
+    colors.resize(65536 * 3);
+    for (uint32_t bits = 0; bits < 65536; ++bits) {
+        unsigned char* c = &colors[bits * 3];
+        const float error = Metrics::Simd::HalfToFloat(static_cast<uint16_t>(bits));
+        if (bits == Metrics::ERROR_MAP_BACKGROUND || std::isnan(error)) {
+            c[0] = background.r;
+            c[1] = background.g;
+            c[2] = background.b;
+            continue;
+        }
+        unsigned char rgba[4];
+        Metrics::Evaluator::HeatmapColor(lut, error * multiplier, rgba);
+        c[0] = rgba[0];
+        c[1] = rgba[1];
+        c[2] = rgba[2];
+    }
+}
+
+bool ErrorMapTool::RecolorFile(const fs::path& path) {
+    Metrics::ErrorMapReader reader;
+    if (!reader.Open(path.string())) return false;
+
+    float multiplier = config.recolor.multiplier > 0.0f ? config.recolor.multiplier : reader.ErrorMultiplier();
+    if (!(multiplier > 0.0f)) multiplier = 1.0f;
+    const unsigned char* lut = Metrics::Evaluator::HeatmapLUT(config.recolor.palette);
+    BuildColorTable(multiplier, lut);
+
+    std::ostringstream dirName;
+    dirName << "recolor_" << Metrics::HeatmapPaletteName(config.recolor.palette) << "_x" << multiplier;
+    const fs::path outDir = path.parent_path() / dirName.str();
+    fs::create_directories(outDir);
+
+    // 与运行时的图例相同: 顶部标签为热力图饱和处的真实误差 = 1 / 倍率
+    auto formatFloat = [](float v) {
+        std::string s = std::to_string(v);
+        return s.substr(0, 4);
+    };
+    const float maxError = 1.0f / multiplier;
+    Metrics::Evaluator::RenderLegend(lut, formatFloat(maxError), formatFloat(maxError / 2.0f), "0.0", pixels);
+    imageWriter.Write((outDir / "legend").string(), Utils::ImageFormat::Png, Metrics::Evaluator::LEGEND_WIDTH,
+                      Metrics::Evaluator::LEGEND_HEIGHT, 3, pixels.data(), false);
+
+    Metrics::ErrorMapView view;
+    int views = 0;
+    while (reader.Next(view, frame)) {
+        const int w = view.region.frameWidth, h = view.region.frameHeight;
+        pixels.resize(frame.size() * 3);
+        for (size_t i = 0; i < frame.size(); ++i) {
+            const unsigned char* c = &colors[frame[i] * 3];
+            pixels[i * 3 + 0] = c[0];
+            pixels[i * 3 + 1] = c[1];
+            pixels[i * 3 + 2] = c[2];
+        }
+        // 误差图为 GL 的自底向上行序，由编码器翻转
+        if (!imageWriter.Write((outDir / ("view_" + std::to_string(view.viewIndex))).string(), config.recolor.format,
+                               w, h, 3, pixels.data(), true, &stats)) {
+            return false;
+        }
+        views++;
+    }
+    std::cout << "  [Recolor] " << path.string() << " (" << reader.Phase() << "): " << views << " views -> "
+              << outDir.string() << std::endl;
+    return true;
+}
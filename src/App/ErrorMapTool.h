@@ -0,0 +1,23 @@
+#pragma once
+#include "Config.h"
+#include "Utils/ImageWriter.h"
+
+// 离线重新着色 (config.recolor)：由 .vmerr 逐像素误差图重新生成热力图与图例，不需要 GPU 与模型文件
+class ErrorMapTool {
+public:
+    explicit ErrorMapTool(const AppConfig& config);
+
+    // 返回成功处理的文件数
+    int Run();
+
+private:
+    const AppConfig& config;
+    Utils::ImageWriter imageWriter;
+    Utils::ImageWriteStats stats;
+    std::vector<unsigned char> colors;  // half 位模式 -> RGB (按当前文件的倍率与调色板构建)
+    std::vector<uint16_t> frame;
+    std::vector<unsigned char> pixels;
+
+    bool RecolorFile(const std::filesystem::path& path);
+    void BuildColorTable(float multiplier, const unsigned char* lut);
+};
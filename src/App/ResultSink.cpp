@@ -0,0 +1,204 @@
+#include "ResultSink.h"
+
+#include <type_traits>
+
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char kMagic[8] = { 'V', 'M', 'C', 'O', 'L', 'S', '0', '1' };
+    constexpr uint32_t kVersion = 1;
+    constexpr size_t kHeaderSize = 64;
+    constexpr size_t kColumnEntrySize = 32;
+
+    template<typename T>
+    void Put(std::string& out, T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "POD only");
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void PadTo8(std::string& out) {
+        out.append((8 - out.size() % 8) % 8, '\0');
+    }
+
+    template<typename T>
+    void PutColumn(std::string& out, const std::vector<T>& column) {
+        if (!column.empty()) out.append(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+        PadTo8(out);
+    }
+}
+
+ResultSink::~ResultSink() {
+    EndBatch();
+}
+
+void ResultSink::BeginBatch(const fs::path& path) {
+    tables.clear();
+    strings.clear();
+    stringIndex.clear();
+    models.clear();
+    methods.clear();
+    metrics.clear();
+    views.clear();
+    values.clear();
+    timesMs.clear();
+    columnarPath = path;
+    batchOpen = true;
+}
+
+void ResultSink::DeclareTable(const fs::path& path, const std::string& header, TableScope scope) {
+    Table& table = tables[path.string()];
+    table.header = header + "\n";
+    table.body.clear();
+    table.scope = scope;
+    table.declared = true;
+    table.dirty = (scope == TableScope::Model);
+    if (scope == TableScope::Batch) WriteAtomically(path, table.header, table.body);
+}
+
+void ResultSink::AppendRow(const fs::path& path, const std::string& row) {
+    Table& table = tables[path.string()];
+    table.body.append(row);
+    table.body.push_back('\n');
+    table.dirty = true;
+}
+
+void ResultSink::BeginModel(const std::string& model, const std::string& method) {
+    currentModel = Intern(model);
+    currentMethod = Intern(method);
+}
+
+void ResultSink::Record(int view, const std::string& metric, double value, double timeMs) {
+    models.push_back(currentModel);
+    methods.push_back(currentMethod);
+    views.push_back(view);
+    metrics.push_back(Intern(metric));
+    values.push_back(value);
+    timesMs.push_back(timeMs);
+}
+
+uint32_t ResultSink::Intern(const std::string& text) {
+    auto it = stringIndex.find(text);
+    if (it != stringIndex.end()) return it->second;
+    const uint32_t index = static_cast<uint32_t>(strings.size());
+    strings.push_back(text);
+    stringIndex.emplace(text, index);
+    return index;
+}
+
+void ResultSink::FlushModel() {
+    for (auto it = tables.begin(); it != tables.end();) {
+        Table& table = it->second;
+        if (table.dirty) {
+            if (table.declared) {
+                WriteAtomically(it->first, table.header, table.body);
+            } else {
+                // 未声明的表: 保留文件中已有的内容，只追加本模型的行
+                std::ofstream file(it->first, std::ios::app | std::ios::binary);
+                if (file.is_open()) file << table.body;
+                else std::cerr << "[Results] Failed to append " << it->first << std::endl;
+                table.body.clear();
+            }
+            table.dirty = false;
+        }
+        if (table.scope == TableScope::Model && table.declared) it = tables.erase(it);
+        else ++it;
+    }
+}
+
+bool ResultSink::WriteAtomically(const fs::path& path, const std::string& header, const std::string& body) {
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "[Results] Failed to open " << tmp.string() << std::endl;
+            return false;
+        }
+        file << header << body;
+        if (!file.good()) {
+            std::cerr << "[Results] Failed to write " << tmp.string() << std::endl;
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        std::cerr << "[Results] Failed to rename " << tmp.string() << " -> " << path.string() << ": " << ec.message() << std::endl;
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+void ResultSink::EndBatch() {
+    if (!batchOpen) return;
+    batchOpen = false;
+    FlushModel();
+    if (columnarPath.empty()) return;
+
+    // 字符串表
+    std::vector<uint64_t> stringOffsets;
+    stringOffsets.reserve(strings.size() + 1);
+    std::string stringData;
+    for (const std::string& s : strings) {
+        stringOffsets.push_back(stringData.size());
+        stringData += s;
+    }
+    stringOffsets.push_back(stringData.size());
+
+    struct Column { const char* name; uint32_t type; uint32_t elementSize; };
+    const Column columns[] = {
+        { "model", 0, 4 }, { "method", 0, 4 }, { "view", 1, 4 }, { "metric", 0, 4 }, { "value", 2, 8 }, { "timeMs", 2, 8 }
+    };
+    const uint32_t columnCount = sizeof(columns) / sizeof(columns[0]);
+    const uint64_t rowCount = views.size();
+
+    // 先排布各段偏移，再按顺序写出
+    auto align8 = [](uint64_t v) { return (v + 7) / 8 * 8; };
+    const uint64_t stringOffsetsPos = kHeaderSize;
+    const uint64_t stringDataPos = stringOffsetsPos + stringOffsets.size() * sizeof(uint64_t);
+    const uint64_t columnsPos = align8(stringDataPos + stringData.size());
+    uint64_t dataPos = columnsPos + columnCount * kColumnEntrySize;
+    uint64_t columnOffsets[6];
+    for (uint32_t c = 0; c < columnCount; ++c) {
+        columnOffsets[c] = dataPos;
+        dataPos = align8(dataPos + rowCount * columns[c].elementSize);
+    }
+
+    std::string out;
+    out.reserve(static_cast<size_t>(dataPos));
+    out.append(kMagic, sizeof(kMagic));
+    Put<uint32_t>(out, kVersion);
+    Put<uint32_t>(out, columnCount);
+    Put<uint64_t>(out, rowCount);
+    Put<uint64_t>(out, strings.size());
+    Put<uint64_t>(out, stringOffsetsPos);
+    Put<uint64_t>(out, stringDataPos);
+    Put<uint64_t>(out, columnsPos);
+    Put<uint64_t>(out, 0);
+
+    for (uint64_t offset : stringOffsets) Put<uint64_t>(out, offset);
+    out += stringData;
+    PadTo8(out);
+
+    for (uint32_t c = 0; c < columnCount; ++c) {
+        char name[16] = {};
+        std::strncpy(name, columns[c].name, sizeof(name) - 1);
+        out.append(name, sizeof(name));
+        Put<uint32_t>(out, columns[c].type);
+        Put<uint32_t>(out, columns[c].elementSize);
+        Put<uint64_t>(out, columnOffsets[c]);
+    }
+
+    PutColumn(out, models);
+    PutColumn(out, methods);
+    PutColumn(out, views);
+    PutColumn(out, metrics);
+    PutColumn(out, values);
+    PutColumn(out, timesMs);
+
+    if (WriteAtomically(columnarPath, std::string(), out)) {
+        std::cout << "[Results] " << rowCount << " records -> " << columnarPath.string() << std::endl;
+    }
+}
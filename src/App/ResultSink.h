@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @brief 结果输出缓冲
+ * CSV 行先追加到内存中的表，每个模型结束时 FlushModel 统一落盘一次：
+ * 每张改动过的表先完整写入 <文件>.tmp 再重命名覆盖，读取方不会看到写了一半的文件。
+ * - Batch 表 (全局 metrics_*.csv): 整个批次的行都保留在内存中，每次落盘重写整张表 (每个模型只有几行)
+ * - Model 表 (模型目录下的逐视角 CSV): 只在当前模型内有效，落盘后丢弃
+ * 未声明的表按追加方式写入 (与旧行为一致，不覆盖已有内容)。
+ *
+ * 同时收集列式记录 (模型, 方法, 视角, 指标, 数值, 耗时)，EndBatch 时写出一个二进制文件，
+ * 分析工具可直接内存映射读取，无需解析 CSV。文件布局 (little-endian，各段按 8 字节对齐):
+ *   Header (64 字节):
+ *     char     magic[8]      "VMCOLS01"
+ *     uint32   version       1
+ *     uint32   columnCount   6
+ *     uint64   rowCount
+ *     uint64   stringCount   字符串表条目数 (模型名、方法名、指标名共用)
+ *     uint64   stringOffsets 偏移: uint64[stringCount + 1]，相对 stringData 的字节偏移
+ *     uint64   stringData    偏移: UTF-8 字符串拼接 (无结束符)
+ *     uint64   columns       偏移: 列目录
+ *     uint64   reserved
+ *   列目录 (每列 32 字节): char name[16]; uint32 type (0 = uint32, 1 = int32, 2 = float64); uint32 elementSize; uint64 offset
+ *   列数据 (各 rowCount 个元素):
+ *     model  uint32   字符串表下标
+ *     method uint32   字符串表下标 (优化模型的文件名，即被评估的简化方法 / 资产)
+ *     view   int32    视角原始编号，-1 表示模型级汇总
+ *     metric uint32   字符串表下标 (PSNR、SSIM、MS-SSIM、FLIP、Normal、Silhouette、Hausdorff)
+ *     value  float64
+ *     timeMs float64  指标计算耗时 (未测量时为 NaN)
+ */
+class ResultSink {
+public:
+    enum class TableScope { Batch, Model };
+
+    ResultSink() = default;
+    ~ResultSink();
+
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+
+    // 清空全部表与记录；columnarPath 为空时不写二进制文件
+    void BeginBatch(const std::filesystem::path& columnarPath);
+    // 写出二进制列式文件 (批次内只生效一次，析构时若尚未调用会自动调用)
+    void EndBatch();
+
+    // 声明一张表。Batch 表立即以表头原子写出 (批次尚无结果时文件也存在)，Model 表延迟到 FlushModel
+    void DeclareTable(const std::filesystem::path& path, const std::string& header, TableScope scope);
+    // row 不含换行符
+    void AppendRow(const std::filesystem::path& path, const std::string& row);
+
+    void BeginModel(const std::string& model, const std::string& method);
+    void Record(int view, const std::string& metric, double value, double timeMs = std::numeric_limits<double>::quiet_NaN());
+    // 落盘本模型改动过的表，并丢弃 Model 表
+    void FlushModel();
+
+    size_t RecordCount() const { return views.size(); }
+
+private:
+    struct Table {
+        std::string header;
+        std::string body;        // Batch / Model 表: 全部行；未声明的表: 尚未追加的行
+        TableScope scope = TableScope::Batch;
+        bool declared = false;
+        bool dirty = false;
+    };
+
+    uint32_t Intern(const std::string& text);
+    static bool WriteAtomically(const std::filesystem::path& path, const std::string& header, const std::string& body);
+
+    std::map<std::string, Table> tables;   // 按路径排序，落盘顺序稳定
+
+    std::filesystem::path columnarPath;
+    bool batchOpen = false;
+
+    // 列式记录 (按列存放，EndBatch 时直接写出)
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringIndex;
+    std::vector<uint32_t> models, methods, metrics;
+    std::vector<int32_t> views;
+    std::vector<double> values, timesMs;
+    uint32_t currentModel = 0;
+    uint32_t currentMethod = 0;
+};
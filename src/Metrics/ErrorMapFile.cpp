@@ -0,0 +1,204 @@
+#include "ErrorMapFile.h"
+#include "PixelPasses.h"
+
+namespace Metrics {
+
+    namespace {
+        constexpr char kMagic[8] = { 'V', 'M', 'E', 'R', 'R', '0', '0', '1' };
+        constexpr uint32_t kVersion = 1;
+        constexpr uint16_t kRunFlag = 0x8000u;
+        constexpr size_t kMaxSegment = 0x7FFFu;
+        constexpr size_t kMinRun = 3;   // 更短的重复按字面段处理 (重复段本身占 2 个 uint16)
+        // 读取时接受的最大画面 (边长不超过 GL 纹理上限，总像素 2^28)，超出视为损坏
+        constexpr int32_t kMaxFrameSize = 32768;
+        constexpr size_t kMaxFramePixels = size_t(1) << 28;
+
+        template<typename T>
+        void WritePod(std::ofstream& out, const T& value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        bool ReadPod(std::ifstream& in, T& value) {
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
+        // 一行接一行地把区域内的像素当作一个连续序列编码 (背景游程通常跨行)
+        void EncodeRle(const ImageView& error, std::vector<uint16_t>& tokens) {
+            tokens.clear();
+            size_t literalStart = 0, literalCount = 0;   // 待写出的字面段 (在 tokens 中预留了令牌位置)
+
+            auto closeLiteral = [&]() {
+                if (literalCount == 0) return;
+                tokens[literalStart] = static_cast<uint16_t>(literalCount);
+                literalCount = 0;
+            };
+            auto pushLiteral = [&](uint16_t v) {
+                if (literalCount == 0 || literalCount == kMaxSegment) {
+                    closeLiteral();
+                    literalStart = tokens.size();
+                    tokens.push_back(0);
+                }
+                tokens.push_back(v);
+                literalCount++;
+            };
+
+            const size_t total = error.PixelCount();
+            const int width = error.width;
+            auto at = [&](size_t i) { return error.Row<uint16_t>(static_cast<int>(i / width))[i % width]; };
+
+            size_t i = 0;
+            while (i < total) {
+                const uint16_t v = at(i);
+                size_t run = 1;
+                while (i + run < total && run < kMaxSegment && at(i + run) == v) run++;
+                if (run >= kMinRun) {
+                    closeLiteral();
+                    tokens.push_back(static_cast<uint16_t>(kRunFlag | run));
+                    tokens.push_back(v);
+                } else {
+                    for (size_t k = 0; k < run; ++k) pushLiteral(v);
+                }
+                i += run;
+            }
+            closeLiteral();
+        }
+    }
+
+    bool ErrorMapWriter::Open(const std::string& filePath, const std::string& phase, float errorMultiplier) {
+        Close();
+        path = filePath;
+        file.open(filePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "[ErrorMap] Failed to open " << filePath << std::endl;
+            return false;
+        }
+
+        file.write(kMagic, sizeof(kMagic));
+        WritePod(file, kVersion);
+        WritePod(file, errorMultiplier);
+        WritePod(file, static_cast<uint32_t>(phase.size()));
+        const uint32_t reserved[3] = { 0, 0, 0 };
+        file.write(reinterpret_cast<const char*>(reserved), sizeof(reserved));
+        file.write(phase.data(), static_cast<std::streamsize>(phase.size()));
+        const char pad[4] = {};
+        file.write(pad, (4 - phase.size() % 4) % 4);
+        bytesWritten = 32 + phase.size() + (4 - phase.size() % 4) % 4;
+        rawBytes = 0;
+        return file.good();
+    }
+
+    void ErrorMapWriter::Close() {
+        if (file.is_open()) file.close();
+        path.clear();
+    }
+
+    void ErrorMapWriter::Append(int viewIndex, const FrameRegion& region, const ImageView& error) {
+        if (!file.is_open()) return;
+        if (error.format != PixelFormat::R16F || error.width != region.width || error.height != region.height) {
+            std::cerr << "[ErrorMap] Error: error map does not match the evaluated region!" << std::endl;
+            return;
+        }
+
+        EncodeRle(error, tokens);
+        const int32_t header[7] = { viewIndex, region.frameWidth, region.frameHeight, region.x, region.y, region.width, region.height };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        WritePod(file, static_cast<uint32_t>(tokens.size()));
+        if (tokens.size() % 2) tokens.push_back(0);
+        file.write(reinterpret_cast<const char*>(tokens.data()), static_cast<std::streamsize>(tokens.size() * sizeof(uint16_t)));
+        if (!file.good()) std::cerr << "[ErrorMap] Failed to write " << path << std::endl;
+
+        bytesWritten += sizeof(header) + sizeof(uint32_t) + tokens.size() * sizeof(uint16_t);
+        rawBytes += error.PixelCount() * sizeof(uint16_t);
+    }
+
+    bool ErrorMapReader::Open(const std::string& filePath) {
+        // 允许复用同一个读取器打开下一个文件
+        file.close();
+        file.clear();
+        path = filePath;
+        std::error_code ec;
+        fileSize = std::filesystem::file_size(filePath, ec);
+        file.open(filePath, std::ios::binary);
+        if (ec || !file.is_open()) {
+            std::cerr << "[ErrorMap] Failed to open " << filePath << std::endl;
+            return false;
+        }
+
+        char magic[8] = {};
+        uint32_t version = 0, phaseLength = 0, reserved[3] = {};
+        file.read(magic, sizeof(magic));
+        if (!file || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || !ReadPod(file, version) || version != kVersion ||
+            !ReadPod(file, errorMultiplier) || !ReadPod(file, phaseLength) || !ReadPod(file, reserved) || phaseLength > 256) {
+            std::cerr << "[ErrorMap] Not an error map file: " << filePath << std::endl;
+            return false;
+        }
+        phase.resize(phaseLength);
+        file.read(&phase[0], phaseLength);
+        file.seekg((4 - phaseLength % 4) % 4, std::ios::cur);
+        return static_cast<bool>(file);
+    }
+
+    bool ErrorMapReader::Next(ErrorMapView& view, std::vector<uint16_t>& frame) {
+        int32_t header[7];
+        uint32_t tokenCount = 0;
+        if (!ReadPod(file, header)) return false;   // 正常结束
+        if (!ReadPod(file, tokenCount)) {
+            std::cerr << "[ErrorMap] Truncated view block in " << path << std::endl;
+            return false;
+        }
+
+        view.viewIndex = header[0];
+        FrameRegion& r = view.region;
+        r.frameWidth = header[1];
+        r.frameHeight = header[2];
+        r.x = header[3];
+        r.y = header[4];
+        r.width = header[5];
+        r.height = header[6];
+        if (r.frameWidth <= 0 || r.frameHeight <= 0 || r.frameWidth > kMaxFrameSize || r.frameHeight > kMaxFrameSize ||
+            static_cast<size_t>(r.frameWidth) * r.frameHeight > kMaxFramePixels || r.x < 0 || r.y < 0 || r.width < 0 || r.height < 0 || r.x > r.frameWidth - r.width || r.y > r.frameHeight - r.height) {
+            std::cerr << "[ErrorMap] Corrupt view header in " << path << std::endl;
+            return false;
+        }
+
+        // 令牌数不超过剩余字节，也不超过区域像素数的两倍 (全部为字面段时的上限)，否则不分配缓冲
+        const uint64_t paddedCount = static_cast<uint64_t>(tokenCount) + tokenCount % 2;
+        const uint64_t remaining = fileSize - std::min<uint64_t>(fileSize, static_cast<uint64_t>(file.tellg()));
+        if (paddedCount > remaining / sizeof(uint16_t) || tokenCount > 2 * static_cast<uint64_t>(r.PixelCount())) {
+            std::cerr << "[ErrorMap] Corrupt token count " << tokenCount << " for view " << view.viewIndex << " in " << path << std::endl;
+            return false;
+        }
+
+        tokens.resize(static_cast<size_t>(paddedCount));
+        if (!file.read(reinterpret_cast<char*>(tokens.data()), static_cast<std::streamsize>(tokens.size() * sizeof(uint16_t)))) {
+            std::cerr << "[ErrorMap] Truncated view data in " << path << std::endl;
+            return false;
+        }
+
+        frame.assign(static_cast<size_t>(r.frameWidth) * r.frameHeight, ERROR_MAP_BACKGROUND);
+        const size_t total = r.PixelCount();
+        size_t pixel = 0, t = 0;
+        auto put = [&](uint16_t v) {
+            const size_t row = pixel / r.width, col = pixel % r.width;
+            frame[(static_cast<size_t>(r.y) + row) * static_cast<size_t>(r.frameWidth) + static_cast<size_t>(r.x) + col] = v;
+            pixel++;
+        };
+        while (t < tokenCount && pixel < total) {
+            const uint16_t token = tokens[t++];
+            const size_t n = token & kMaxSegment;
+            if (token & kRunFlag) {
+                if (t >= tokenCount) break;
+                const uint16_t v = tokens[t++];
+                for (size_t k = 0; k < n && pixel < total; ++k) put(v);
+            } else {
+                for (size_t k = 0; k < n && t < tokenCount && pixel < total; ++k) put(tokens[t++]);
+            }
+        }
+        if (pixel != total) {
+            std::cerr << "[ErrorMap] View " << view.viewIndex << " decodes to " << pixel << " of " << total << " pixels in " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "ImageView.h"
+
+namespace Metrics {
+
+    /**
+     * @brief 逐像素误差图容器 (.vmerr)
+     * 每个模型的每个阶段一个文件，视角按评估顺序追加；离线工具据此重新生成热力图与图例，无需 GPU 与模型。
+     * 文件布局 (little-endian):
+     *   文件头 (32 字节):
+     *     char    magic[8]         "VMERR001"
+     *     uint32  version          1
+     *     float   errorMultiplier  运行时的热力图倍率 (热力图值 = 误差 * 倍率)
+     *     uint32  phaseLength      阶段名字节数 (PSNR / SSIM / FLIP / Normal / Silhouette)
+     *     uint32  reserved[3]
+     *     char    phase[phaseLength]，补齐到 4 字节
+     *   视角块 (重复至文件末尾):
+     *     int32   viewIndex        视角原始编号
+     *     int32   frameWidth, frameHeight
+     *     int32   x, y, width, height   评估区域 (GL 坐标，原点在左下角；未裁剪时为整幅画面)
+     *     uint32  tokenCount       之后的 uint16 个数
+     *     uint16  tokens[tokenCount]: 区域内像素按行 (自底向上) 的 half 误差值，游程编码:
+     *       令牌最高位为 1: 重复段，低 15 位为长度 n (1..32767)，后跟 1 个值
+     *       令牌最高位为 0: 字面段，低 15 位为长度 n，后跟 n 个值
+     *     (tokenCount 为奇数时补 1 个 uint16，块保持 4 字节对齐)
+     * 区域外的像素与值为 ERROR_MAP_BACKGROUND 的像素均为背景。
+     */
+    struct ErrorMapView {
+        int viewIndex = 0;
+        FrameRegion region;
+    };
+
+    class ErrorMapWriter {
+    public:
+        // 截断并写入文件头；失败时输出错误信息并返回 false (之后的 Append 不生效)
+        bool Open(const std::string& path, const std::string& phase, float errorMultiplier);
+        void Close();
+        bool IsOpen() const { return file.is_open(); }
+        const std::string& Path() const { return path; }
+
+        // error: 区域大小的 R16F 误差图 (行序与 region 一致)
+        void Append(int viewIndex, const FrameRegion& region, const ImageView& error);
+
+        uint64_t BytesWritten() const { return bytesWritten; }
+        uint64_t RawBytes() const { return rawBytes; }   // 未编码时的 half 字节数 (统计压缩率)
+
+    private:
+        std::ofstream file;
+        std::string path;
+        std::vector<uint16_t> tokens;   // 编码缓冲，跨视角复用
+        uint64_t bytesWritten = 0;
+        uint64_t rawBytes = 0;
+    };
+
+    class ErrorMapReader {
+    public:
+        bool Open(const std::string& path);
+        const std::string& Phase() const { return phase; }
+        float ErrorMultiplier() const { return errorMultiplier; }
+
+        // 读取下一个视角并展开为整幅画面 (frameWidth * frameHeight 个 half，区域外填 ERROR_MAP_BACKGROUND)
+        // 文件结束或数据损坏时返回 false (损坏的尺寸与令牌数在分配内存之前拒绝)
+        bool Next(ErrorMapView& view, std::vector<uint16_t>& frame);
+
+    private:
+        std::ifstream file;
+        std::string path;
+        uint64_t fileSize = 0;
+        std::string phase;
+        float errorMultiplier = 1.0f;
+        std::vector<uint16_t> tokens;
+    };
+}
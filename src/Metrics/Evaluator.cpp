@@ -1,33 +1,34 @@
 #include "Evaluator.h"
+#include "SimdKernels.h"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
 
 namespace Metrics {
 
-    std::pair<double, double> Evaluator::ComputePSNR(
-            const std::vector<unsigned char>& img1,
-            const std::vector<unsigned char>& img2,
-            int width, int height
-    ) {
-        (void)width;
-        (void)height;
-
-        if (img1.size() != img2.size()) {
+    std::pair<double, double> Evaluator::ComputePSNR(const ImageView& img1, const ImageView& img2) {
+        if (img1.PixelCount() == 0 || img2.PixelCount() == 0) {
+            std::cerr << "[Metric] Error: Empty image for PSNR!" << std::endl;
+            return {0.0, 0.0};
+        }
+        if (!img1.SameShape(img2)) {
             std::cerr << "[Metric] Error: Image sizes do not match for PSNR!" << std::endl;
             return {0.0, 0.0};
         }
 
-        double sumSqDiff = 0.0;
-        size_t totalPixels = img1.size();
-
-        for (size_t i = 0; i < totalPixels; ++i) {
-            double v1 = static_cast<double>(img1[i]);
-            double v2 = static_cast<double>(img2[i]);
-
-            double diff = v1 - v2;
-            sumSqDiff += diff * diff;
+        // 整数精确累加 (SIMD 分发)，结果与逐像素 double 累加完全一致
+        // 紧密排列时整幅图一次处理，否则逐行处理
+        size_t rowBytes = img1.width * BytesPerPixel(img1.format);
+        uint64_t sum = 0;
+        if (img1.IsContiguous() && img2.IsContiguous()) {
+            sum = Simd::SumSquaredDiffU8(img1.Row<uint8_t>(0), img2.Row<uint8_t>(0), rowBytes * img1.height);
+        } else {
+            for (int y = 0; y < img1.height; ++y) {
+                sum += Simd::SumSquaredDiffU8(img1.Row<uint8_t>(y), img2.Row<uint8_t>(y), rowBytes);
+            }
         }
+        double sumSqDiff = static_cast<double>(sum);
+        size_t totalPixels = rowBytes * img1.height;
 
         double mse = sumSqDiff / (double)totalPixels;
 
@@ -39,45 +40,25 @@ namespace Metrics {
         return {mse, psnr};
     }
 
-    double Evaluator::ComputeNormalError(
-            const std::vector<float>& nMap1,
-            const std::vector<float>& nMap2,
-            int width, int height
-    ) {
-        (void)width;
-        (void)height;
-
-        if (nMap1.size() != nMap2.size()) {
+    double Evaluator::ComputeNormalError(const ImageView& nMap1, const ImageView& nMap2) {
+        if (!nMap1.SameShape(nMap2) || nMap1.format != PixelFormat::RGB32F) {
             std::cerr << "[Metric] Error: Normal map sizes do not match!" << std::endl;
             return 0.0;
         }
 
-        double sumSqDiff = 0.0;
+        // 由于 shader 中法线执行了 N*0.5+0.5，一个合法的几何法线转换后不可能出现绝对的(0,0,0)
+        // 所以，出现 0,0,0 一定是我们刚刚在 glClearBufferfv 中强制刷新的背景。背景不计入有效像素，防止拉低均值。
+        // (背景差值恒为 0，因此平方差和可以直接在整张图上累加)
         size_t validPixels = 0;
-        size_t totalPixels = nMap1.size() / 3;
-
-        for (size_t i = 0; i < totalPixels; ++i) {
-            float r1 = nMap1[i * 3 + 0];
-            float g1 = nMap1[i * 3 + 1];
-            float b1 = nMap1[i * 3 + 2];
-
-            float r2 = nMap2[i * 3 + 0];
-            float g2 = nMap2[i * 3 + 1];
-            float b2 = nMap2[i * 3 + 2];
-
-            // 【修改点】由于 shader 中法线执行了 N*0.5+0.5，一个合法的几何法线转换后不可能出现绝对的(0,0,0)
-            // 所以，出现 0,0,0 一定是我们刚刚在 glClearBufferfv 中强制刷新的背景。跳过它，防止背景拉低均值。
-            if (r1 == 0.0f && g1 == 0.0f && b1 == 0.0f &&
-                r2 == 0.0f && g2 == 0.0f && b2 == 0.0f) {
-                continue;
+        double sumSqDiff = 0.0;
+        if (nMap1.IsContiguous() && nMap2.IsContiguous()) {
+            sumSqDiff = Simd::NormalSquaredDiff(nMap1.Row<float>(0), nMap2.Row<float>(0), nMap1.PixelCount(), validPixels);
+        } else {
+            for (int y = 0; y < nMap1.height; ++y) {
+                size_t rowValid = 0;
+                sumSqDiff += Simd::NormalSquaredDiff(nMap1.Row<float>(y), nMap2.Row<float>(y), nMap1.width, rowValid);
+                validPixels += rowValid;
             }
-
-            double dr = static_cast<double>(r1 - r2);
-            double dg = static_cast<double>(g1 - g2);
-            double db = static_cast<double>(b1 - b2);
-
-            sumSqDiff += (dr*dr + dg*dg + db*db);
-            validPixels++;
         }
 
         if (validPixels == 0) return 0.0;
@@ -86,25 +67,74 @@ namespace Metrics {
         return sumSqDiff / (static_cast<double>(validPixels) * 3.0);
     }
 
-    double Evaluator::ComputeSilhouetteError(
-            const std::vector<unsigned char>& sil1,
-            const std::vector<unsigned char>& sil2,
-            int width, int height
-    ) {
-        (void)width;
-        (void)height;
+    double Evaluator::ComputeSilhouetteError(const ImageView& sil1, const ImageView& sil2) {
+        if (!sil1.SameShape(sil2) || sil1.format != PixelFormat::R8 || sil1.PixelCount() == 0) return 0.0;
+
+        // 二值差的平方即不一致像素数
+        size_t mismatches = 0;
+        if (sil1.IsContiguous() && sil2.IsContiguous()) {
+            mismatches = Simd::CountMaskMismatch(sil1.Row<uint8_t>(0), sil2.Row<uint8_t>(0), sil1.PixelCount());
+        } else {
+            for (int y = 0; y < sil1.height; ++y) {
+                mismatches += Simd::CountMaskMismatch(sil1.Row<uint8_t>(y), sil2.Row<uint8_t>(y), sil1.width);
+            }
+        }
 
-        if (sil1.size() != sil2.size()) return 0.0;
+        return static_cast<double>(mismatches) / (double)sil1.PixelCount();
+    }
 
-        double sumSqDiff = 0.0;
-        for (size_t i = 0; i < sil1.size(); ++i) {
-            double v1 = (sil1[i] > 0) ? 1.0 : 0.0;
-            double v2 = (sil2[i] > 0) ? 1.0 : 0.0;
-            double diff = std::abs(v1 - v2);
-            sumSqDiff += diff * diff;
+    void Evaluator::PackSilhouette(const ImageView& sil, PackedMask& out) {
+        out.pixelCount = sil.PixelCount();
+        out.words.assign((out.pixelCount + 63) / 64, 0);
+        if (sil.IsContiguous()) {
+            Simd::PackMask(sil.Row<uint8_t>(0), out.pixelCount, out.words.data());
+            return;
+        }
+        // 行间有填充时逐像素写入连续的位流
+        size_t bit = 0;
+        for (int y = 0; y < sil.height; ++y) {
+            const uint8_t* row = sil.Row<uint8_t>(y);
+            for (int x = 0; x < sil.width; ++x, ++bit) {
+                if (row[x] > 0) out.words[bit >> 6] |= (uint64_t(1) << (bit & 63));
+            }
         }
+    }
+
+    double Evaluator::ComputeSilhouetteError(const PackedMask& sil1, const PackedMask& sil2) {
+        if (sil1.pixelCount != sil2.pixelCount || sil1.pixelCount == 0) return 0.0;
+
+        // 末尾多余的位两侧均为 0，不影响计数
+        double mismatches = static_cast<double>(Simd::CountBitMismatch(sil1.words.data(), sil2.words.data(), sil1.words.size()));
+        return mismatches / static_cast<double>(sil1.pixelCount);
+    }
 
-        return sumSqDiff / (double)sil1.size();
+    void Evaluator::BuildCoverage(const ImageView& depth, CoverageMask& out) {
+        out.Resize(depth.width, depth.height);
+        for (int y = 0; y < depth.height; ++y) {
+            const float* row = depth.Row<float>(y);
+            uint32_t* dst = &out.words[static_cast<size_t>(y) * out.rowWords];
+            for (int x = 0; x < depth.width; ++x) {
+                if (row[x] < 0.9999f) dst[x >> 5] |= (1u << (x & 31));
+            }
+        }
+    }
+
+    void Evaluator::Downsample2x(const ImageView& src, std::vector<unsigned char>& out) {
+        const int channels = static_cast<int>(BytesPerPixel(src.format));
+        const int w = src.width / 2, h = src.height / 2;
+        out.resize(static_cast<size_t>(w) * h * channels);
+        for (int y = 0; y < h; ++y) {
+            const uint8_t* r0 = src.Row<uint8_t>(2 * y);
+            const uint8_t* r1 = src.Row<uint8_t>(2 * y + 1);
+            unsigned char* dst = &out[static_cast<size_t>(y) * w * channels];
+            for (int x = 0; x < w; ++x) {
+                const int i = 2 * x * channels;
+                for (int c = 0; c < channels; ++c) {
+                    int sum = r0[i + c] + r0[i + channels + c] + r1[i + c] + r1[i + channels + c];
+                    dst[x * channels + c] = static_cast<unsigned char>((sum + 2) >> 2);
+                }
+            }
+        }
     }
 
     void Evaluator::ValueToColor(float value, unsigned char& r, unsigned char& g, unsigned char& b) {
@@ -141,97 +171,198 @@ namespace Metrics {
         b = static_cast<unsigned char>(floatB * 255.0f);
     }
 
-    std::vector<unsigned char> Evaluator::GenerateHeatmap(
-            const std::vector<unsigned char>& refBytes,
-            const std::vector<float>& refFloats,
-            const std::vector<unsigned char>& optBytes,
-            const std::vector<float>& optFloats,
-            int width, int height,
-            int mode,
-            unsigned char bgR, unsigned char bgG, unsigned char bgB,
-            float errorMultiplier
-    ) {
-        std::vector<unsigned char> heatmap(width * height * 4);
-
-        for (int i = 0; i < width * height; ++i) {
-            bool isBackground = false;
-
-            if (mode == 1) { // Normal
-                if (refFloats[i*3] == 0.0f && refFloats[i*3+1] == 0.0f && refFloats[i*3+2] == 0.0f &&
-                    optFloats[i*3] == 0.0f && optFloats[i*3+1] == 0.0f && optFloats[i*3+2] == 0.0f) {
-                    isBackground = true;
+    const unsigned char* Evaluator::HeatmapLUT(HeatmapPalette palette) {
+        auto build = [](HeatmapPalette p) {
+            std::vector<unsigned char> table(HEATMAP_LUT_SIZE * 3);
+            for (int i = 0; i < HEATMAP_LUT_SIZE; ++i) {
+                float value = static_cast<float>(i) / static_cast<float>(HEATMAP_LUT_SIZE - 1);
+                unsigned char* c = &table[i * 3];
+                if (p == HeatmapPalette::Gray) {
+                    c[0] = c[1] = c[2] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+                }
+                else if (p == HeatmapPalette::Viridis) {
+                    // 6 次多项式拟合 (https://www.shadertoy.com/view/WlfXRN)
+                    const glm::vec3 k[7] = {
+                        { 0.2777273272234177f, 0.005407344544966578f, 0.3340998053353061f },
+                        { 0.1050930431085774f, 1.404613529898575f, 1.384590162594685f },
+                        { -0.3308618287255563f, 0.214847559468213f, 0.09509516302823659f },
+                        { -4.634230498983486f, -5.799100973351585f, -19.33244095627987f },
+                        { 6.228269936347081f, 14.17993336680509f, 56.69055260068105f },
+                        { 4.776384997670288f, -13.74514537774601f, -65.35303263337234f },
+                        { -5.435455855934631f, 4.645852612178535f, 26.3124352495832f }
+                    };
+                    glm::vec3 color = k[6];
+                    for (int j = 5; j >= 0; --j) color = k[j] + value * color;
+                    color = glm::clamp(color, 0.0f, 1.0f);
+                    c[0] = static_cast<unsigned char>(color.r * 255.0f + 0.5f);
+                    c[1] = static_cast<unsigned char>(color.g * 255.0f + 0.5f);
+                    c[2] = static_cast<unsigned char>(color.b * 255.0f + 0.5f);
                 }
-            } else { // Color/Silhouette
-                bool refIsBlack = (refBytes[i*3] == 0 && refBytes[i*3+1] == 0 && refBytes[i*3+2] == 0);
-                bool optIsBlack = (optBytes[i*3] == 0 && optBytes[i*3+1] == 0 && optBytes[i*3+2] == 0);
+                else {
+                    ValueToColor(value, c[0], c[1], c[2]);
+                }
+            }
+            return table;
+        };
+        static const std::vector<unsigned char> luts[3] = {
+            build(HeatmapPalette::Default), build(HeatmapPalette::Gray), build(HeatmapPalette::Viridis)
+        };
+        return luts[static_cast<int>(palette)].data();
+    }
 
-                if (refIsBlack && optIsBlack) {
-                    isBackground = true;
+    void Evaluator::RenderLegend(const unsigned char* lut, const std::string& topText, const std::string& midText,
+                                 const std::string& bottomText, std::vector<unsigned char>& pixels) {
+        const int legW = LEGEND_WIDTH;  // 拓宽图像以容纳文字
+        const int legH = LEGEND_HEIGHT;
+        const int barW = 40;            // 左侧颜色条的宽度
+
+        // 初始化背景为暗灰色 (RGB: 40,40,40)，使白色文字和高对比度热力图更加清晰
+        pixels.assign(static_cast<size_t>(legW) * legH * 3, 40);
+
+        // 【黑科技】内置 3x5 像素的点阵字体，支持数字 0-9 和小数点
+        const char* font[11] = {
+                "111101101101111", // 0
+                "010110010010111", // 1
+                "111001111100111", // 2
+                "111001111001111", // 3
+                "101101111001001", // 4
+                "111100111001111", // 5
+                "111100111101111", // 6
+                "111001010010010", // 7
+                "111101111101111", // 8
+                "111101111001111", // 9
+                "000000000000010"  // .
+        };
+
+        // 绘制文字的 Lambda 闭包
+        auto drawText = [&](int startX, int startY, const std::string& text, int scale) {
+            for (char c : text) {
+                int idx = -1;
+                if (c >= '0' && c <= '9') idx = c - '0';
+                else if (c == '.') idx = 10;
+
+                if (idx >= 0) {
+                    const char* bitmap = font[idx];
+                    for (int py = 0; py < 5; ++py) {
+                        for (int px = 0; px < 3; ++px) {
+                            if (bitmap[py * 3 + px] != '1') continue;
+                            // 放大像素点
+                            for (int sy = 0; sy < scale; ++sy) {
+                                for (int sx = 0; sx < scale; ++sx) {
+                                    int drawX = startX + px * scale + sx;
+                                    int drawY = startY + py * scale + sy;
+                                    if (drawX >= 0 && drawX < legW && drawY >= 0 && drawY < legH) {
+                                        int pIdx = (drawY * legW + drawX) * 3;
+                                        pixels[pIdx + 0] = 255; // 文字颜色：纯白
+                                        pixels[pIdx + 1] = 255;
+                                        pixels[pIdx + 2] = 255;
+                                    }
+                                }
+                            }
+                        }
+                    }
                 }
+                // 移动光标，准备画下一个字符 (字符宽 3 + 间距 1 = 4)
+                startX += 4 * scale;
             }
+        };
 
-            if (isBackground) {
-                heatmap[i * 4 + 0] = bgR;
-                heatmap[i * 4 + 1] = bgG;
-                heatmap[i * 4 + 2] = bgB;
-                heatmap[i * 4 + 3] = 255;
-                continue;
+        // 1. 绘制左侧的颜色渐变条 (与热力图同一查找表)
+        for (int y = 0; y < legH; ++y) {
+            float value = 1.0f - static_cast<float>(y) / static_cast<float>(legH - 1);
+            unsigned char rgba[4];
+            HeatmapColor(lut, value, rgba);
+            for (int x = 0; x < barW; ++x) {
+                int idx = (y * legW + x) * 3;
+                pixels[idx + 0] = rgba[0];
+                pixels[idx + 1] = rgba[1];
+                pixels[idx + 2] = rgba[2];
             }
+        }
 
-            float diff = 0.0f;
+        // 2. 绘制右侧的数值标签
+        int textX = barW + 15;
+        int textScale = 3;  // 字体放大倍数
+        int charH = 5 * textScale;
 
-            if (mode == 0) { // Color / PSNR
-                float r1 = refBytes[i * 3 + 0] / 255.0f;
-                float g1 = refBytes[i * 3 + 1] / 255.0f;
-                float b1 = refBytes[i * 3 + 2] / 255.0f;
+        drawText(textX, 10, topText, textScale);                              // 顶部 (最大误差)
+        drawText(textX, (legH - charH) / 2, midText, textScale);              // 中部
+        drawText(textX, legH - 10 - charH, bottomText, textScale);            // 底部 (最小误差)
+    }
 
-                float r2 = optBytes[i * 3 + 0] / 255.0f;
-                float g2 = optBytes[i * 3 + 1] / 255.0f;
-                float b2 = optBytes[i * 3 + 2] / 255.0f;
+    void Evaluator::GenerateHeatmap(
+            const ImageView& ref,
+            const ImageView& opt,
+            int mode,
+            const MutableImageView& heatmap,
+            Color8 background,
+            float errorMultiplier
+    ) {
+        if (!ref.SameShape(opt) || heatmap.width != ref.width || heatmap.height != ref.height) {
+            std::cerr << "[Metric] Error: Heatmap sizes do not match!" << std::endl;
+            return;
+        }
 
-                float dr = r1 - r2;
-                float dg = g1 - g2;
-                float db = b1 - b2;
+        const unsigned char* lut = HeatmapLUT();
+        const int channels = ChannelCount(ref.format);
 
-                diff = std::sqrt(dr*dr + dg*dg + db*db);
-                diff *= errorMultiplier;
-            }
-            else if (mode == 1) { // Normal
-                float n1x = refFloats[i * 3 + 0];
-                float n1y = refFloats[i * 3 + 1];
-                float n1z = refFloats[i * 3 + 2];
+        for (int y = 0; y < ref.height; ++y) {
+            unsigned char* dst = heatmap.Row<unsigned char>(y);
 
-                float n2x = optFloats[i * 3 + 0];
-                float n2y = optFloats[i * 3 + 1];
-                float n2z = optFloats[i * 3 + 2];
+            for (int x = 0; x < ref.width; ++x) {
+                unsigned char* px = dst + x * 4;
+                float diff = 0.0f;
 
-                auto toNormal = [](float v) { return v * 2.0f - 1.0f; };
+                if (mode == 1) { // Normal
+                    const float* n1 = ref.Row<float>(y) + x * 3;
+                    const float* n2 = opt.Row<float>(y) + x * 3;
 
-                // 还原至 [-1, 1]
-                float nx1 = toNormal(n1x), ny1 = toNormal(n1y), nz1 = toNormal(n1z);
-                float nx2 = toNormal(n2x), ny2 = toNormal(n2y), nz2 = toNormal(n2z);
+                    if (n1[0] == 0.0f && n1[1] == 0.0f && n1[2] == 0.0f &&
+                        n2[0] == 0.0f && n2[1] == 0.0f && n2[2] == 0.0f) {
+                        px[0] = background.r; px[1] = background.g; px[2] = background.b; px[3] = 255;
+                        continue;
+                    }
 
-                float dot = nx1 * nx2 + ny1 * ny2 + nz1 * nz2;
-                dot = std::max(-1.0f, std::min(1.0f, dot));
+                    auto toNormal = [](float v) { return v * 2.0f - 1.0f; };
 
-                // 映射到 [0, 1] 区间。(1 - dot)/2，完全一致为0，完全相反为1
-                diff = (1.0f - dot) / 2.0f;
-            }
-            else if (mode == 2) { // Silhouette
-                float v1 = refBytes[i * 3 + 0] / 255.0f;
-                float v2 = optBytes[i * 3 + 0] / 255.0f;
-                diff = std::abs(v1 - v2);
-            }
+                    // 还原至 [-1, 1]
+                    float dot = toNormal(n1[0]) * toNormal(n2[0]) +
+                                toNormal(n1[1]) * toNormal(n2[1]) +
+                                toNormal(n1[2]) * toNormal(n2[2]);
+                    dot = std::max(-1.0f, std::min(1.0f, dot));
 
-            unsigned char r, g, b;
-            ValueToColor(diff, r, g, b);
+                    // 映射到 [0, 1] 区间。(1 - dot)/2，完全一致为0，完全相反为1
+                    diff = (1.0f - dot) / 2.0f;
+                }
+                else { // Color / Silhouette
+                    const unsigned char* p1 = ref.Row<unsigned char>(y) + x * channels;
+                    const unsigned char* p2 = opt.Row<unsigned char>(y) + x * channels;
+
+                    bool refIsBlack = true, optIsBlack = true;
+                    for (int c = 0; c < std::min(channels, 3); ++c) {
+                        refIsBlack = refIsBlack && p1[c] == 0;
+                        optIsBlack = optIsBlack && p2[c] == 0;
+                    }
+                    if (refIsBlack && optIsBlack) {
+                        px[0] = background.r; px[1] = background.g; px[2] = background.b; px[3] = 255;
+                        continue;
+                    }
+
+                    if (mode == 0) { // Color / PSNR
+                        float dr = p1[0] / 255.0f - p2[0] / 255.0f;
+                        float dg = p1[1] / 255.0f - p2[1] / 255.0f;
+                        float db = p1[2] / 255.0f - p2[2] / 255.0f;
+
+                        diff = std::sqrt(dr*dr + dg*dg + db*db);
+                        diff *= errorMultiplier;
+                    }
+                    else { // Silhouette
+                        diff = std::abs(p1[0] / 255.0f - p2[0] / 255.0f);
+                    }
+                }
 
-            heatmap[i * 4 + 0] = r;
-            heatmap[i * 4 + 1] = g;
-            heatmap[i * 4 + 2] = b;
-            heatmap[i * 4 + 3] = 255;
+                HeatmapColor(lut, diff, px);
+            }
         }
-
-        return heatmap;
     }
-}
\ No newline at end of file
+}
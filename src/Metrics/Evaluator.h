@@ -1,4 +1,6 @@
 #pragma once
+#include "HeatmapPalette.h"
+#include "ImageView.h"
 
 namespace Metrics {
 
@@ -10,59 +12,120 @@ namespace Metrics {
         double mse_silhouette;// L_sil (轮廓误差)
     };
 
+    // 按位打包的二值掩码：第 i 个像素对应 words[i / 64] 的第 i % 64 位 (1 = 模型轮廓)
+    struct PackedMask {
+        size_t pixelCount = 0;
+        std::vector<uint64_t> words;
+
+        bool Test(size_t i) const { return ((words[i >> 6] >> (i & 63)) & 1u) != 0; }
+    };
+
+    // 覆盖掩码 (1 = 模型覆盖，0 = 背景)：每行按 32 像素打包为 uint32，行序与 GL 回读一致 (自下而上)
+    struct CoverageMask {
+        int width = 0;
+        int height = 0;
+        int rowWords = 0;
+        std::vector<uint32_t> words;
+
+        void Resize(int w, int h) {
+            width = w;
+            height = h;
+            rowWords = (w + 31) / 32;
+            words.assign(static_cast<size_t>(rowWords) * h, 0u);
+        }
+        const uint32_t* Row(int y) const { return &words[static_cast<size_t>(y) * rowWords]; }
+        bool Test(int x, int y) const { return ((Row(y)[x >> 5] >> (x & 31)) & 1u) != 0; }
+    };
+
     class Evaluator {
     public:
         /**
-         * @brief 计算两幅 RGB 图像 (uint8) 的 MSE 和 PSNR
-         * @param img1 参考图像数据
-         * @param img2 优化图像数据
+         * @brief 计算两幅图像 (uint8，任意通道数) 的 MSE 和 PSNR
+         * @param img1 参考图像视图 (R8/RG8/RGB8/RGBA8)
+         * @param img2 优化图像视图 (格式与尺寸须一致)
          * @return std::pair<mse, psnr>
          */
-        static std::pair<double, double> ComputePSNR(
-                const std::vector<unsigned char>& img1,
-                const std::vector<unsigned char>& img2,
-                int width, int height
-        );
+        static std::pair<double, double> ComputePSNR(const ImageView& img1, const ImageView& img2);
 
         /**
          * @brief 计算法线一致性误差 (MSE of Normal Maps)
-         * @param nMap1 参考法线数据 (float RGB)
-         * @param nMap2 优化法线数据
+         * @param nMap1 参考法线视图 (RGB32F)
+         * @param nMap2 优化法线视图
          */
-        static double ComputeNormalError(
-                const std::vector<float>& nMap1,
-                const std::vector<float>& nMap2,
-                int width, int height
-        );
+        static double ComputeNormalError(const ImageView& nMap1, const ImageView& nMap2);
 
         /**
          * @brief 计算轮廓误差 (MSE of Binary Silhouette Maps)
-         * @param sil1 参考轮廓图 (0 or 255)
-         * @param sil2 优化轮廓图
+         * @param sil1 参考轮廓图视图 (R8，0 or 255)
+         * @param sil2 优化轮廓图视图
          */
-        static double ComputeSilhouetteError(
-                const std::vector<unsigned char>& sil1,
-                const std::vector<unsigned char>& sil2,
-                int width, int height
-        );
+        static double ComputeSilhouetteError(const ImageView& sil1, const ImageView& sil2);
+
+        // 将单通道轮廓图视图 (R8，>0 为轮廓) 打包为按位掩码
+        static void PackSilhouette(const ImageView& sil, PackedMask& out);
 
-        // 成热力图数据 (返回 RGBA 字节流)
-        // mode: 0=Color(PSNR), 1=Normal, 2=Silhouette
-        static std::vector<unsigned char> GenerateHeatmap(
-                const std::vector<unsigned char>& refBytes,
-                const std::vector<float>& refFloats, // 法线需要浮点数据，不需要时传空
-                const std::vector<unsigned char>& optBytes,
-                const std::vector<float>& optFloats,
-                int width, int height,
+        /**
+         * @brief 计算打包轮廓的误差: popcount(a XOR b) / 像素数
+         */
+        static double ComputeSilhouetteError(const PackedMask& sil1, const PackedMask& sil2);
+
+        // 由深度图视图 (R32F) 生成覆盖掩码 (深度 >= 0.9999 视为背景)
+        static void BuildCoverage(const ImageView& depth, CoverageMask& out);
+
+        // 8bit 图像 2x2 盒式降采样 (奇数尺寸丢弃最后一行/列)，输出紧密排列、格式与输入相同
+        static void Downsample2x(const ImageView& src, std::vector<unsigned char>& out);
+
+        // 八面体编码 (RG16) -> 与 G-buffer 一致的 [0,1] 编码法线 (N*0.5+0.5)
+        static void DecodeOctNormal(uint16_t ox, uint16_t oy, float enc[3]) {
+            float x = ox / 65535.0f * 2.0f - 1.0f;
+            float y = oy / 65535.0f * 2.0f - 1.0f;
+            float z = 1.0f - std::abs(x) - std::abs(y);
+            if (z < 0.0f) {
+                float fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                float fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                x = fx;
+                y = fy;
+            }
+            float invLen = 1.0f / std::sqrt(x * x + y * y + z * z);
+            enc[0] = x * invLen * 0.5f + 0.5f;
+            enc[1] = y * invLen * 0.5f + 0.5f;
+            enc[2] = z * invLen * 0.5f + 0.5f;
+        }
+
+        // 生成热力图，写入调用方提供的 RGBA8 视图 (尺寸须与输入一致)
+        // mode: 0=Color(PSNR, RGB8), 1=Normal(RGB32F), 2=Silhouette(R8 或 RGB8)
+        static void GenerateHeatmap(
+                const ImageView& ref,
+                const ImageView& opt,
                 int mode,
-                unsigned char bgR = 0,
-                unsigned char bgG = 0,
-                unsigned char bgB = 0,
+                const MutableImageView& heatmap,
+                Color8 background = Color8(),
                 float errorMultiplier = 3.0f
         );
 
+        // 热力图颜色查找表：[0,1] 误差量化为 HEATMAP_LUT_SIZE 级，每级 3 字节 RGB (每个调色板首次使用时预计算)
+        static constexpr int HEATMAP_LUT_SIZE = 1024;
+        static const unsigned char* HeatmapLUT(HeatmapPalette palette = HeatmapPalette::Default);
+
+        // 绘制热力图图例 (LEGEND_WIDTH x LEGEND_HEIGHT，RGB8，自顶向下)：左侧为 lut 的渐变条，右侧为三个刻度标签
+        // 标签只支持数字与小数点
+        static constexpr int LEGEND_WIDTH = 120;
+        static constexpr int LEGEND_HEIGHT = 600;
+        static void RenderLegend(const unsigned char* lut, const std::string& topText, const std::string& midText,
+                                 const std::string& bottomText, std::vector<unsigned char>& pixels);
+
+        // 查表写出一个 RGBA 热力图像素 (value 自动钳制到 [0,1])
+        static void HeatmapColor(const unsigned char* lut, float value, unsigned char* rgba) {
+            value = std::max(0.0f, std::min(1.0f, value));
+            const unsigned char* c = lut + static_cast<int>(value * (HEATMAP_LUT_SIZE - 1) + 0.5f) * 3;
+            rgba[0] = c[0];
+            rgba[1] = c[1];
+            rgba[2] = c[2];
+            rgba[3] = 255;
+        }
+
     private:
-        // 热力图颜色映射 (Value 0.0-1.0 -> R,G,B)
+        // 热力图颜色映射 (Value 0.0-1.0 -> R,G,B)，仅用于构建查找表
         static void ValueToColor(float value, unsigned char& r, unsigned char& g, unsigned char& b);
     };
 }
\ No newline at end of file
@@ -0,0 +1,373 @@
+#include "FlipEvaluator.h"
+#include "SimdKernels.h"
+#include "Utils/ParallelUtils.h"
+
+namespace Metrics {
+
+    // 每个任务处理的行数 (固定值，保证部分和的合并顺序与线程数无关)
+    static const int ROWS_PER_BLOCK = 16;
+    // 水平滤波的输出平面: CSF (A, RG, BY1, BY2) + 特征 (高斯, 一阶导, 二阶导)
+    static const int CSF_PLANES = 4;
+    static const int HORIZONTAL_PLANES = CSF_PLANES + 3;
+    // 竖直滤波的累加行: CSF (A, RG, BY) + 特征 (边缘 x/y, 点 x/y)
+    static const int VERTICAL_ROWS = 3 + 4;
+    // 参考图保留的平面: Hunt 调整后的 Lab + 边缘/点强度
+    static const int REF_PLANES = 5;
+
+    static const double PI = 3.14159265358979323846;
+
+    // LDR-FLIP 参数
+    static const float QC = 0.7f;   // 颜色差的压缩指数
+    // 特征差的压缩指数 QF = 0.5，即开平方 (见 FilterImage)
+    static const float PC = 0.4f;   // 颜色差重分布的分段点
+    static const float PT = 0.95f;  // 分段点处的目标误差
+    static const double FEATURE_WIDTH = 0.082; // 人眼边缘检测滤波器的峰谷宽度 (度)
+
+    // 线性 sRGB <-> XYZ (D65)
+    static const float RGB_TO_XYZ[9] = {
+        0.41238656f, 0.35759149f, 0.18045049f,
+        0.21263682f, 0.71518298f, 0.07218020f,
+        0.01933062f, 0.11919716f, 0.95037259f
+    };
+    static const float XYZ_TO_RGB[9] = {
+         3.24100323f, -1.53739897f, -0.49861588f,
+        -0.96922425f,  1.87592998f,  0.04155423f,
+         0.05563942f, -0.20401121f,  1.05714898f
+    };
+    // 参考白 = 线性 RGB (1,1,1) 对应的 XYZ
+    static const float WHITE_X = 0.95042854f;
+    static const float WHITE_Y = 1.0f;
+    static const float WHITE_Z = 1.08890037f;
+
+    static int BlockCount(int height) {
+        return (height + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+    }
+
+    // 8bit sRGB -> 线性值
+    static const float* SrgbToLinearLUT() {
+        static float table[256];
+        static const bool initialized = [] {
+            for (int i = 0; i < 256; ++i) {
+                double c = i / 255.0;
+                table[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+            }
+            return true;
+        }();
+        (void)initialized;
+        return table;
+    }
+
+    // 立方根: 位运算给出初值，两次牛顿迭代后相对误差 < 1e-6 (t > 0)
+    // 每个像素需要 6 次立方根，std::cbrt 会成为整个指标的主要开销
+    static float FastCbrt(float t) {
+        uint32_t bits;
+        std::memcpy(&bits, &t, sizeof(bits));
+        bits = bits / 3 + 0x2a514067u;
+        float y;
+        std::memcpy(&y, &bits, sizeof(y));
+        y = (2.0f * y + t / (y * y)) * (1.0f / 3.0f);
+        y = (2.0f * y + t / (y * y)) * (1.0f / 3.0f);
+        return y;
+    }
+
+    static float LabF(float t) {
+        const float delta = 6.0f / 29.0f;
+        return t > delta * delta * delta ? FastCbrt(t) : t / (3.0f * delta * delta) + 4.0f / 29.0f;
+    }
+
+    // 线性 RGB (钳制到 [0,1]) -> Hunt 调整后的 L*a*b* (a, b 乘以 0.01 * L)
+    static void LinearRgbToHuntLab(float r, float g, float b, float& L, float& A, float& B) {
+        r = std::max(0.0f, std::min(1.0f, r));
+        g = std::max(0.0f, std::min(1.0f, g));
+        b = std::max(0.0f, std::min(1.0f, b));
+        float fx = LabF((RGB_TO_XYZ[0] * r + RGB_TO_XYZ[1] * g + RGB_TO_XYZ[2] * b) / WHITE_X);
+        float fy = LabF((RGB_TO_XYZ[3] * r + RGB_TO_XYZ[4] * g + RGB_TO_XYZ[5] * b) / WHITE_Y);
+        float fz = LabF((RGB_TO_XYZ[6] * r + RGB_TO_XYZ[7] * g + RGB_TO_XYZ[8] * b) / WHITE_Z);
+        L = 116.0f * fy - 16.0f;
+        A = 0.01f * L * (500.0f * (fx - fy));
+        B = 0.01f * L * (200.0f * (fy - fz));
+    }
+
+    // 滤波后的 YCxCz -> Hunt Lab
+    static void YcxczToHuntLab(float Y, float Cx, float Cz, float& L, float& A, float& B) {
+        float y = (Y + 16.0f) / 116.0f;
+        float X = (Cx / 500.0f + y) * WHITE_X;
+        float Z = (y - Cz / 200.0f) * WHITE_Z;
+        y *= WHITE_Y;
+        float r = XYZ_TO_RGB[0] * X + XYZ_TO_RGB[1] * y + XYZ_TO_RGB[2] * Z;
+        float g = XYZ_TO_RGB[3] * X + XYZ_TO_RGB[4] * y + XYZ_TO_RGB[5] * Z;
+        float b = XYZ_TO_RGB[6] * X + XYZ_TO_RGB[7] * y + XYZ_TO_RGB[8] * Z;
+        LinearRgbToHuntLab(r, g, b, L, A, B);
+    }
+
+    // 颜色差的归一化上限: 纯绿与纯蓝的 HyAB 距离 ^ QC
+    static float ColorDifferenceMax() {
+        static const float cmax = [] {
+            float gl, ga, gb, bl, ba, bb;
+            LinearRgbToHuntLab(0.0f, 1.0f, 0.0f, gl, ga, gb);
+            LinearRgbToHuntLab(0.0f, 0.0f, 1.0f, bl, ba, bb);
+            float hyab = std::abs(gl - bl) + std::sqrt((ga - ba) * (ga - ba) + (gb - bb) * (gb - bb));
+            return std::pow(hyab, QC);
+        }();
+        return cmax;
+    }
+
+    // 一维卷积: out[x] = Σ kernel[k] * src[x + k]，src 为已延拓的行 (起点对齐到 x - radius)
+    // 逐抽头对整行做向量化的乘加 (SIMD 分发)
+    static void Convolve(const float* src, const float* kernel, int taps, int width, float* out) {
+        std::fill(out, out + width, 0.0f);
+        for (int k = 0; k < taps; ++k) Simd::ScaledAdd(out, src + k, kernel[k], width);
+    }
+
+    // 竖直方向累加: acc[x] += Σ kernel[k] * plane[clamp(y + k - radius)][x]
+    static void AccumulateColumn(const float* plane, const float* kernel, int radius, int y, int w, int h, float weight, float* acc) {
+        for (int k = 0; k <= 2 * radius; ++k) {
+            int yi = std::max(0, std::min(h - 1, y + k - radius));
+            Simd::ScaledAdd(acc, plane + static_cast<size_t>(yi) * w, weight * kernel[k], w);
+        }
+    }
+
+    void FlipEvaluator::BuildKernels(float pixelsPerDegree) {
+        kernels.pixelsPerDegree = pixelsPerDegree;
+        const double ppd = pixelsPerDegree;
+
+        // 1. CSF: 各通道为高斯 (BY 为两个高斯之和)，参数取自 LDR-FLIP
+        //    g(x) = a1 * sqrt(π/b1) * exp(-π² x² / b1) + a2 * sqrt(π/b2) * exp(-π² x² / b2)，x 以度为单位
+        const double bA = 0.0047, bRG = 0.0053;
+        const double aBY1 = 34.1, bBY1 = 0.04, aBY2 = 13.5, bBY2 = 0.025;
+        const int r = static_cast<int>(std::ceil(3.0 * std::sqrt(bBY1 / (2.0 * PI * PI)) * ppd));
+        kernels.csfRadius = r;
+
+        auto gaussian = [&](double b, std::vector<float>& out) {
+            std::vector<double> weights(2 * r + 1);
+            double sum = 0.0;
+            for (int i = -r; i <= r; ++i) {
+                double d = i / ppd;
+                weights[i + r] = std::exp(-PI * PI * d * d / b);
+                sum += weights[i + r];
+            }
+            out.resize(weights.size());
+            for (size_t i = 0; i < weights.size(); ++i) out[i] = static_cast<float>(weights[i] / sum);
+            return sum;
+        };
+        gaussian(bA, kernels.achromatic);
+        gaussian(bRG, kernels.redGreen);
+        // 二维核 = c1 * G1(x)G1(y) + c2 * G2(x)G2(y)，整体归一化后拆成两个归一化可分离核的加权和
+        double s1 = gaussian(bBY1, kernels.blueYellow1);
+        double s2 = gaussian(bBY2, kernels.blueYellow2);
+        double c1 = aBY1 * std::sqrt(PI / bBY1) * s1 * s1;
+        double c2 = aBY2 * std::sqrt(PI / bBY2) * s2 * s2;
+        kernels.blueYellowWeight1 = static_cast<float>(c1 / (c1 + c2));
+        kernels.blueYellowWeight2 = static_cast<float>(c2 / (c1 + c2));
+
+        // 2. 特征检测: 高斯一阶/二阶导数，正负权重分别归一化为 +1 / -1
+        //    二维核 = 导数核(x) * 高斯(y)，符号只取决于 x，因此归一化后仍可分离
+        const double sd = 0.5 * FEATURE_WIDTH * ppd;
+        const int fr = static_cast<int>(std::ceil(3.0 * sd));
+        kernels.featureRadius = fr;
+        std::vector<double> g(2 * fr + 1), e(2 * fr + 1), p(2 * fr + 1);
+        double gSum = 0.0, ePos = 0.0, eNeg = 0.0, pPos = 0.0, pNeg = 0.0;
+        for (int i = -fr; i <= fr; ++i) {
+            double gi = std::exp(-(i * i) / (2.0 * sd * sd));
+            g[i + fr] = gi;
+            e[i + fr] = -i * gi;
+            p[i + fr] = (i * i / (sd * sd) - 1.0) * gi;
+            gSum += gi;
+            (e[i + fr] > 0.0 ? ePos : eNeg) += std::abs(e[i + fr]);
+            (p[i + fr] > 0.0 ? pPos : pNeg) += std::abs(p[i + fr]);
+        }
+        kernels.gaussian.resize(g.size());
+        kernels.edge.resize(g.size());
+        kernels.point.resize(g.size());
+        for (size_t i = 0; i < g.size(); ++i) {
+            kernels.gaussian[i] = static_cast<float>(g[i] / gSum);
+            kernels.edge[i] = static_cast<float>(e[i] / (e[i] > 0.0 ? ePos : eNeg));
+            kernels.point[i] = static_cast<float>(p[i] / (p[i] > 0.0 ? pPos : pNeg));
+        }
+    }
+
+    void FlipEvaluator::Reserve(int width, int height, float pixelsPerDegree) {
+        BuildKernels(pixelsPerDegree);
+        SrgbToLinearLUT();
+        ColorDifferenceMax();
+
+        size_t pixels = static_cast<size_t>(width) * height;
+        size_t blocks = static_cast<size_t>(BlockCount(height));
+        size_t pad = static_cast<size_t>(std::max(kernels.csfRadius, kernels.featureRadius));
+        horizontal.reserve(pixels * HORIZONTAL_PLANES);
+        refPlanes.reserve(pixels * REF_PLANES);
+        rowScratch.reserve(blocks * (3 * (width + 2 * pad) + VERTICAL_ROWS * width));
+        partialSums.reserve(blocks);
+        errorMap.reserve(pixels);
+    }
+
+    size_t FlipEvaluator::ReservedBytes() const {
+        return (horizontal.capacity() + refPlanes.capacity() + rowScratch.capacity() + errorMap.capacity()) * sizeof(float) +
+               partialSums.capacity() * sizeof(double);
+    }
+
+    int FlipEvaluator::FilterRadius(float pixelsPerDegree) {
+        if (kernels.pixelsPerDegree != pixelsPerDegree) BuildKernels(pixelsPerDegree);
+        return std::max(kernels.csfRadius, kernels.featureRadius);
+    }
+
+    double FlipEvaluator::Compute(const ImageView& ref, const ImageView& opt, float pixelsPerDegree, size_t backgroundPixels) {
+        const int width = ref.width;
+        const int height = ref.height;
+        const int channels = ChannelCount(ref.format);
+        if (!ref.SameShape(opt) || ref.PixelCount() == 0 || channels < 3 ||
+            ref.format == PixelFormat::RGB32F) {
+            std::cerr << "[Metric] Error: FLIP expects two RGB8/RGBA8 views of the same size!" << std::endl;
+            return 0.0;
+        }
+        if (kernels.pixelsPerDegree != pixelsPerDegree) BuildKernels(pixelsPerDegree);
+
+        const size_t pixels = ref.PixelCount();
+        const int blocks = BlockCount(height);
+        const int pad = std::max(kernels.csfRadius, kernels.featureRadius);
+        mapWidth = width;
+        mapHeight = height;
+        horizontal.resize(pixels * HORIZONTAL_PLANES);
+        refPlanes.resize(pixels * REF_PLANES);
+        rowScratch.resize(static_cast<size_t>(blocks) * (3 * (width + 2 * pad) + VERTICAL_ROWS * width));
+        partialSums.assign(blocks, 0.0);
+        errorMap.resize(pixels);
+
+        // 先处理参考图并保留其 Lab/特征，再处理优化图并逐像素比较
+        FilterImage(ref, refPlanes.data(), refPlanes.data() + 3 * pixels, nullptr, nullptr, nullptr);
+        FilterImage(opt, nullptr, nullptr, refPlanes.data(), refPlanes.data() + 3 * pixels, partialSums.data());
+
+        double sum = 0.0;
+        for (int b = 0; b < blocks; ++b) sum += partialSums[b];
+        return sum / static_cast<double>(pixels + backgroundPixels);
+    }
+
+    void FlipEvaluator::FilterImage(const ImageView& image, float* lab, float* features,
+                                    const float* compareLab, const float* compareFeatures, double* blockSums) {
+        const int w = mapWidth;
+        const int h = mapHeight;
+        const size_t plane = static_cast<size_t>(w) * h;
+        const int blocks = BlockCount(h);
+        const int channels = ChannelCount(image.format);
+        const int pad = std::max(kernels.csfRadius, kernels.featureRadius);
+        const size_t paddedWidth = static_cast<size_t>(w) + 2 * pad;
+        const size_t scratchPerBlock = 3 * paddedWidth + static_cast<size_t>(VERTICAL_ROWS) * w;
+        const float* toLinear = SrgbToLinearLUT();
+        const Kernels& k = kernels;
+
+        // 1. 水平滤波: 逐行转换到 YCxCz 并延拓边缘，再对每个平面做一维卷积
+        Utils::ParallelFor(static_cast<size_t>(blocks), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(h, yBegin + ROWS_PER_BLOCK);
+            float* padY = &rowScratch[block * scratchPerBlock];
+            float* padCx = padY + paddedWidth;
+            float* padCz = padCx + paddedWidth;
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                const unsigned char* src = image.Row<unsigned char>(y);
+                for (int x = 0; x < w; ++x) {
+                    const unsigned char* px = src + x * channels;
+                    float r = toLinear[px[0]], g = toLinear[px[1]], b = toLinear[px[2]];
+                    float X = (RGB_TO_XYZ[0] * r + RGB_TO_XYZ[1] * g + RGB_TO_XYZ[2] * b) / WHITE_X;
+                    float Y = (RGB_TO_XYZ[3] * r + RGB_TO_XYZ[4] * g + RGB_TO_XYZ[5] * b) / WHITE_Y;
+                    float Z = (RGB_TO_XYZ[6] * r + RGB_TO_XYZ[7] * g + RGB_TO_XYZ[8] * b) / WHITE_Z;
+                    padY[pad + x] = 116.0f * Y - 16.0f;
+                    padCx[pad + x] = 500.0f * (X - Y);
+                    padCz[pad + x] = 200.0f * (Y - Z);
+                }
+                for (float* row : { padY, padCx, padCz }) {
+                    std::fill(row, row + pad, row[pad]);
+                    std::fill(row + pad + w, row + paddedWidth, row[pad + w - 1]);
+                }
+
+                const size_t offset = static_cast<size_t>(y) * w;
+                const int csfShift = pad - k.csfRadius;
+                const int csfTaps = 2 * k.csfRadius + 1;
+                Convolve(padY + csfShift, k.achromatic.data(), csfTaps, w, &horizontal[0 * plane + offset]);
+                Convolve(padCx + csfShift, k.redGreen.data(), csfTaps, w, &horizontal[1 * plane + offset]);
+                Convolve(padCz + csfShift, k.blueYellow1.data(), csfTaps, w, &horizontal[2 * plane + offset]);
+                Convolve(padCz + csfShift, k.blueYellow2.data(), csfTaps, w, &horizontal[3 * plane + offset]);
+
+                // 特征检测使用 (Y + 16) / 116；导数核的权重和为 0，常数偏移不影响结果，统一在竖直滤波后除以 116
+                const int featureShift = pad - k.featureRadius;
+                const int featureTaps = 2 * k.featureRadius + 1;
+                Convolve(padY + featureShift, k.gaussian.data(), featureTaps, w, &horizontal[(CSF_PLANES + 0) * plane + offset]);
+                Convolve(padY + featureShift, k.edge.data(), featureTaps, w, &horizontal[(CSF_PLANES + 1) * plane + offset]);
+                Convolve(padY + featureShift, k.point.data(), featureTaps, w, &horizontal[(CSF_PLANES + 2) * plane + offset]);
+            }
+        });
+
+        // 2. 竖直滤波 (按行累加，内层循环连续访问) + 逐像素转换 / 比较
+        const float* hA = &horizontal[0 * plane];
+        const float* hRG = &horizontal[1 * plane];
+        const float* hBY1 = &horizontal[2 * plane];
+        const float* hBY2 = &horizontal[3 * plane];
+        const float* hGauss = &horizontal[(CSF_PLANES + 0) * plane];
+        const float* hEdge = &horizontal[(CSF_PLANES + 1) * plane];
+        const float* hPoint = &horizontal[(CSF_PLANES + 2) * plane];
+        const float cmax = ColorDifferenceMax();
+        const float featureScale = 1.0f / 116.0f;
+
+        Utils::ParallelFor(static_cast<size_t>(blocks), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(h, yBegin + ROWS_PER_BLOCK);
+            float* acc = &rowScratch[block * scratchPerBlock + 3 * paddedWidth];
+            float* accY = acc;
+            float* accCx = acc + w;
+            float* accCz = acc + 2 * w;
+            float* edgeX = acc + 3 * w;
+            float* edgeY = acc + 4 * w;
+            float* pointX = acc + 5 * w;
+            float* pointY = acc + 6 * w;
+            double sum = 0.0;
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                std::fill(acc, acc + static_cast<size_t>(VERTICAL_ROWS) * w, 0.0f);
+                AccumulateColumn(hA, k.achromatic.data(), k.csfRadius, y, w, h, 1.0f, accY);
+                AccumulateColumn(hRG, k.redGreen.data(), k.csfRadius, y, w, h, 1.0f, accCx);
+                AccumulateColumn(hBY1, k.blueYellow1.data(), k.csfRadius, y, w, h, k.blueYellowWeight1, accCz);
+                AccumulateColumn(hBY2, k.blueYellow2.data(), k.csfRadius, y, w, h, k.blueYellowWeight2, accCz);
+                AccumulateColumn(hEdge, k.gaussian.data(), k.featureRadius, y, w, h, 1.0f, edgeX);
+                AccumulateColumn(hGauss, k.edge.data(), k.featureRadius, y, w, h, 1.0f, edgeY);
+                AccumulateColumn(hPoint, k.gaussian.data(), k.featureRadius, y, w, h, 1.0f, pointX);
+                AccumulateColumn(hGauss, k.point.data(), k.featureRadius, y, w, h, 1.0f, pointY);
+
+                const size_t offset = static_cast<size_t>(y) * w;
+                for (int x = 0; x < w; ++x) {
+                    float L, A, B;
+                    YcxczToHuntLab(accY[x], accCx[x], accCz[x], L, A, B);
+                    float edge = featureScale * std::sqrt(edgeX[x] * edgeX[x] + edgeY[x] * edgeY[x]);
+                    float point = featureScale * std::sqrt(pointX[x] * pointX[x] + pointY[x] * pointY[x]);
+                    const size_t i = offset + x;
+
+                    if (!compareLab) {
+                        lab[i] = L;
+                        lab[plane + i] = A;
+                        lab[2 * plane + i] = B;
+                        features[i] = edge;
+                        features[plane + i] = point;
+                        continue;
+                    }
+
+                    // 颜色项: HyAB 距离 ^ QC，分段线性重分布到 [0, 1]
+                    float dL = L - compareLab[i];
+                    float dA = A - compareLab[plane + i];
+                    float dB = B - compareLab[2 * plane + i];
+                    float color = std::pow(std::abs(dL) + std::sqrt(dA * dA + dB * dB), QC);
+                    color = color < PC * cmax ? PT / (PC * cmax) * color
+                                              : PT + (color - PC * cmax) / (cmax - PC * cmax) * (1.0f - PT);
+                    color = std::min(1.0f, color);
+
+                    // 特征项: 边缘/点强度差的较大者
+                    float feature = std::max(std::abs(edge - compareFeatures[i]), std::abs(point - compareFeatures[plane + i]));
+                    feature = std::sqrt(std::min(1.0f, feature * 0.70710678f));
+
+                    float error = std::pow(color, 1.0f - feature);
+                    errorMap[i] = error;
+                    sum += error;
+                }
+            }
+            if (blockSums) blockSums[block] = sum;
+        });
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "ImageView.h"
+
+namespace Metrics {
+
+    /**
+     * @brief FLIP 风格的感知色差 (参考 LDR-FLIP, Andersson et al. 2020)
+     * 1. 颜色项: sRGB -> YCxCz 对立色空间，按人眼对比敏感度 (CSF) 对三个通道分别做空间滤波，
+     *    再转入 Hunt 调整后的 L*a*b*，以 HyAB 距离度量并压缩到 [0, 1]；
+     * 2. 特征项: 在亮度上用高斯一阶/二阶导数检测边缘与点特征，比较两幅图的特征强度；
+     * 3. 逐像素误差 = 颜色项 ^ (1 - 特征项)，范围 [0, 1]。
+     * 所有二维滤波核均可分离 (BY 通道为两个高斯之和)，按行块多线程计算，内层循环连续访问便于向量化；
+     * 边界按边缘像素延拓。缓冲在 Reserve 中一次性分配，之后的 Compute 不再分配堆内存。
+     */
+    class FlipEvaluator {
+    public:
+        // 观察条件: 0.7 m 观看 0.7 m 宽、3840 像素的显示器，约 67 像素/度
+        static constexpr float DEFAULT_PIXELS_PER_DEGREE = 67.0206f;
+
+        void Reserve(int width, int height, float pixelsPerDegree = DEFAULT_PIXELS_PER_DEGREE);
+        size_t ReservedBytes() const;
+
+        /**
+         * @brief 计算逐像素 FLIP 误差图，返回整幅图的平均误差
+         * @param ref / opt 8bit sRGB 彩色视图 (RGB8 / RGBA8)，尺寸与格式须一致
+         * @param backgroundPixels 裁剪区域之外的纯色背景像素数 (误差恒为 0，只计入分母)；
+         *        区域须比物体外扩至少 FilterRadius() + 1 像素，使区域内的滤波结果与整幅画面一致
+         */
+        double Compute(const ImageView& ref, const ImageView& opt, float pixelsPerDegree = DEFAULT_PIXELS_PER_DEGREE,
+                       size_t backgroundPixels = 0);
+
+        // 给定观察条件下滤波核的最大半径 (像素)
+        int FilterRadius(float pixelsPerDegree = DEFAULT_PIXELS_PER_DEGREE);
+
+        // 最近一次 Compute 的误差图 (R32F，[0, 1])
+        ImageView ErrorMap() const { return ImageView(errorMap, mapWidth, mapHeight, PixelFormat::R32F); }
+
+    private:
+        // 按观察距离生成的一维滤波核 (长度均为 2 * radius + 1)
+        struct Kernels {
+            float pixelsPerDegree = 0.0f;
+            int csfRadius = 0;
+            std::vector<float> achromatic, redGreen, blueYellow1, blueYellow2;
+            float blueYellowWeight1 = 0.0f, blueYellowWeight2 = 0.0f;
+            int featureRadius = 0;
+            std::vector<float> gaussian, edge, point;
+        };
+        void BuildKernels(float pixelsPerDegree);
+
+        // 单幅图像的滤波: 输出 Hunt 调整后的 Lab (3 个平面) 与边缘/点特征强度 (2 个平面)；
+        // compareLab/compareFeatures 非空时改为直接与之比较并写出误差图
+        void FilterImage(const ImageView& image, float* lab, float* features,
+                         const float* compareLab, const float* compareFeatures, double* blockSums);
+
+        Kernels kernels;
+        std::vector<float> horizontal;  // 水平滤波结果: 4 个 CSF 平面 + 3 个特征平面
+        std::vector<float> refPlanes;   // 参考图的 Lab (3) + 特征强度 (2)
+        std::vector<float> rowScratch;  // 每个行块: 延拓后的输入行 + 竖直滤波累加器
+        std::vector<double> partialSums;
+        std::vector<float> errorMap;
+        int mapWidth = 0;
+        int mapHeight = 0;
+    };
+}
@@ -0,0 +1,155 @@
+#include "HausdorffEvaluator.h"
+#include "Utils/ParallelUtils.h"
+
+namespace Metrics {
+
+    // 每个任务处理的采样点数 (固定值，保证统计量的合并顺序与线程数无关)
+    static const size_t SAMPLES_PER_BLOCK = 4096;
+
+    // R2 低差异序列的两个增量 (1/φ₂, 1/φ₂²，φ₂ 为塑性数)
+    static const double R2_ALPHA1 = 0.7548776662466927;
+    static const double R2_ALPHA2 = 0.5698402909980532;
+
+    struct DistanceSums {
+        double max = 0.0;
+        double sum = 0.0;
+        double sumSq = 0.0;
+    };
+
+    static void ComputeBounds(const std::vector<glm::vec3>& positions, glm::vec3& bmin, glm::vec3& bmax) {
+        bmin = glm::vec3(std::numeric_limits<float>::max());
+        bmax = glm::vec3(-std::numeric_limits<float>::max());
+        for (const glm::vec3& p : positions) {
+            bmin = glm::min(bmin, p);
+            bmax = glm::max(bmax, p);
+        }
+    }
+
+    HausdorffResult HausdorffEvaluator::Compute(
+            const std::vector<glm::vec3>& refPositions, const std::vector<unsigned int>& refIndices,
+            const std::vector<glm::vec3>& optPositions, const std::vector<unsigned int>& optIndices,
+            const HausdorffOptions& options
+    ) {
+        HausdorffResult result;
+        if (refPositions.empty() || optPositions.empty() || refIndices.size() < 3 || optIndices.size() < 3) {
+            std::cerr << "[Metric] Error: Hausdorff distance needs two non-empty triangle meshes!" << std::endl;
+            return result;
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        glm::vec3 refMin, refMax, optMin, optMax;
+        ComputeBounds(refPositions, refMin, refMax);
+        ComputeBounds(optPositions, optMin, optMax);
+        result.diagonal = glm::length(refMax - refMin);
+
+        glm::vec3 refOffset(0.0f), optOffset(0.0f);
+        if (options.alignCenters) {
+            refOffset = -(refMin + refMax) * 0.5f;
+            optOffset = -(optMin + optMax) * 0.5f;
+        }
+
+        TriangleBVH refBVH, optBVH;
+        refBVH.Build(refPositions, refIndices, refOffset);
+        optBVH.Build(optPositions, optIndices, optOffset);
+
+        result.optToRef = Measure(optPositions, optIndices, optOffset, refBVH, options.surfaceSamples);
+        result.refToOpt = Measure(refPositions, refIndices, refOffset, optBVH, options.surfaceSamples);
+        result.hausdorff = std::max(result.optToRef.max, result.refToOpt.max);
+        result.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    DirectedDistance HausdorffEvaluator::Measure(
+            const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+            const glm::vec3& offset, const TriangleBVH& target, size_t surfaceSamples
+    ) {
+        DirectedDistance out;
+        if (target.TriangleCount() == 0) return out;
+
+        // 1. 三角形面积的累积分布 (double，避免千万级三角形时的精度损失)
+        const size_t triangleCount = indices.size() / 3;
+        std::vector<double> cdf(triangleCount);
+        double totalArea = 0.0;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            unsigned int i0 = indices[t * 3], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+            if (i0 < positions.size() && i1 < positions.size() && i2 < positions.size()) {
+                glm::vec3 e1 = positions[i1] - positions[i0];
+                glm::vec3 e2 = positions[i2] - positions[i0];
+                totalArea += 0.5 * static_cast<double>(glm::length(glm::cross(e1, e2)));
+            }
+            cdf[t] = totalArea;
+        }
+        if (!(totalArea > 0.0)) surfaceSamples = 0;
+
+        // 2. 采样点下标 [0, 顶点数) 为顶点，其后为表面点；分块并行查询
+        const size_t vertexSamples = positions.size();
+        const size_t total = vertexSamples + surfaceSamples;
+        const size_t blocks = (total + SAMPLES_PER_BLOCK - 1) / SAMPLES_PER_BLOCK;
+        std::vector<DistanceSums> partial(blocks);
+
+        auto samplePoint = [&](size_t s) -> glm::vec3 {
+            if (s < vertexSamples) return positions[s] + offset;
+            size_t k = s - vertexSamples;
+            // 面积分布上的等距分位点 -> 三角形
+            double u = (static_cast<double>(k) + 0.5) / static_cast<double>(surfaceSamples) * totalArea;
+            size_t t = static_cast<size_t>(std::upper_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+            t = std::min(t, triangleCount - 1);
+            // R2 序列 -> 三角形内均匀分布的重心坐标 (落在另一半平行四边形时翻折)
+            double r1 = 0.5 + R2_ALPHA1 * static_cast<double>(k);
+            double r2 = 0.5 + R2_ALPHA2 * static_cast<double>(k);
+            float b1 = static_cast<float>(r1 - std::floor(r1));
+            float b2 = static_cast<float>(r2 - std::floor(r2));
+            if (b1 + b2 > 1.0f) {
+                b1 = 1.0f - b1;
+                b2 = 1.0f - b2;
+            }
+            const glm::vec3& a = positions[indices[t * 3]];
+            const glm::vec3& b = positions[indices[t * 3 + 1]];
+            const glm::vec3& c = positions[indices[t * 3 + 2]];
+            return a + (b - a) * b1 + (c - a) * b2 + offset;
+        };
+
+        Utils::ParallelFor(blocks, [&](size_t block) {
+            size_t begin = block * SAMPLES_PER_BLOCK;
+            size_t end = std::min(total, begin + SAMPLES_PER_BLOCK);
+            DistanceSums sums;
+            glm::vec3 prevPoint(0.0f);
+            float prevDist = -1.0f;
+
+            for (size_t s = begin; s < end; ++s) {
+                glm::vec3 p = samplePoint(s);
+                // 相邻采样点在空间上通常相近: 由三角不等式 d(p) <= d(prev) + |p - prev| 得到上界用于剪枝，
+                // 上界内找不到更近的三角形时 (上界恰好取到) 再做一次无界查询，结果与逐点独立查询一致
+                float dist2 = std::numeric_limits<float>::max();
+                bool found = false;
+                if (prevDist >= 0.0f) {
+                    float bound = prevDist + glm::length(p - prevPoint);
+                    found = target.ClosestDistanceSquared(p, bound * bound, dist2);
+                }
+                if (!found) target.ClosestDistanceSquared(p, std::numeric_limits<float>::max(), dist2);
+
+                double d = std::sqrt(static_cast<double>(dist2));
+                sums.max = std::max(sums.max, d);
+                sums.sum += d;
+                sums.sumSq += d * d;
+                prevPoint = p;
+                prevDist = static_cast<float>(d);
+            }
+            partial[block] = sums;
+        });
+
+        DistanceSums merged;
+        for (const DistanceSums& s : partial) {
+            merged.max = std::max(merged.max, s.max);
+            merged.sum += s.sum;
+            merged.sumSq += s.sumSq;
+        }
+        out.samples = total;
+        if (total > 0) {
+            out.max = merged.max;
+            out.mean = merged.sum / static_cast<double>(total);
+            out.rms = std::sqrt(merged.sumSq / static_cast<double>(total));
+        }
+        return out;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "TriangleBVH.h"
+
+namespace Metrics {
+
+    // 单向距离统计: 在源网格表面采样，统计到目标网格的最近距离
+    struct DirectedDistance {
+        double max = 0.0;
+        double mean = 0.0;
+        double rms = 0.0;
+        size_t samples = 0;
+    };
+
+    struct HausdorffResult {
+        DirectedDistance optToRef;  // 在优化模型上采样，映射到参考模型 (与原 PyMeshLab 脚本相同的方向)
+        DirectedDistance refToOpt;
+        double hausdorff = 0.0;     // 对称 Hausdorff 距离 = 两个方向最大值中的较大者
+        double diagonal = 0.0;      // 参考模型包围盒对角线长度 (用于换算相对误差)
+        double timeMs = 0.0;        // 构建 BVH + 双向采样的总耗时
+    };
+
+    struct HausdorffOptions {
+        size_t surfaceSamples = 1000000; // 每个方向按面积均匀分布的表面采样点数 (另加全部顶点)
+        bool alignCenters = true;        // 两个模型分别平移到包围盒中心后再比较
+    };
+
+    /**
+     * @brief 双向 Hausdorff 距离 (几何偏差)
+     * 分别为两个网格构建 SAH BVH；采样点为源网格的全部顶点加上按三角形面积分层抽样的表面点
+     * (面积累积分布上的等距分位点 + R2 低差异序列的重心坐标，结果可复现)。
+     * 点到三角形的最近距离查询按固定大小的分块多线程执行，统计量按块序合并，与线程数无关。
+     * 输入为模型的原始坐标，距离单位与模型一致。
+     */
+    class HausdorffEvaluator {
+    public:
+        static HausdorffResult Compute(
+                const std::vector<glm::vec3>& refPositions, const std::vector<unsigned int>& refIndices,
+                const std::vector<glm::vec3>& optPositions, const std::vector<unsigned int>& optIndices,
+                const HausdorffOptions& options = {}
+        );
+
+    private:
+        static DirectedDistance Measure(
+                const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+                const glm::vec3& offset, const TriangleBVH& target, size_t surfaceSamples
+        );
+    };
+}
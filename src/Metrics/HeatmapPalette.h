@@ -0,0 +1,31 @@
+#pragma once
+
+namespace Metrics {
+
+    // 热力图调色板 (运行时固定使用 Default；离线重新着色工具可切换)
+    enum class HeatmapPalette {
+        Default,    // 蓝 -> 绿 -> 红 (Evaluator::ValueToColor)
+        Gray,       // 黑 -> 白
+        Viridis     // matplotlib viridis 的多项式拟合 (感知均匀，对色觉缺陷友好)
+    };
+
+    inline const char* HeatmapPaletteName(HeatmapPalette palette) {
+        switch (palette) {
+            case HeatmapPalette::Default: return "default";
+            case HeatmapPalette::Gray:    return "gray";
+            case HeatmapPalette::Viridis: return "viridis";
+        }
+        return "unknown";
+    }
+
+    // 按名称查找 (与 HeatmapPaletteName 对应)，未知名称返回 false
+    inline bool ParseHeatmapPalette(const std::string& name, HeatmapPalette& palette) {
+        for (HeatmapPalette p : { HeatmapPalette::Default, HeatmapPalette::Gray, HeatmapPalette::Viridis }) {
+            if (name == HeatmapPaletteName(p)) {
+                palette = p;
+                return true;
+            }
+        }
+        return false;
+    }
+}
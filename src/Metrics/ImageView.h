@@ -0,0 +1,143 @@
+#pragma once
+
+namespace Metrics {
+
+    // 像素格式 (与 GL 回读格式一一对应)
+    enum class PixelFormat {
+        R8,      // GL_RED / GL_UNSIGNED_BYTE
+        RG8,
+        RGB8,    // GL_RGB / GL_UNSIGNED_BYTE
+        RGBA8,   // GL_RGBA / GL_UNSIGNED_BYTE
+        R32F,    // GL_DEPTH_COMPONENT / GL_FLOAT
+        RGB32F,  // GL_RGB / GL_FLOAT
+        RG16,    // GL_RG / GL_UNSIGNED_SHORT (八面体法线)
+        RGBA16F, // GL_RGBA / GL_HALF_FLOAT (色调映射前的线性辐射度)
+        R16F     // 单通道 half (逐像素误差图)
+    };
+
+    inline int ChannelCount(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::R8:
+            case PixelFormat::R16F:
+            case PixelFormat::R32F:   return 1;
+            case PixelFormat::RG8:
+            case PixelFormat::RG16:   return 2;
+            case PixelFormat::RGB8:
+            case PixelFormat::RGB32F: return 3;
+            case PixelFormat::RGBA8:
+            case PixelFormat::RGBA16F: return 4;
+        }
+        return 0;
+    }
+
+    inline size_t BytesPerPixel(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::R8:     return 1;
+            case PixelFormat::R16F:   return 2;
+            case PixelFormat::RG8:    return 2;
+            case PixelFormat::RGB8:   return 3;
+            case PixelFormat::RGBA8:  return 4;
+            case PixelFormat::R32F:   return 4;
+            case PixelFormat::RGB32F: return 12;
+            case PixelFormat::RG16:   return 4;
+            case PixelFormat::RGBA16F: return 8;
+        }
+        return 0;
+    }
+
+    // 8bit 格式按通道数选择 (1~4 通道)
+    inline PixelFormat ByteFormatFromChannels(int channels) {
+        switch (channels) {
+            case 1:  return PixelFormat::R8;
+            case 2:  return PixelFormat::RG8;
+            case 4:  return PixelFormat::RGBA8;
+            default: return PixelFormat::RGB8;
+        }
+    }
+
+    /**
+     * @brief 只读图像视图 (不持有内存)
+     * 可指向 std::vector、映射的 PBO、缓存页或图块，stride 为相邻两行起始地址的字节差
+     */
+    struct ImageView {
+        const void* data = nullptr;
+        int width = 0;
+        int height = 0;
+        size_t stride = 0;
+        PixelFormat format = PixelFormat::RGB8;
+
+        ImageView() = default;
+        ImageView(const void* d, int w, int h, PixelFormat f, size_t rowStride = 0)
+            : data(d), width(w), height(h), stride(rowStride ? rowStride : w * BytesPerPixel(f)), format(f) {}
+
+        // 便捷构造：紧密排列的 std::vector
+        template<typename T>
+        ImageView(const std::vector<T>& v, int w, int h, PixelFormat f) : ImageView(v.data(), w, h, f) {}
+
+        template<typename T>
+        const T* Row(int y) const {
+            return reinterpret_cast<const T*>(static_cast<const unsigned char*>(data) + static_cast<size_t>(y) * stride);
+        }
+
+        size_t PixelCount() const { return static_cast<size_t>(width) * height; }
+        bool IsContiguous() const { return stride == width * BytesPerPixel(format); }
+        bool SameShape(const ImageView& o) const { return width == o.width && height == o.height && format == o.format; }
+    };
+
+    // 可写图像视图 (调用方提供输出内存)
+    struct MutableImageView {
+        void* data = nullptr;
+        int width = 0;
+        int height = 0;
+        size_t stride = 0;
+        PixelFormat format = PixelFormat::RGBA8;
+
+        MutableImageView() = default;
+        MutableImageView(void* d, int w, int h, PixelFormat f, size_t rowStride = 0)
+            : data(d), width(w), height(h), stride(rowStride ? rowStride : w * BytesPerPixel(f)), format(f) {}
+
+        template<typename T>
+        MutableImageView(std::vector<T>& v, int w, int h, PixelFormat f) : MutableImageView(v.data(), w, h, f) {}
+
+        template<typename T>
+        T* Row(int y) const {
+            return reinterpret_cast<T*>(static_cast<unsigned char*>(data) + static_cast<size_t>(y) * stride);
+        }
+
+        operator ImageView() const { return ImageView(data, width, height, format, stride); }
+    };
+
+    /**
+     * @brief 裁剪评估时视图在整幅画面中的位置 (GL 回读坐标，原点在左下角)
+     * 区域之外的像素在参考 / 优化两幅图中都是同一纯色背景，指标按整幅画面归一化时解析地计入。
+     */
+    struct FrameRegion {
+        int frameWidth = 0;
+        int frameHeight = 0;
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+
+        static FrameRegion Full(int w, int h) { return { w, h, 0, 0, w, h }; }
+
+        bool IsFull() const { return width == frameWidth && height == frameHeight; }
+        size_t PixelCount() const { return static_cast<size_t>(width) * height; }
+        size_t BackgroundPixels() const {
+            return static_cast<size_t>(frameWidth) * frameHeight - PixelCount();
+        }
+    };
+
+    // 8bit RGB 颜色 (背景色 / 轮廓色)
+    struct Color8 {
+        unsigned char r = 0;
+        unsigned char g = 0;
+        unsigned char b = 0;
+
+        static Color8 FromFloat(const glm::vec3& c) {
+            return { static_cast<unsigned char>(c.r * 255.0f),
+                     static_cast<unsigned char>(c.g * 255.0f),
+                     static_cast<unsigned char>(c.b * 255.0f) };
+        }
+    };
+}
@@ -41,39 +41,44 @@ namespace Metrics {
     }
 
     void MetricVisualizer::RenderComparison(unsigned int texRef, unsigned int texBase, unsigned int texHeatmap) {
-        int panelW = width / 3;
+        RenderComparison(texRef, texBase, texHeatmap, width, height);
+    }
+
+    void MetricVisualizer::RenderComparison(unsigned int texRef, unsigned int texBase, unsigned int texHeatmap, int targetWidth, int targetHeight) {
+        int panelW = targetWidth / 3;
 
         // A. 左侧
-        glViewport(0, 0, panelW, height);
+        glViewport(0, 0, panelW, targetHeight);
         simpleTextureShader->use();
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, texRef);
         RenderQuad();
 
         // B. 中间
-        glViewport(panelW, 0, panelW, height);
+        glViewport(panelW, 0, panelW, targetHeight);
         simpleTextureShader->use();
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, texBase);
         RenderQuad();
 
         // C. Heatmap (现在直接当作普通纹理绘制)
-        glViewport(panelW * 2, 0, panelW, height);
+        glViewport(panelW * 2, 0, panelW, targetHeight);
         simpleTextureShader->use();
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, texHeatmap);
         RenderQuad();
 
         // D. 图例
-        int legendW = 20;
-        int legendH = 300;
-        int legendX = (panelW * 3) - legendW - 30;
-        int legendY = (height - legendH) / 2;
+        float legendScale = (float)targetHeight / (float)height;
+        int legendW = std::max((int)(20 * legendScale), 1);
+        int legendH = std::max((int)(300 * legendScale), 1);
+        int legendX = (panelW * 3) - legendW - (int)(30 * legendScale);
+        int legendY = (targetHeight - legendH) / 2;
         glViewport(legendX, legendY, legendW, legendH);
         legendShader->use();
         RenderQuad();
 
-        glViewport(0, 0, width, height);
+        glViewport(0, 0, targetWidth, targetHeight);
     }
 
     void MetricVisualizer::RenderQuad() {
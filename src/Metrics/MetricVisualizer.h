@@ -10,6 +10,8 @@ namespace Metrics {
         // texRef/texBase: 从 PBRRenderer 得到的纹理 ID
         // mode: 0=PSNR(Color), 1=ND(Normal), 2=SD(Depth+Normal)
         void RenderComparison(unsigned int texRef, unsigned int texBase, unsigned int texHeatmap);
+        // 绘制到当前绑定的帧缓冲 (targetWidth x targetHeight)，图例按相对窗口高度的比例缩放
+        void RenderComparison(unsigned int texRef, unsigned int texBase, unsigned int texHeatmap, int targetWidth, int targetHeight);
         void RenderComposite(unsigned int refTex, unsigned int optTex, int mode);
 
     private:
@@ -0,0 +1,558 @@
+#include "PixelPasses.h"
+#include "Evaluator.h"
+#include "SimdKernels.h"
+#include "Utils/ParallelUtils.h"
+
+namespace Metrics {
+
+    // 每个任务处理的行数 (固定值，保证部分和的合并顺序与线程数无关)
+    static const int ROWS_PER_BLOCK = 16;
+
+    // 打包轮廓按 64 像素的字划分任务
+    static const size_t WORDS_PER_BLOCK = 256;
+
+    static int BlockCount(int height) {
+        return (height + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+    }
+
+    static void WritePixel(unsigned char* dst, Color8 c) {
+        dst[0] = c.r; dst[1] = c.g; dst[2] = c.b; dst[3] = 255;
+    }
+
+    static void WritePixel(unsigned char* dst, const unsigned char* rgb) {
+        dst[0] = rgb[0]; dst[1] = rgb[1]; dst[2] = rgb[2]; dst[3] = 255;
+    }
+
+    // 连续 count 个 RGBA8 像素填入同一颜色
+    static void FillPixels(unsigned char* dst, Color8 c, int count) {
+        const unsigned char rgba[4] = { c.r, c.g, c.b, 255 };
+        uint32_t pattern;
+        std::memcpy(&pattern, rgba, 4);
+        for (int i = 0; i < count; ++i) std::memcpy(dst + static_cast<size_t>(i) * 4, &pattern, 4);
+    }
+
+    // 部分和缓冲: 每个调用线程一份，容量只增不减，稳态下不分配堆内存
+    // (工作线程只写入各自块对应的元素，缓冲本身归调用线程所有)
+    template<typename T>
+    static std::vector<T>& PartialBuffer(size_t count) {
+        thread_local std::vector<T> buffer;
+        buffer.assign(count, T());
+        return buffer;
+    }
+
+    // 逐像素误差图 (可选输出)：未乘倍率的误差以 half 存储，两侧均为背景的像素写入 ERROR_MAP_BACKGROUND
+    static uint16_t* ErrorRow(const PixelPassTargets& out, int y) {
+        return out.error.data ? out.error.Row<uint16_t>(y) : nullptr;
+    }
+
+    static void WriteError(uint16_t* row, int x, float e) {
+        if (row) row[x] = Simd::FloatToHalf(e);
+    }
+
+    static void WriteErrorBackground(uint16_t* row, int x) {
+        if (row) row[x] = ERROR_MAP_BACKGROUND;
+    }
+
+    static bool CoverageBit(const uint32_t* row, int x) {
+        return ((row[x >> 5] >> (x & 31)) & 1u) != 0;
+    }
+
+    static bool CheckTargets(const ImageView& input, const PixelPassTargets& out) {
+        auto matches = [&](const MutableImageView& v) {
+            return v.width == input.width && v.height == input.height && v.format == PixelFormat::RGBA8;
+        };
+        const bool errorMatches = !out.error.data || (out.error.width == input.width && out.error.height == input.height &&
+                                                      out.error.format == PixelFormat::R16F);
+        if (matches(out.refDisplay) && matches(out.optDisplay) && matches(out.heatmap) && errorMatches) return true;
+        std::cerr << "[Metric] Error: Pixel pass targets do not match input size!" << std::endl;
+        return false;
+    }
+
+    double PixelPasses::ColorPass(
+            const ImageView& refColor, const CoverageMask& refCoverage,
+            const ImageView& optColor, const CoverageMask& optCoverage,
+            Color8 background, Color8 heatmapBg, float errorMultiplier,
+            const PixelPassTargets& out, size_t backgroundPixels
+    ) {
+        const int width = refColor.width;
+        const int height = refColor.height;
+        if (!refColor.SameShape(optColor) || refColor.PixelCount() == 0 || !CheckTargets(refColor, out)) return 0.0;
+
+        const unsigned char* lut = Evaluator::HeatmapLUT();
+        const int channels = ChannelCount(refColor.format);
+        const int blocks = BlockCount(height);
+        std::vector<uint64_t>& partialSums = PartialBuffer<uint64_t>(blocks);
+
+        Utils::ParallelFor(static_cast<size_t>(blocks), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(height, yBegin + ROWS_PER_BLOCK);
+            uint64_t sum = 0;
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                const unsigned char* refRow = refColor.Row<unsigned char>(y);
+                const unsigned char* optRow = optColor.Row<unsigned char>(y);
+                const uint32_t* refCov = refCoverage.Row(y);
+                const uint32_t* optCov = optCoverage.Row(y);
+                unsigned char* refOut = out.refDisplay.Row<unsigned char>(y);
+                unsigned char* optOut = out.optDisplay.Row<unsigned char>(y);
+                unsigned char* heatOut = out.heatmap.Row<unsigned char>(y);
+                uint16_t* errOut = ErrorRow(out, y);
+
+                for (int x = 0; x < width; ++x) {
+                    const unsigned char* ref = refRow + x * channels;
+                    const unsigned char* opt = optRow + x * channels;
+
+                    // 1. PSNR 使用包含背景的原始画面 (整数精确累加)
+                    int dr = ref[0] - opt[0];
+                    int dg = ref[1] - opt[1];
+                    int db = ref[2] - opt[2];
+                    sum += static_cast<uint64_t>(dr * dr + dg * dg + db * db);
+
+                    // 2. 未被模型覆盖的像素是背景或天空盒，背景像素在热力图中按黑色参与比较
+                    bool refIsBg = !CoverageBit(refCov, x);
+                    bool optIsBg = !CoverageBit(optCov, x);
+
+                    if (refIsBg) WritePixel(refOut + x * 4, background);
+                    else         WritePixel(refOut + x * 4, ref);
+                    if (optIsBg) WritePixel(optOut + x * 4, background);
+                    else         WritePixel(optOut + x * 4, opt);
+
+                    bool refIsBlack = refIsBg || (ref[0] == 0 && ref[1] == 0 && ref[2] == 0);
+                    bool optIsBlack = optIsBg || (opt[0] == 0 && opt[1] == 0 && opt[2] == 0);
+                    if (refIsBlack && optIsBlack) {
+                        WritePixel(heatOut + x * 4, heatmapBg);
+                        WriteErrorBackground(errOut, x);
+                        continue;
+                    }
+
+                    // 3. 热力图: RGB 欧氏距离
+                    float r1 = refIsBg ? 0.0f : ref[0] / 255.0f, r2 = optIsBg ? 0.0f : opt[0] / 255.0f;
+                    float g1 = refIsBg ? 0.0f : ref[1] / 255.0f, g2 = optIsBg ? 0.0f : opt[1] / 255.0f;
+                    float b1 = refIsBg ? 0.0f : ref[2] / 255.0f, b2 = optIsBg ? 0.0f : opt[2] / 255.0f;
+                    float fr = r1 - r2, fg = g1 - g2, fb = b1 - b2;
+                    float diff = std::sqrt(fr * fr + fg * fg + fb * fb);
+                    WriteError(errOut, x, diff);
+                    Evaluator::HeatmapColor(lut, diff * errorMultiplier, heatOut + x * 4);
+                }
+            }
+            partialSums[block] = sum;
+        });
+
+        uint64_t sumSqDiff = 0;
+        for (uint64_t s : partialSums) sumSqDiff += s;
+
+        double mse = static_cast<double>(sumSqDiff) / static_cast<double>((refColor.PixelCount() + backgroundPixels) * 3);
+        return (mse < 1e-10) ? 99.99 : 10.0 * std::log10((255.0 * 255.0) / mse);
+    }
+
+    void PixelPasses::ErrorMapPass(
+            const ImageView& refColor, const CoverageMask& refCoverage,
+            const ImageView& optColor, const CoverageMask& optCoverage,
+            const ImageView& errorMap, bool invert,
+            Color8 background, Color8 heatmapBg, float errorMultiplier,
+            const PixelPassTargets& out
+    ) {
+        const int width = refColor.width;
+        const int height = refColor.height;
+        if (!refColor.SameShape(optColor) || refColor.PixelCount() == 0 || !CheckTargets(refColor, out) ||
+            errorMap.width != width || errorMap.height != height || errorMap.format != PixelFormat::R32F) {
+            return;
+        }
+
+        const unsigned char* lut = Evaluator::HeatmapLUT();
+        const int channels = ChannelCount(refColor.format);
+        const int blocks = BlockCount(height);
+        // 热力图值 = (bias + sign * e) * 倍率
+        const float bias = invert ? 1.0f : 0.0f;
+        const float sign = invert ? -1.0f : 1.0f;
+
+        Utils::ParallelFor(static_cast<size_t>(blocks), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(height, yBegin + ROWS_PER_BLOCK);
+            for (int y = yBegin; y < yEnd; ++y) {
+                const unsigned char* refRow = refColor.Row<unsigned char>(y);
+                const unsigned char* optRow = optColor.Row<unsigned char>(y);
+                const float* mapRow = errorMap.Row<float>(y);
+                const uint32_t* refCov = refCoverage.Row(y);
+                const uint32_t* optCov = optCoverage.Row(y);
+                unsigned char* refOut = out.refDisplay.Row<unsigned char>(y);
+                unsigned char* optOut = out.optDisplay.Row<unsigned char>(y);
+                unsigned char* heatOut = out.heatmap.Row<unsigned char>(y);
+                uint16_t* errOut = ErrorRow(out, y);
+
+                for (int x = 0; x < width; ++x) {
+                    const unsigned char* ref = refRow + x * channels;
+                    const unsigned char* opt = optRow + x * channels;
+                    bool refIsBg = !CoverageBit(refCov, x);
+                    bool optIsBg = !CoverageBit(optCov, x);
+
+                    if (refIsBg) WritePixel(refOut + x * 4, background);
+                    else         WritePixel(refOut + x * 4, ref);
+                    if (optIsBg) WritePixel(optOut + x * 4, background);
+                    else         WritePixel(optOut + x * 4, opt);
+
+                    bool refIsBlack = refIsBg || (ref[0] == 0 && ref[1] == 0 && ref[2] == 0);
+                    bool optIsBlack = optIsBg || (opt[0] == 0 && opt[1] == 0 && opt[2] == 0);
+                    if (refIsBlack && optIsBlack) {
+                        WritePixel(heatOut + x * 4, heatmapBg);
+                        WriteErrorBackground(errOut, x);
+                        continue;
+                    }
+
+                    const float e = bias + sign * mapRow[x];
+                    WriteError(errOut, x, e);
+                    Evaluator::HeatmapColor(lut, e * errorMultiplier, heatOut + x * 4);
+                }
+            }
+        });
+    }
+
+    double PixelPasses::NormalPass(
+            const ImageView& refNormals, const ImageView& refBytes,
+            const ImageView& optNormals, const ImageView& optBytes,
+            Color8 background, Color8 heatmapBg,
+            const PixelPassTargets& out
+    ) {
+        const int width = refNormals.width;
+        const int height = refNormals.height;
+        if (!refNormals.SameShape(optNormals) || refNormals.PixelCount() == 0 || !CheckTargets(refNormals, out)) return 0.0;
+
+        const unsigned char* lut = Evaluator::HeatmapLUT();
+        const int byteChannels = ChannelCount(refBytes.format);
+        const int blocks = BlockCount(height);
+        std::vector<double>& partialSums = PartialBuffer<double>(blocks);
+        std::vector<size_t>& partialValid = PartialBuffer<size_t>(blocks);
+
+        Utils::ParallelFor(static_cast<size_t>(blocks), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(height, yBegin + ROWS_PER_BLOCK);
+            double sum = 0.0;
+            size_t valid = 0;
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                const float* refRow = refNormals.Row<float>(y);
+                const float* optRow = optNormals.Row<float>(y);
+                const unsigned char* refByteRow = refBytes.Row<unsigned char>(y);
+                const unsigned char* optByteRow = optBytes.Row<unsigned char>(y);
+                unsigned char* refOut = out.refDisplay.Row<unsigned char>(y);
+                unsigned char* optOut = out.optDisplay.Row<unsigned char>(y);
+                unsigned char* heatOut = out.heatmap.Row<unsigned char>(y);
+                uint16_t* errOut = ErrorRow(out, y);
+
+                for (int x = 0; x < width; ++x) {
+                    const float* n1 = refRow + x * 3;
+                    const float* n2 = optRow + x * 3;
+
+                    // 合法法线经过 N*0.5+0.5 后不可能为 (0,0,0)，出现 0 即为清屏背景
+                    bool refIsBg = (n1[0] == 0.0f && n1[1] == 0.0f && n1[2] == 0.0f);
+                    bool optIsBg = (n2[0] == 0.0f && n2[1] == 0.0f && n2[2] == 0.0f);
+
+                    if (refIsBg) WritePixel(refOut + x * 4, background);
+                    else         WritePixel(refOut + x * 4, refByteRow + x * byteChannels);
+                    if (optIsBg) WritePixel(optOut + x * 4, background);
+                    else         WritePixel(optOut + x * 4, optByteRow + x * byteChannels);
+
+                    if (refIsBg && optIsBg) {
+                        WritePixel(heatOut + x * 4, heatmapBg);
+                        WriteErrorBackground(errOut, x);
+                        continue;
+                    }
+
+                    // 1. 法线 MSE 部分和
+                    double dr = static_cast<double>(n1[0] - n2[0]);
+                    double dg = static_cast<double>(n1[1] - n2[1]);
+                    double db = static_cast<double>(n1[2] - n2[2]);
+                    sum += dr * dr + dg * dg + db * db;
+                    valid++;
+
+                    // 2. 热力图: 还原至 [-1, 1] 后的夹角，(1 - dot)/2 映射到 [0, 1]
+                    float dot = (n1[0] * 2.0f - 1.0f) * (n2[0] * 2.0f - 1.0f) +
+                                (n1[1] * 2.0f - 1.0f) * (n2[1] * 2.0f - 1.0f) +
+                                (n1[2] * 2.0f - 1.0f) * (n2[2] * 2.0f - 1.0f);
+                    dot = std::max(-1.0f, std::min(1.0f, dot));
+                    WriteError(errOut, x, (1.0f - dot) / 2.0f);
+                    Evaluator::HeatmapColor(lut, (1.0f - dot) / 2.0f, heatOut + x * 4);
+                }
+            }
+            partialSums[block] = sum;
+            partialValid[block] = valid;
+        });
+
+        double sumSqDiff = 0.0;
+        size_t validPixels = 0;
+        for (int b = 0; b < blocks; ++b) {
+            sumSqDiff += partialSums[b];
+            validPixels += partialValid[b];
+        }
+        return (validPixels == 0) ? 0.0 : sumSqDiff / (static_cast<double>(validPixels) * 3.0);
+    }
+
+    double PixelPasses::NormalPassCompact(
+            const ImageView& refOct, const CoverageMask& refCoverage,
+            const ImageView& optOct, const CoverageMask& optCoverage,
+            Color8 background, Color8 heatmapBg,
+            const PixelPassTargets& out
+    ) {
+        const int width = refOct.width;
+        const int height = refOct.height;
+        if (!refOct.SameShape(optOct) || refOct.PixelCount() == 0 || !CheckTargets(refOct, out)) return 0.0;
+
+        const unsigned char* lut = Evaluator::HeatmapLUT();
+        const int blocks = BlockCount(height);
+        std::vector<double>& partialSums = PartialBuffer<double>(blocks);
+        std::vector<size_t>& partialValid = PartialBuffer<size_t>(blocks);
+
+        Utils::ParallelFor(static_cast<size_t>(blocks), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(height, yBegin + ROWS_PER_BLOCK);
+            double sum = 0.0;
+            size_t valid = 0;
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                const uint16_t* refRow = refOct.Row<uint16_t>(y);
+                const uint16_t* optRow = optOct.Row<uint16_t>(y);
+                const uint32_t* refCov = refCoverage.Row(y);
+                const uint32_t* optCov = optCoverage.Row(y);
+                unsigned char* refOut = out.refDisplay.Row<unsigned char>(y);
+                unsigned char* optOut = out.optDisplay.Row<unsigned char>(y);
+                unsigned char* heatOut = out.heatmap.Row<unsigned char>(y);
+                uint16_t* errOut = ErrorRow(out, y);
+
+                for (int x = 0; x < width; ++x) {
+                    bool refIsBg = !CoverageBit(refCov, x);
+                    bool optIsBg = !CoverageBit(optCov, x);
+
+                    if (refIsBg && optIsBg) {
+                        WritePixel(refOut + x * 4, background);
+                        WritePixel(optOut + x * 4, background);
+                        WritePixel(heatOut + x * 4, heatmapBg);
+                        WriteErrorBackground(errOut, x);
+                        continue;
+                    }
+
+                    // 即时解码；背景与旧路径一致按 (0,0,0) 参与计算
+                    float n1[3] = { 0.0f, 0.0f, 0.0f };
+                    float n2[3] = { 0.0f, 0.0f, 0.0f };
+                    if (!refIsBg) Evaluator::DecodeOctNormal(refRow[x * 2], refRow[x * 2 + 1], n1);
+                    if (!optIsBg) Evaluator::DecodeOctNormal(optRow[x * 2], optRow[x * 2 + 1], n2);
+
+                    unsigned char rgb[3];
+                    if (refIsBg) WritePixel(refOut + x * 4, background);
+                    else {
+                        for (int k = 0; k < 3; ++k) rgb[k] = static_cast<unsigned char>(n1[k] * 255.0f + 0.5f);
+                        WritePixel(refOut + x * 4, rgb);
+                    }
+                    if (optIsBg) WritePixel(optOut + x * 4, background);
+                    else {
+                        for (int k = 0; k < 3; ++k) rgb[k] = static_cast<unsigned char>(n2[k] * 255.0f + 0.5f);
+                        WritePixel(optOut + x * 4, rgb);
+                    }
+
+                    double dr = static_cast<double>(n1[0] - n2[0]);
+                    double dg = static_cast<double>(n1[1] - n2[1]);
+                    double db = static_cast<double>(n1[2] - n2[2]);
+                    sum += dr * dr + dg * dg + db * db;
+                    valid++;
+
+                    float dot = (n1[0] * 2.0f - 1.0f) * (n2[0] * 2.0f - 1.0f) +
+                                (n1[1] * 2.0f - 1.0f) * (n2[1] * 2.0f - 1.0f) +
+                                (n1[2] * 2.0f - 1.0f) * (n2[2] * 2.0f - 1.0f);
+                    dot = std::max(-1.0f, std::min(1.0f, dot));
+                    WriteError(errOut, x, (1.0f - dot) / 2.0f);
+                    Evaluator::HeatmapColor(lut, (1.0f - dot) / 2.0f, heatOut + x * 4);
+                }
+            }
+            partialSums[block] = sum;
+            partialValid[block] = valid;
+        });
+
+        double sumSqDiff = 0.0;
+        size_t validPixels = 0;
+        for (int b = 0; b < blocks; ++b) {
+            sumSqDiff += partialSums[b];
+            validPixels += partialValid[b];
+        }
+        return (validPixels == 0) ? 0.0 : sumSqDiff / (static_cast<double>(validPixels) * 3.0);
+    }
+
+    double PixelPasses::SilhouettePass(
+            const PackedMask& refSil,
+            const PackedMask& optSil,
+            Color8 background, Color8 silhouetteColor, Color8 heatmapBg,
+            const PixelPassTargets& out, size_t backgroundPixels
+    ) {
+        const int width = out.heatmap.width;
+        const size_t pixelCount = static_cast<size_t>(width) * out.heatmap.height;
+        if (pixelCount == 0 || refSil.pixelCount != pixelCount || optSil.pixelCount != pixelCount ||
+            !CheckTargets(ImageView(nullptr, width, out.heatmap.height, PixelFormat::R8), out)) {
+            return 0.0;
+        }
+
+        // 二值轮廓的热力图只有两种颜色：一致 (0) 与不一致 (1)
+        unsigned char matchColor[4], mismatchColor[4];
+        const unsigned char* lut = Evaluator::HeatmapLUT();
+        Evaluator::HeatmapColor(lut, 0.0f, matchColor);
+        Evaluator::HeatmapColor(lut, 1.0f, mismatchColor);
+
+        const size_t wordCount = refSil.words.size();
+        const size_t blocks = (wordCount + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK;
+        std::vector<size_t>& partialCounts = PartialBuffer<size_t>(blocks);
+
+        Utils::ParallelFor(blocks, [&](size_t block) {
+            size_t wBegin = block * WORDS_PER_BLOCK;
+            size_t wEnd = std::min(wordCount, wBegin + WORDS_PER_BLOCK);
+
+            // 误差直接在打包形式上计算: popcount(a XOR b)
+            partialCounts[block] = Simd::CountBitMismatch(&refSil.words[wBegin], &optSil.words[wBegin], wEnd - wBegin);
+
+            // 打包位流按行优先排列，逐像素推进 (x, y) 以支持带 stride 的输出
+            size_t base = wBegin * 64;
+            int y = static_cast<int>(base / width);
+            int x = static_cast<int>(base % width);
+            unsigned char* refOut = out.refDisplay.Row<unsigned char>(y);
+            unsigned char* optOut = out.optDisplay.Row<unsigned char>(y);
+            unsigned char* heatOut = out.heatmap.Row<unsigned char>(y);
+            uint16_t* errOut = ErrorRow(out, y);
+
+            // x 到达行尾时换到下一行 (最后一行保持不动，其后已没有像素)
+            auto advanceRow = [&]() {
+                if (x == width && static_cast<size_t>(y + 1) * width < pixelCount) {
+                    x = 0;
+                    ++y;
+                    refOut = out.refDisplay.Row<unsigned char>(y);
+                    optOut = out.optDisplay.Row<unsigned char>(y);
+                    heatOut = out.heatmap.Row<unsigned char>(y);
+                    errOut = ErrorRow(out, y);
+                }
+            };
+
+            for (size_t w = wBegin; w < wEnd; ++w) {
+                uint64_t a = refSil.words[w];
+                uint64_t b = optSil.words[w];
+                size_t end = std::min<size_t>(64, pixelCount - w * 64);
+
+                // 两侧整个字都是背景 (轮廓之外的大部分画面)：按行分段整块填充，不再逐位判断
+                if ((a | b) == 0) {
+                    size_t remaining = end;
+                    while (remaining > 0) {
+                        const int run = static_cast<int>(std::min<size_t>(remaining, static_cast<size_t>(width - x)));
+                        FillPixels(refOut + x * 4, background, run);
+                        FillPixels(optOut + x * 4, background, run);
+                        FillPixels(heatOut + x * 4, heatmapBg, run);
+                        if (errOut) std::fill(errOut + x, errOut + x + run, ERROR_MAP_BACKGROUND);
+                        x += run;
+                        remaining -= run;
+                        advanceRow();
+                    }
+                    continue;
+                }
+
+                for (size_t k = 0; k < end; ++k) {
+                    bool v1 = ((a >> k) & 1u) != 0;
+                    bool v2 = ((b >> k) & 1u) != 0;
+
+                    WritePixel(refOut + x * 4, v1 ? silhouetteColor : background);
+                    WritePixel(optOut + x * 4, v2 ? silhouetteColor : background);
+
+                    if (!v1 && !v2) {
+                        WritePixel(heatOut + x * 4, heatmapBg);
+                        WriteErrorBackground(errOut, x);
+                    } else {
+                        std::memcpy(heatOut + x * 4, v1 != v2 ? mismatchColor : matchColor, 4);
+                        WriteError(errOut, x, v1 != v2 ? 1.0f : 0.0f);
+                    }
+
+                    ++x;
+                    advanceRow();
+                }
+            }
+        });
+
+        size_t totalMismatches = 0;
+        for (size_t c : partialCounts) totalMismatches += c;
+        return static_cast<double>(totalMismatches) / static_cast<double>(pixelCount + backgroundPixels);
+    }
+
+    // gamma 编码的量化阈值: 线性值 t 编码为 k 当且仅当 kGammaThresholds[k-1] <= t < kGammaThresholds[k]
+    // (即 round(pow(t, 1/2.2) * 255))，逐像素二分查找，省去每通道一次 pow
+    static const float* GammaThresholds() {
+        static const std::vector<float> thresholds = [] {
+            std::vector<float> t(255);
+            for (int k = 1; k <= 255; ++k) t[k - 1] = std::pow((k - 0.5f) / 255.0f, 2.2f);
+            return t;
+        }();
+        return thresholds.data();
+    }
+
+    static unsigned char EncodeGamma(float t, const float* thresholds) {
+        return static_cast<unsigned char>(std::upper_bound(thresholds, thresholds + 255, t) - thresholds);
+    }
+
+    void PixelPasses::ToneMapPass(
+            const ImageView& linear, const CoverageMask& coverage,
+            float exposure, ToneOperator op, bool skybox, Color8 background,
+            const MutableImageView& out
+    ) {
+        const int width = linear.width;
+        const int height = linear.height;
+        if (linear.format != PixelFormat::RGBA16F || out.format != PixelFormat::RGB8 ||
+            out.width != width || out.height != height) {
+            std::cerr << "[Metric] Error: Tone map pass expects RGBA16F input and RGB8 output of the same size!" << std::endl;
+            return;
+        }
+
+        const float* thresholds = GammaThresholds();
+        Utils::ParallelFor(static_cast<size_t>(BlockCount(height)), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(height, yBegin + ROWS_PER_BLOCK);
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                const uint16_t* row = linear.Row<uint16_t>(y);
+                const uint32_t* cov = coverage.Row(y);
+                unsigned char* dst = out.Row<unsigned char>(y);
+
+                for (int x = 0; x < width; ++x) {
+                    unsigned char* px = dst + x * 3;
+                    const bool covered = CoverageBit(cov, x);
+                    if (!covered && !skybox) {
+                        px[0] = background.r; px[1] = background.g; px[2] = background.b;
+                        continue;
+                    }
+                    for (int c = 0; c < 3; ++c) {
+                        float v = std::max(Simd::HalfToFloat(row[x * 4 + c]), 0.0f);
+                        v = covered ? ToneMap(v * exposure, op) : ToneMap(v, ToneOperator::Reinhard);
+                        px[c] = EncodeGamma(v, thresholds);
+                    }
+                }
+            }
+        });
+    }
+
+    void PixelPasses::PadToFrame(const ImageView& regionPixels, const FrameRegion& region, Color8 fill, const MutableImageView& out) {
+        if (regionPixels.format != PixelFormat::RGBA8 || out.format != PixelFormat::RGBA8 ||
+            regionPixels.width != region.width || regionPixels.height != region.height ||
+            out.width != region.frameWidth || out.height != region.frameHeight) {
+            std::cerr << "[Metric] Error: Pad to frame expects RGBA8 images matching the region and its frame!" << std::endl;
+            return;
+        }
+
+        // 每个像素只写一次: 区域外的行与区域左右两侧填充，区域内的行段直接拷贝
+        const int frameWidth = region.frameWidth;
+        const int rightBegin = region.x + region.width;
+        Utils::ParallelFor(static_cast<size_t>(BlockCount(region.frameHeight)), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(region.frameHeight, yBegin + ROWS_PER_BLOCK);
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                unsigned char* dst = out.Row<unsigned char>(y);
+                if (y < region.y || y >= region.y + region.height) {
+                    FillPixels(dst, fill, frameWidth);
+                    continue;
+                }
+                FillPixels(dst, fill, region.x);
+                std::memcpy(dst + static_cast<size_t>(region.x) * 4, regionPixels.Row<unsigned char>(y - region.y), static_cast<size_t>(region.width) * 4);
+                FillPixels(dst + static_cast<size_t>(rightBegin) * 4, fill, frameWidth - rightBegin);
+            }
+        });
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include "ImageView.h"
+#include "ToneMapping.h"
+
+namespace Metrics {
+
+    struct PackedMask;
+    struct CoverageMask;
+
+    // 逐像素误差图中两侧均为背景的像素 (half NaN，热力图中对应 heatmapBackground)
+    constexpr uint16_t ERROR_MAP_BACKGROUND = 0x7E00;
+
+    // 融合内核的输出目标 (均为 RGBA8，内存由调用方提供，尺寸须与输入一致)
+    struct PixelPassTargets {
+        MutableImageView refDisplay; // 已替换背景色，直接上传给 texRef
+        MutableImageView optDisplay; // 直接上传给 texOpt
+        MutableImageView heatmap;
+        // 可选 (data 为空时不输出)：热力图所用的逐像素误差 (乘倍率之前)，R16F
+        MutableImageView error;
+    };
+
+    // 持有输出内存的便捷容器，跨帧复用避免反复分配
+    struct PixelPassOutput {
+        std::vector<unsigned char> refDisplay;
+        std::vector<unsigned char> optDisplay;
+        std::vector<unsigned char> heatmap;
+        std::vector<uint16_t> errorMap;  // 逐像素误差 (R16F，仅 withErrorMap 时准备)
+        double error = 0.0; // 当前阶段的指标值 (PSNR / Normal MSE / Silhouette MSE)
+
+        // 按尺寸准备缓冲区 (容量足够时不重新分配)，返回指向它们的视图
+        PixelPassTargets Prepare(int width, int height, bool withErrorMap = false) {
+            size_t bytes = static_cast<size_t>(width) * height * 4;
+            refDisplay.resize(bytes);
+            optDisplay.resize(bytes);
+            heatmap.resize(bytes);
+            PixelPassTargets targets;
+            targets.refDisplay = MutableImageView(refDisplay, width, height, PixelFormat::RGBA8);
+            targets.optDisplay = MutableImageView(optDisplay, width, height, PixelFormat::RGBA8);
+            targets.heatmap = MutableImageView(heatmap, width, height, PixelFormat::RGBA8);
+            if (withErrorMap) {
+                errorMap.resize(static_cast<size_t>(width) * height);
+                targets.error = MutableImageView(errorMap, width, height, PixelFormat::R16F);
+            }
+            return targets;
+        }
+    };
+
+    /**
+     * @brief 融合的逐像素计算 (每个阶段一个内核)
+     * 按行块并行，每个像素只读取一次，同时产出指标部分和、展示缓冲与热力图。
+     * 行块划分固定 (与线程数无关)，部分和按块序合并，结果可复现。
+     * 输入输出均为图像视图，可直接作用于映射的 PBO 或图块，无需拷贝。
+     */
+    class PixelPasses {
+    public:
+        /**
+         * @brief PSNR 阶段，返回 PSNR
+         * @param refColor / optColor RGB8 画面
+         * PSNR 使用包含背景的原始画面计算；未被覆盖掩码标记的像素视为背景，
+         * 展示图填入 background，热力图中两侧均为背景的像素填入 heatmapBg
+         * @param backgroundPixels 裁剪区域之外的纯色背景像素数 (两侧相同，差值为 0，只计入分母)
+         */
+        static double ColorPass(
+                const ImageView& refColor, const CoverageMask& refCoverage,
+                const ImageView& optColor, const CoverageMask& optCoverage,
+                Color8 background, Color8 heatmapBg, float errorMultiplier,
+                const PixelPassTargets& out, size_t backgroundPixels = 0
+        );
+
+        /**
+         * @brief 基于逐像素误差图的展示图与热力图 (SSIM / FLIP 阶段，指标本身由对应的 Evaluator 计算)
+         * @param errorMap 逐像素误差图 (R32F)
+         * @param invert 为 true 时按相似度处理: 热力图显示 (1 - e) * errorMultiplier (SSIM)，否则显示 e * errorMultiplier (FLIP)
+         * 背景处理与 ColorPass 一致
+         */
+        static void ErrorMapPass(
+                const ImageView& refColor, const CoverageMask& refCoverage,
+                const ImageView& optColor, const CoverageMask& optCoverage,
+                const ImageView& errorMap, bool invert,
+                Color8 background, Color8 heatmapBg, float errorMultiplier,
+                const PixelPassTargets& out
+        );
+
+        /**
+         * @brief Normal 阶段，返回法线 MSE
+         * @param refNormals / optNormals RGB32F 法线 (N*0.5+0.5)
+         * @param refBytes / optBytes GPU 量化后的法线颜色 (RGB8)，用于展示
+         * 浮点法线为 (0,0,0) 的像素为清屏背景；MSE 只统计至少一侧被覆盖的像素，裁剪掉的背景不影响结果
+         */
+        static double NormalPass(
+                const ImageView& refNormals, const ImageView& refBytes,
+                const ImageView& optNormals, const ImageView& optBytes,
+                Color8 background, Color8 heatmapBg,
+                const PixelPassTargets& out
+        );
+
+        /**
+         * @brief Normal 阶段 (紧凑回读)，返回法线 MSE
+         * 输入为 RG16 八面体编码法线与覆盖掩码，逐像素即时解码
+         */
+        static double NormalPassCompact(
+                const ImageView& refOct, const CoverageMask& refCoverage,
+                const ImageView& optOct, const CoverageMask& optCoverage,
+                Color8 background, Color8 heatmapBg,
+                const PixelPassTargets& out
+        );
+
+        /**
+         * @brief 色调映射后处理: 线性辐射度 (RGBA16F，pbr.frag 在曝光之前的输出) -> RGB8，供曝光 / 算子扫描复用 ColorPass
+         * 被覆盖的像素: ToneMap(c * exposure) 后做 1/2.2 gamma 并四舍五入量化；与 GPU 写入后按 8bit 回读的结果最多相差 1 级，
+         * 只出现在舍入边界附近 (线性值以 RGBA16F 存储，驱动的 pow / 定点转换精度不同)；
+         * 未覆盖的像素: skybox 为 true 时与 background.frag 相同 (Reinhard，不乘曝光)，否则为清屏背景色 background
+         * @param out RGB8，尺寸与 linear 一致
+         */
+        static void ToneMapPass(
+                const ImageView& linear, const CoverageMask& coverage,
+                float exposure, ToneOperator op, bool skybox, Color8 background,
+                const MutableImageView& out
+        );
+
+        /**
+         * @brief 把区域大小的 RGBA8 图像补齐为整幅画面: 区域外填入 fill，区域内逐行拷贝
+         * 用于按 ROI 计算的热力图以整幅画面输出 (与上传到热力图面板的结果一致)；行序与 region 的坐标系一致
+         * @param out RGBA8，尺寸为 region.frameWidth x region.frameHeight
+         */
+        static void PadToFrame(const ImageView& regionPixels, const FrameRegion& region, Color8 fill, const MutableImageView& out);
+
+        /**
+         * @brief Silhouette 阶段，返回轮廓误差
+         * 输入为按位打包的轮廓掩码，误差为 popcount(a XOR b)，展示图中轮廓填入 silhouetteColor
+         * @param backgroundPixels 裁剪区域之外的像素数 (不含轮廓，只计入分母)
+         */
+        static double SilhouettePass(
+                const PackedMask& refSil,
+                const PackedMask& optSil,
+                Color8 background, Color8 silhouetteColor, Color8 heatmapBg,
+                const PixelPassTargets& out, size_t backgroundPixels = 0
+        );
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+namespace Metrics {
+
+    /**
+     * @brief 逐视角误差的在线均值 / 方差 (Welford 算法，单次遍历且数值稳定)
+     * 用于渐进式视角采样: 均值的置信区间半宽 z * s / sqrt(n) 达到容差后提前结束当前阶段。
+     */
+    class RunningStats {
+    public:
+        void Reset() {
+            count = 0;
+            mean = 0.0;
+            m2 = 0.0;
+        }
+
+        void Add(double value) {
+            ++count;
+            double delta = value - mean;
+            mean += delta / static_cast<double>(count);
+            m2 += delta * (value - mean);
+        }
+
+        size_t Count() const { return count; }
+        double Mean() const { return mean; }
+        // 无偏样本方差 (n - 1)
+        double Variance() const { return (count > 1) ? m2 / static_cast<double>(count - 1) : 0.0; }
+
+        // 均值的置信区间半宽；样本不足 2 个时无法估计，返回无穷大
+        double HalfWidth(double z) const {
+            if (count < 2) return std::numeric_limits<double>::infinity();
+            return z * std::sqrt(Variance() / static_cast<double>(count));
+        }
+
+    private:
+        size_t count = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+    };
+}
@@ -0,0 +1,693 @@
+// 该文件不使用预编译头 (见 CMakeLists.txt)，自行包含所需的标准库头文件
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include "SimdKernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VM_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define VM_SIMD_X86 0
+#endif
+
+// GCC/Clang 需要按函数开启目标指令集；MSVC 允许直接使用内建函数
+#if defined(_MSC_VER) && !defined(__clang__)
+#define VM_TARGET(x)
+#else
+#define VM_TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace Metrics {
+namespace Simd {
+
+    static inline size_t PopCount(uint64_t v) {
+        return std::bitset<64>(v).count();
+    }
+
+    // 每个像素由 3 个连续比较位表示，统计三位全为 1 的像素数
+    // bits: 第 k 位对应第 k 个通道分量；mask: 每个像素首位 (0b...001001001)
+    static inline size_t CountTriples(uint64_t bits, uint64_t mask) {
+        return PopCount(bits & (bits >> 1) & (bits >> 2) & mask);
+    }
+
+    // =========================================================
+    // 标量实现 (基准 & 尾部处理)
+    // =========================================================
+    static uint64_t SSD_U8_Scalar(const uint8_t* a, const uint8_t* b, size_t n) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            int d = static_cast<int>(a[i]) - static_cast<int>(b[i]);
+            sum += static_cast<uint64_t>(d * d);
+        }
+        return sum;
+    }
+
+    // 浮点累加采用固定的 16 路交错顺序：第 i 个元素累加到 lanes[i % 16]，
+    // 最后按固定的二叉树归并，尾部元素再串行累加。各指令集路径严格遵循同一顺序，
+    // 因此结果与标量路径逐位一致 (不依赖 CPU 能力)
+    static const size_t FLOAT_LANES = 16;
+
+    static double ReduceLanes(const double* lanes) {
+        double l8[8], l4[4];
+        for (int k = 0; k < 8; ++k) l8[k] = lanes[k] + lanes[k + 8];
+        for (int k = 0; k < 4; ++k) l4[k] = l8[k] + l8[k + 4];
+        return (l4[0] + l4[2]) + (l4[1] + l4[3]);
+    }
+
+    static double SSD_F32_Tail(const float* a, const float* b, size_t n) {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double d = static_cast<double>(a[i] - b[i]);
+            sum += d * d;
+        }
+        return sum;
+    }
+
+    static double SSD_F16_Tail(const uint16_t* a, const uint16_t* b, size_t n) {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double d = static_cast<double>(HalfToFloat(a[i]) - HalfToFloat(b[i]));
+            sum += d * d;
+        }
+        return sum;
+    }
+
+    static double SSD_F32_Scalar(const float* a, const float* b, size_t n) {
+        double lanes[FLOAT_LANES] = {};
+        size_t i = 0;
+        for (; i + FLOAT_LANES <= n; i += FLOAT_LANES) {
+            for (size_t k = 0; k < FLOAT_LANES; ++k) {
+                double d = static_cast<double>(a[i + k] - b[i + k]);
+                lanes[k] += d * d;
+            }
+        }
+        return ReduceLanes(lanes) + SSD_F32_Tail(a + i, b + i, n - i);
+    }
+
+    static double SSD_F16_Scalar(const uint16_t* a, const uint16_t* b, size_t n) {
+        double lanes[FLOAT_LANES] = {};
+        size_t i = 0;
+        for (; i + FLOAT_LANES <= n; i += FLOAT_LANES) {
+            for (size_t k = 0; k < FLOAT_LANES; ++k) {
+                double d = static_cast<double>(HalfToFloat(a[i + k]) - HalfToFloat(b[i + k]));
+                lanes[k] += d * d;
+            }
+        }
+        return ReduceLanes(lanes) + SSD_F16_Tail(a + i, b + i, n - i);
+    }
+
+    static size_t CountBackground_Scalar(const float* a, const float* b, size_t pixels) {
+        size_t bg = 0;
+        for (size_t i = 0; i < pixels; ++i) {
+            if (a[i * 3] == 0.0f && a[i * 3 + 1] == 0.0f && a[i * 3 + 2] == 0.0f &&
+                b[i * 3] == 0.0f && b[i * 3 + 1] == 0.0f && b[i * 3 + 2] == 0.0f) {
+                bg++;
+            }
+        }
+        return bg;
+    }
+
+    static size_t Mismatch_Scalar(const uint8_t* a, const uint8_t* b, size_t n) {
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i) {
+            count += ((a[i] > 0) != (b[i] > 0)) ? 1 : 0;
+        }
+        return count;
+    }
+
+    // 第 i 个像素写入 dst[i / 64] 的第 i % 64 位，末尾不足 64 的位补 0
+    static void PackMask_Scalar(const uint8_t* src, size_t n, uint64_t* dst) {
+        size_t words = (n + 63) / 64;
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t bits = 0;
+            size_t end = std::min<size_t>(64, n - w * 64);
+            for (size_t k = 0; k < end; ++k) {
+                bits |= static_cast<uint64_t>(src[w * 64 + k] > 0) << k;
+            }
+            dst[w] = bits;
+        }
+    }
+
+    static size_t BitMismatch_Scalar(const uint64_t* a, const uint64_t* b, size_t words) {
+        size_t count = 0;
+        for (size_t w = 0; w < words; ++w) count += PopCount(a[w] ^ b[w]);
+        return count;
+    }
+
+    static void ScaledAdd_Scalar(float* dst, const float* src, float scale, size_t n) {
+        for (size_t i = 0; i < n; ++i) dst[i] += scale * src[i];
+    }
+
+#if VM_SIMD_X86
+    // int32 累加器每批最多处理的迭代数：每次迭代单个 lane 最多增加 2 * 2 * 255^2 = 260100，
+    // 4096 次迭代后仍远低于 INT32_MAX，之后再扩展到 64 位
+    static const size_t U8_BATCH = 4096;
+
+    // =========================================================
+    // SSE2
+    // =========================================================
+    static uint64_t SSD_U8_SSE2(const uint8_t* a, const uint8_t* b, size_t n) {
+        const __m128i zero = _mm_setzero_si128();
+        uint64_t total = 0;
+        size_t i = 0;
+        while (i + 16 <= n) {
+            __m128i acc = zero;
+            size_t batchEnd = std::min(n - (n - i) % 16, i + U8_BATCH * 16);
+            for (; i < batchEnd; i += 16) {
+                __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+                __m128i dLo = _mm_sub_epi16(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero));
+                __m128i dHi = _mm_sub_epi16(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero));
+                acc = _mm_add_epi32(acc, _mm_madd_epi16(dLo, dLo));
+                acc = _mm_add_epi32(acc, _mm_madd_epi16(dHi, dHi));
+            }
+            alignas(16) int32_t lanes[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+            for (int32_t v : lanes) total += static_cast<uint64_t>(v);
+        }
+        return total + SSD_U8_Scalar(a + i, b + i, n - i);
+    }
+
+    static double SSD_F32_SSE2(const float* a, const float* b, size_t n) {
+        // 8 个累加器 x 2 lane = 16 路，acc[k] 对应块内元素 2k, 2k+1
+        __m128d acc[8];
+        for (int k = 0; k < 8; ++k) acc[k] = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + FLOAT_LANES <= n; i += FLOAT_LANES) {
+            for (int q = 0; q < 4; ++q) {
+                __m128 d = _mm_sub_ps(_mm_loadu_ps(a + i + q * 4), _mm_loadu_ps(b + i + q * 4));
+                __m128d lo = _mm_cvtps_pd(d);
+                __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(d, d));
+                acc[q * 2] = _mm_add_pd(acc[q * 2], _mm_mul_pd(lo, lo));
+                acc[q * 2 + 1] = _mm_add_pd(acc[q * 2 + 1], _mm_mul_pd(hi, hi));
+            }
+        }
+        alignas(16) double lanes[FLOAT_LANES];
+        for (int k = 0; k < 8; ++k) _mm_store_pd(lanes + k * 2, acc[k]);
+        return ReduceLanes(lanes) + SSD_F32_Tail(a + i, b + i, n - i);
+    }
+
+    static size_t CountBackground_SSE2(const float* a, const float* b, size_t pixels) {
+        const __m128 zero = _mm_setzero_ps();
+        size_t bg = 0;
+        size_t p = 0;
+        for (; p + 4 <= pixels; p += 4) {
+            const float* pa = a + p * 3;
+            const float* pb = b + p * 3;
+            uint64_t bits = 0;
+            for (int k = 0; k < 3; ++k) {
+                __m128 m = _mm_and_ps(_mm_cmpeq_ps(_mm_loadu_ps(pa + k * 4), zero),
+                                      _mm_cmpeq_ps(_mm_loadu_ps(pb + k * 4), zero));
+                bits |= static_cast<uint64_t>(_mm_movemask_ps(m)) << (k * 4);
+            }
+            bg += CountTriples(bits, 0x249ull);
+        }
+        return bg + CountBackground_Scalar(a + p * 3, b + p * 3, pixels - p);
+    }
+
+    static size_t Mismatch_SSE2(const uint8_t* a, const uint8_t* b, size_t n) {
+        const __m128i zero = _mm_setzero_si128();
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i za = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), zero);
+            __m128i zb = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)), zero);
+            count += PopCount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_xor_si128(za, zb))));
+        }
+        return count + Mismatch_Scalar(a + i, b + i, n - i);
+    }
+
+    static void PackMask_SSE2(const uint8_t* src, size_t n, uint64_t* dst) {
+        const __m128i zero = _mm_setzero_si128();
+        size_t fullWords = n / 64;
+        for (size_t w = 0; w < fullWords; ++w) {
+            uint64_t zeroBits = 0;
+            for (int q = 0; q < 4; ++q) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + w * 64 + q * 16));
+                zeroBits |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)))) << (q * 16);
+            }
+            dst[w] = ~zeroBits;
+        }
+        PackMask_Scalar(src + fullWords * 64, n - fullWords * 64, dst + fullWords);
+    }
+
+    static void ScaledAdd_SSE2(float* dst, const float* src, float scale, size_t n) {
+        const __m128 s = _mm_set1_ps(scale);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 v = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(s, _mm_loadu_ps(src + i)));
+            _mm_storeu_ps(dst + i, v);
+        }
+        ScaledAdd_Scalar(dst + i, src + i, scale, n - i);
+    }
+
+    // =========================================================
+    // AVX2 (+F16C)
+    // =========================================================
+    VM_TARGET("avx2")
+    static uint64_t SSD_U8_AVX2(const uint8_t* a, const uint8_t* b, size_t n) {
+        uint64_t total = 0;
+        size_t i = 0;
+        while (i + 32 <= n) {
+            __m256i acc = _mm256_setzero_si256();
+            size_t batchEnd = std::min(n - (n - i) % 32, i + U8_BATCH * 32);
+            for (; i < batchEnd; i += 32) {
+                __m256i a0 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+                __m256i b0 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+                __m256i a1 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16)));
+                __m256i b1 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16)));
+                __m256i d0 = _mm256_sub_epi16(a0, b0);
+                __m256i d1 = _mm256_sub_epi16(a1, b1);
+                acc = _mm256_add_epi32(acc, _mm256_madd_epi16(d0, d0));
+                acc = _mm256_add_epi32(acc, _mm256_madd_epi16(d1, d1));
+            }
+            alignas(32) int32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+            for (int32_t v : lanes) total += static_cast<uint64_t>(v);
+        }
+        return total + SSD_U8_Scalar(a + i, b + i, n - i);
+    }
+
+    // 4 个累加器 x 4 lane = 16 路，acc[k] 对应块内元素 4k..4k+3
+    VM_TARGET("avx2")
+    static void AccumulateSquares256(__m256 d, __m256d& accLo, __m256d& accHi) {
+        __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(d));
+        __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(d, 1));
+        accLo = _mm256_add_pd(accLo, _mm256_mul_pd(lo, lo));
+        accHi = _mm256_add_pd(accHi, _mm256_mul_pd(hi, hi));
+    }
+
+    VM_TARGET("avx2")
+    static double ReduceAccumulators256(const __m256d* acc) {
+        alignas(32) double lanes[FLOAT_LANES];
+        for (int k = 0; k < 4; ++k) _mm256_store_pd(lanes + k * 4, acc[k]);
+        return ReduceLanes(lanes);
+    }
+
+    VM_TARGET("avx2")
+    static double SSD_F32_AVX2(const float* a, const float* b, size_t n) {
+        __m256d acc[4];
+        for (int k = 0; k < 4; ++k) acc[k] = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + FLOAT_LANES <= n; i += FLOAT_LANES) {
+            AccumulateSquares256(_mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)), acc[0], acc[1]);
+            AccumulateSquares256(_mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)), acc[2], acc[3]);
+        }
+        return ReduceAccumulators256(acc) + SSD_F32_Tail(a + i, b + i, n - i);
+    }
+
+    VM_TARGET("avx2,f16c")
+    static __m256 LoadHalf8(const uint16_t* p) {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    }
+
+    VM_TARGET("avx2,f16c")
+    static double SSD_F16_AVX2(const uint16_t* a, const uint16_t* b, size_t n) {
+        __m256d acc[4];
+        for (int k = 0; k < 4; ++k) acc[k] = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + FLOAT_LANES <= n; i += FLOAT_LANES) {
+            AccumulateSquares256(_mm256_sub_ps(LoadHalf8(a + i), LoadHalf8(b + i)), acc[0], acc[1]);
+            AccumulateSquares256(_mm256_sub_ps(LoadHalf8(a + i + 8), LoadHalf8(b + i + 8)), acc[2], acc[3]);
+        }
+        return ReduceAccumulators256(acc) + SSD_F16_Tail(a + i, b + i, n - i);
+    }
+
+    VM_TARGET("avx2")
+    static size_t CountBackground_AVX2(const float* a, const float* b, size_t pixels) {
+        const __m256 zero = _mm256_setzero_ps();
+        size_t bg = 0;
+        size_t p = 0;
+        for (; p + 8 <= pixels; p += 8) {
+            const float* pa = a + p * 3;
+            const float* pb = b + p * 3;
+            uint64_t bits = 0;
+            for (int k = 0; k < 3; ++k) {
+                __m256 m = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(pa + k * 8), zero, _CMP_EQ_OQ),
+                                         _mm256_cmp_ps(_mm256_loadu_ps(pb + k * 8), zero, _CMP_EQ_OQ));
+                bits |= static_cast<uint64_t>(_mm256_movemask_ps(m)) << (k * 8);
+            }
+            bg += CountTriples(bits, 0x249249ull);
+        }
+        return bg + CountBackground_Scalar(a + p * 3, b + p * 3, pixels - p);
+    }
+
+    VM_TARGET("avx2")
+    static size_t Mismatch_AVX2(const uint8_t* a, const uint8_t* b, size_t n) {
+        const __m256i zero = _mm256_setzero_si256();
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i za = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), zero);
+            __m256i zb = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)), zero);
+            count += PopCount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_xor_si256(za, zb))));
+        }
+        return count + Mismatch_Scalar(a + i, b + i, n - i);
+    }
+
+    VM_TARGET("avx2")
+    static void PackMask_AVX2(const uint8_t* src, size_t n, uint64_t* dst) {
+        const __m256i zero = _mm256_setzero_si256();
+        size_t fullWords = n / 64;
+        for (size_t w = 0; w < fullWords; ++w) {
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + w * 64));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + w * 64 + 32));
+            uint64_t zeroLo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, zero)));
+            uint64_t zeroHi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, zero)));
+            dst[w] = ~(zeroLo | (zeroHi << 32));
+        }
+        PackMask_Scalar(src + fullWords * 64, n - fullWords * 64, dst + fullWords);
+    }
+
+    VM_TARGET("avx2")
+    static void ScaledAdd_AVX2(float* dst, const float* src, float scale, size_t n) {
+        const __m256 s = _mm256_set1_ps(scale);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 v = _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(s, _mm256_loadu_ps(src + i)));
+            _mm256_storeu_ps(dst + i, v);
+        }
+        ScaledAdd_Scalar(dst + i, src + i, scale, n - i);
+    }
+
+#if defined(__x86_64__) || defined(_M_X64)
+    // AVX2 级别的 CPU 均支持 POPCNT 指令
+    VM_TARGET("popcnt")
+    static size_t BitMismatch_Popcnt(const uint64_t* a, const uint64_t* b, size_t words) {
+        size_t count = 0;
+        for (size_t w = 0; w < words; ++w) {
+            count += static_cast<size_t>(_mm_popcnt_u64(a[w] ^ b[w]));
+        }
+        return count;
+    }
+#else
+    static size_t BitMismatch_Popcnt(const uint64_t* a, const uint64_t* b, size_t words) {
+        return BitMismatch_Scalar(a, b, words);
+    }
+#endif
+
+    // =========================================================
+    // AVX-512 (F + BW)
+    // =========================================================
+#if defined(__GNUC__) && !defined(__clang__)
+    // GCC 12 的 avx512fintrin.h 中 _mm512_undefined_pd 会触发误报
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    VM_TARGET("avx512f,avx512bw")
+    static uint64_t SSD_U8_AVX512(const uint8_t* a, const uint8_t* b, size_t n) {
+        uint64_t total = 0;
+        size_t i = 0;
+        while (i + 64 <= n) {
+            __m512i acc = _mm512_setzero_si512();
+            size_t batchEnd = std::min(n - (n - i) % 64, i + U8_BATCH * 64);
+            for (; i < batchEnd; i += 64) {
+                __m512i a0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+                __m512i b0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+                __m512i a1 = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32)));
+                __m512i b1 = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32)));
+                __m512i d0 = _mm512_sub_epi16(a0, b0);
+                __m512i d1 = _mm512_sub_epi16(a1, b1);
+                acc = _mm512_add_epi32(acc, _mm512_madd_epi16(d0, d0));
+                acc = _mm512_add_epi32(acc, _mm512_madd_epi16(d1, d1));
+            }
+            alignas(64) int32_t lanes[16];
+            _mm512_store_si512(reinterpret_cast<__m512i*>(lanes), acc);
+            for (int32_t v : lanes) total += static_cast<uint64_t>(v);
+        }
+        return total + SSD_U8_Scalar(a + i, b + i, n - i);
+    }
+
+    // 2 个累加器 x 8 lane = 16 路，acc0 对应块内元素 0..7，acc1 对应 8..15
+    VM_TARGET("avx512f")
+    static double ReduceAccumulators512(__m512d acc0, __m512d acc1) {
+        alignas(64) double lanes[FLOAT_LANES];
+        _mm512_store_pd(lanes, acc0);
+        _mm512_store_pd(lanes + 8, acc1);
+        return ReduceLanes(lanes);
+    }
+
+    VM_TARGET("avx512f")
+    static void AccumulateSquares512(__m256 dLo, __m256 dHi, __m512d& acc0, __m512d& acc1) {
+        __m512d lo = _mm512_cvtps_pd(dLo);
+        __m512d hi = _mm512_cvtps_pd(dHi);
+        acc0 = _mm512_add_pd(acc0, _mm512_mul_pd(lo, lo));
+        acc1 = _mm512_add_pd(acc1, _mm512_mul_pd(hi, hi));
+    }
+
+    VM_TARGET("avx512f")
+    static double SSD_F32_AVX512(const float* a, const float* b, size_t n) {
+        __m512d acc0 = _mm512_setzero_pd();
+        __m512d acc1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + FLOAT_LANES <= n; i += FLOAT_LANES) {
+            __m256 dLo = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+            __m256 dHi = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+            AccumulateSquares512(dLo, dHi, acc0, acc1);
+        }
+        return ReduceAccumulators512(acc0, acc1) + SSD_F32_Tail(a + i, b + i, n - i);
+    }
+
+    VM_TARGET("avx512f,f16c")
+    static double SSD_F16_AVX512(const uint16_t* a, const uint16_t* b, size_t n) {
+        __m512d acc0 = _mm512_setzero_pd();
+        __m512d acc1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + FLOAT_LANES <= n; i += FLOAT_LANES) {
+            __m256 dLo = _mm256_sub_ps(LoadHalf8(a + i), LoadHalf8(b + i));
+            __m256 dHi = _mm256_sub_ps(LoadHalf8(a + i + 8), LoadHalf8(b + i + 8));
+            AccumulateSquares512(dLo, dHi, acc0, acc1);
+        }
+        return ReduceAccumulators512(acc0, acc1) + SSD_F16_Tail(a + i, b + i, n - i);
+    }
+
+    VM_TARGET("avx512f")
+    static size_t CountBackground_AVX512(const float* a, const float* b, size_t pixels) {
+        const __m512 zero = _mm512_setzero_ps();
+        size_t bg = 0;
+        size_t p = 0;
+        for (; p + 16 <= pixels; p += 16) {
+            const float* pa = a + p * 3;
+            const float* pb = b + p * 3;
+            uint64_t bits = 0;
+            for (int k = 0; k < 3; ++k) {
+                __mmask16 m = _mm512_cmp_ps_mask(_mm512_loadu_ps(pa + k * 16), zero, _CMP_EQ_OQ) &
+                              _mm512_cmp_ps_mask(_mm512_loadu_ps(pb + k * 16), zero, _CMP_EQ_OQ);
+                bits |= static_cast<uint64_t>(m) << (k * 16);
+            }
+            bg += CountTriples(bits, 0x249249249249ull);
+        }
+        return bg + CountBackground_Scalar(a + p * 3, b + p * 3, pixels - p);
+    }
+
+    VM_TARGET("avx512f,avx512bw")
+    static size_t Mismatch_AVX512(const uint8_t* a, const uint8_t* b, size_t n) {
+        const __m512i zero = _mm512_setzero_si512();
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64) {
+            __mmask64 za = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(a + i), zero);
+            __mmask64 zb = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(b + i), zero);
+            count += PopCount(static_cast<uint64_t>(za ^ zb));
+        }
+        return count + Mismatch_Scalar(a + i, b + i, n - i);
+    }
+
+    VM_TARGET("avx512f,avx512bw")
+    static void PackMask_AVX512(const uint8_t* src, size_t n, uint64_t* dst) {
+        size_t fullWords = n / 64;
+        for (size_t w = 0; w < fullWords; ++w) {
+            __m512i v = _mm512_loadu_si512(src + w * 64);
+            dst[w] = static_cast<uint64_t>(_mm512_test_epi8_mask(v, v));
+        }
+        PackMask_Scalar(src + fullWords * 64, n - fullWords * 64, dst + fullWords);
+    }
+
+    VM_TARGET("avx512f")
+    static void ScaledAdd_AVX512(float* dst, const float* src, float scale, size_t n) {
+        const __m512 s = _mm512_set1_ps(scale);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m512 v = _mm512_add_ps(_mm512_loadu_ps(dst + i), _mm512_mul_ps(s, _mm512_loadu_ps(src + i)));
+            _mm512_storeu_ps(dst + i, v);
+        }
+        ScaledAdd_Scalar(dst + i, src + i, scale, n - i);
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+    // =========================================================
+    // CPU 特性检测
+    // =========================================================
+#if defined(_MSC_VER) && !defined(__clang__)
+    static Level DetectLevelImpl() {
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        bool f16c = (info[2] & (1 << 29)) != 0;
+
+        bool avx2 = false, avx512f = false, avx512bw = false;
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+            avx512f = (info[1] & (1 << 16)) != 0;
+            avx512bw = (info[1] & (1 << 30)) != 0;
+        }
+
+        // 还需确认操作系统保存了 YMM/ZMM 寄存器状态
+        unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        bool osAVX = (xcr0 & 0x6) == 0x6;
+        bool osAVX512 = (xcr0 & 0xE6) == 0xE6;
+
+        // AVX-512 级别的 half 内核仍用 F16C 转换，且 SetLevel 可降到 AVX2，因此同时要求 AVX2 级别的全部特性
+        bool levelAVX2 = osAVX && avx && avx2 && f16c;
+        if (levelAVX2 && osAVX512 && avx512f && avx512bw) return Level::AVX512;
+        if (levelAVX2) return Level::AVX2;
+        return sse2 ? Level::SSE2 : Level::Scalar;
+    }
+#else
+    static Level DetectLevelImpl() {
+        __builtin_cpu_init();
+        // AVX-512 级别的 half 内核仍用 F16C 转换，且 SetLevel 可降到 AVX2，因此同时要求 AVX2 级别的全部特性
+        bool levelAVX2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+        if (levelAVX2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return Level::AVX512;
+        if (levelAVX2) return Level::AVX2;
+        if (__builtin_cpu_supports("sse2")) return Level::SSE2;
+        return Level::Scalar;
+    }
+#endif
+
+#else
+    static Level DetectLevelImpl() { return Level::Scalar; }
+#endif
+
+    static std::atomic<int>& CurrentLevel() {
+        static std::atomic<int> level{ static_cast<int>(DetectLevel()) };
+        return level;
+    }
+
+    Level DetectLevel() {
+        static const Level detected = DetectLevelImpl();
+        return detected;
+    }
+
+    Level GetLevel() {
+        return static_cast<Level>(CurrentLevel().load(std::memory_order_relaxed));
+    }
+
+    void SetLevel(Level level) {
+        int clamped = std::min(static_cast<int>(level), static_cast<int>(DetectLevel()));
+        CurrentLevel().store(clamped, std::memory_order_relaxed);
+    }
+
+    const char* LevelName(Level level) {
+        switch (level) {
+            case Level::SSE2:   return "SSE2";
+            case Level::AVX2:   return "AVX2";
+            case Level::AVX512: return "AVX-512";
+            default:            return "Scalar";
+        }
+    }
+
+    // =========================================================
+    // 对外接口 (按当前等级分发)
+    // =========================================================
+    uint64_t SumSquaredDiffU8(const uint8_t* a, const uint8_t* b, size_t count) {
+        switch (GetLevel()) {
+#if VM_SIMD_X86
+            case Level::AVX512: return SSD_U8_AVX512(a, b, count);
+            case Level::AVX2:   return SSD_U8_AVX2(a, b, count);
+            case Level::SSE2:   return SSD_U8_SSE2(a, b, count);
+#endif
+            default:            return SSD_U8_Scalar(a, b, count);
+        }
+    }
+
+    double SumSquaredDiffF32(const float* a, const float* b, size_t count) {
+        switch (GetLevel()) {
+#if VM_SIMD_X86
+            case Level::AVX512: return SSD_F32_AVX512(a, b, count);
+            case Level::AVX2:   return SSD_F32_AVX2(a, b, count);
+            case Level::SSE2:   return SSD_F32_SSE2(a, b, count);
+#endif
+            default:            return SSD_F32_Scalar(a, b, count);
+        }
+    }
+
+    double SumSquaredDiffF16(const uint16_t* a, const uint16_t* b, size_t count) {
+        switch (GetLevel()) {
+#if VM_SIMD_X86
+            case Level::AVX512: return SSD_F16_AVX512(a, b, count);
+            case Level::AVX2:   return SSD_F16_AVX2(a, b, count);
+#endif
+            default:            return SSD_F16_Scalar(a, b, count); // SSE2 无硬件半精度转换
+        }
+    }
+
+    double NormalSquaredDiff(const float* a, const float* b, size_t pixelCount, size_t& validPixels) {
+        size_t background = 0;
+        switch (GetLevel()) {
+#if VM_SIMD_X86
+            case Level::AVX512: background = CountBackground_AVX512(a, b, pixelCount); break;
+            case Level::AVX2:   background = CountBackground_AVX2(a, b, pixelCount); break;
+            case Level::SSE2:   background = CountBackground_SSE2(a, b, pixelCount); break;
+#endif
+            default:            background = CountBackground_Scalar(a, b, pixelCount); break;
+        }
+        validPixels = pixelCount - background;
+        return SumSquaredDiffF32(a, b, pixelCount * 3);
+    }
+
+    size_t CountMaskMismatch(const uint8_t* a, const uint8_t* b, size_t count) {
+        switch (GetLevel()) {
+#if VM_SIMD_X86
+            case Level::AVX512: return Mismatch_AVX512(a, b, count);
+            case Level::AVX2:   return Mismatch_AVX2(a, b, count);
+            case Level::SSE2:   return Mismatch_SSE2(a, b, count);
+#endif
+            default:            return Mismatch_Scalar(a, b, count);
+        }
+    }
+
+    void PackMask(const uint8_t* src, size_t count, uint64_t* dst) {
+        switch (GetLevel()) {
+#if VM_SIMD_X86
+            case Level::AVX512: PackMask_AVX512(src, count, dst); break;
+            case Level::AVX2:   PackMask_AVX2(src, count, dst); break;
+            case Level::SSE2:   PackMask_SSE2(src, count, dst); break;
+#endif
+            default:            PackMask_Scalar(src, count, dst); break;
+        }
+    }
+
+    size_t CountBitMismatch(const uint64_t* a, const uint64_t* b, size_t words) {
+#if VM_SIMD_X86
+        if (GetLevel() >= Level::AVX2) return BitMismatch_Popcnt(a, b, words);
+#endif
+        return BitMismatch_Scalar(a, b, words);
+    }
+
+    void ScaledAdd(float* dst, const float* src, float scale, size_t count) {
+        switch (GetLevel()) {
+#if VM_SIMD_X86
+            case Level::AVX512: ScaledAdd_AVX512(dst, src, scale, count); break;
+            case Level::AVX2:   ScaledAdd_AVX2(dst, src, scale, count); break;
+            case Level::SSE2:   ScaledAdd_SSE2(dst, src, scale, count); break;
+#endif
+            default:            ScaledAdd_Scalar(dst, src, scale, count); break;
+        }
+    }
+}
+}
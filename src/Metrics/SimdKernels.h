@@ -0,0 +1,105 @@
+#pragma once
+
+namespace Metrics {
+namespace Simd {
+
+    // 指令集等级 (按能力递增)
+    enum class Level {
+        Scalar = 0,
+        SSE2 = 1,
+        AVX2 = 2,    // AVX2 + F16C
+        AVX512 = 3   // AVX-512F + AVX-512BW (同时要求 AVX2 + F16C)
+    };
+
+    // 运行时检测 CPU 支持的最高等级 (结果会被缓存)
+    Level DetectLevel();
+    // 当前使用的等级，默认为检测结果
+    Level GetLevel();
+    // 强制指定等级 (用于对照测试/基准)，超过 CPU 能力时会被钳制到检测结果
+    void SetLevel(Level level);
+    const char* LevelName(Level level);
+
+    // IEEE 754 半精度 -> 单精度 (标量实现，精确转换)
+    inline float HalfToFloat(uint16_t h) {
+        uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+        uint32_t exp = (h >> 10) & 0x1Fu;
+        uint32_t mant = h & 0x3FFu;
+        uint32_t bits;
+        if (exp == 0) {
+            if (mant == 0) {
+                bits = sign;
+            } else {
+                // 非规格化数：归一化尾数
+                exp = 127 - 15 + 1;
+                while ((mant & 0x400u) == 0) { mant <<= 1; exp--; }
+                mant &= 0x3FFu;
+                bits = sign | (exp << 23) | (mant << 13);
+            }
+        } else if (exp == 0x1F) {
+            bits = sign | 0x7F800000u | (mant << 13);
+        } else {
+            bits = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+        }
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    // 单精度 -> IEEE 754 半精度 (标量实现，就近舍入到偶数；超出范围饱和为 Inf，NaN 保持为 NaN)
+    inline uint16_t FloatToHalf(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+        const uint32_t absBits = bits & 0x7FFFFFFFu;
+        if (absBits >= 0x7F800000u) return static_cast<uint16_t>(sign | (absBits > 0x7F800000u ? 0x7E00u : 0x7C00u));
+        if (absBits >= 0x477FF000u) return static_cast<uint16_t>(sign | 0x7C00u);   // >= 65520 舍入后溢出
+        if (absBits < 0x38800000u) {
+            // 非规格化数 (含 0): 以 2^-24 为单位就近舍入
+            if (absBits < 0x33000000u) return sign;
+            const uint32_t exp = absBits >> 23;
+            const uint32_t mant = (absBits & 0x7FFFFFu) | 0x800000u;
+            const uint32_t shift = 126 - exp;   // 14..24
+            uint32_t half = mant >> shift;
+            const uint32_t rest = mant & ((1u << shift) - 1u);
+            const uint32_t halfway = 1u << (shift - 1);
+            if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+            return static_cast<uint16_t>(sign | half);
+        }
+        uint32_t half = ((absBits >> 13) - ((127u - 15u) << 10));
+        const uint32_t rest = absBits & 0x1FFFu;
+        if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // --- 误差内核 (根据当前等级分发) ---
+
+    // uint8 平方差和，整数累加，结果精确
+    uint64_t SumSquaredDiffU8(const uint8_t* a, const uint8_t* b, size_t count);
+
+    // float 平方差和 (差值以 float 计算，平方与累加使用 double，与标量路径一致)
+    double SumSquaredDiffF32(const float* a, const float* b, size_t count);
+
+    // half 平方差和 (先精确转换为 float，再同 F32)
+    double SumSquaredDiffF16(const uint16_t* a, const uint16_t* b, size_t count);
+
+    // 交错 RGB 法线的平方差和；同时统计有效像素数 (两侧不同时为 (0,0,0) 背景)
+    // 背景像素差值恒为 0，因此不影响平方差和
+    double NormalSquaredDiff(const float* a, const float* b, size_t pixelCount, size_t& validPixels);
+
+    // 统计二值掩码不一致的像素数: (a > 0) != (b > 0)，结果精确
+    size_t CountMaskMismatch(const uint8_t* a, const uint8_t* b, size_t count);
+
+    // 将二值掩码 (src[i] > 0) 按位打包：第 i 个像素写入 dst[i / 64] 的第 i % 64 位
+    // dst 需容纳 (count + 63) / 64 个字，末尾多余的位补 0
+    void PackMask(const uint8_t* src, size_t count, uint64_t* dst);
+
+    // 统计两个打包掩码中不一致的位数: popcount(a XOR b)
+    size_t CountBitMismatch(const uint64_t* a, const uint64_t* b, size_t words);
+
+    // --- 滤波内核 ---
+
+    // dst[i] += scale * src[i] (可分离卷积的单个抽头)
+    // 先乘后加、不使用 FMA，各指令集路径与标量结果逐位一致
+    void ScaledAdd(float* dst, const float* src, float scale, size_t count);
+}
+}
@@ -0,0 +1,316 @@
+#include "SsimEvaluator.h"
+#include "Utils/ParallelUtils.h"
+
+namespace Metrics {
+
+    // 每个任务处理的行数 (固定值，保证部分和的合并顺序与线程数无关)
+    static const int ROWS_PER_BLOCK = 16;
+    static const int MOMENT_COUNT = 5;
+    static const int WINDOW_SIZE = 2 * SsimEvaluator::WINDOW_RADIUS + 1;
+
+    // MS-SSIM 标准权重 (Wang et al. 2003)
+    static const double MS_SSIM_WEIGHTS[SsimEvaluator::MAX_SCALES] = { 0.0448, 0.2856, 0.3001, 0.2363, 0.1333 };
+
+    static const double C1 = (0.01 * 255.0) * (0.01 * 255.0);
+    static const double C2 = (0.03 * 255.0) * (0.03 * 255.0);
+
+    // 亮度以 127.5 为中心存储：方差/协方差 (E[x²] - μ²) 在 float 下的抵消误差随量级平方下降，
+    // 计算亮度项时再把均值加回
+    static const float LUMA_CENTER = 127.5f;
+
+    static int BlockCount(int height) {
+        return (height + ROWS_PER_BLOCK - 1) / ROWS_PER_BLOCK;
+    }
+
+    // 归一化的一维高斯核 (σ = 1.5)
+    static const float* GaussianKernel() {
+        static float kernel[WINDOW_SIZE];
+        static const bool initialized = [] {
+            double weights[WINDOW_SIZE];
+            double sum = 0.0;
+            for (int i = 0; i < WINDOW_SIZE; ++i) {
+                double d = i - SsimEvaluator::WINDOW_RADIUS;
+                weights[i] = std::exp(-(d * d) / (2.0 * 1.5 * 1.5));
+                sum += weights[i];
+            }
+            for (int i = 0; i < WINDOW_SIZE; ++i) kernel[i] = static_cast<float>(weights[i] / sum);
+            return true;
+        }();
+        (void)initialized;
+        return kernel;
+    }
+
+    // 高斯窗口内 5 个矩 (x, y, x², y², xy) 的加权和
+    struct MomentSums {
+        float x = 0.0f, y = 0.0f, xx = 0.0f, yy = 0.0f, xy = 0.0f;
+
+        void Add(float g, float va, float vb) {
+            x += g * va;
+            y += g * vb;
+            xx += g * va * va;
+            yy += g * vb * vb;
+            xy += g * va * vb;
+        }
+    };
+
+    void SsimEvaluator::Reserve(int width, int height) {
+        size_t w = static_cast<size_t>(width), h = static_cast<size_t>(height);
+        for (int s = 0; s < MAX_SCALES; ++s) {
+            lumRef[s].reserve(w * h);
+            lumOpt[s].reserve(w * h);
+            w = std::max<size_t>(1, w / 2);
+            h = std::max<size_t>(1, h / 2);
+        }
+        size_t pixels = static_cast<size_t>(width) * height;
+        size_t blocks = static_cast<size_t>(BlockCount(height));
+        moments.reserve(pixels * MOMENT_COUNT);
+        rowScratch.reserve(blocks * MOMENT_COUNT * width);
+        partialSsim.reserve(blocks);
+        partialCs.reserve(blocks);
+        ssimMap.reserve(pixels);
+    }
+
+    size_t SsimEvaluator::ReservedBytes() const {
+        size_t bytes = (moments.capacity() + rowScratch.capacity() + ssimMap.capacity()) * sizeof(float) +
+                       (partialSsim.capacity() + partialCs.capacity()) * sizeof(double);
+        for (int s = 0; s < MAX_SCALES; ++s) {
+            bytes += (lumRef[s].capacity() + lumOpt[s].capacity()) * sizeof(float);
+        }
+        return bytes;
+    }
+
+    SsimResult SsimEvaluator::Compute(const ImageView& ref, const ImageView& opt, int scales, const FrameRegion* region) {
+        SsimResult result;
+        const int width = ref.width;
+        const int height = ref.height;
+        const int channels = ChannelCount(ref.format);
+        if (!ref.SameShape(opt) || ref.PixelCount() == 0 || channels < 3 ||
+            ref.format == PixelFormat::RGB32F) {
+            std::cerr << "[Metric] Error: SSIM expects two RGB8/RGBA8 views of the same size!" << std::endl;
+            return result;
+        }
+        const bool cropped = region && !region->IsFull();
+        if (cropped && (region->width != width || region->height != height)) {
+            std::cerr << "[Metric] Error: SSIM crop region does not match the view size!" << std::endl;
+            return result;
+        }
+        const int frameWidth = cropped ? region->frameWidth : width;
+        const int frameHeight = cropped ? region->frameHeight : height;
+
+        // 最粗尺度至少要容纳一个完整窗口
+        scales = ClampScales(scales);
+        while (scales > 1 && (std::min(frameWidth, frameHeight) >> (scales - 1)) < WINDOW_SIZE) --scales;
+        result.scales = scales;
+
+        // 1. 亮度 (BT.601，减去 LUMA_CENTER)
+        lumRef[0].resize(ref.PixelCount());
+        lumOpt[0].resize(ref.PixelCount());
+        Utils::ParallelFor(static_cast<size_t>(BlockCount(height)), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(height, yBegin + ROWS_PER_BLOCK);
+            for (int y = yBegin; y < yEnd; ++y) {
+                const unsigned char* a = ref.Row<unsigned char>(y);
+                const unsigned char* b = opt.Row<unsigned char>(y);
+                float* la = &lumRef[0][static_cast<size_t>(y) * width];
+                float* lb = &lumOpt[0][static_cast<size_t>(y) * width];
+                for (int x = 0; x < width; ++x) {
+                    const unsigned char* pa = a + x * channels;
+                    const unsigned char* pb = b + x * channels;
+                    la[x] = 0.299f * pa[0] + 0.587f * pa[1] + 0.114f * pa[2] - LUMA_CENTER;
+                    lb[x] = 0.299f * pb[0] + 0.587f * pb[1] + 0.114f * pb[2] - LUMA_CENTER;
+                }
+            }
+        });
+
+        mapWidth = width;
+        mapHeight = height;
+        ssimMap.resize(ref.PixelCount());
+
+        // 2. 逐尺度计算；尺度 0 同时输出 SSIM 图
+        double weightSum = 0.0;
+        for (int s = 0; s < scales; ++s) weightSum += MS_SSIM_WEIGHTS[s];
+
+        // 区域外背景的亮度: 取区域边缘上一个不贴画面边缘的像素 (外扩保证其为背景)
+        float backgroundLum = 0.0f;
+        if (cropped) {
+            size_t index = 0;
+            if (region->x == 0 && region->x + width < frameWidth) index = static_cast<size_t>(width - 1);
+            else if (region->x == 0 && region->y == 0) index = static_cast<size_t>(height - 1) * width;
+            backgroundLum = lumRef[0][index];
+        }
+
+        double msssim = 1.0;
+        int w = width, h = height;
+        int fw = frameWidth, fh = frameHeight;
+        for (int s = 0; s < scales; ++s) {
+            if (s > 0) {
+                // 2x2 平均下采样
+                int pw = w, ph = h;
+                w = std::max(1, pw / 2);
+                h = std::max(1, ph / 2);
+                fw = std::max(1, fw / 2);
+                fh = std::max(1, fh / 2);
+                backgroundLum = 0.25f * (backgroundLum + backgroundLum + backgroundLum + backgroundLum);
+                lumRef[s].resize(static_cast<size_t>(w) * h);
+                lumOpt[s].resize(static_cast<size_t>(w) * h);
+                const float* srcRef = lumRef[s - 1].data();
+                const float* srcOpt = lumOpt[s - 1].data();
+                float* dstRef = lumRef[s].data();
+                float* dstOpt = lumOpt[s].data();
+                for (int y = 0; y < h; ++y) {
+                    const size_t r0 = static_cast<size_t>(2 * y) * pw;
+                    const size_t r1 = r0 + pw;
+                    for (int x = 0; x < w; ++x) {
+                        dstRef[static_cast<size_t>(y) * w + x] = 0.25f * (srcRef[r0 + 2 * x] + srcRef[r0 + 2 * x + 1] + srcRef[r1 + 2 * x] + srcRef[r1 + 2 * x + 1]);
+                        dstOpt[static_cast<size_t>(y) * w + x] = 0.25f * (srcOpt[r0 + 2 * x] + srcOpt[r0 + 2 * x + 1] + srcOpt[r1 + 2 * x] + srcOpt[r1 + 2 * x + 1]);
+                    }
+                }
+            }
+
+            ScaleStats stats = ComputeScale(lumRef[s].data(), lumOpt[s].data(), w, h, s == 0 ? ssimMap.data() : nullptr);
+            const size_t framePixels = static_cast<size_t>(fw) * fh;
+            const size_t backgroundPixels = framePixels - static_cast<size_t>(w) * h;
+            if (cropped && backgroundPixels > 0) {
+                ScaleStats bg = ConstantPatch(backgroundLum);
+                stats.ssim += bg.ssim * static_cast<double>(backgroundPixels);
+                stats.cs += bg.cs * static_cast<double>(backgroundPixels);
+            }
+            stats.ssim /= static_cast<double>(framePixels);
+            stats.cs /= static_cast<double>(framePixels);
+            if (s == 0) result.ssim = stats.ssim;
+
+            // 负的 cs / SSIM 截断为 0，避免非整数次幂出现 NaN
+            double weight = MS_SSIM_WEIGHTS[s] / weightSum;
+            double term = (s == scales - 1) ? stats.ssim : stats.cs;
+            msssim *= std::pow(std::max(0.0, term), weight);
+        }
+        result.msssim = msssim;
+        return result;
+    }
+
+    SsimEvaluator::ScaleStats SsimEvaluator::ComputeScale(const float* a, const float* b, int w, int h, float* map) {
+        const float* g = GaussianKernel();
+        const size_t plane = static_cast<size_t>(w) * h;
+        const int blocks = BlockCount(h);
+        moments.resize(plane * MOMENT_COUNT);
+        rowScratch.resize(static_cast<size_t>(blocks) * MOMENT_COUNT * w);
+        partialSsim.assign(blocks, 0.0);
+        partialCs.assign(blocks, 0.0);
+
+        float* mx = moments.data();
+        float* my = mx + plane;
+        float* mxx = my + plane;
+        float* myy = mxx + plane;
+        float* mxy = myy + plane;
+
+        // 1. 水平滤波: 5 个矩同时计算
+        Utils::ParallelFor(static_cast<size_t>(blocks), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(h, yBegin + ROWS_PER_BLOCK);
+            for (int y = yBegin; y < yEnd; ++y) {
+                const size_t row = static_cast<size_t>(y) * w;
+                const float* ra = a + row;
+                const float* rb = b + row;
+                auto store = [&](int x, const MomentSums& m) {
+                    mx[row + x] = m.x;
+                    my[row + x] = m.y;
+                    mxx[row + x] = m.xx;
+                    myy[row + x] = m.yy;
+                    mxy[row + x] = m.xy;
+                };
+                // 窗口越界的左右边缘按边缘像素延拓，内部无需钳制
+                auto filterClamped = [&](int x) {
+                    MomentSums m;
+                    for (int k = 0; k < WINDOW_SIZE; ++k) {
+                        int xi = std::max(0, std::min(w - 1, x + k - WINDOW_RADIUS));
+                        m.Add(g[k], ra[xi], rb[xi]);
+                    }
+                    store(x, m);
+                };
+
+                int interiorBegin = std::min(w, WINDOW_RADIUS);
+                int interiorEnd = std::max(interiorBegin, w - WINDOW_RADIUS);
+                for (int x = 0; x < interiorBegin; ++x) filterClamped(x);
+                for (int x = interiorBegin; x < interiorEnd; ++x) {
+                    const float* pa = ra + x - WINDOW_RADIUS;
+                    const float* pb = rb + x - WINDOW_RADIUS;
+                    MomentSums m;
+                    for (int k = 0; k < WINDOW_SIZE; ++k) m.Add(g[k], pa[k], pb[k]);
+                    store(x, m);
+                }
+                for (int x = interiorEnd; x < w; ++x) filterClamped(x);
+            }
+        });
+
+        // 2. 竖直滤波 (按行累加，内层循环连续访问) + 逐像素 SSIM
+        Utils::ParallelFor(static_cast<size_t>(blocks), [&](size_t block) {
+            int yBegin = static_cast<int>(block) * ROWS_PER_BLOCK;
+            int yEnd = std::min(h, yBegin + ROWS_PER_BLOCK);
+            float* acc = &rowScratch[block * MOMENT_COUNT * w];
+            double sumSsim = 0.0, sumCs = 0.0;
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                std::fill(acc, acc + static_cast<size_t>(MOMENT_COUNT) * w, 0.0f);
+                for (int k = 0; k < WINDOW_SIZE; ++k) {
+                    int yi = std::max(0, std::min(h - 1, y + k - WINDOW_RADIUS));
+                    const size_t row = static_cast<size_t>(yi) * w;
+                    const float gk = g[k];
+                    for (int m = 0; m < MOMENT_COUNT; ++m) {
+                        const float* src = mx + m * plane + row;
+                        float* dst = acc + m * w;
+                        for (int x = 0; x < w; ++x) dst[x] += gk * src[x];
+                    }
+                }
+
+                const float* ax = acc;
+                const float* ay = acc + w;
+                const float* axx = acc + 2 * w;
+                const float* ayy = acc + 3 * w;
+                const float* axy = acc + 4 * w;
+                float* mapRow = map ? map + static_cast<size_t>(y) * w : nullptr;
+                for (int x = 0; x < w; ++x) {
+                    double cx = ax[x], cy = ay[x];
+                    double vx = std::max(0.0, axx[x] - cx * cx);
+                    double vy = std::max(0.0, ayy[x] - cy * cy);
+                    double cxy = axy[x] - cx * cy;
+                    double ux = cx + LUMA_CENTER, uy = cy + LUMA_CENTER;
+                    double l = (2.0 * ux * uy + C1) / (ux * ux + uy * uy + C1);
+                    double cs = (2.0 * cxy + C2) / (vx + vy + C2);
+                    sumSsim += l * cs;
+                    sumCs += cs;
+                    if (mapRow) mapRow[x] = static_cast<float>(l * cs);
+                }
+            }
+            partialSsim[block] = sumSsim;
+            partialCs[block] = sumCs;
+        });
+
+        ScaleStats stats;
+        for (int b = 0; b < blocks; ++b) {
+            stats.ssim += partialSsim[b];
+            stats.cs += partialCs[b];
+        }
+        return stats;
+    }
+
+    SsimEvaluator::ScaleStats SsimEvaluator::ConstantPatch(float lum) {
+        const float* g = GaussianKernel();
+        MomentSums row;
+        for (int k = 0; k < WINDOW_SIZE; ++k) row.Add(g[k], lum, lum);
+
+        const float moments[MOMENT_COUNT] = { row.x, row.y, row.xx, row.yy, row.xy };
+        float acc[MOMENT_COUNT] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int k = 0; k < WINDOW_SIZE; ++k) {
+            for (int m = 0; m < MOMENT_COUNT; ++m) acc[m] += g[k] * moments[m];
+        }
+
+        double cx = acc[0], cy = acc[1];
+        double vx = std::max(0.0, acc[2] - cx * cx);
+        double vy = std::max(0.0, acc[3] - cy * cy);
+        double cxy = acc[4] - cx * cy;
+        double ux = cx + LUMA_CENTER, uy = cy + LUMA_CENTER;
+        double l = (2.0 * ux * uy + C1) / (ux * ux + uy * uy + C1);
+        double cs = (2.0 * cxy + C2) / (vx + vy + C2);
+        return { l * cs, cs };
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "ImageView.h"
+
+namespace Metrics {
+
+    struct SsimResult {
+        double ssim = 0.0;    // 全分辨率平均 SSIM
+        double msssim = 0.0;  // 多尺度 SSIM
+        int scales = 0;       // 实际使用的尺度数 (分辨率过小时自动减少)
+    };
+
+    /**
+     * @brief SSIM / MS-SSIM (Wang et al. 2003/2004)
+     * 在 BT.601 亮度上计算，11x11 高斯窗口 (σ = 1.5) 拆分为水平 + 竖直两次一维滤波，
+     * 边界按边缘像素延拓，K1 = 0.01，K2 = 0.03，L = 255。
+     * MS-SSIM 逐尺度 2x2 平均下采样，使用标准的 5 尺度权重 (尺度不足时按剩余权重归一化)。
+     * 所有中间缓冲在 Reserve 中按最大分辨率一次性分配，之后的 Compute 不再分配堆内存。
+     */
+    class SsimEvaluator {
+    public:
+        static constexpr int MAX_SCALES = 5;
+        static constexpr int WINDOW_RADIUS = 5;
+
+        void Reserve(int width, int height);
+        size_t ReservedBytes() const;
+
+        /**
+         * @brief 计算 SSIM 与 MS-SSIM
+         * @param ref / opt 8bit 彩色视图 (RGB8 / RGBA8)，尺寸与格式须一致
+         * @param scales MS-SSIM 的尺度数 (1 ~ MAX_SCALES)
+         * @param region 非空时 ref / opt 为整幅画面中的裁剪区域: 尺度数与均值按整幅画面计算，
+         *        区域外纯色背景的逐像素值由 ConstantPatch 解析给出。区域须满足 CropMargin / CropAlignment
+         * 全分辨率的逐像素 SSIM 图保留在 SsimMap() 中，供热力图使用
+         */
+        SsimResult Compute(const ImageView& ref, const ImageView& opt, int scales = MAX_SCALES,
+                           const FrameRegion* region = nullptr);
+
+        // 裁剪区域相对物体包围矩形的最小外扩 (全分辨率像素): 每个尺度上窗口都不会越过区域边缘触及物体
+        static int CropMargin(int scales) { return (WINDOW_RADIUS + 2) << (ClampScales(scales) - 1); }
+        // 裁剪区域起点 (及未贴画面边缘的终点) 的对齐要求，保证各尺度的 2x2 下采样与整幅画面对齐
+        static int CropAlignment(int scales) { return 1 << (ClampScales(scales) - 1); }
+
+        // 最近一次 Compute 的 SSIM 图 (R32F，与输入同尺寸)
+        ImageView SsimMap() const { return ImageView(ssimMap, mapWidth, mapHeight, PixelFormat::R32F); }
+
+    private:
+        // 单个尺度上的平均 SSIM 与平均对比度-结构项 (cs)
+        struct ScaleStats {
+            double ssim = 0.0;
+            double cs = 0.0;
+        };
+        // 返回逐像素 SSIM 与 cs 的总和
+        ScaleStats ComputeScale(const float* lumRef, const float* lumOpt, int w, int h, float* map);
+        // 亮度恒为 lum (已减去 LUMA_CENTER) 的区域内单个像素的 SSIM 与 cs，与 ComputeScale 的浮点运算顺序一致
+        static ScaleStats ConstantPatch(float lum);
+        static int ClampScales(int scales) { return std::max(1, std::min(scales, MAX_SCALES)); }
+
+        std::vector<float> lumRef[MAX_SCALES];
+        std::vector<float> lumOpt[MAX_SCALES];
+        std::vector<float> moments;   // 水平滤波后的 5 个矩平面: μx, μy, x², y², xy
+        std::vector<float> rowScratch; // 竖直滤波的行累加器 (每个行块 5 行)
+        std::vector<double> partialSsim, partialCs;
+        std::vector<float> ssimMap;
+        int mapWidth = 0;
+        int mapHeight = 0;
+    };
+}
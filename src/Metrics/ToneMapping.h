@@ -0,0 +1,35 @@
+#pragma once
+
+namespace Metrics {
+
+    // 色调映射算子 (与着色器中的实现逐一对应)
+    enum class ToneOperator {
+        Aces,       // pbr.frag 的 ACES Filmic 拟合 (默认渲染路径)
+        Reinhard,   // x / (1 + x)，background.frag 的天空盒使用
+        Clamp       // 不做压缩，直接截断到 [0, 1]
+    };
+
+    inline const char* ToneOperatorName(ToneOperator op) {
+        switch (op) {
+            case ToneOperator::Aces:     return "ACES";
+            case ToneOperator::Reinhard: return "Reinhard";
+            case ToneOperator::Clamp:    return "Clamp";
+        }
+        return "Unknown";
+    }
+
+    // 单通道色调映射 (曝光已乘入 x)，输出 [0, 1]
+    inline float ToneMap(float x, ToneOperator op) {
+        switch (op) {
+            case ToneOperator::Aces: {
+                const float a = 2.51f, b = 0.03f, c = 2.43f, d = 0.59f, e = 0.14f;
+                return std::min(std::max((x * (a * x + b)) / (x * (c * x + d) + e), 0.0f), 1.0f);
+            }
+            case ToneOperator::Reinhard:
+                return x / (x + 1.0f);
+            case ToneOperator::Clamp:
+                return std::min(std::max(x, 0.0f), 1.0f);
+        }
+        return x;
+    }
+}
@@ -0,0 +1,227 @@
+#include "TriangleBVH.h"
+
+namespace Metrics {
+
+    static const int SAH_BINS = 16;
+    static const uint32_t MAX_LEAF_SIZE = 4;      // 不超过该数量时 SAH 可以选择不再划分
+    static const uint32_t FORCED_LEAF_SIZE = 1;   // 单个三角形直接成为叶子 (质心完全重合的集合同样无法再划分)
+    static const int MAX_DEPTH = 64;              // 查询栈深度 (退化划分时构建同样受此限制)
+
+    struct Aabb {
+        glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+        void Grow(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+        void Grow(const Aabb& b) { min = glm::min(min, b.min); max = glm::max(max, b.max); }
+        float HalfArea() const {
+            glm::vec3 e = max - min;
+            return (e.x < 0.0f) ? 0.0f : e.x * e.y + e.y * e.z + e.z * e.x;
+        }
+    };
+
+    // 点到三角形的最近距离平方 (Ericson, Real-Time Collision Detection 5.1.5)
+    static float PointTriangleDistanceSquared(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+        float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+        if (d1 <= 0.0f && d2 <= 0.0f) return glm::dot(ap, ap);
+
+        glm::vec3 bp = p - b;
+        float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+        if (d3 >= 0.0f && d4 <= d3) return glm::dot(bp, bp);
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+            glm::vec3 q = a + ab * (d1 / (d1 - d3));
+            return glm::dot(p - q, p - q);
+        }
+
+        glm::vec3 cp = p - c;
+        float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+        if (d6 >= 0.0f && d5 <= d6) return glm::dot(cp, cp);
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+            glm::vec3 q = a + ac * (d2 / (d2 - d6));
+            return glm::dot(p - q, p - q);
+        }
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+            glm::vec3 q = b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+            return glm::dot(p - q, p - q);
+        }
+
+        float denom = 1.0f / (va + vb + vc);
+        glm::vec3 q = a + ab * (vb * denom) + ac * (vc * denom);
+        return glm::dot(p - q, p - q);
+    }
+
+    // 点到包围盒的距离平方 (点在盒内为 0)
+    static float PointBoxDistanceSquared(const glm::vec3& p, const glm::vec3& bmin, const glm::vec3& bmax) {
+        glm::vec3 d = glm::max(glm::max(bmin - p, p - bmax), glm::vec3(0.0f));
+        return glm::dot(d, d);
+    }
+
+    void TriangleBVH::Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, const glm::vec3& offset) {
+        nodes.clear();
+        triangles.clear();
+
+        // 1. 收集有效三角形及其包围盒/质心
+        std::vector<Triangle> source;
+        source.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            unsigned int i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+            if (i0 >= positions.size() || i1 >= positions.size() || i2 >= positions.size()) continue;
+            Triangle t{ positions[i0] + offset, positions[i1] + offset, positions[i2] + offset };
+            if (t.a == t.b && t.b == t.c) continue;
+            source.push_back(t);
+        }
+        const uint32_t count = static_cast<uint32_t>(source.size());
+        if (count == 0) return;
+
+        std::vector<Aabb> boxes(count);
+        std::vector<glm::vec3> centroids(count);
+        std::vector<uint32_t> order(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            boxes[i].Grow(source[i].a);
+            boxes[i].Grow(source[i].b);
+            boxes[i].Grow(source[i].c);
+            centroids[i] = (source[i].a + source[i].b + source[i].c) * (1.0f / 3.0f);
+            order[i] = i;
+        }
+
+        // 2. 自顶向下分箱 SAH 划分 (显式栈)
+        nodes.reserve(2 * static_cast<size_t>(count / MAX_LEAF_SIZE + 1));
+        nodes.emplace_back();
+        struct BuildTask { uint32_t node, begin, end; int depth; };
+        std::vector<BuildTask> stack;
+        stack.push_back({ 0, 0, count, 0 });
+
+        while (!stack.empty()) {
+            BuildTask task = stack.back();
+            stack.pop_back();
+            const uint32_t n = task.end - task.begin;
+
+            Aabb bounds, centroidBounds;
+            for (uint32_t i = task.begin; i < task.end; ++i) {
+                bounds.Grow(boxes[order[i]]);
+                centroidBounds.Grow(centroids[order[i]]);
+            }
+            nodes[task.node].boundsMin = bounds.min;
+            nodes[task.node].boundsMax = bounds.max;
+
+            auto makeLeaf = [&]() {
+                nodes[task.node].leftOrFirst = task.begin;
+                nodes[task.node].count = n;
+            };
+
+            if (n <= FORCED_LEAF_SIZE || task.depth >= MAX_DEPTH - 2) { makeLeaf(); continue; }
+
+            // 在每个轴上将质心分入 SAH_BINS 个箱，扫描所有箱边界，取代价最小的划分
+            int bestAxis = -1, bestSplit = 0;
+            float bestCost = std::numeric_limits<float>::max();
+            for (int axis = 0; axis < 3; ++axis) {
+                float lo = centroidBounds.min[axis], hi = centroidBounds.max[axis];
+                if (!(hi > lo)) continue;
+                float scale = SAH_BINS / (hi - lo);
+
+                Aabb binBounds[SAH_BINS];
+                uint32_t binCounts[SAH_BINS] = {};
+                for (uint32_t i = task.begin; i < task.end; ++i) {
+                    int b = std::min(SAH_BINS - 1, static_cast<int>((centroids[order[i]][axis] - lo) * scale));
+                    binCounts[b]++;
+                    binBounds[b].Grow(boxes[order[i]]);
+                }
+
+                float rightArea[SAH_BINS];
+                uint32_t rightCount[SAH_BINS];
+                Aabb acc;
+                uint32_t accCount = 0;
+                for (int b = SAH_BINS - 1; b > 0; --b) {
+                    acc.Grow(binBounds[b]);
+                    accCount += binCounts[b];
+                    rightArea[b] = acc.HalfArea();
+                    rightCount[b] = accCount;
+                }
+                acc = Aabb();
+                accCount = 0;
+                for (int b = 0; b < SAH_BINS - 1; ++b) {
+                    acc.Grow(binBounds[b]);
+                    accCount += binCounts[b];
+                    if (accCount == 0 || rightCount[b + 1] == 0) continue;
+                    float cost = acc.HalfArea() * accCount + rightArea[b + 1] * rightCount[b + 1];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = b + 1;
+                    }
+                }
+            }
+
+            // 划分代价 (遍历代价按 1 个三角形计) 不低于直接成为叶子时停止划分
+            float leafCost = bounds.HalfArea() * n;
+            float splitCost = bounds.HalfArea() + bestCost;
+            if (bestAxis < 0 || (n <= MAX_LEAF_SIZE && splitCost >= leafCost)) { makeLeaf(); continue; }
+
+            float lo = centroidBounds.min[bestAxis];
+            float scale = SAH_BINS / (centroidBounds.max[bestAxis] - lo);
+            uint32_t* mid = std::partition(order.data() + task.begin, order.data() + task.end, [&](uint32_t t) {
+                return std::min(SAH_BINS - 1, static_cast<int>((centroids[t][bestAxis] - lo) * scale)) < bestSplit;
+            });
+            uint32_t split = static_cast<uint32_t>(mid - order.data());
+            if (split == task.begin || split == task.end) split = task.begin + n / 2;
+
+            uint32_t left = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+            nodes.emplace_back();
+            nodes[task.node].leftOrFirst = left;
+            nodes[task.node].count = 0;
+            stack.push_back({ left + 1, split, task.end, task.depth + 1 });
+            stack.push_back({ left, task.begin, split, task.depth + 1 });
+        }
+
+        // 3. 三角形按叶子顺序重排
+        triangles.resize(count);
+        for (uint32_t i = 0; i < count; ++i) triangles[i] = source[order[i]];
+    }
+
+    bool TriangleBVH::ClosestDistanceSquared(const glm::vec3& p, float bound, float& outDist2) const {
+        if (nodes.empty()) return false;
+
+        float best = bound;
+        bool found = false;
+        uint32_t stack[MAX_DEPTH];
+        int top = 0;
+        if (PointBoxDistanceSquared(p, nodes[0].boundsMin, nodes[0].boundsMax) >= best) return false;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (node.count > 0) {
+                for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+                    const Triangle& t = triangles[i];
+                    float d2 = PointTriangleDistanceSquared(p, t.a, t.b, t.c);
+                    if (d2 < best) {
+                        best = d2;
+                        found = true;
+                    }
+                }
+                continue;
+            }
+
+            // 先访问较近的子节点，出栈时再次按当前最优距离剪枝
+            uint32_t nearChild = node.leftOrFirst, farChild = node.leftOrFirst + 1;
+            float dNear = PointBoxDistanceSquared(p, nodes[nearChild].boundsMin, nodes[nearChild].boundsMax);
+            float dFar = PointBoxDistanceSquared(p, nodes[farChild].boundsMin, nodes[farChild].boundsMax);
+            if (dFar < dNear) {
+                std::swap(nearChild, farChild);
+                std::swap(dNear, dFar);
+            }
+            if (dFar < best) stack[top++] = farChild;
+            if (dNear < best) stack[top++] = nearChild;
+        }
+
+        if (found) outDist2 = best;
+        return found;
+    }
+}
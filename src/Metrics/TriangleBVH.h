@@ -0,0 +1,47 @@
+#pragma once
+
+namespace Metrics {
+
+    /**
+     * @brief 三角形包围体层次 (BVH)，用于点到网格的最近距离查询
+     * 自顶向下构建，每个节点在三个轴上做分箱 SAH (表面积启发式) 选择划分；
+     * 叶子中的三角形按遍历顺序重排并按值存储，查询时连续访问。
+     * 构建完成后只读，可在多个线程中并发查询。
+     */
+    class TriangleBVH {
+    public:
+        /**
+         * @brief 构建 BVH
+         * @param positions 顶点位置
+         * @param indices 三角形索引 (每 3 个一组)，越界或退化为点的三角形被跳过
+         * @param offset 构建时对所有顶点施加的平移 (用于包围盒中心对齐)
+         */
+        void Build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+                   const glm::vec3& offset = glm::vec3(0.0f));
+
+        /**
+         * @brief 点到最近三角形的距离平方
+         * @param bound 已知的距离平方上界 (只搜索严格更近的三角形)
+         * @return 找到更近的三角形时返回 true 并写入 outDist2，否则保持 outDist2 不变
+         */
+        bool ClosestDistanceSquared(const glm::vec3& p, float bound, float& outDist2) const;
+
+        size_t TriangleCount() const { return triangles.size(); }
+        size_t NodeCount() const { return nodes.size(); }
+        size_t MemoryBytes() const { return nodes.capacity() * sizeof(Node) + triangles.capacity() * sizeof(Triangle); }
+
+    private:
+        struct Node {
+            glm::vec3 boundsMin;
+            uint32_t leftOrFirst = 0; // 内部节点: 左子节点下标 (右子节点紧随其后)；叶子: 首个三角形下标
+            glm::vec3 boundsMax;
+            uint32_t count = 0;       // 叶子中的三角形数，0 表示内部节点
+        };
+        struct Triangle {
+            glm::vec3 a, b, c;
+        };
+
+        std::vector<Node> nodes;
+        std::vector<Triangle> triangles;
+    };
+}
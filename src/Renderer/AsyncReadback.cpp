@@ -0,0 +1,99 @@
+#include "AsyncReadback.h"
+#include "Utils/MemoryTracker.h"
+#include "Utils/Profiler.h"
+
+namespace Renderer {
+
+    AsyncReadback::~AsyncReadback() {
+        Release();
+    }
+
+    void AsyncReadback::Init(size_t depth, Sink readbackSink) {
+        Release();
+        slots.resize(std::max<size_t>(depth, 1));
+        for (Slot& slot : slots) glGenBuffers(1, &slot.pbo);
+        sink = std::move(readbackSink);
+    }
+
+    void AsyncReadback::Release() {
+        for (Slot& slot : slots) {
+            if (slot.fence) glDeleteSync(slot.fence);
+            if (slot.pbo) Utils::TrackedDeleteBuffers(1, &slot.pbo);
+        }
+        slots.clear();
+        head = 0;
+        count = 0;
+    }
+
+    void AsyncReadback::Enqueue(int x, int y, int width, int height, const std::string& name, int tag) {
+        if (slots.empty()) return;
+        if (count == slots.size()) {
+            // 环已满: 同步取回最旧的请求，腾出位置
+            stalls++;
+            Complete(slots[head], true);
+        }
+
+        Slot& slot = slots[(head + count) % slots.size()];
+        const size_t bytes = static_cast<size_t>(width) * height * 3;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        if (slot.capacity < bytes) {
+            Utils::TrackedBufferData(Utils::MemoryCategory::FrameBuffer, GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), NULL, GL_STREAM_READ);
+            slot.capacity = bytes;
+        }
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        slot.request.name = name;
+        slot.request.tag = tag;
+        slot.request.width = width;
+        slot.request.height = height;
+        count++;
+        Utils::Profiler::Instance().AddReadback(bytes);
+    }
+
+    void AsyncReadback::Poll() {
+        while (count > 0) {
+            Slot& slot = slots[head];
+            GLenum status = glClientWaitSync(slot.fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+            Complete(slot, false);
+        }
+    }
+
+    void AsyncReadback::Drain() {
+        while (count > 0) Complete(slots[head], true);
+    }
+
+    void AsyncReadback::Complete(Slot& slot, bool wait) {
+        if (wait) {
+            Utils::CpuProfileScope scope("ReadbackWait");
+            // 首次等待时刷新命令流，避免栅栏尚未提交导致永远等不到
+            GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+            while (true) {
+                GLenum status = glClientWaitSync(slot.fence, flags, 1000000000ull);
+                if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || status == GL_WAIT_FAILED) break;
+                flags = 0;
+            }
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        const Request& request = slot.request;
+        const size_t bytes = static_cast<size_t>(request.width) * request.height * 3;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_READ_BIT);
+        if (pixels) {
+            if (sink) sink(request, static_cast<const unsigned char*>(pixels));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            std::cerr << "[Readback] Failed to map pixel buffer for " << request.name << std::endl;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        head = (head + 1) % slots.size();
+        count--;
+    }
+}
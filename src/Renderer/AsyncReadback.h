@@ -0,0 +1,58 @@
+#pragma once
+
+namespace Renderer {
+
+    /**
+     * @brief 异步像素回读 (PBO 环)
+     * Enqueue 从当前绑定的读帧缓冲发起 glReadPixels 到像素打包缓冲 (PBO) 并插入栅栏，调用立即返回；
+     * 之后的帧中 Poll 只取回 GPU 已完成的请求 (映射 PBO 后交给回调)，不会让 CPU 等待 GPU。
+     * 环写满时最旧的一项同步取回 (计入 Stalls)。行序为 OpenGL 的自底向上，RGB8 紧密排列。
+     */
+    class AsyncReadback {
+    public:
+        struct Request {
+            std::string name;   // 调用方的标识 (例如输出路径)
+            int tag = 0;        // 调用方的附加信息 (例如输出格式)
+            int width = 0;
+            int height = 0;
+        };
+        using Sink = std::function<void(const Request& request, const unsigned char* pixels)>;
+
+        AsyncReadback() = default;
+        ~AsyncReadback();
+
+        AsyncReadback(const AsyncReadback&) = delete;
+        AsyncReadback& operator=(const AsyncReadback&) = delete;
+
+        // depth: 同时在途的请求数上限
+        void Init(size_t depth, Sink sink);
+        void Release();
+        bool Ready() const { return !slots.empty(); }
+
+        void Enqueue(int x, int y, int width, int height, const std::string& name, int tag);
+        // 取回已完成的请求 (按提交顺序)
+        void Poll();
+        // 等待并取回全部在途请求
+        void Drain();
+
+        size_t Pending() const { return count; }
+        size_t Stalls() const { return stalls; }
+        void ResetStats() { stalls = 0; }
+
+    private:
+        struct Slot {
+            unsigned int pbo = 0;
+            size_t capacity = 0;
+            GLsync fence = nullptr;
+            Request request;
+        };
+
+        void Complete(Slot& slot, bool wait);
+
+        std::vector<Slot> slots;
+        size_t head = 0;    // 最旧的在途请求
+        size_t count = 0;
+        size_t stalls = 0;
+        Sink sink;
+    };
+}
@@ -0,0 +1,128 @@
+#include "DeferredShading.h"
+#include "PBRRenderer.h"
+#include "Utils/GeometryUtils.h"
+#include "Utils/MemoryTracker.h"
+
+namespace Renderer {
+
+    namespace {
+        unsigned int CreateTexture(int width, int height, GLint internalFormat, GLenum format, GLenum type) {
+            unsigned int tex = 0;
+            glGenTextures(1, &tex);
+            glBindTexture(GL_TEXTURE_2D, tex);
+            Utils::TrackedTexImage2D(Utils::MemoryCategory::FrameBuffer, GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            return tex;
+        }
+    }
+
+    DeferredShading::DeferredShading(int w, int h) : width(w), height(h) {
+        shader = std::make_unique<Shader>("assets/shaders/metrics/quad.vert", "assets/shaders/pbr/deferred.frag");
+        shader->use();
+        shader->setInt("irradianceMap", 0);
+        shader->setInt("prefilterMap", 1);
+        shader->setInt("brdfLUT", 2);
+        shader->setInt("gMaterial", 3);
+        shader->setInt("gSurface", 4);
+        shader->setInt("gNormal", 5);
+        shader->setInt("gDepth", 6);
+        shader->setInt("environmentMap", 7);
+
+        // 快照格式与 PBRRenderer 的附件一致，拷贝时不做格式转换
+        for (Slot& slot : slots) {
+            slot.materialTex = CreateTexture(width, height, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+            slot.surfaceTex = CreateTexture(width, height, GL_RG16F, GL_RG, GL_FLOAT);
+            slot.normalTex = CreateTexture(width, height, GL_RGB16F, GL_RGB, GL_FLOAT);
+            slot.depthTex = CreateTexture(width, height, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT);
+        }
+
+        shadeTex = CreateTexture(width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+        glGenFramebuffers(1, &shadeFBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, shadeFBO);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, shadeTex, 0);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (status != GL_FRAMEBUFFER_COMPLETE) std::cerr << "[Deferred] Shading framebuffer is incomplete!" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    DeferredShading::~DeferredShading() {
+        for (Slot& slot : slots) {
+            Utils::TrackedDeleteTextures(1, &slot.materialTex);
+            Utils::TrackedDeleteTextures(1, &slot.surfaceTex);
+            Utils::TrackedDeleteTextures(1, &slot.normalTex);
+            Utils::TrackedDeleteTextures(1, &slot.depthTex);
+        }
+        Utils::TrackedDeleteTextures(1, &shadeTex);
+        glDeleteFramebuffers(1, &shadeFBO);
+    }
+
+    glm::ivec4 DeferredShading::Rect() const {
+        if (scissor.z > 0 && scissor.w > 0) return scissor;
+        return glm::ivec4(0, 0, width, height);
+    }
+
+    void DeferredShading::Capture(const PBRRenderer& pbr, int slot) {
+        if (pbr.GetMaterialTex() == 0 || pbr.GetWidth() != width || pbr.GetHeight() != height) {
+            std::cerr << "[Deferred] Error: renderer has no matching G-buffer!" << std::endl;
+            return;
+        }
+        const Slot& dst = slots[slot];
+        const glm::ivec4 r = Rect();
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, pbr.GetFBO());
+
+        const std::pair<GLenum, unsigned int> copies[] = {
+            { GL_COLOR_ATTACHMENT3, dst.materialTex }, { GL_COLOR_ATTACHMENT4, dst.surfaceTex }, { GL_COLOR_ATTACHMENT1, dst.normalTex }
+        };
+        for (const auto& copy : copies) {
+            glReadBuffer(copy.first);
+            glBindTexture(GL_TEXTURE_2D, copy.second);
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, r.x, r.y, r.x, r.y, r.z, r.w);
+        }
+        // 深度纹理的拷贝来源是读帧缓冲的深度附件
+        glBindTexture(GL_TEXTURE_2D, dst.depthTex);
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, r.x, r.y, r.x, r.y, r.z, r.w);
+
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    }
+
+    void DeferredShading::Shade(int slot, const IBLMaps& env, float rotationDegrees, const glm::mat4& view,
+                                const glm::mat4& projection, const glm::vec3& camPos, bool skybox) {
+        const Slot& src = slots[slot];
+        const glm::ivec4 r = Rect();
+
+        glBindFramebuffer(GL_FRAMEBUFFER, shadeFBO);
+        glViewport(0, 0, width, height);
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(r.x, r.y, r.z, r.w);   // 着色目标没有深度附件，深度测试总是通过
+
+        // 环境旋转 θ 等价于以 -θ 旋转查询方向
+        const glm::mat3 envRotation = glm::mat3(glm::rotate(glm::mat4(1.0f), glm::radians(-rotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+        shader->use();
+        shader->setMat4("invViewProj", glm::inverse(projection * view));
+        shader->setMat4("invSkyViewProj", glm::inverse(projection * glm::mat4(glm::mat3(view))));
+        shader->setVec3("camPos", camPos);
+        shader->setMat3("envRotation", envRotation);
+        shader->setVec2("invSize", glm::vec2(1.0f / width, 1.0f / height));
+        shader->setFloat("u_Exposure", exposure);
+        shader->setBool("u_Skybox", skybox);
+        shader->setVec3("u_Background", background);
+
+        glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_CUBE_MAP, env.irradianceMap);
+        glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_CUBE_MAP, env.prefilterMap);
+        glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, env.brdfLUT);
+        glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, src.materialTex);
+        glActiveTexture(GL_TEXTURE4); glBindTexture(GL_TEXTURE_2D, src.surfaceTex);
+        glActiveTexture(GL_TEXTURE5); glBindTexture(GL_TEXTURE_2D, src.normalTex);
+        glActiveTexture(GL_TEXTURE6); glBindTexture(GL_TEXTURE_2D, src.depthTex);
+        glActiveTexture(GL_TEXTURE7); glBindTexture(GL_TEXTURE_CUBE_MAP, env.envCubemap);
+
+        Utils::GeometryUtils::RenderQuad();
+
+        glActiveTexture(GL_TEXTURE0);
+        glDisable(GL_SCISSOR_TEST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "Renderer/IBLBaker.h"
+#include "Renderer/Shader.h"
+
+namespace Renderer {
+    class PBRRenderer;
+
+    /**
+     * @brief 延迟着色 (多环境评估)
+     * Capture 把 PBRRenderer 刚绘制完的 G-buffer (反照率 / 金属度、粗糙度 / 着色模型、法线、深度) 拷贝为一组快照，
+     * 参考与优化模型各占一组；Shade 以全屏四边形对某组快照用指定的 IBL 环境重新着色，着色与 pbr.frag /
+     * background.frag 一致，结果写入内部的 RGBA8 目标 (之后从 GetFBO() 的附件 0 回读)。
+     * 几何只在前向通道中绘制一次，N 个环境只需 N 次全屏着色。尺寸须与来源渲染器一致。
+     */
+    class DeferredShading {
+    public:
+        static constexpr int SLOT_COUNT = 2; // 0 = 参考模型, 1 = 优化模型
+
+        DeferredShading(int width, int height);
+        ~DeferredShading();
+
+        DeferredShading(const DeferredShading&) = delete;
+        DeferredShading& operator=(const DeferredShading&) = delete;
+
+        void SetExposure(float exp) { exposure = exp; }
+        void SetBackground(glm::vec3 back) { background = back; }
+        // 限定拷贝与着色的像素矩形 (屏幕空间 ROI)，w/h <= 0 表示整幅画面
+        void SetScissor(int x, int y, int w, int h) { scissor = glm::ivec4(x, y, w, h); }
+
+        // 拷贝 pbr 当前的 G-buffer 到 slot (pbr 须已 EnableGBufferCapture)
+        void Capture(const PBRRenderer& pbr, int slot);
+        // rotationDegrees: 环境绕世界 Y 轴的旋转角；skybox: 背景像素绘制环境天空盒 (否则填背景色)
+        void Shade(int slot, const IBLMaps& env, float rotationDegrees, const glm::mat4& view, const glm::mat4& projection,
+                   const glm::vec3& camPos, bool skybox);
+
+        unsigned int GetFBO() const { return shadeFBO; }
+        int GetWidth() const { return width; }
+        int GetHeight() const { return height; }
+
+    private:
+        struct Slot {
+            unsigned int materialTex = 0;
+            unsigned int surfaceTex = 0;
+            unsigned int normalTex = 0;
+            unsigned int depthTex = 0;
+        };
+
+        int width, height;
+        Slot slots[SLOT_COUNT];
+        unsigned int shadeFBO = 0;
+        unsigned int shadeTex = 0;
+        float exposure = 1.0f;
+        glm::vec3 background = glm::vec3(1.0f);
+        glm::ivec4 scissor = glm::ivec4(0);
+        std::unique_ptr<Shader> shader;
+
+        glm::ivec4 Rect() const;
+    };
+}
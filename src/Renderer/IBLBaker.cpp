@@ -1,6 +1,7 @@
 #include "Renderer/IBLBaker.h"
 #include "Renderer/Shader.h"
 #include "Utils/GeometryUtils.h"
+#include "Utils/MemoryTracker.h"
 #include "stb_image.h"
 
 
@@ -17,7 +18,7 @@ namespace Renderer {
         if (data) {
             glGenTextures(1, &hdrTexture);
             glBindTexture(GL_TEXTURE_2D, hdrTexture);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
+            Utils::TrackedTexImage2D(Utils::MemoryCategory::IBL, GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, data);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -53,7 +54,7 @@ namespace Renderer {
         glGenTextures(1, &outMaps.envCubemap);
         glBindTexture(GL_TEXTURE_CUBE_MAP, outMaps.envCubemap);
         for (unsigned int i = 0; i < 6; ++i)
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 512, 512, 0, GL_RGB, GL_FLOAT, nullptr);
+            Utils::TrackedTexImage2D(Utils::MemoryCategory::IBL, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 512, 512, 0, GL_RGB, GL_FLOAT, nullptr);
 
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -70,7 +71,7 @@ namespace Renderer {
 
         glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
         glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
+        Utils::TrackedRenderbufferStorage(Utils::MemoryCategory::IBL, GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
         glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, captureRBO);
         glViewport(0, 0, 512, 512);
 
@@ -81,12 +82,12 @@ namespace Renderer {
             Utils::GeometryUtils::RenderCube();
         }
         glBindTexture(GL_TEXTURE_CUBE_MAP, outMaps.envCubemap);
-        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+        Utils::TrackedGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 
         // --- B. Irradiance Map ---
         glGenTextures(1, &outMaps.irradianceMap);
         glBindTexture(GL_TEXTURE_CUBE_MAP, outMaps.irradianceMap);
-        for (unsigned int i = 0; i < 6; ++i) glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
+        for (unsigned int i = 0; i < 6; ++i) Utils::TrackedTexImage2D(Utils::MemoryCategory::IBL, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
@@ -95,7 +96,7 @@ namespace Renderer {
 
         glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
         glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 32, 32);
+        Utils::TrackedRenderbufferStorage(Utils::MemoryCategory::IBL, GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 32, 32);
 
         irradianceShader.use();
         irradianceShader.setInt("environmentMap", 0);
@@ -114,13 +115,13 @@ namespace Renderer {
         // --- C. Prefilter Map ---
         glGenTextures(1, &outMaps.prefilterMap);
         glBindTexture(GL_TEXTURE_CUBE_MAP, outMaps.prefilterMap);
-        for (unsigned int i = 0; i < 6; ++i) glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 128, 128, 0, GL_RGB, GL_FLOAT, nullptr);
+        for (unsigned int i = 0; i < 6; ++i) Utils::TrackedTexImage2D(Utils::MemoryCategory::IBL, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 128, 128, 0, GL_RGB, GL_FLOAT, nullptr);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR); // 重要
         glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+        Utils::TrackedGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 
         prefilterShader.use();
         prefilterShader.setInt("environmentMap", 0);
@@ -134,7 +135,7 @@ namespace Renderer {
             unsigned int mipWidth  = 128 * std::pow(0.5, mip);
             unsigned int mipHeight = 128 * std::pow(0.5, mip);
             glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mipWidth, mipHeight);
+            Utils::TrackedRenderbufferStorage(Utils::MemoryCategory::IBL, GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mipWidth, mipHeight);
             glViewport(0, 0, mipWidth, mipHeight);
 
             float roughness = (float)mip / (float)(maxMipLevels - 1);
@@ -150,7 +151,7 @@ namespace Renderer {
         // --- D. BRDF LUT ---
         glGenTextures(1, &outMaps.brdfLUT);
         glBindTexture(GL_TEXTURE_2D, outMaps.brdfLUT);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, 512, 512, 0, GL_RG, GL_FLOAT, 0);
+        Utils::TrackedTexImage2D(Utils::MemoryCategory::IBL, GL_TEXTURE_2D, 0, GL_RG16F, 512, 512, 0, GL_RG, GL_FLOAT, 0);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -158,7 +159,7 @@ namespace Renderer {
 
         glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
         glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
+        Utils::TrackedRenderbufferStorage(Utils::MemoryCategory::IBL, GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, outMaps.brdfLUT, 0);
 
         glViewport(0, 0, 512, 512);
@@ -168,9 +169,9 @@ namespace Renderer {
 
         // Cleanup
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glDeleteTextures(1, &hdrTexture);
+        Utils::TrackedDeleteTextures(1, &hdrTexture);
         glDeleteFramebuffers(1, &captureFBO);
-        glDeleteRenderbuffers(1, &captureRBO);
+        Utils::TrackedDeleteRenderbuffers(1, &captureRBO);
 
         return outMaps;
     }
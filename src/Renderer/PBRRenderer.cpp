@@ -1,5 +1,6 @@
 #include "PBRRenderer.h"
 #include "Utils/GeometryUtils.h"
+#include "Utils/MemoryTracker.h"
 
 namespace Renderer {
 
@@ -24,9 +25,12 @@ namespace Renderer {
 
     PBRRenderer::~PBRRenderer() {
         glDeleteFramebuffers(1, &fbo);
-        glDeleteTextures(1, &colorTex);
-        glDeleteTextures(1, &normalTex);
-        glDeleteTextures(1, &depthTex);
+        Utils::TrackedDeleteTextures(1, &colorTex);
+        Utils::TrackedDeleteTextures(1, &normalTex);
+        Utils::TrackedDeleteTextures(1, &depthTex);
+        if (linearTex) Utils::TrackedDeleteTextures(1, &linearTex);
+        if (materialTex) Utils::TrackedDeleteTextures(1, &materialTex);
+        if (surfaceTex) Utils::TrackedDeleteTextures(1, &surfaceTex);
     }
 
     void PBRRenderer::SetupFBO() {
@@ -36,7 +40,7 @@ namespace Renderer {
         // Color Attachment 0: RGBA16F
         glGenTextures(1, &colorTex);
         glBindTexture(GL_TEXTURE_2D, colorTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
+        Utils::TrackedTexImage2D(Utils::MemoryCategory::FrameBuffer, GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
@@ -44,14 +48,14 @@ namespace Renderer {
         // Color Attachment 1: RGB16F
         glGenTextures(1, &normalTex);
         glBindTexture(GL_TEXTURE_2D, normalTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, NULL);
+        Utils::TrackedTexImage2D(Utils::MemoryCategory::FrameBuffer, GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_FLOAT, NULL);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normalTex, 0);
 
         glGenTextures(1, &depthTex);
         glBindTexture(GL_TEXTURE_2D, depthTex);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        Utils::TrackedTexImage2D(Utils::MemoryCategory::FrameBuffer, GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTex, 0);
 
         unsigned int attachments[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
@@ -59,15 +63,64 @@ namespace Renderer {
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
+    unsigned int PBRRenderer::CreateAttachment(int index, GLint internalFormat, GLenum format) {
+        unsigned int tex = 0;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        Utils::TrackedTexImage2D(Utils::MemoryCategory::FrameBuffer, GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + index, GL_TEXTURE_2D, tex, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return tex;
+    }
+
+    void PBRRenderer::UpdateDrawBuffers() {
+        // 未启用的附件位置填 GL_NONE，着色器中对应的输出被丢弃
+        const GLenum linear = linearTex ? GL_COLOR_ATTACHMENT2 : GL_NONE;
+        unsigned int attachments[5] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, linear,
+                                        GL_COLOR_ATTACHMENT3, GL_COLOR_ATTACHMENT4 };
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glDrawBuffers(materialTex ? 5 : (linearTex ? 3 : 2), attachments);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void PBRRenderer::EnableLinearCapture() {
+        if (linearTex) return;
+        // Color Attachment 2: RGBA16F
+        linearTex = CreateAttachment(2, GL_RGBA16F, GL_RGBA);
+        UpdateDrawBuffers();
+    }
+
+    void PBRRenderer::EnableGBufferCapture() {
+        if (materialTex) return;
+        // Color Attachment 3: RGBA16F, Color Attachment 4: RG16F
+        materialTex = CreateAttachment(3, GL_RGBA16F, GL_RGBA);
+        surfaceTex = CreateAttachment(4, GL_RG16F, GL_RG);
+        UpdateDrawBuffers();
+    }
+
     void PBRRenderer::BeginScene(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& camPos) {
         glBindFramebuffer(GL_FRAMEBUFFER, fbo);
         glViewport(0, 0, width, height);
 
+        // 屏幕空间 ROI: 区域外保持上一次的内容，不再被读取
+        if (scissor.z > 0 && scissor.w > 0) {
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(scissor.x, scissor.y, scissor.z, scissor.w);
+        }
+
         // 【修改点】分离清除缓冲的操作。确保法线贴图缓冲区的背景被绝对置零 (0, 0, 0)，为 Evaluator 计算误差剔除背景做准备
         float bgColor[] = { this->background.r, this->background.g, this->background.b, 1.0f };
         float black[] = { 0.0f, 0.0f, 0.0f, 0.0f };
         glClearBufferfv(GL_COLOR, 0, bgColor); // GL_COLOR_ATTACHMENT0 (画面背景)
         glClearBufferfv(GL_COLOR, 1, black);   // GL_COLOR_ATTACHMENT1 (法线背景强制纯黑)
+        if (linearTex) glClearBufferfv(GL_COLOR, 2, black); // GL_COLOR_ATTACHMENT2 (线性辐射度，背景由覆盖掩码区分)
+        if (materialTex) {
+            glClearBufferfv(GL_COLOR, 3, black);            // GL_COLOR_ATTACHMENT3/4 (G-buffer，着色模型 0 = 背景)
+            glClearBufferfv(GL_COLOR, 4, black);
+        }
         glClear(GL_DEPTH_BUFFER_BIT);
 
         glEnable(GL_DEPTH_TEST);
@@ -104,8 +157,9 @@ namespace Renderer {
             pbrShader->setInt("u_ShadingModel", lit);
             pbrShader->setFloat("u_Exposure", this->exposure);
             pbrShader->setVec3("u_AlbedoDefault", glm::vec3(1.0f));
-            pbrShader->setFloat("u_RoughnessDefault", config.render.roughnessDefault);
-            pbrShader->setFloat("u_MetallicDefault", config.render.metallicDefault);
+            // 超过 std::string 短字符串长度的 uniform 名直接传 const char*，避免每帧构造临时字符串
+            glUniform1f(glGetUniformLocation(pbrShader->ID, "u_RoughnessDefault"), config.render.roughnessDefault);
+            glUniform1f(glGetUniformLocation(pbrShader->ID, "u_MetallicDefault"), config.render.metallicDefault);
             pbrShader->setMat4("model", modelMatrix);
 
             targetModel->Draw(pbrShader->ID);
@@ -127,5 +181,8 @@ namespace Renderer {
         glDepthFunc(GL_LESS);
     }
 
-    void PBRRenderer::EndScene() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+    void PBRRenderer::EndScene() {
+        glDisable(GL_SCISSOR_TEST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
 }
\ No newline at end of file
@@ -16,23 +16,40 @@ namespace Renderer {
 
         void SetExposure(float exp) {exposure = exp;}
         void SetBackground(glm::vec3 back){background = back;}
+        // 限定 BeginScene ~ EndScene 之间清屏与绘制的像素矩形 (屏幕空间 ROI)，w/h <= 0 表示整幅画面
+        void SetScissor(int x, int y, int w, int h) { scissor = glm::ivec4(x, y, w, h); }
+        // 追加 RGBA16F 附件 2，记录曝光与色调映射之前的线性辐射度 (曝光 / 色调映射扫描)
+        void EnableLinearCapture();
+        // 追加延迟着色所需的 G-buffer 附件 3 (RGBA16F 反照率 + 金属度) 与 4 (RG16F 粗糙度 + 着色模型)，
+        // 法线与深度沿用附件 1 与深度附件 (多环境评估)
+        void EnableGBufferCapture();
 
         unsigned int GetFBO() const { return fbo; }
         unsigned int GetColorTex() const {return colorTex;}
         unsigned int GetNormalTex() const {return normalTex;}
         unsigned int GetDepthTex() const {return depthTex;}
+        unsigned int GetLinearTex() const {return linearTex;}
+        unsigned int GetMaterialTex() const {return materialTex;}
+        unsigned int GetSurfaceTex() const {return surfaceTex;}
+        int GetWidth() const {return width;}
+        int GetHeight() const {return height;}
 
     private:
         int width, height;
         unsigned int fbo;
         unsigned int colorTex, normalTex, depthTex;
+        unsigned int linearTex = 0;
+        unsigned int materialTex = 0, surfaceTex = 0;
         float exposure;
         glm::vec3 background;
+        glm::ivec4 scissor = glm::ivec4(0);
 
         std::unique_ptr<Shader> pbrShader;
         std::unique_ptr<Shader> backgroundShader;
         std::unique_ptr<Shader> visShader;
 
         void SetupFBO();
+        unsigned int CreateAttachment(int index, GLint internalFormat, GLenum format);
+        void UpdateDrawBuffers();
     };
 }
\ No newline at end of file
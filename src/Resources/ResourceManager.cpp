@@ -1,7 +1,7 @@
 #include "ResourceManager.h"
 
 namespace Resources {
-    std::shared_ptr<Scene::Model> ResourceManager::LoadModel(const std::string& path) {
+    std::shared_ptr<Scene::Model> ResourceManager::LoadModel(const std::string& path, const Scene::ModelLoadOptions& options) {
         // 检查缓存
         if (modelCache.find(path) != modelCache.end()) {
             return modelCache[path];
@@ -9,12 +9,29 @@ namespace Resources {
 
         // 加载新模型
         std::cout << "[Res] Loading Model: " << path << std::endl;
-        auto model = std::make_shared<Scene::Model>(path);
+        auto source = memorySources.find(path);
+        auto model = (source != memorySources.end())
+                ? std::make_shared<Scene::Model>(path, source->second.data, source->second.formatHint, options)
+                : std::make_shared<Scene::Model>(path, options);
         modelCache[path] = model;
         return model;
     }
 
+    void ResourceManager::RegisterMemoryModel(const std::string& name, std::vector<unsigned char> data, const std::string& formatHint) {
+        memorySources[name] = { std::move(data), formatHint };
+    }
+
+    void ResourceManager::Unload(const std::string& path) {
+        auto it = modelCache.find(path);
+        if (it != modelCache.end()) {
+            it->second->Release();
+            modelCache.erase(it);
+        }
+        memorySources.erase(path);
+    }
+
     void ResourceManager::Clear() {
         modelCache.clear();
+        memorySources.clear();
     }
 }
\ No newline at end of file
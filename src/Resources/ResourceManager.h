@@ -15,13 +15,26 @@ namespace Resources {
         }
 
         // 加载或获取已缓存的模型
-        std::shared_ptr<Scene::Model> LoadModel(const std::string& path);
+        std::shared_ptr<Scene::Model> LoadModel(const std::string& path, const Scene::ModelLoadOptions& options = {});
+
+        // 注册内存中的模型数据 (如程序化生成的基准网格)，之后以 name 调用 LoadModel 时从内存导入
+        void RegisterMemoryModel(const std::string& name, std::vector<unsigned char> data, const std::string& formatHint);
+
+        // 卸载单个模型: 释放其 GL 缓冲与纹理并移出缓存 (同时丢弃对应的内存数据)，须在 GL 线程调用
+        void Unload(const std::string& path);
 
         // 清理所有资源
         void Clear();
 
     private:
         ResourceManager() = default;
+
+        struct MemorySource {
+            std::vector<unsigned char> data;
+            std::string formatHint;
+        };
+
         std::unordered_map<std::string, std::shared_ptr<Scene::Model>> modelCache;
+        std::unordered_map<std::string, MemorySource> memorySources;
     };
 }
\ No newline at end of file
@@ -0,0 +1,347 @@
+#include "TextureCache.h"
+#include "Metrics/Evaluator.h"
+#include "Utils/MemoryTracker.h"
+
+// S3TC 为扩展格式，部分 glad 配置未生成对应常量
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace Resources {
+
+    namespace fs = std::filesystem;
+
+    static const char CACHE_MAGIC[4] = { 'V', 'M', 'T', 'X' };
+    static const uint32_t CACHE_VERSION = 1;
+
+    // FNV-1a 64bit，保证缓存文件名在不同编译器/平台下稳定
+    static uint64_t HashString(const std::string& s) {
+        uint64_t h = 1469598103934665603ull;
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    static GLenum FormatFromChannels(int channels) {
+        if (channels == 1) return GL_RED;
+        if (channels == 4) return GL_RGBA;
+        return GL_RGB;
+    }
+
+    TextureCache::TextureCache(const TextureLoadOptions& opts) : options(opts) {
+        if (options.useCache && !options.cacheDir.empty()) {
+            std::error_code ec;
+            fs::create_directories(options.cacheDir, ec);
+        }
+
+        if (options.compress) {
+            GLint extCount = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extCount);
+            for (GLint i = 0; i < extCount; ++i) {
+                const char* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+                if (ext && std::strcmp(ext, "GL_EXT_texture_compression_s3tc") == 0) {
+                    compressionSupported = true;
+                    break;
+                }
+            }
+            if (!compressionSupported) {
+                std::cout << "[Texture] S3TC not supported, RGB/RGBA textures stay uncompressed." << std::endl;
+            }
+        }
+    }
+
+    std::string TextureCache::CacheFileFor(const std::string& sourceId) const {
+        if (!options.useCache || options.cacheDir.empty()) return "";
+
+        std::ostringstream key;
+        key << sourceId << "|max=" << options.maxSize << "|bc=" << (options.compress ? 1 : 0) << "|v" << CACHE_VERSION;
+
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << HashString(key.str()) << ".vmtex";
+        return (fs::path(options.cacheDir) / name.str()).string();
+    }
+
+    unsigned int TextureCache::ChooseCompressedFormat(int channels) const {
+        // 单通道贴图使用核心格式 RGTC1；RGB/RGBA 需要 S3TC 扩展；双通道保持未压缩
+        if (channels == 1) return GL_COMPRESSED_RED_RGTC1;
+        if (!compressionSupported) return 0;
+        if (channels == 3) return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        if (channels == 4) return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        return 0;
+    }
+
+    void TextureCache::Downsample(const unsigned char* src, int width, int height, int channels, TextureLevel& dst) {
+        // 2x2 盒式滤波 (与 glGenerateMipmap 的常见实现一致)，奇数边长时夹取边缘像素
+        dst.width = std::max(1, width / 2);
+        dst.height = std::max(1, height / 2);
+        dst.data.resize(static_cast<size_t>(dst.width) * dst.height * channels);
+
+        for (int y = 0; y < dst.height; ++y) {
+            int y0 = std::min(y * 2, height - 1);
+            int y1 = std::min(y * 2 + 1, height - 1);
+            for (int x = 0; x < dst.width; ++x) {
+                int x0 = std::min(x * 2, width - 1);
+                int x1 = std::min(x * 2 + 1, width - 1);
+                for (int c = 0; c < channels; ++c) {
+                    int sum = src[(static_cast<size_t>(y0) * width + x0) * channels + c]
+                            + src[(static_cast<size_t>(y0) * width + x1) * channels + c]
+                            + src[(static_cast<size_t>(y1) * width + x0) * channels + c]
+                            + src[(static_cast<size_t>(y1) * width + x1) * channels + c];
+                    dst.data[(static_cast<size_t>(y) * dst.width + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    bool TextureCache::NeedsProcessing(int width, int height) const {
+        if (options.useCache || options.compress) return true;
+        return options.maxSize > 0 && std::max(width, height) > options.maxSize;
+    }
+
+    void TextureCache::Prepare(const unsigned char* pixels, int width, int height, int channels, TextureImage& out) const {
+        out.channels = channels;
+        out.compressedFormat = 0;
+        out.droppedLevels = 0;
+        out.sourceBytes = static_cast<size_t>(width) * height * channels * 4 / 3;
+        out.levels.clear();
+
+        // 1. 丢弃评估分辨率永远采样不到的顶层 Mip (直接从 stb 缓冲降采样，避免拷贝原始大图)
+        TextureLevel base;
+        const unsigned char* src = pixels;
+        int w = width, h = height;
+        while (options.maxSize > 0 && std::max(w, h) > options.maxSize) {
+            TextureLevel half;
+            Downsample(src, w, h, channels, half);
+            base = std::move(half);
+            src = base.data.data();
+            w = base.width;
+            h = base.height;
+            out.droppedLevels++;
+        }
+        if (out.droppedLevels == 0) {
+            base.width = width;
+            base.height = height;
+            base.data.assign(pixels, pixels + static_cast<size_t>(width) * height * channels);
+        }
+        out.levels.push_back(std::move(base));
+
+        // 2. 需要落盘或压缩时，在工作线程中预构建完整 Mip 链；否则仍交给 glGenerateMipmap
+        if (options.useCache || options.compress) {
+            while (out.levels.back().width > 1 || out.levels.back().height > 1) {
+                TextureLevel next;
+                const TextureLevel& prev = out.levels.back();
+                Downsample(prev.data.data(), prev.width, prev.height, channels, next);
+                out.levels.push_back(std::move(next));
+            }
+        }
+    }
+
+    unsigned int TextureCache::Upload(TextureImage& image, const std::string& cacheFile, TextureStats& stats) const {
+        unsigned int textureID;
+        glGenTextures(1, &textureID);
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        GLenum format = FormatFromChannels(image.channels);
+        int levelCount = static_cast<int>(image.levels.size());
+        size_t uploaded = 0;
+
+        if (image.compressedFormat != 0) {
+            // 缓存命中的压缩数据：直接上传块数据
+            for (int l = 0; l < levelCount; ++l) {
+                const TextureLevel& lv = image.levels[l];
+                Utils::TrackedCompressedTexImage2D(Utils::MemoryCategory::Texture, GL_TEXTURE_2D, l, image.compressedFormat,
+                                                   lv.width, lv.height, 0, static_cast<GLsizei>(lv.data.size()), lv.data.data());
+                uploaded += lv.data.size();
+            }
+        } else {
+            unsigned int target = options.compress ? ChooseCompressedFormat(image.channels) : 0;
+            GLint internalFormat = target ? static_cast<GLint>(target) : static_cast<GLint>(format);
+
+            for (int l = 0; l < levelCount; ++l) {
+                const TextureLevel& lv = image.levels[l];
+                Utils::TrackedTexImage2D(Utils::MemoryCategory::Texture, GL_TEXTURE_2D, l, internalFormat, lv.width, lv.height, 0, format, GL_UNSIGNED_BYTE, lv.data.data());
+            }
+
+            if (target && !image.fromCache) {
+                // 测量压缩误差：回读解压后的顶层与源像素对比
+                const TextureLevel& top = image.levels[0];
+                std::vector<unsigned char> decoded(top.data.size());
+                glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                glGetTexImage(GL_TEXTURE_2D, 0, format, GL_UNSIGNED_BYTE, decoded.data());
+                glPixelStorei(GL_PACK_ALIGNMENT, 4);
+                Metrics::PixelFormat pixelFormat = Metrics::ByteFormatFromChannels(image.channels);
+                double psnr = Metrics::Evaluator::ComputePSNR(Metrics::ImageView(top.data, top.width, top.height, pixelFormat),
+                                                              Metrics::ImageView(decoded, top.width, top.height, pixelFormat)).second;
+                stats.worstPSNR = std::min(stats.worstPSNR, psnr);
+
+                // 回读驱动压缩后的块数据，替换 CPU 端的未压缩像素以便落盘
+                for (int l = 0; l < levelCount; ++l) {
+                    GLint size = 0;
+                    glGetTexLevelParameteriv(GL_TEXTURE_2D, l, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+                    image.levels[l].data.resize(static_cast<size_t>(size));
+                    glGetCompressedTexImage(GL_TEXTURE_2D, l, image.levels[l].data.data());
+                }
+                image.compressedFormat = target;
+            }
+
+            for (const auto& lv : image.levels) uploaded += lv.data.size();
+
+            if (levelCount == 1) {
+                Utils::TrackedGenerateMipmap(GL_TEXTURE_2D);
+                uploaded = uploaded * 4 / 3;
+            }
+
+            if (!cacheFile.empty() && !image.fromCache) Write(cacheFile, image);
+        }
+
+        if (levelCount > 1) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        stats.textureCount++;
+        stats.droppedLevels += image.droppedLevels;
+        stats.sourceBytes += image.sourceBytes;
+        stats.uploadedBytes += uploaded;
+        if (image.fromCache) stats.cacheHits++;
+
+        // 上传完成后释放 CPU 端像素
+        image.levels.clear();
+        image.levels.shrink_to_fit();
+        return textureID;
+    }
+
+    // 单个层级应有的字节数 (压缩格式按 4x4 块计)；格式与通道数不匹配时返回 0
+    static uint64_t ExpectedLevelBytes(uint32_t compressedFormat, int channels, int width, int height) {
+        const uint64_t blocks = static_cast<uint64_t>((width + 3) / 4) * static_cast<uint64_t>((height + 3) / 4);
+        switch (compressedFormat) {
+            case 0: return static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * static_cast<uint64_t>(channels);
+            case GL_COMPRESSED_RED_RGTC1: return channels == 1 ? blocks * 8 : 0;
+            case GL_COMPRESSED_RGB_S3TC_DXT1_EXT: return channels == 3 ? blocks * 8 : 0;
+            case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: return channels == 4 ? blocks * 16 : 0;
+            default: return 0;
+        }
+    }
+
+    bool TextureCache::Read(const std::string& cacheFile, TextureImage& out) const {
+        if (cacheFile.empty()) return false;
+        std::error_code ec;
+        const uint64_t fileSize = fs::file_size(cacheFile, ec);
+        if (ec) return false;
+        std::ifstream in(cacheFile, std::ios::binary);
+        if (!in.is_open()) return false;
+
+        // 截断或损坏的缓存按未命中处理: 删除后由本次解码结果重建，而不是按文件中的尺寸分配内存
+        auto invalid = [&]() {
+            in.close();
+            std::cerr << "[Texture] Warning: Discarding corrupt cache entry " << cacheFile << std::endl;
+            std::error_code removeError;
+            fs::remove(cacheFile, removeError);
+            return false;
+        };
+
+        char magic[4];
+        uint32_t version = 0, levelCount = 0;
+        int32_t channels = 0, dropped = 0;
+        uint32_t compressedFormat = 0;
+        uint64_t sourceBytes = 0;
+
+        in.read(magic, 4);
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        if (!in || std::memcmp(magic, CACHE_MAGIC, 4) != 0 || version != CACHE_VERSION) return invalid();
+
+        in.read(reinterpret_cast<char*>(&channels), sizeof(channels));
+        in.read(reinterpret_cast<char*>(&compressedFormat), sizeof(compressedFormat));
+        in.read(reinterpret_cast<char*>(&dropped), sizeof(dropped));
+        in.read(reinterpret_cast<char*>(&sourceBytes), sizeof(sourceBytes));
+        in.read(reinterpret_cast<char*>(&levelCount), sizeof(levelCount));
+        if (!in || channels < 1 || channels > 4 || levelCount == 0 || levelCount > 32) return invalid();
+
+        // 文件头之后剩余的字节数，每个层级至少占一个 16 字节的层级头
+        const uint64_t LEVEL_HEADER_BYTES = sizeof(int32_t) * 2 + sizeof(uint64_t);
+        uint64_t remaining = fileSize - static_cast<uint64_t>(in.tellg());
+        if (static_cast<uint64_t>(levelCount) * LEVEL_HEADER_BYTES > remaining) return invalid();
+
+        TextureImage image;
+        image.channels = channels;
+        image.compressedFormat = compressedFormat;
+        image.droppedLevels = dropped;
+        image.sourceBytes = static_cast<size_t>(sourceBytes);
+        image.fromCache = true;
+        image.levels.resize(levelCount);
+
+        const int MAX_LEVEL_SIZE = 1 << 16;
+        for (size_t l = 0; l < image.levels.size(); ++l) {
+            TextureLevel& lv = image.levels[l];
+            int32_t w = 0, h = 0;
+            uint64_t size = 0;
+            in.read(reinterpret_cast<char*>(&w), sizeof(w));
+            in.read(reinterpret_cast<char*>(&h), sizeof(h));
+            in.read(reinterpret_cast<char*>(&size), sizeof(size));
+            if (!in || w <= 0 || h <= 0 || w > MAX_LEVEL_SIZE || h > MAX_LEVEL_SIZE) return invalid();
+            // 后续层级必须是上一级减半 (与 Prepare 构建的 Mip 链一致)
+            if (l > 0 && (w != std::max(1, image.levels[l - 1].width / 2) || h != std::max(1, image.levels[l - 1].height / 2))) return invalid();
+            remaining -= LEVEL_HEADER_BYTES;
+            if (size != ExpectedLevelBytes(compressedFormat, channels, w, h) || size > remaining) return invalid();
+
+            lv.width = w;
+            lv.height = h;
+            lv.data.resize(static_cast<size_t>(size));
+            in.read(reinterpret_cast<char*>(lv.data.data()), static_cast<std::streamsize>(size));
+            if (!in) return invalid();
+            remaining -= size;
+        }
+
+        out = std::move(image);
+        return true;
+    }
+
+    bool TextureCache::Write(const std::string& cacheFile, const TextureImage& image) {
+        // 先写临时文件再重命名，避免中途退出留下损坏的缓存
+        std::string tmpFile = cacheFile + ".tmp";
+        {
+            std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return false;
+
+            int32_t channels = image.channels;
+            uint32_t compressedFormat = image.compressedFormat;
+            int32_t dropped = image.droppedLevels;
+            uint64_t sourceBytes = image.sourceBytes;
+            uint32_t levelCount = static_cast<uint32_t>(image.levels.size());
+
+            out.write(CACHE_MAGIC, 4);
+            out.write(reinterpret_cast<const char*>(&CACHE_VERSION), sizeof(CACHE_VERSION));
+            out.write(reinterpret_cast<const char*>(&channels), sizeof(channels));
+            out.write(reinterpret_cast<const char*>(&compressedFormat), sizeof(compressedFormat));
+            out.write(reinterpret_cast<const char*>(&dropped), sizeof(dropped));
+            out.write(reinterpret_cast<const char*>(&sourceBytes), sizeof(sourceBytes));
+            out.write(reinterpret_cast<const char*>(&levelCount), sizeof(levelCount));
+
+            for (const auto& lv : image.levels) {
+                int32_t w = lv.width, h = lv.height;
+                uint64_t size = lv.data.size();
+                out.write(reinterpret_cast<const char*>(&w), sizeof(w));
+                out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+                out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+                out.write(reinterpret_cast<const char*>(lv.data.data()), static_cast<std::streamsize>(size));
+            }
+            if (!out) return false;
+        }
+
+        std::error_code ec;
+        fs::rename(tmpFile, cacheFile, ec);
+        if (ec) {
+            fs::remove(tmpFile, ec);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+namespace Resources {
+
+    // 纹理加载选项 (由 Application 根据 AppConfig::Texture 与渲染分辨率推算得到)
+    struct TextureLoadOptions {
+        int maxSize = -1;          // 基础层最大边长，超出部分的 Mip 层级直接丢弃 (-1 = 不限制)
+        bool useCache = false;     // 是否启用磁盘缓存 (预构建 Mip 链)
+        bool compress = false;     // 是否转码为 GPU 块压缩格式 (S3TC / RGTC)
+        std::string cacheDir;      // 缓存目录
+    };
+
+    // 单个 Mip 层级的像素数据 (未压缩为紧密排列的 8bit 像素，压缩时为块数据)
+    struct TextureLevel {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> data;
+    };
+
+    // CPU 端的一张纹理 (可能来自 stb 解码，也可能来自磁盘缓存)
+    struct TextureImage {
+        int channels = 0;
+        unsigned int compressedFormat = 0; // 0 表示未压缩
+        int droppedLevels = 0;             // 因分辨率限制丢弃的顶层 Mip 数
+        bool fromCache = false;
+        size_t sourceBytes = 0;            // 原始分辨率 + 完整 Mip 链的未压缩字节数
+        std::vector<TextureLevel> levels;
+    };
+
+    // 单个模型的纹理管线统计 (用于报告显存与加载收益)
+    struct TextureStats {
+        int textureCount = 0;
+        int cacheHits = 0;
+        int droppedLevels = 0;
+        size_t sourceBytes = 0;   // 原始分辨率 + 完整 Mip 链的未压缩字节数
+        size_t uploadedBytes = 0; // 实际上传到显存的字节数
+        double worstPSNR = 99.99; // 压缩带来的最差 PSNR (仅在本次新建压缩缓存时测量)
+    };
+
+    class TextureCache {
+    public:
+        explicit TextureCache(const TextureLoadOptions& options);
+
+        // 根据源标识 (路径 + 大小 + 修改时间等) 生成缓存文件路径，未启用缓存时返回空
+        std::string CacheFileFor(const std::string& sourceId) const;
+
+        // [工作线程] 读取缓存文件
+        bool Read(const std::string& cacheFile, TextureImage& out) const;
+
+        // 是否需要对解码结果做额外处理 (降采样 / 预构建 Mip / 压缩 / 落盘)，否则沿用原始上传路径
+        bool NeedsProcessing(int width, int height) const;
+
+        // [工作线程] 接管 stb 解码结果：按 maxSize 丢弃顶层 Mip，需要时在 CPU 上预构建完整 Mip 链
+        void Prepare(const unsigned char* pixels, int width, int height, int channels, TextureImage& out) const;
+
+        // [GL 线程] 上传纹理 (必要时由驱动压缩并回读块数据)，并写回缓存
+        unsigned int Upload(TextureImage& image, const std::string& cacheFile, TextureStats& stats) const;
+
+    private:
+        TextureLoadOptions options;
+        bool compressionSupported = false;
+
+        static void Downsample(const unsigned char* src, int width, int height, int channels, TextureLevel& dst);
+        static bool Write(const std::string& cacheFile, const TextureImage& image);
+        unsigned int ChooseCompressedFormat(int channels) const;
+    };
+}
@@ -59,4 +59,33 @@ namespace Scene {
 
         return samples;
     }
-}
\ No newline at end of file
+
+    std::vector<CameraSample> CameraSampler::ProgressiveOrder(const std::vector<CameraSample>& samples) {
+        std::vector<CameraSample> ordered;
+        if (samples.empty()) return ordered;
+        ordered.reserve(samples.size());
+
+        // minDist2[i]: 候选点 i 到已选集合的最小距离平方，已选点记为 -1
+        std::vector<float> minDist2(samples.size(), std::numeric_limits<float>::max());
+        size_t next = 0;
+        for (size_t k = 0; k < samples.size(); ++k) {
+            ordered.push_back(samples[next]);
+            minDist2[next] = -1.0f;
+
+            const glm::vec3& chosen = samples[next].position;
+            size_t best = 0;
+            float bestDist2 = -1.0f;
+            for (size_t i = 0; i < samples.size(); ++i) {
+                if (minDist2[i] < 0.0f) continue;
+                glm::vec3 d = samples[i].position - chosen;
+                minDist2[i] = std::min(minDist2[i], glm::dot(d, d));
+                if (minDist2[i] > bestDist2) {  // 严格大于: 距离相同时取编号较小者
+                    bestDist2 = minDist2[i];
+                    best = i;
+                }
+            }
+            next = best;
+        }
+        return ordered;
+    }
+}
@@ -24,6 +24,14 @@ namespace Scene {
                 float jitterStrength = 0.0f
         );
 
+        /**
+         * @brief 渐进式评估的视角顺序 (贪心最远点)
+         * 从第一个采样点出发，每次选取与已选集合最小距离最大的视角，
+         * 使任意前缀都近似均匀覆盖球面，提前停止时的均值估计不偏向某一侧。结果确定，可复现。
+         * @return 重排后的采样点 (CameraSample::index 保持原编号)
+         */
+        static std::vector<CameraSample> ProgressiveOrder(const std::vector<CameraSample>& samples);
+
     private:
         // 计算刚好包围模型的 FOV
         static float CalculateAdaptiveFOV(float modelRadius, float cameraDistance);
@@ -1,4 +1,5 @@
 #pragma once
+#include "Utils/MemoryTracker.h"
 
 
 namespace Scene {
@@ -27,15 +28,30 @@ namespace Scene {
         std::vector<Texture>      textures;
         MaterialProps             matProps;
         unsigned int VAO;
+        unsigned int indexCount = 0;
 
         Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures, MaterialProps props) {
             this->vertices = vertices;
             this->indices = indices;
             this->textures = textures;
             this->matProps = props;
+            this->indexCount = static_cast<unsigned int>(this->indices.size());
             setupMesh();
         }
 
+        // 流式导入：GL 缓冲已由调用方分块上传完毕，主机端不保留顶点/索引副本
+        Mesh(unsigned int vao, unsigned int vbo, unsigned int ebo, unsigned int count, std::vector<Texture> textures, MaterialProps props)
+                : textures(textures), matProps(props), VAO(vao), indexCount(count), VBO(vbo), EBO(ebo) {}
+
+        // 为当前绑定的 VAO/VBO 设置 Vertex 布局
+        static void SetupVertexAttributes() {
+            glEnableVertexAttribArray(0); glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+            glEnableVertexAttribArray(1); glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+            glEnableVertexAttribArray(2); glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+            glEnableVertexAttribArray(3); glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
+            glEnableVertexAttribArray(4); glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+        }
+
         void Draw(unsigned int shaderProgram) {
             const unsigned int SLOT_ALBEDO = 3;
             const unsigned int SLOT_NORMAL = 4;
@@ -46,7 +62,7 @@ namespace Scene {
             bool hasMR     = false;
 
             for(unsigned int i = 0; i < textures.size(); i++) {
-                std::string name = textures[i].type;
+                const std::string& name = textures[i].type;
                 if(name == "albedoMap") {
                     glActiveTexture(GL_TEXTURE0 + SLOT_ALBEDO);
                     glBindTexture(GL_TEXTURE_2D, textures[i].id);
@@ -76,11 +92,58 @@ namespace Scene {
             glUniform1f(glGetUniformLocation(shaderProgram, "u_MetallicDefault"), matProps.metallic);
 
             glBindVertexArray(VAO);
-            glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, 0);
             glBindVertexArray(0);
             glActiveTexture(GL_TEXTURE0);
         }
 
+        /**
+         * @brief 追加本网格的顶点位置与三角形索引 (索引加上 indexBase 偏移)
+         * 普通网格直接读取主机端副本；流式导入的网格主机端无副本，按 stagingVertices 分块从 VBO/EBO 回读
+         * (需在 GL 线程调用)，主机端只额外保留位置，峰值内存与块大小成正比
+         */
+        void AppendPositions(std::vector<glm::vec3>& positions, std::vector<unsigned int>& outIndices,
+                             size_t stagingVertices = 65536) const {
+            const unsigned int indexBase = static_cast<unsigned int>(positions.size());
+            if (!vertices.empty() || indexCount == 0) {
+                for (const Vertex& v : vertices) positions.push_back(v.Position);
+                for (unsigned int idx : indices) outIndices.push_back(indexBase + idx);
+                return;
+            }
+
+            GLint vboBytes = 0;
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &vboBytes);
+            const size_t vertexCount = static_cast<size_t>(vboBytes) / sizeof(Vertex);
+            const size_t chunk = std::max<size_t>(1, stagingVertices);
+            std::vector<Vertex> staging(std::min(chunk, vertexCount));
+            positions.reserve(positions.size() + vertexCount);
+            for (size_t start = 0; start < vertexCount; start += chunk) {
+                size_t count = std::min(chunk, vertexCount - start);
+                glGetBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(start * sizeof(Vertex)),
+                                   static_cast<GLsizeiptr>(count * sizeof(Vertex)), staging.data());
+                for (size_t i = 0; i < count; ++i) positions.push_back(staging[i].Position);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            // 索引缓冲挂在 VAO 上，需绑定 VAO 后再读取，避免改动其他 VAO 的状态
+            const size_t first = outIndices.size();
+            outIndices.resize(first + indexCount);
+            glBindVertexArray(VAO);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+            glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(indexCount * sizeof(unsigned int)), &outIndices[first]);
+            glBindVertexArray(0);
+            for (size_t i = first; i < outIndices.size(); ++i) outIndices[i] += indexBase;
+        }
+
+        // 释放 GL 缓冲 (须在 GL 线程、上下文销毁之前调用)
+        void Release() {
+            if (VAO) glDeleteVertexArrays(1, &VAO);
+            if (VBO) Utils::TrackedDeleteBuffers(1, &VBO);
+            if (EBO) Utils::TrackedDeleteBuffers(1, &EBO);
+            VAO = VBO = EBO = 0;
+        }
+
     private:
         unsigned int VBO, EBO;
         void setupMesh() {
@@ -89,14 +152,10 @@ namespace Scene {
             glGenBuffers(1, &EBO);
             glBindVertexArray(VAO);
             glBindBuffer(GL_ARRAY_BUFFER, VBO);
-            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+            Utils::TrackedBufferData(Utils::MemoryCategory::Mesh, GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-            glEnableVertexAttribArray(0); glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-            glEnableVertexAttribArray(1); glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-            glEnableVertexAttribArray(2); glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-            glEnableVertexAttribArray(3); glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
-            glEnableVertexAttribArray(4); glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+            Utils::TrackedBufferData(Utils::MemoryCategory::Mesh, GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+            SetupVertexAttributes();
             glBindVertexArray(0);
         }
     };
@@ -1,6 +1,9 @@
 #include "Scene/Model.h"
+#include "Utils/MemoryTracker.h"
+#include "Utils/ParallelUtils.h"
 
 #include <assimp/Importer.hpp>
+#include <assimp/ProgressHandler.hpp>
 #include <assimp/postprocess.h>
 
 #include <cmath>
@@ -13,11 +16,24 @@
 
 namespace Scene {
 
+    // 【修改点】移除了 aiProcess_CalcTangentSpace，避免 Assimp 根据 UV 边界强行拆分顶点，保证纯几何法线一致性
+    static const unsigned int ImportFlags =
+            aiProcess_Triangulate |
+            aiProcess_FlipUVs |
+            aiProcess_JoinIdenticalVertices |
+            aiProcess_GenSmoothNormals;
+
+    // 内存超出预算时取消导入 (Assimp 在读取与各后处理步骤之间回调 Update，返回 false 即中止；由 Importer 负责释放)
+    class BudgetProgressHandler : public Assimp::ProgressHandler {
+    public:
+        bool Update(float) override { return !Utils::MemoryTracker::Instance().OverBudget(); }
+    };
+
     static inline bool IsFiniteVec3(const glm::vec3& v) {
         return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
     }
 
-    Model::Model(std::string const &path) {
+    Model::Model(std::string const &path, const ModelLoadOptions& options) : loadOptions(options) {
         stbi_set_flip_vertically_on_load(false);
         loadModel(path);
         computeBoundingBox();
@@ -32,79 +48,137 @@ namespace Scene {
         return modelMatrix;
     }
 
-    void Model::loadModel(std::string const &path) {
+    void Model::CollectTriangles(std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices) const {
+        positions.clear();
+        indices.clear();
+        for (const auto& mesh : meshes) {
+            mesh.AppendPositions(positions, indices, loadOptions.chunkVertices);
+        }
+    }
+
+    void Model::Release() {
+        for (auto& mesh : meshes) mesh.Release();
+        for (const auto& texture : textures_loaded) {
+            if (texture.id) Utils::TrackedDeleteTextures(1, &texture.id);
+        }
+        textures_loaded.clear();
+        textureLookup.clear();
+    }
+
+    Model::Model(std::string const &name, const std::vector<unsigned char> &data, const std::string &formatHint,
+                 const ModelLoadOptions& options) : loadOptions(options) {
+        // 只设置本线程的翻转状态，不改动其他加载路径 (如 IBLBaker) 依赖的全局标记
+        stbi_set_flip_vertically_on_load_thread(false);
         Assimp::Importer importer;
+        importer.SetProgressHandler(new BudgetProgressHandler());
+        const aiScene* imported = importer.ReadFileFromMemory(data.data(), data.size(), ImportFlags, formatHint.c_str());
+        processImported(importer, imported, name);
+        computeBoundingBox();
+    }
 
-        // 【修改点】移除了 aiProcess_CalcTangentSpace，避免 Assimp 根据 UV 边界强行拆分顶点，保证纯几何法线一致性
-        const aiScene* scene = importer.ReadFile(
-                path,
-                aiProcess_Triangulate |
-                aiProcess_FlipUVs |
-                aiProcess_JoinIdenticalVertices |
-                aiProcess_GenSmoothNormals
-        );
+    void Model::loadModel(std::string const &path) {
+        Assimp::Importer importer;
+        importer.SetProgressHandler(new BudgetProgressHandler());
+        const aiScene* imported = importer.ReadFile(path, ImportFlags);
+        processImported(importer, imported, path);
+    }
 
-        if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+    void Model::processImported(Assimp::Importer &importer, const aiScene *imported, std::string const &path) {
+        if(!imported || imported->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !imported->mRootNode) {
             std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
             return;
         }
 
-        this->scenePtr = scene;
+        // 接管场景所有权，流式模式下才能在每个网格上传后立即释放其数据
+        std::unique_ptr<aiScene> scene(importer.GetOrphanedScene());
+        this->scenePtr = scene.get();
 
         std::filesystem::path p(path);
         this->directory = p.parent_path().string();
 
-        processNode(scene->mRootNode, scene);
+        if (loadOptions.streaming) {
+            meshRefCounts.assign(scene->mNumMeshes, 0);
+            countMeshRefs(scene->mRootNode);
+        }
+
+        preloadTextures(scene.get(), path);
+        processNode(scene->mRootNode, scene.get());
+        preloadedTextures.clear();
+        meshRefCounts.clear();
+        this->scenePtr = nullptr;
     }
 
-    void Model::processNode(aiNode *node, const aiScene *scene) {
+    void Model::countMeshRefs(const aiNode *node) {
+        for (unsigned int i = 0; i < node->mNumMeshes; i++) meshRefCounts[node->mMeshes[i]]++;
+        for (unsigned int i = 0; i < node->mNumChildren; i++) countMeshRefs(node->mChildren[i]);
+    }
+
+    void Model::processNode(aiNode *node, aiScene *scene) {
+        // 超出内存预算后不再上传剩余网格，由调用方中止当前模型
+        if (Utils::MemoryTracker::Instance().OverBudget()) return;
         for(unsigned int i = 0; i < node->mNumMeshes; i++) {
-            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            meshes.push_back(processMesh(mesh, scene));
+            unsigned int meshIdx = node->mMeshes[i];
+            aiMesh* mesh = scene->mMeshes[meshIdx];
+            if (!mesh) continue;
+
+            if (loadOptions.streaming) {
+                meshes.push_back(streamMesh(mesh, scene));
+                // 最后一个引用处理完毕，立即归还该网格占用的主机内存
+                if (--meshRefCounts[meshIdx] == 0) {
+                    delete scene->mMeshes[meshIdx];
+                    scene->mMeshes[meshIdx] = nullptr;
+                }
+            } else {
+                meshes.push_back(processMesh(mesh, scene));
+            }
         }
         for(unsigned int i = 0; i < node->mNumChildren; i++) {
             processNode(node->mChildren[i], scene);
         }
     }
 
+    static Vertex ConvertVertex(const aiMesh *mesh, unsigned int i) {
+        Vertex vertex;
+        glm::vec3 v;
+
+        v.x = mesh->mVertices[i].x;
+        v.y = mesh->mVertices[i].y;
+        v.z = mesh->mVertices[i].z;
+        vertex.Position = v;
+
+        if (mesh->HasNormals()) {
+            v.x = mesh->mNormals[i].x;
+            v.y = mesh->mNormals[i].y;
+            v.z = mesh->mNormals[i].z;
+            vertex.Normal = v;
+        } else {
+            vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+
+        if(mesh->mTextureCoords[0]) {
+            glm::vec2 uv;
+            uv.x = mesh->mTextureCoords[0][i].x;
+            uv.y = mesh->mTextureCoords[0][i].y;
+            vertex.TexCoords = uv;
+
+            // 由于移除了计算切线空间的 Flag，这里不再读取切线，给默认值
+            vertex.Tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+            vertex.Bitangent = glm::vec3(0.0f, 1.0f, 0.0f);
+        } else {
+            vertex.TexCoords = glm::vec2(0.0f, 0.0f);
+        }
+        return vertex;
+    }
+
     Mesh Model::processMesh(aiMesh *mesh, const aiScene *scene) {
         std::vector<Vertex> vertices;
         std::vector<unsigned int> indices;
         std::vector<Texture> textures;
         MaterialProps matProps;
 
+        vertices.reserve(mesh->mNumVertices);
         for(unsigned int i = 0; i < mesh->mNumVertices; i++) {
-            Vertex vertex;
-            glm::vec3 v;
-
-            v.x = mesh->mVertices[i].x;
-            v.y = mesh->mVertices[i].y;
-            v.z = mesh->mVertices[i].z;
-            vertex.Position = v;
-
-            if (mesh->HasNormals()) {
-                v.x = mesh->mNormals[i].x;
-                v.y = mesh->mNormals[i].y;
-                v.z = mesh->mNormals[i].z;
-                vertex.Normal = v;
-            } else {
-                vertex.Normal = glm::vec3(0.0f, 1.0f, 0.0f);
-            }
-
-            if(mesh->mTextureCoords[0]) {
-                glm::vec2 uv;
-                uv.x = mesh->mTextureCoords[0][i].x;
-                uv.y = mesh->mTextureCoords[0][i].y;
-                vertex.TexCoords = uv;
-
-                // 由于移除了计算切线空间的 Flag，这里不再读取切线，给默认值
-                vertex.Tangent = glm::vec3(1.0f, 0.0f, 0.0f);
-                vertex.Bitangent = glm::vec3(0.0f, 1.0f, 0.0f);
-            } else {
-                vertex.TexCoords = glm::vec2(0.0f, 0.0f);
-            }
-
-            vertices.push_back(vertex);
+            vertices.push_back(ConvertVertex(mesh, i));
         }
 
         for(unsigned int i = 0; i < mesh->mNumFaces; i++) {
@@ -113,6 +187,74 @@ namespace Scene {
                 indices.push_back(face.mIndices[j]);
         }
 
+        loadMaterial(mesh, scene, textures, matProps);
+        return Mesh(vertices, indices, textures, matProps);
+    }
+
+    Mesh Model::streamMesh(aiMesh *mesh, const aiScene *scene) {
+        std::vector<Texture> textures;
+        MaterialProps matProps;
+        loadMaterial(mesh, scene, textures, matProps);
+
+        const size_t chunkVerts = std::max<size_t>(1, loadOptions.chunkVertices);
+        const size_t chunkIndices = chunkVerts * 3;
+
+        size_t indexCount = 0;
+        for (unsigned int i = 0; i < mesh->mNumFaces; i++) indexCount += mesh->mFaces[i].mNumIndices;
+
+        unsigned int VAO, VBO, EBO;
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glGenBuffers(1, &EBO);
+        glBindVertexArray(VAO);
+
+        // 1. 顶点：预分配显存，按块转换到暂存缓冲后 glBufferSubData 上传，同时累积包围盒
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        Utils::TrackedBufferData(Utils::MemoryCategory::Mesh, GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh->mNumVertices * sizeof(Vertex)), nullptr, GL_STATIC_DRAW);
+
+        std::vector<Vertex> stagingVerts;
+        stagingVerts.reserve(std::min<size_t>(chunkVerts, mesh->mNumVertices));
+        for (size_t start = 0; start < mesh->mNumVertices; start += chunkVerts) {
+            size_t end = std::min<size_t>(start + chunkVerts, mesh->mNumVertices);
+            stagingVerts.clear();
+            for (size_t i = start; i < end; ++i) {
+                Vertex vertex = ConvertVertex(mesh, static_cast<unsigned int>(i));
+                streamedMin = glm::min(streamedMin, vertex.Position);
+                streamedMax = glm::max(streamedMax, vertex.Position);
+                stagingVerts.push_back(vertex);
+            }
+            glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(start * sizeof(Vertex)),
+                            static_cast<GLsizeiptr>(stagingVerts.size() * sizeof(Vertex)), stagingVerts.data());
+        }
+
+        // 2. 索引：同样分块展开面索引并上传
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        Utils::TrackedBufferData(Utils::MemoryCategory::Mesh, GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexCount * sizeof(unsigned int)), nullptr, GL_STATIC_DRAW);
+
+        std::vector<unsigned int> stagingIndices;
+        stagingIndices.reserve(std::min(chunkIndices, indexCount));
+        size_t uploadedIndices = 0;
+        auto flushIndices = [&]() {
+            if (stagingIndices.empty()) return;
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(uploadedIndices * sizeof(unsigned int)),
+                            static_cast<GLsizeiptr>(stagingIndices.size() * sizeof(unsigned int)), stagingIndices.data());
+            uploadedIndices += stagingIndices.size();
+            stagingIndices.clear();
+        };
+        for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+            const aiFace& face = mesh->mFaces[i];
+            for (unsigned int j = 0; j < face.mNumIndices; j++) stagingIndices.push_back(face.mIndices[j]);
+            if (stagingIndices.size() >= chunkIndices) flushIndices();
+        }
+        flushIndices();
+
+        Mesh::SetupVertexAttributes();
+        glBindVertexArray(0);
+
+        return Mesh(VAO, VBO, EBO, static_cast<unsigned int>(indexCount), textures, matProps);
+    }
+
+    void Model::loadMaterial(aiMesh *mesh, const aiScene *scene, std::vector<Texture> &textures, MaterialProps &matProps) {
         if (mesh->mMaterialIndex >= 0) {
             aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
             bool hasAlbedo = false;
@@ -144,8 +286,99 @@ namespace Scene {
             if (AI_SUCCESS == material->Get(AI_MATKEY_METALLIC_FACTOR, val)) matProps.metallic = val;
             if (AI_SUCCESS == material->Get(AI_MATKEY_ROUGHNESS_FACTOR, val)) matProps.roughness = val;
         }
+    }
 
-        return Mesh(vertices, indices, textures, matProps);
+    // 纹理源的唯一标识 (用于磁盘缓存键)：外部文件取绝对路径 + 大小 + 修改时间，内嵌纹理取模型路径 + 索引
+    static std::string TextureSourceId(const std::string &path, const std::string &texDirectory, const std::string &modelPath, const aiScene *scene) {
+        std::ostringstream id;
+        if (!path.empty() && path[0] == '*') {
+            size_t index = static_cast<size_t>(std::strtoul(path.c_str() + 1, nullptr, 10));
+            id << std::filesystem::absolute(modelPath).string() << "#" << path;
+            if (scene && index < scene->mNumTextures) id << ":" << scene->mTextures[index]->mWidth << "x" << scene->mTextures[index]->mHeight;
+            return id.str();
+        }
+
+        std::error_code ec;
+        std::filesystem::path p = std::filesystem::absolute(std::filesystem::path(texDirectory) / path, ec);
+        id << p.string();
+        auto size = std::filesystem::file_size(p, ec);
+        if (!ec) id << ":" << size;
+        auto mtime = std::filesystem::last_write_time(p, ec);
+        if (!ec) id << ":" << mtime.time_since_epoch().count();
+        return id.str();
+    }
+
+    void Model::preloadTextures(const aiScene *scene, const std::string &modelPath) {
+        std::vector<std::string> paths;
+        std::unordered_set<std::string> seen;
+
+        auto collect = [&](aiMaterial* mat, aiTextureType type) {
+            unsigned int count = mat->GetTextureCount(type);
+            for (unsigned int i = 0; i < count; i++) {
+                aiString str;
+                mat->GetTexture(type, i, &str);
+                if (seen.insert(str.C_Str()).second) paths.emplace_back(str.C_Str());
+            }
+            return count > 0;
+        };
+
+        // 与 processMesh 中的贴图选择顺序保持一致，避免解码实际不会被使用的 Emissive 贴图
+        for (unsigned int m = 0; m < scene->mNumMaterials; m++) {
+            aiMaterial* material = scene->mMaterials[m];
+            if (!collect(material, aiTextureType_BASE_COLOR) && !collect(material, aiTextureType_DIFFUSE))
+                collect(material, aiTextureType_EMISSIVE);
+            collect(material, aiTextureType_NORMALS);
+            collect(material, aiTextureType_UNKNOWN);
+        }
+
+        if (paths.empty()) return;
+
+        Resources::TextureCache cache(loadOptions.texture);
+        const std::string& texDirectory = this->directory;
+
+        std::vector<std::string> cacheFiles(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) {
+            cacheFiles[i] = cache.CacheFileFor(TextureSourceId(paths[i], texDirectory, modelPath, scene));
+        }
+
+        // 1. 并行解码 (PNG/JPEG 解压、降采样与 Mip 构建都是 CPU 密集型，与 GL 上下文无关)
+        //    缓存命中时直接读取预构建的 Mip 链，跳过解码
+        std::vector<DecodedTexture> decoded(paths.size());
+        std::vector<Resources::TextureImage> images(paths.size());
+        Utils::ParallelFor(paths.size(), [&](size_t i) {
+            if (cache.Read(cacheFiles[i], images[i])) return;
+
+            DecodedTexture d = DecodeTexture(paths[i], texDirectory, scene);
+            if (d.data && cache.NeedsProcessing(d.width, d.height)) {
+                cache.Prepare(d.data, d.width, d.height, d.nrComponents, images[i]);
+                stbi_image_free(d.data);
+                d.data = nullptr;
+            } else {
+                decoded[i] = d;
+            }
+        });
+
+        // 2. 串行上传 (GL 调用必须留在持有上下文的线程)
+        Resources::TextureStats stats;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (!images[i].levels.empty()) {
+                preloadedTextures[paths[i]] = cache.Upload(images[i], cacheFiles[i], stats);
+                continue;
+            }
+            if (decoded[i].data) {
+                size_t bytes = static_cast<size_t>(decoded[i].width) * decoded[i].height * decoded[i].nrComponents * 4 / 3;
+                stats.textureCount++;
+                stats.sourceBytes += bytes;
+                stats.uploadedBytes += bytes;
+            }
+            preloadedTextures[paths[i]] = UploadTexture(decoded[i], paths[i]);
+        }
+
+        std::cout << "  [Texture] " << stats.textureCount << " textures, cache hits: " << stats.cacheHits
+                  << ", dropped mips: " << stats.droppedLevels
+                  << ", VRAM: " << (stats.uploadedBytes >> 20) << " MB (source " << (stats.sourceBytes >> 20) << " MB)";
+        if (stats.worstPSNR < 99.99) std::cout << ", worst compression PSNR: " << stats.worstPSNR << " dB";
+        std::cout << std::endl;
     }
 
     std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName) {
@@ -153,71 +386,85 @@ namespace Scene {
         for(unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
             aiString str;
             mat->GetTexture(type, i, &str);
-            bool skip = false;
-            for(unsigned int j = 0; j < textures_loaded.size(); j++) {
-                if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0) {
-                    textures.push_back(textures_loaded[j]);
-                    skip = true; break;
-                }
+
+            auto found = textureLookup.find(str.C_Str());
+            if (found != textureLookup.end()) {
+                textures.push_back(textures_loaded[found->second]);
+                continue;
             }
-            if(!skip) {
-                Texture texture;
+
+            Texture texture;
+            auto preloaded = preloadedTextures.find(str.C_Str());
+            if (preloaded != preloadedTextures.end()) {
+                texture.id = preloaded->second;
+            } else {
                 texture.id = TextureFromFile(str.C_Str(), this->directory, this->scenePtr);
-                texture.type = typeName;
-                texture.path = str.C_Str();
-                textures.push_back(texture);
-                textures_loaded.push_back(texture);
             }
+            texture.type = typeName;
+            texture.path = str.C_Str();
+            textures.push_back(texture);
+            textureLookup[texture.path] = textures_loaded.size();
+            textures_loaded.push_back(texture);
         }
         return textures;
     }
 
     unsigned int Model::TextureFromFile(const char *path, const std::string &texDirectory, const aiScene* scene) {
-        std::string filename = std::string(path);
-        unsigned int textureID;
-        glGenTextures(1, &textureID);
+        DecodedTexture decoded = DecodeTexture(path, texDirectory, scene);
+        return UploadTexture(decoded, path);
+    }
+
+    Model::DecodedTexture Model::DecodeTexture(const std::string &path, const std::string &texDirectory, const aiScene* scene) {
+        DecodedTexture out;
 
-        int width, height, nrComponents;
-        unsigned char *data = nullptr;
+        // 可能运行在工作线程中，显式设置本线程的翻转状态，不依赖全局标记
+        stbi_set_flip_vertically_on_load_thread(false);
 
         const aiTexture* embeddedTex = nullptr;
-        if (path[0] == '*') {
-            size_t index = std::stoi(filename.substr(1));
+        if (!path.empty() && path[0] == '*') {
+            size_t index = static_cast<size_t>(std::strtoul(path.c_str() + 1, nullptr, 10));
             if (scene && index < scene->mNumTextures) embeddedTex = scene->mTextures[index];
         }
 
         if (embeddedTex) {
             if (embeddedTex->mHeight == 0) {
-                data = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(embeddedTex->pcData), embeddedTex->mWidth, &width, &height, &nrComponents, 0);
+                out.data = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(embeddedTex->pcData), embeddedTex->mWidth, &out.width, &out.height, &out.nrComponents, 0);
             } else {
-                data = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(embeddedTex->pcData), embeddedTex->mWidth * embeddedTex->mHeight * 4, &width, &height, &nrComponents, 0);
+                out.data = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(embeddedTex->pcData), embeddedTex->mWidth * embeddedTex->mHeight * 4, &out.width, &out.height, &out.nrComponents, 0);
             }
         } else {
-            std::filesystem::path p = std::filesystem::path(texDirectory) / filename;
-            data = stbi_load(p.string().c_str(), &width, &height, &nrComponents, 0);
+            std::filesystem::path p = std::filesystem::path(texDirectory) / path;
+            out.data = stbi_load(p.string().c_str(), &out.width, &out.height, &out.nrComponents, 0);
         }
+        return out;
+    }
 
-        if (data) {
+    unsigned int Model::UploadTexture(DecodedTexture &decoded, const std::string &path) {
+        unsigned int textureID;
+        glGenTextures(1, &textureID);
+
+        if (decoded.data) {
             GLenum format = GL_RGB;
-            if (nrComponents == 1) format = GL_RED;
-            else if (nrComponents == 3) format = GL_RGB;
-            else if (nrComponents == 4) format = GL_RGBA;
+            if (decoded.nrComponents == 1) format = GL_RED;
+            else if (decoded.nrComponents == 3) format = GL_RGB;
+            else if (decoded.nrComponents == 4) format = GL_RGBA;
 
             glBindTexture(GL_TEXTURE_2D, textureID);
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
+            Utils::TrackedTexImage2D(Utils::MemoryCategory::Texture, GL_TEXTURE_2D, 0, format, decoded.width, decoded.height, 0, format, GL_UNSIGNED_BYTE, decoded.data);
+            Utils::TrackedGenerateMipmap(GL_TEXTURE_2D);
 
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-            stbi_image_free(data);
+            stbi_image_free(decoded.data);
+            decoded.data = nullptr;
         } else {
             std::cout << "[Error] Texture failed to load: " << path << std::endl;
             unsigned char pink[] = { 255, 0, 255, 255 };
             glBindTexture(GL_TEXTURE_2D, textureID);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pink);
+            Utils::TrackedTexImage2D(Utils::MemoryCategory::Texture, GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pink);
         }
         return textureID;
     }
@@ -240,6 +487,10 @@ namespace Scene {
             }
         }
 
+        // 流式导入的网格不保留顶点，使用转换时累积的包围盒
+        minX = std::min(minX, streamedMin.x); minY = std::min(minY, streamedMin.y); minZ = std::min(minZ, streamedMin.z);
+        maxX = std::max(maxX, streamedMax.x); maxY = std::max(maxY, streamedMax.y); maxZ = std::max(maxZ, streamedMax.z);
+
         boundsMin = glm::vec3(minX, minY, minZ);
         boundsMax = glm::vec3(maxX, maxY, maxZ);
 
@@ -2,10 +2,21 @@
 
 #include <assimp/scene.h>
 #include "Scene/Mesh.h" // 包含 Mesh 定义 (Vertex, Texture, MaterialProps)
+#include "Resources/TextureCache.h"
 
+namespace Assimp { class Importer; }
 
 namespace Scene {
 
+    // 模型加载选项
+    struct ModelLoadOptions {
+        Resources::TextureLoadOptions texture;
+        // 流式导入：逐网格分块转换到固定大小的暂存缓冲并直接上传，不在主机端保留 Vertex 副本，
+        // 每个 aiMesh 上传后立即释放
+        bool streaming = false;
+        size_t chunkVertices = 65536;    // 每个暂存块的顶点数 (索引块为其 3 倍)
+    };
+
     class Model {
     public:
         std::vector<Texture> textures_loaded;
@@ -16,19 +27,57 @@ namespace Scene {
         glm::vec3 boundsMax;
         glm::mat4 modelMatrix;
 
-        Model(std::string const &path);
+        Model(std::string const &path, const ModelLoadOptions& options = {});
+        // 从内存缓冲导入 (如程序化生成的基准网格)，formatHint 为格式扩展名 (如 "ply")，name 仅用于日志与纹理目录
+        Model(std::string const &name, const std::vector<unsigned char> &data, const std::string &formatHint,
+              const ModelLoadOptions& options = {});
         void Draw(unsigned int shaderID);
         glm::mat4 GetNormalizationMatrix() const;
 
+        // 汇总所有网格的顶点位置与三角形索引 (模型原始坐标，与渲染一致不应用节点变换)
+        // 流式导入的网格从显存回读，需在 GL 线程调用
+        void CollectTriangles(std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices) const;
+
+        // 释放全部网格缓冲与材质纹理 (须在 GL 线程、上下文销毁之前调用)
+        void Release();
+
     private:
+        // CPU 端解码后的纹理像素 (由 stb_image 分配，上传后释放)
+        struct DecodedTexture {
+            unsigned char* data = nullptr;
+            int width = 0;
+            int height = 0;
+            int nrComponents = 0;
+        };
+
         const aiScene* scenePtr;
+        ModelLoadOptions loadOptions;
+
+        // 流式模式下由转换过程累积的包围盒 (此时 Mesh 不保留顶点)
+        glm::vec3 streamedMin = glm::vec3(1e9f);
+        glm::vec3 streamedMax = glm::vec3(-1e9f);
+        // 流式模式下每个 aiMesh 剩余的节点引用数，归零后释放
+        std::vector<unsigned int> meshRefCounts;
+
+        // 纹理路径 -> textures_loaded 下标，替代原先的线性 strcmp 查重
+        std::unordered_map<std::string, size_t> textureLookup;
+        // 纹理路径 -> 预先并行解码并上传好的 GL 纹理 ID
+        std::unordered_map<std::string, unsigned int> preloadedTextures;
 
         void loadModel(std::string const &path);
-        void processNode(aiNode *node, const aiScene *scene);
+        void processImported(Assimp::Importer &importer, const aiScene *imported, std::string const &path);
+        void processNode(aiNode *node, aiScene *scene);
         Mesh processMesh(aiMesh *mesh, const aiScene *scene);
+        Mesh streamMesh(aiMesh *mesh, const aiScene *scene);
+        void loadMaterial(aiMesh *mesh, const aiScene *scene, std::vector<Texture> &textures, MaterialProps &matProps);
+        void countMeshRefs(const aiNode *node);
 
+        // 收集所有材质引用的唯一纹理，在工作线程中并行解码，随后在 GL 线程串行上传
+        void preloadTextures(const aiScene *scene, const std::string &modelPath);
         std::vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName);
         unsigned int TextureFromFile(const char *path, const std::string &texDirectory, const aiScene* scene);
+        static DecodedTexture DecodeTexture(const std::string &path, const std::string &texDirectory, const aiScene* scene);
+        static unsigned int UploadTexture(DecodedTexture &decoded, const std::string &path);
         void computeBoundingBox();
     };
 }
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include "Scene/ProceduralModels.h"
+
+#include <array>
+
+
+namespace Scene {
+
+    namespace {
+
+        /**
+         * 立方体表面网格的构建器: 每个面划分为 n x n 个单元，角点用整数格点 (各分量 [0, n]) 表示，
+         * 相邻面共享棱上的格点，因此生成的网格是闭合的。level 为附加的离散层级 (greeble 高度)，
+         * 同一格点的不同层级是不同的顶点。
+         */
+        class CubeLattice {
+        public:
+            CubeLattice(ProceduralMesh& mesh, int n) : mesh(mesh), n(n) {}
+
+            // 第 face 个面 (axis = face / 2，偶数为正向) 上单元角点 (i, j) 的格点坐标
+            glm::ivec3 Corner(int face, int i, int j) const {
+                const int axis = face / 2;
+                glm::ivec3 c(0);
+                c[axis] = (face % 2 == 0) ? n : 0;
+                c[(axis + 1) % 3] = i;
+                c[(axis + 2) % 3] = j;
+                return c;
+            }
+
+            // 格点在 [-1, 1]^3 立方体上的位置
+            glm::vec3 CubePoint(const glm::ivec3& c) const {
+                return glm::vec3(c) * (2.0f / n) - glm::vec3(1.0f);
+            }
+
+            template<typename PositionFn>
+            unsigned int Vertex(const glm::ivec3& c, int level, PositionFn&& position) {
+                const uint64_t key = uint64_t(c.x) | (uint64_t(c.y) << 16) | (uint64_t(c.z) << 32) | (uint64_t(level) << 48);
+                auto it = lookup.find(key);
+                if (it != lookup.end()) return it->second;
+                const unsigned int index = static_cast<unsigned int>(mesh.positions.size());
+                mesh.positions.push_back(position(c));
+                lookup.emplace(key, index);
+                return index;
+            }
+
+            // 四边形 (a, b, c, d 按环绕顺序) 拆为两个三角形，朝向与 outward 一致
+            void Quad(unsigned int a, unsigned int b, unsigned int c, unsigned int d, const glm::vec3& outward) {
+                const glm::vec3& pa = mesh.positions[a];
+                glm::vec3 normal = glm::cross(mesh.positions[b] - pa, mesh.positions[c] - pa);
+                if (glm::dot(normal, outward) < 0.0f) std::swap(b, d);
+                mesh.indices.insert(mesh.indices.end(), { a, b, c, a, c, d });
+            }
+
+        private:
+            ProceduralMesh& mesh;
+            int n;
+            std::unordered_map<uint64_t, unsigned int> lookup;
+        };
+
+        struct TripleHash {
+            size_t operator()(const std::array<unsigned int, 3>& t) const {
+                uint64_t h = t[0];
+                h = h * 0x9E3779B97F4A7C15ull ^ t[1];
+                h = h * 0x9E3779B97F4A7C15ull ^ t[2];
+                return static_cast<size_t>(h ^ (h >> 29));
+            }
+        };
+    }
+
+    const char* ProceduralModels::ShapeName(ProceduralShape shape) {
+        switch (shape) {
+            case ProceduralShape::Sphere:      return "Sphere";
+            case ProceduralShape::GreebledBox: return "GreebledBox";
+        }
+        return "Unknown";
+    }
+
+    ProceduralMesh ProceduralModels::Generate(ProceduralShape shape, size_t targetTriangles, uint32_t seed) {
+        // 细分球: 6 个面 x n^2 个单元 x 2 个三角形
+        auto subdivisionsFor = [](double trianglesPerCell, size_t target) {
+            return std::max(2, static_cast<int>(std::lround(std::sqrt(target / (12.0 * trianglesPerCell)))));
+        };
+
+        if (shape == ProceduralShape::Sphere) return Sphere(subdivisionsFor(1.0, targetTriangles));
+
+        // greeble 方盒的侧壁数量取决于随机布局，先按经验比例估算细分数，再按实际三角形数校正一次
+        int n = subdivisionsFor(1.3, targetTriangles);
+        ProceduralMesh mesh = GreebledBox(n, seed);
+        double perCell = mesh.TriangleCount() / (12.0 * n * n);
+        int corrected = subdivisionsFor(perCell, targetTriangles);
+        if (corrected != n) mesh = GreebledBox(corrected, seed);
+        return mesh;
+    }
+
+    ProceduralMesh ProceduralModels::Sphere(int n) {
+        ProceduralMesh mesh;
+        mesh.positions.reserve(static_cast<size_t>(6) * (n + 1) * (n + 1));
+        mesh.indices.reserve(static_cast<size_t>(36) * n * n);
+        CubeLattice lattice(mesh, n);
+
+        // 切线映射使投影到球面后的单元面积接近均匀
+        auto position = [&](const glm::ivec3& c) {
+            glm::vec3 p = lattice.CubePoint(c);
+            const float quarterPi = glm::pi<float>() * 0.25f;
+            return glm::normalize(glm::vec3(std::tan(p.x * quarterPi), std::tan(p.y * quarterPi), std::tan(p.z * quarterPi)));
+        };
+
+        for (int face = 0; face < 6; ++face) {
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    unsigned int a = lattice.Vertex(lattice.Corner(face, i, j), 0, position);
+                    unsigned int b = lattice.Vertex(lattice.Corner(face, i + 1, j), 0, position);
+                    unsigned int c = lattice.Vertex(lattice.Corner(face, i + 1, j + 1), 0, position);
+                    unsigned int d = lattice.Vertex(lattice.Corner(face, i, j + 1), 0, position);
+                    lattice.Quad(a, b, c, d, mesh.positions[a]);
+                }
+            }
+        }
+        return mesh;
+    }
+
+    ProceduralMesh ProceduralModels::GreebledBox(int n, uint32_t seed) {
+        ProceduralMesh mesh;
+        CubeLattice lattice(mesh, n);
+
+        const int blockSize = std::max(1, std::min(4, n / 8)); // 凸起块的边长 (单元数)
+        const float levelHeight = 0.04f;
+
+        for (int face = 0; face < 6; ++face) {
+            const int axis = face / 2;
+            const float sign = (face % 2 == 0) ? 1.0f : -1.0f;
+            glm::vec3 normal(0.0f);
+            normal[axis] = sign;
+            glm::vec3 axisU(0.0f), axisV(0.0f);
+            axisU[(axis + 1) % 3] = 1.0f;
+            axisV[(axis + 2) % 3] = 1.0f;
+
+            // 每个块随机取一个高度层级 (半数为 0)，面边界一圈单元固定为 0，使相邻面在棱上闭合
+            std::mt19937 rng(seed * 6u + static_cast<uint32_t>(face));
+            std::uniform_int_distribution<int> levelDist(-3, 3);
+            const int blocks = (n + blockSize - 1) / blockSize;
+            std::vector<int> blockLevels(static_cast<size_t>(blocks) * blocks);
+            for (int& level : blockLevels) level = std::max(0, levelDist(rng));
+
+            auto level = [&](int i, int j) {
+                if (i <= 0 || j <= 0 || i >= n - 1 || j >= n - 1) return 0;
+                return blockLevels[static_cast<size_t>(i / blockSize) * blocks + j / blockSize];
+            };
+
+            auto vertex = [&](int i, int j, int lv) {
+                return lattice.Vertex(lattice.Corner(face, i, j), lv, [&](const glm::ivec3& c) {
+                    return lattice.CubePoint(c) + normal * (levelHeight * lv);
+                });
+            };
+
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    const int lv = level(i, j);
+                    lattice.Quad(vertex(i, j, lv), vertex(i + 1, j, lv), vertex(i + 1, j + 1, lv), vertex(i, j + 1, lv), normal);
+
+                    // 与 +u / +v 方向相邻单元的高度差形成侧壁，朝向较低的一侧
+                    if (i + 1 < n) {
+                        const int next = level(i + 1, j);
+                        if (next != lv) {
+                            lattice.Quad(vertex(i + 1, j, lv), vertex(i + 1, j + 1, lv), vertex(i + 1, j + 1, next), vertex(i + 1, j, next),
+                                         next < lv ? axisU : -axisU);
+                        }
+                    }
+                    if (j + 1 < n) {
+                        const int next = level(i, j + 1);
+                        if (next != lv) {
+                            lattice.Quad(vertex(i, j + 1, lv), vertex(i + 1, j + 1, lv), vertex(i + 1, j + 1, next), vertex(i, j + 1, next),
+                                         next < lv ? axisV : -axisV);
+                        }
+                    }
+                }
+            }
+        }
+        return mesh;
+    }
+
+    ProceduralMesh ProceduralModels::Simplify(const ProceduralMesh& mesh, float ratio) {
+        const size_t triangles = mesh.TriangleCount();
+        if (ratio >= 1.0f || triangles == 0) return mesh;
+        const double target = std::max(4.0, ratio * static_cast<double>(triangles));
+
+        // 聚类后的网格近似为边长 cellSize 的规则网格: 三角形数 ≈ 2 * 面积 / cellSize^2
+        double area = 0.0;
+        for (size_t t = 0; t < triangles; ++t) {
+            const glm::vec3& a = mesh.positions[mesh.indices[t * 3 + 0]];
+            const glm::vec3& b = mesh.positions[mesh.indices[t * 3 + 1]];
+            const glm::vec3& c = mesh.positions[mesh.indices[t * 3 + 2]];
+            area += 0.5 * glm::length(glm::cross(b - a, c - a));
+        }
+        float cellSize = static_cast<float>(std::sqrt(2.0 * area / target));
+
+        ProceduralMesh result = ClusterVertices(mesh, cellSize);
+        if (result.TriangleCount() > 0) {
+            cellSize *= static_cast<float>(std::sqrt(result.TriangleCount() / target));
+            result = ClusterVertices(mesh, cellSize);
+        }
+        return result;
+    }
+
+    ProceduralMesh ProceduralModels::ClusterVertices(const ProceduralMesh& mesh, float cellSize) {
+        glm::vec3 boundsMin(std::numeric_limits<float>::max());
+        for (const glm::vec3& p : mesh.positions) boundsMin = glm::min(boundsMin, p);
+
+        const float invCell = 1.0f / std::max(cellSize, 1e-6f);
+        const int64_t maxCell = (int64_t(1) << 21) - 1;
+
+        std::unordered_map<uint64_t, unsigned int> cellLookup;
+        std::vector<unsigned int> clusterOf(mesh.positions.size());
+        std::vector<glm::dvec3> sums;
+        std::vector<unsigned int> counts;
+
+        for (size_t i = 0; i < mesh.positions.size(); ++i) {
+            const glm::vec3 g = (mesh.positions[i] - boundsMin) * invCell;
+            uint64_t key = 0;
+            for (int k = 0; k < 3; ++k) {
+                key |= static_cast<uint64_t>(std::min<int64_t>(static_cast<int64_t>(g[k]), maxCell)) << (21 * k);
+            }
+            auto inserted = cellLookup.emplace(key, static_cast<unsigned int>(sums.size()));
+            if (inserted.second) {
+                sums.emplace_back(0.0);
+                counts.push_back(0);
+            }
+            const unsigned int cluster = inserted.first->second;
+            clusterOf[i] = cluster;
+            sums[cluster] += glm::dvec3(mesh.positions[i]);
+            counts[cluster]++;
+        }
+
+        ProceduralMesh result;
+        result.positions.resize(sums.size());
+        for (size_t c = 0; c < sums.size(); ++c) result.positions[c] = glm::vec3(sums[c] / static_cast<double>(counts[c]));
+
+        // 三个顶点落在不同单元的三角形才保留；同一组单元只保留第一个 (不论环绕方向)
+        std::unordered_set<std::array<unsigned int, 3>, TripleHash> seen;
+        for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+            std::array<unsigned int, 3> tri = { clusterOf[mesh.indices[t]], clusterOf[mesh.indices[t + 1]], clusterOf[mesh.indices[t + 2]] };
+            if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) continue;
+            std::array<unsigned int, 3> sorted = tri;
+            std::sort(sorted.begin(), sorted.end());
+            if (!seen.insert(sorted).second) continue;
+            result.indices.insert(result.indices.end(), tri.begin(), tri.end());
+        }
+        return result;
+    }
+
+    std::vector<unsigned char> ProceduralModels::ToBinaryPly(const ProceduralMesh& mesh) {
+        std::ostringstream header;
+        header << "ply\nformat binary_little_endian 1.0\n"
+               << "element vertex " << mesh.positions.size() << "\n"
+               << "property float x\nproperty float y\nproperty float z\n"
+               << "element face " << mesh.TriangleCount() << "\n"
+               << "property list uchar int vertex_indices\nend_header\n";
+        const std::string text = header.str();
+
+        const size_t faceBytes = 1 + 3 * sizeof(int32_t);
+        std::vector<unsigned char> data(text.size() + mesh.positions.size() * 3 * sizeof(float) + mesh.TriangleCount() * faceBytes);
+        unsigned char* dst = data.data();
+        std::memcpy(dst, text.data(), text.size());
+        dst += text.size();
+
+        // 目标平台 (x86 / ARM) 均为小端序，按内存布局直接写出
+        for (const glm::vec3& p : mesh.positions) {
+            const float xyz[3] = { p.x, p.y, p.z };
+            std::memcpy(dst, xyz, sizeof(xyz));
+            dst += sizeof(xyz);
+        }
+        for (size_t t = 0; t < mesh.TriangleCount(); ++t) {
+            *dst++ = 3;
+            const int32_t tri[3] = { static_cast<int32_t>(mesh.indices[t * 3]), static_cast<int32_t>(mesh.indices[t * 3 + 1]),
+                                     static_cast<int32_t>(mesh.indices[t * 3 + 2]) };
+            std::memcpy(dst, tri, sizeof(tri));
+            dst += sizeof(tri);
+        }
+        return data;
+    }
+}
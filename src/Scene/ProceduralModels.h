@@ -0,0 +1,43 @@
+#pragma once
+
+
+namespace Scene {
+
+    // 程序化网格 (仅位置与三角形索引，法线由导入时的 aiProcess_GenSmoothNormals 生成)
+    struct ProceduralMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<unsigned int> indices;
+
+        size_t TriangleCount() const { return indices.size() / 3; }
+    };
+
+    enum class ProceduralShape {
+        Sphere,       // 细分球 (立方体格点投影到球面，三角形大小均匀)
+        GreebledBox   // 表面布满随机凸起块的方盒 (大量硬边与小尺度细节)
+    };
+
+    /**
+     * @brief 端到端吞吐基准使用的程序化模型 (结果只由参数与种子决定，可在任意机器上复现)
+     * 参考模型按目标三角形数生成，优化模型由顶点聚类按比例简化，
+     * 二者序列化为二进制 PLY 后交给 Assimp 从内存导入，与真实资产走同一条加载路径。
+     */
+    class ProceduralModels {
+    public:
+        static const char* ShapeName(ProceduralShape shape);
+
+        // 生成约 targetTriangles 个三角形的网格 (坐标范围约为 [-1, 1])
+        static ProceduralMesh Generate(ProceduralShape shape, size_t targetTriangles, uint32_t seed);
+
+        // 顶点聚类简化: 同一均匀网格单元内的顶点合并为均值，退化与重复的三角形被丢弃。
+        // 单元大小按表面积估算后再校正一次，三角形数约为 ratio * 原始数
+        static ProceduralMesh Simplify(const ProceduralMesh& mesh, float ratio);
+
+        // 序列化为二进制 (little-endian) PLY
+        static std::vector<unsigned char> ToBinaryPly(const ProceduralMesh& mesh);
+
+    private:
+        static ProceduralMesh Sphere(int subdivisions);
+        static ProceduralMesh GreebledBox(int subdivisions, uint32_t seed);
+        static ProceduralMesh ClusterVertices(const ProceduralMesh& mesh, float cellSize);
+    };
+}
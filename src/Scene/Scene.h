@@ -1,6 +1,7 @@
 #pragma once
 #include "Model.h"
 #include "Renderer/IBLBaker.h" // 获取 IBLMaps 定义
+#include "Utils/MemoryTracker.h"
 
 namespace Scene {
     struct Scene {
@@ -11,12 +12,13 @@ namespace Scene {
         // 环境数据
         Renderer::IBLMaps envMaps;
 
-        // 简单的资源释放辅助
+        // 简单的资源释放辅助 (释放后清零，之后的模型会重新烘焙)
         void Cleanup() {
-            if (envMaps.envCubemap) glDeleteTextures(1, &envMaps.envCubemap);
-            if (envMaps.irradianceMap) glDeleteTextures(1, &envMaps.irradianceMap);
-            if (envMaps.prefilterMap) glDeleteTextures(1, &envMaps.prefilterMap);
-            if (envMaps.brdfLUT) glDeleteTextures(1, &envMaps.brdfLUT);
+            if (envMaps.envCubemap) Utils::TrackedDeleteTextures(1, &envMaps.envCubemap);
+            if (envMaps.irradianceMap) Utils::TrackedDeleteTextures(1, &envMaps.irradianceMap);
+            if (envMaps.prefilterMap) Utils::TrackedDeleteTextures(1, &envMaps.prefilterMap);
+            if (envMaps.brdfLUT) Utils::TrackedDeleteTextures(1, &envMaps.brdfLUT);
+            envMaps = Renderer::IBLMaps();
         }
     };
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace Utils {
+
+    static std::atomic<uint64_t> allocationCount{0};
+
+#ifndef NDEBUG
+    bool AllocationCounter::Enabled() { return true; }
+#else
+    bool AllocationCounter::Enabled() { return false; }
+#endif
+
+    uint64_t AllocationCounter::Count() {
+        return allocationCount.load(std::memory_order_relaxed);
+    }
+
+#ifndef NDEBUG
+    static void* CountedAlloc(size_t size) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    // 对齐版本 (alignas 超过默认对齐的类型，如 SIMD 缓冲)；MSVC 的对齐内存必须用 _aligned_free 释放
+    static void* CountedAlignedAlloc(size_t size, std::align_val_t alignment) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        const size_t align = static_cast<size_t>(alignment);
+#if defined(_MSC_VER)
+        return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+        // aligned_alloc 要求大小为对齐的整数倍
+        const size_t rounded = (std::max<size_t>(size, 1) + align - 1) / align * align;
+        return std::aligned_alloc(align, rounded);
+#endif
+    }
+
+    static void AlignedFree(void* p) {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+#endif
+}
+
+#ifndef NDEBUG
+// 全局 operator new/delete 替换 (只能存在于一个编译单元)
+void* operator new(size_t size) {
+    void* p = Utils::CountedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = Utils::CountedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Utils::CountedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Utils::CountedAlloc(size); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* p = Utils::CountedAlignedAlloc(size, alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    void* p = Utils::CountedAlignedAlloc(size, alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Utils::CountedAlignedAlloc(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Utils::CountedAlignedAlloc(size, alignment); }
+
+void operator delete(void* p, std::align_val_t) noexcept { Utils::AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Utils::AlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { Utils::AlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { Utils::AlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { Utils::AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { Utils::AlignedFree(p); }
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+namespace Utils {
+
+    /**
+     * @brief 调试用堆分配计数
+     * Debug 构建 (未定义 NDEBUG) 中替换全局 operator new，统计所有线程的分配次数；
+     * Release 构建不替换，Enabled() 返回 false，计数恒为 0。
+     * 注意: 只统计 operator new (STL 容器、std::string 等，含 std::align_val_t 对齐版本)，驱动内部的 malloc 不在统计范围内。
+     */
+    class AllocationCounter {
+    public:
+        static bool Enabled();
+        static uint64_t Count();
+    };
+
+    // 作用域检查: 析构时断言作用域内没有发生堆分配 (仅 Debug 构建生效；active = false 时跳过，用于预热帧)
+    class ZeroAllocationScope {
+    public:
+        explicit ZeroAllocationScope(const char* label, bool active = true)
+            : label(label), active(active), start(AllocationCounter::Count()) {}
+        ~ZeroAllocationScope() {
+            if (!active || !AllocationCounter::Enabled()) return;
+            uint64_t count = AllocationCounter::Count() - start;
+            if (count != 0) {
+                std::cerr << "[Alloc] " << label << ": " << count << " heap allocation(s) in steady state" << std::endl;
+            }
+            assert(count == 0 && "steady-state loop must not allocate");
+        }
+
+        ZeroAllocationScope(const ZeroAllocationScope&) = delete;
+        ZeroAllocationScope& operator=(const ZeroAllocationScope&) = delete;
+
+    private:
+        const char* label;
+        bool active;
+        uint64_t start;
+    };
+}
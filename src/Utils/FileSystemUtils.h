@@ -28,6 +28,19 @@ namespace Utils {
         }
         return "";
     }
+    // 目录 (递归) 中全部指定后缀的文件，按路径排序
+    inline std::vector<std::string> FindFilesByExt(const std::string& folder, const std::vector<std::string>& extensions) {
+        std::vector<std::string> files;
+        if (!fs::exists(folder)) return files;
+        for (const auto& entry : fs::recursive_directory_iterator(folder)) {
+            if (entry.is_directory()) continue;
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            if (std::find(extensions.begin(), extensions.end(), ext) != extensions.end()) files.push_back(entry.path().string());
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
     inline std::filesystem::path FindFirstModelFile(const std::filesystem::path& dir, const std::string& targetExt) {
         namespace fs = std::filesystem;
         if (!fs::exists(dir) || !fs::is_directory(dir)) return {};
@@ -1,4 +1,5 @@
 #include "GeometryUtils.h"
+#include "MemoryTracker.h"
 
 namespace Utils {
 
@@ -57,7 +58,7 @@ namespace Utils {
             glGenBuffers(1, &cubeVBO);
             // fill buffer
             glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+            TrackedBufferData(MemoryCategory::Other, GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
             // link vertex attributes
             glBindVertexArray(cubeVAO);
             glEnableVertexAttribArray(0);
@@ -87,7 +88,7 @@ namespace Utils {
             glGenBuffers(1, &quadVBO);
             glBindVertexArray(quadVAO);
             glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+            TrackedBufferData(MemoryCategory::Other, GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
             glEnableVertexAttribArray(0);
             glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
             glEnableVertexAttribArray(1);
@@ -97,4 +98,12 @@ namespace Utils {
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         glBindVertexArray(0);
     }
-}
\ No newline at end of file
+
+    void GeometryUtils::Release() {
+        if (cubeVAO) glDeleteVertexArrays(1, &cubeVAO);
+        if (cubeVBO) TrackedDeleteBuffers(1, &cubeVBO);
+        if (quadVAO) glDeleteVertexArrays(1, &quadVAO);
+        if (quadVBO) TrackedDeleteBuffers(1, &quadVBO);
+        cubeVAO = cubeVBO = quadVAO = quadVBO = 0;
+    }
+}
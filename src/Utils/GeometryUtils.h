@@ -7,6 +7,8 @@ namespace Utils {
         static void RenderCube();
         // 绘制全屏四边形 (用于后处理、BRDF LUT)
         static void RenderQuad();
+        // 释放缓存的几何体 (销毁 GL 上下文前调用，之后的新上下文会重新创建)
+        static void Release();
 
     private:
         static unsigned int cubeVAO;
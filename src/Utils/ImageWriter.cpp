@@ -0,0 +1,181 @@
+#include "ImageWriter.h"
+
+#include "stb_image_write.h"
+
+namespace Utils {
+
+    const char* ImageFormatName(ImageFormat format) {
+        switch (format) {
+            case ImageFormat::None:    return "None";
+            case ImageFormat::Png:     return "PNG";
+            case ImageFormat::FastPng: return "FastPNG";
+            case ImageFormat::Qoi:     return "QOI";
+            case ImageFormat::Raw:     return "Raw";
+            default:                   return "Unknown";
+        }
+    }
+
+    const char* ImageFormatExtension(ImageFormat format) {
+        switch (format) {
+            case ImageFormat::Png:
+            case ImageFormat::FastPng: return ".png";
+            case ImageFormat::Qoi:     return ".qoi";
+            case ImageFormat::Raw:     return ".ppm";
+            default:                   return "";
+        }
+    }
+
+    bool ImageWriter::Write(const std::string& pathWithoutExtension, ImageFormat format, int width, int height, int channels,
+                            const unsigned char* pixels, bool flipVertically, ImageWriteStats* stats) {
+        if (format == ImageFormat::None) return true;
+
+        auto start = std::chrono::steady_clock::now();
+        if (!Encode(format, width, height, channels, pixels, flipVertically)) return false;
+        auto encoded = std::chrono::steady_clock::now();
+
+        const std::string path = pathWithoutExtension + ImageFormatExtension(format);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (file.is_open()) file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!file.is_open() || !file.good()) {
+            std::cerr << "[Error] Failed to write image: " << path << std::endl;
+            return false;
+        }
+        file.close();
+        auto written = std::chrono::steady_clock::now();
+
+        if (stats) {
+            stats->images++;
+            stats->bytes += buffer.size();
+            stats->encodeMs += std::chrono::duration<double, std::milli>(encoded - start).count();
+            stats->writeMs += std::chrono::duration<double, std::milli>(written - encoded).count();
+        }
+        return true;
+    }
+
+    bool ImageWriter::Encode(ImageFormat format, int width, int height, int channels, const unsigned char* pixels, bool flipVertically) {
+        buffer.clear();
+        if (width <= 0 || height <= 0 || (channels != 3 && channels != 4)) {
+            std::cerr << "[Error] Unsupported image layout: " << width << "x" << height << "x" << channels << std::endl;
+            return false;
+        }
+        switch (format) {
+            case ImageFormat::Png:     EncodePng(width, height, channels, pixels, flipVertically, false); break;
+            case ImageFormat::FastPng: EncodePng(width, height, channels, pixels, flipVertically, true); break;
+            case ImageFormat::Qoi:     EncodeQoi(width, height, channels, pixels, flipVertically); break;
+            case ImageFormat::Raw:     EncodePpm(width, height, channels, pixels, flipVertically); break;
+            default: return false;
+        }
+        return !buffer.empty();
+    }
+
+    void ImageWriter::EncodePng(int width, int height, int channels, const unsigned char* pixels, bool flipVertically, bool fast) {
+        // stb 的 zlib 会把低于 5 的级别提升到 5；快速模式另外固定使用 Sub 滤波器，省去每行 5 种滤波器的试算
+        const int previousLevel = stbi_write_png_compression_level;
+        const int previousFilter = stbi_write_force_png_filter;
+        stbi_write_png_compression_level = fast ? 5 : 8;
+        stbi_write_force_png_filter = fast ? 1 : -1;
+
+        // 负行距让 stb 自底向上读取，不依赖全局的 stbi_flip_vertically_on_write
+        const int stride = width * channels;
+        const unsigned char* first = flipVertically ? pixels + static_cast<size_t>(height - 1) * stride : pixels;
+        stbi_write_png_to_func([](void* context, void* data, int size) {
+            auto* out = static_cast<std::vector<unsigned char>*>(context);
+            out->insert(out->end(), static_cast<unsigned char*>(data), static_cast<unsigned char*>(data) + size);
+        }, &buffer, width, height, channels, first, flipVertically ? -stride : stride);
+
+        stbi_write_png_compression_level = previousLevel;
+        stbi_write_force_png_filter = previousFilter;
+    }
+
+    void ImageWriter::EncodeQoi(int width, int height, int channels, const unsigned char* pixels, bool flipVertically) {
+        // https://qoiformat.org/qoi-specification.pdf
+        const size_t pixelCount = static_cast<size_t>(width) * height;
+        buffer.reserve(14 + pixelCount * (channels + 1) + 8);
+
+        auto putU32 = [&](uint32_t v) {
+            buffer.push_back(static_cast<unsigned char>(v >> 24));
+            buffer.push_back(static_cast<unsigned char>(v >> 16));
+            buffer.push_back(static_cast<unsigned char>(v >> 8));
+            buffer.push_back(static_cast<unsigned char>(v));
+        };
+        buffer.insert(buffer.end(), { 'q', 'o', 'i', 'f' });
+        putU32(static_cast<uint32_t>(width));
+        putU32(static_cast<uint32_t>(height));
+        buffer.push_back(static_cast<unsigned char>(channels));
+        buffer.push_back(0);   // sRGB + 线性 alpha
+
+        struct Rgba { unsigned char r, g, b, a; };
+        Rgba index[64] = {};
+        Rgba prev = { 0, 0, 0, 255 };
+        int run = 0;
+        const int stride = width * channels;
+
+        for (int row = 0; row < height; ++row) {
+            const unsigned char* line = pixels + static_cast<size_t>(flipVertically ? height - 1 - row : row) * stride;
+            for (int x = 0; x < width; ++x) {
+                const unsigned char* p = line + x * channels;
+                Rgba px = { p[0], p[1], p[2], channels == 4 ? p[3] : prev.a };
+
+                if (px.r == prev.r && px.g == prev.g && px.b == prev.b && px.a == prev.a) {
+                    if (++run == 62) {
+                        buffer.push_back(static_cast<unsigned char>(0xC0 | (run - 1)));   // QOI_OP_RUN
+                        run = 0;
+                    }
+                    continue;
+                }
+                if (run > 0) {
+                    buffer.push_back(static_cast<unsigned char>(0xC0 | (run - 1)));
+                    run = 0;
+                }
+
+                const int hash = (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+                const Rgba& slot = index[hash];
+                if (slot.r == px.r && slot.g == px.g && slot.b == px.b && slot.a == px.a) {
+                    buffer.push_back(static_cast<unsigned char>(hash));                 // QOI_OP_INDEX
+                }
+                else {
+                    index[hash] = px;
+                    if (px.a == prev.a) {
+                        const int dr = static_cast<signed char>(px.r - prev.r);
+                        const int dg = static_cast<signed char>(px.g - prev.g);
+                        const int db = static_cast<signed char>(px.b - prev.b);
+                        const int drg = dr - dg, dbg = db - dg;
+                        if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                            buffer.push_back(static_cast<unsigned char>(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));   // QOI_OP_DIFF
+                        }
+                        else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                            buffer.push_back(static_cast<unsigned char>(0x80 | (dg + 32)));                                  // QOI_OP_LUMA
+                            buffer.push_back(static_cast<unsigned char>((drg + 8) << 4 | (dbg + 8)));
+                        }
+                        else {
+                            buffer.insert(buffer.end(), { 0xFE, px.r, px.g, px.b });                                         // QOI_OP_RGB
+                        }
+                    }
+                    else {
+                        buffer.insert(buffer.end(), { 0xFF, px.r, px.g, px.b, px.a });                                       // QOI_OP_RGBA
+                    }
+                }
+                prev = px;
+            }
+        }
+        if (run > 0) buffer.push_back(static_cast<unsigned char>(0xC0 | (run - 1)));
+        buffer.insert(buffer.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+    }
+
+    void ImageWriter::EncodePpm(int width, int height, int channels, const unsigned char* pixels, bool flipVertically) {
+        // PPM 只有 RGB；RGBA 输入丢弃 alpha
+        const std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+        buffer.reserve(header.size() + static_cast<size_t>(width) * height * 3);
+        buffer.insert(buffer.end(), header.begin(), header.end());
+
+        const int stride = width * channels;
+        for (int row = 0; row < height; ++row) {
+            const unsigned char* line = pixels + static_cast<size_t>(flipVertically ? height - 1 - row : row) * stride;
+            if (channels == 3) {
+                buffer.insert(buffer.end(), line, line + stride);
+            } else {
+                for (int x = 0; x < width; ++x) buffer.insert(buffer.end(), line + x * 4, line + x * 4 + 3);
+            }
+        }
+    }
+}
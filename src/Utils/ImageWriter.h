@@ -0,0 +1,49 @@
+#pragma once
+
+namespace Utils {
+
+    // 截图输出格式
+    enum class ImageFormat {
+        None,      // 不输出
+        Png,       // stb PNG，zlib 级别 8 (stb 默认)
+        FastPng,   // stb PNG，zlib 取 stb 允许的最低级别并固定行滤波器 (跳过逐行 5 种滤波的试算)
+        Qoi,       // QOI 无损，单遍编码
+        Raw        // 未压缩 PPM (P6)
+    };
+
+    const char* ImageFormatName(ImageFormat format);
+    const char* ImageFormatExtension(ImageFormat format);   // 含点号；None 返回 ""
+
+    // 编码与写盘的累计统计
+    struct ImageWriteStats {
+        size_t images = 0;
+        uint64_t bytes = 0;
+        double encodeMs = 0.0;
+        double writeMs = 0.0;
+
+        void Reset() { *this = ImageWriteStats(); }
+    };
+
+    /**
+     * @brief 截图编码器
+     * 先编码到复用的内存缓冲再一次性写盘，分别统计编码与写盘耗时；输入为紧密排列的 RGB8 / RGBA8。
+     * flipVertically = true 表示输入为 OpenGL 的自底向上行序，编码时逐行翻转 (不修改调用方缓冲，也不改动 stb 的全局翻转设置)。
+     */
+    class ImageWriter {
+    public:
+        // pathWithoutExtension 会追加格式对应的扩展名；失败时返回 false 并输出错误信息
+        bool Write(const std::string& pathWithoutExtension, ImageFormat format, int width, int height, int channels,
+                   const unsigned char* pixels, bool flipVertically, ImageWriteStats* stats = nullptr);
+
+        // 只编码不写盘 (基准测试用)，结果留在 Buffer() 中
+        bool Encode(ImageFormat format, int width, int height, int channels, const unsigned char* pixels, bool flipVertically);
+        const std::vector<unsigned char>& Buffer() const { return buffer; }
+
+    private:
+        std::vector<unsigned char> buffer;
+
+        void EncodePng(int width, int height, int channels, const unsigned char* pixels, bool flipVertically, bool fast);
+        void EncodeQoi(int width, int height, int channels, const unsigned char* pixels, bool flipVertically);
+        void EncodePpm(int width, int height, int channels, const unsigned char* pixels, bool flipVertically);
+    };
+}
@@ -0,0 +1,360 @@
+#include "MemoryTracker.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Utils {
+
+    namespace {
+        constexpr double kMB = 1024.0 * 1024.0;
+
+        // 当前绑定到 target 的 GL 对象
+        GLuint BoundObject(GLenum target) {
+            GLenum binding = 0;
+            if (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z) {
+                binding = GL_TEXTURE_BINDING_CUBE_MAP;
+            } else {
+                switch (target) {
+                    case GL_TEXTURE_2D:           binding = GL_TEXTURE_BINDING_2D; break;
+                    case GL_TEXTURE_CUBE_MAP:     binding = GL_TEXTURE_BINDING_CUBE_MAP; break;
+                    case GL_ARRAY_BUFFER:         binding = GL_ARRAY_BUFFER_BINDING; break;
+                    case GL_ELEMENT_ARRAY_BUFFER: binding = GL_ELEMENT_ARRAY_BUFFER_BINDING; break;
+                    case GL_PIXEL_PACK_BUFFER:    binding = GL_PIXEL_PACK_BUFFER_BINDING; break;
+                    case GL_PIXEL_UNPACK_BUFFER:  binding = GL_PIXEL_UNPACK_BUFFER_BINDING; break;
+                    case GL_UNIFORM_BUFFER:       binding = GL_UNIFORM_BUFFER_BINDING; break;
+                    case GL_RENDERBUFFER:         binding = GL_RENDERBUFFER_BINDING; break;
+                    default: return 0;
+                }
+            }
+            GLint id = 0;
+            glGetIntegerv(binding, &id);
+            return static_cast<GLuint>(id);
+        }
+    }
+
+    const char* MemoryCategoryName(MemoryCategory category) {
+        switch (category) {
+            case MemoryCategory::Texture:     return "Texture";
+            case MemoryCategory::Mesh:        return "Mesh";
+            case MemoryCategory::FrameBuffer: return "FrameBuffer";
+            case MemoryCategory::IBL:         return "IBL";
+            case MemoryCategory::Other:       return "Other";
+            default:                          return "Unknown";
+        }
+    }
+
+    uint64_t ImageBytes(GLint internalFormat, GLsizei width, GLsizei height) {
+        const uint64_t pixels = static_cast<uint64_t>(std::max(width, 0)) * static_cast<uint64_t>(std::max(height, 0));
+        const uint64_t blocks = static_cast<uint64_t>((std::max(width, 0) + 3) / 4) * static_cast<uint64_t>((std::max(height, 0) + 3) / 4);
+        switch (internalFormat) {
+            case GL_RED: case GL_R8:
+                return pixels;
+            case GL_RG: case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16:
+                return pixels * 2;
+            case GL_RGB: case GL_RGB8: case GL_SRGB8:
+                return pixels * 3;
+            case GL_RGBA: case GL_RGBA8: case GL_SRGB8_ALPHA8:
+            case GL_RG16: case GL_RG16F: case GL_R32F: case GL_R32UI:
+            case GL_DEPTH_COMPONENT: case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32F: case GL_DEPTH24_STENCIL8:
+                return pixels * 4;
+            case GL_RGB16F:
+                return pixels * 6;
+            case GL_RGBA16F: case GL_RG32F:
+                return pixels * 8;
+            case GL_RGB32F:
+                return pixels * 12;
+            case GL_RGBA32F:
+                return pixels * 16;
+            // 块压缩: RGTC1 / DXT1 每 4x4 块 8 字节，RGTC2 / DXT3 / DXT5 每块 16 字节 (S3TC 为扩展枚举，直接使用数值)
+            case GL_COMPRESSED_RED_RGTC1: case GL_COMPRESSED_SIGNED_RED_RGTC1: case 0x83F0: case 0x83F1:
+                return blocks * 8;
+            case GL_COMPRESSED_RG_RGTC2: case GL_COMPRESSED_SIGNED_RG_RGTC2: case 0x83F2: case 0x83F3:
+                return blocks * 16;
+            default:
+                return pixels * 4;
+        }
+    }
+
+    MemoryTracker::~MemoryTracker() {
+        {
+            std::lock_guard<std::mutex> lock(samplerMutex);
+            samplerStop = true;
+        }
+        samplerWake.notify_all();
+        if (sampler.joinable()) sampler.join();
+    }
+
+    void MemoryTracker::Configure(bool enable, uint64_t hostBudgetBytes, uint64_t gpuBudgetBytes, int intervalMs) {
+        enabled = enable;
+        hostBudget = hostBudgetBytes;
+        gpuBudget = gpuBudgetBytes;
+        sampleIntervalMs = std::max(intervalMs, 1);
+    }
+
+    uint64_t MemoryTracker::CurrentHostBytes() {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+        return static_cast<uint64_t>(counters.WorkingSetSize);
+#elif defined(__linux__)
+        // statm 第二个字段为常驻页数；用栈缓冲与 POSIX read，不经过 iostream (采样线程不分配堆内存)
+        int fd = ::open("/proc/self/statm", O_RDONLY);
+        if (fd < 0) return 0;
+        char buffer[128];
+        ssize_t n = ::read(fd, buffer, sizeof(buffer) - 1);
+        ::close(fd);
+        if (n <= 0) return 0;
+        buffer[n] = '\0';
+
+        const char* p = buffer;
+        while (*p && *p != ' ') ++p;
+        uint64_t pages = 0;
+        while (*p == ' ') ++p;
+        while (*p >= '0' && *p <= '9') pages = pages * 10 + static_cast<uint64_t>(*p++ - '0');
+        return pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 0;
+#endif
+    }
+
+    void MemoryTracker::BeginModel() {
+        overBudget.store(false, std::memory_order_relaxed);
+        hostOverBytes.store(0, std::memory_order_relaxed);
+        gpuOverBytes = 0;
+        gpuPeak = gpuTotal;
+        for (int c = 0; c < (int)MemoryCategory::Count; ++c) gpuPeakByCategory[c] = gpuCurrent[c];
+        hostPeak.store(CurrentHostBytes(), std::memory_order_relaxed);
+        if (!enabled) return;
+
+        CheckGpuBudget();
+        {
+            std::lock_guard<std::mutex> lock(samplerMutex);
+            samplerStop = false;
+        }
+        if (!sampler.joinable()) sampler = std::thread(&MemoryTracker::SampleLoop, this);
+    }
+
+    MemoryReport MemoryTracker::EndModel() {
+        if (sampler.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(samplerMutex);
+                samplerStop = true;
+            }
+            samplerWake.notify_all();
+            sampler.join();
+        }
+
+        MemoryReport report;
+        report.peakHostBytes = std::max(hostPeak.load(std::memory_order_relaxed), CurrentHostBytes());
+        report.peakGpuBytes = gpuPeak;
+        for (int c = 0; c < (int)MemoryCategory::Count; ++c) report.peakGpuBytesByCategory[c] = gpuPeakByCategory[c];
+        report.overBudget = overBudget.load(std::memory_order_relaxed);
+
+        std::ostringstream reason;
+        reason << std::fixed << std::setprecision(1);
+        if (uint64_t host = hostOverBytes.load(std::memory_order_relaxed)) {
+            reason << "host RSS " << host / kMB << " MB > budget " << hostBudget / kMB << " MB";
+        }
+        if (gpuOverBytes) {
+            if (reason.tellp() > 0) reason << "; ";
+            reason << "GPU " << gpuOverBytes / kMB << " MB > budget " << gpuBudget / kMB << " MB";
+        }
+        report.budgetReason = reason.str();
+        return report;
+    }
+
+    void MemoryTracker::SampleLoop() {
+        std::unique_lock<std::mutex> lock(samplerMutex);
+        while (!samplerStop) {
+            uint64_t rss = CurrentHostBytes();
+            uint64_t peak = hostPeak.load(std::memory_order_relaxed);
+            while (rss > peak && !hostPeak.compare_exchange_weak(peak, rss, std::memory_order_relaxed)) {}
+
+            if (hostBudget && rss > hostBudget && !overBudget.load(std::memory_order_relaxed)) {
+                hostOverBytes.store(rss, std::memory_order_relaxed);
+                overBudget.store(true, std::memory_order_relaxed);
+            }
+            samplerWake.wait_for(lock, std::chrono::milliseconds(sampleIntervalMs));
+        }
+    }
+
+    void MemoryTracker::Add(MemoryCategory category, uint64_t bytes) {
+        gpuCurrent[(int)category] += bytes;
+        gpuTotal += bytes;
+        gpuPeakByCategory[(int)category] = std::max(gpuPeakByCategory[(int)category], gpuCurrent[(int)category]);
+        gpuPeak = std::max(gpuPeak, gpuTotal);
+        CheckGpuBudget();
+    }
+
+    void MemoryTracker::Remove(MemoryCategory category, uint64_t bytes) {
+        bytes = std::min(bytes, gpuCurrent[(int)category]);
+        gpuCurrent[(int)category] -= bytes;
+        gpuTotal -= bytes;
+    }
+
+    void MemoryTracker::CheckGpuBudget() {
+        if (!enabled || !gpuBudget || gpuTotal <= gpuBudget || gpuOverBytes) return;
+        gpuOverBytes = gpuTotal;
+        overBudget.store(true, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::OnTextureImage(MemoryCategory category, GLenum target, GLint level, uint64_t bytes) {
+        GLuint id = BoundObject(target);
+        if (!id) return;
+        TextureEntry& entry = textures[id];
+        entry.category = category;
+        for (Image& image : entry.images) {
+            if (image.target == target && image.level == level) {
+                Remove(category, image.bytes);
+                image.bytes = bytes;
+                Add(category, bytes);
+                return;
+            }
+        }
+        entry.images.push_back({ target, level, bytes });
+        Add(category, bytes);
+    }
+
+    void MemoryTracker::OnGenerateMipmap(GLenum target) {
+        auto it = textures.find(BoundObject(target));
+        if (it == textures.end()) return;
+        TextureEntry& entry = it->second;
+
+        // 先取出各个面的基础层级，再替换对应的 mip 链记录 (push_back 可能使引用失效)
+        std::vector<Image> bases;
+        for (const Image& image : entry.images) {
+            if (image.level == 0) bases.push_back(image);
+        }
+        for (const Image& base : bases) {
+            const uint64_t bytes = base.bytes / 3;
+            bool replaced = false;
+            for (Image& image : entry.images) {
+                if (image.target == base.target && image.level == -1) {
+                    Remove(entry.category, image.bytes);
+                    image.bytes = bytes;
+                    replaced = true;
+                    break;
+                }
+            }
+            if (!replaced) entry.images.push_back({ base.target, -1, bytes });
+            Add(entry.category, bytes);
+        }
+    }
+
+    void MemoryTracker::OnBufferData(MemoryCategory category, GLenum target, uint64_t bytes) {
+        GLuint id = BoundObject(target);
+        if (!id) return;
+        ObjectEntry& entry = buffers[id];
+        Remove(entry.category, entry.bytes);
+        entry.category = category;
+        entry.bytes = bytes;
+        Add(category, bytes);
+    }
+
+    void MemoryTracker::OnRenderbufferStorage(MemoryCategory category, uint64_t bytes) {
+        GLuint id = BoundObject(GL_RENDERBUFFER);
+        if (!id) return;
+        ObjectEntry& entry = renderbuffers[id];
+        Remove(entry.category, entry.bytes);
+        entry.category = category;
+        entry.bytes = bytes;
+        Add(category, bytes);
+    }
+
+    void MemoryTracker::OnDeleteTextures(GLsizei n, const GLuint* ids) {
+        for (GLsizei i = 0; i < n; ++i) {
+            auto it = textures.find(ids[i]);
+            if (it == textures.end()) continue;
+            for (const Image& image : it->second.images) Remove(it->second.category, image.bytes);
+            textures.erase(it);
+        }
+    }
+
+    void MemoryTracker::OnDeleteBuffers(GLsizei n, const GLuint* ids) {
+        for (GLsizei i = 0; i < n; ++i) {
+            auto it = buffers.find(ids[i]);
+            if (it == buffers.end()) continue;
+            Remove(it->second.category, it->second.bytes);
+            buffers.erase(it);
+        }
+    }
+
+    void MemoryTracker::OnDeleteRenderbuffers(GLsizei n, const GLuint* ids) {
+        for (GLsizei i = 0; i < n; ++i) {
+            auto it = renderbuffers.find(ids[i]);
+            if (it == renderbuffers.end()) continue;
+            Remove(it->second.category, it->second.bytes);
+            renderbuffers.erase(it);
+        }
+    }
+
+    // --- GL 分配包装 (未启用记账时只转发 gl* 调用，不查询绑定对象) ---
+
+    void TrackedTexImage2D(MemoryCategory category, GLenum target, GLint level, GLint internalFormat,
+                           GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data) {
+        glTexImage2D(target, level, internalFormat, width, height, border, format, type, data);
+        MemoryTracker& tracker = MemoryTracker::Instance();
+        if (!tracker.Enabled()) return;
+        tracker.OnTextureImage(category, target, level, ImageBytes(internalFormat, width, height));
+    }
+
+    void TrackedCompressedTexImage2D(MemoryCategory category, GLenum target, GLint level, GLenum internalFormat,
+                                     GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data) {
+        glCompressedTexImage2D(target, level, internalFormat, width, height, border, imageSize, data);
+        MemoryTracker& tracker = MemoryTracker::Instance();
+        if (!tracker.Enabled()) return;
+        tracker.OnTextureImage(category, target, level, static_cast<uint64_t>(std::max(imageSize, 0)));
+    }
+
+    void TrackedGenerateMipmap(GLenum target) {
+        glGenerateMipmap(target);
+        MemoryTracker& tracker = MemoryTracker::Instance();
+        if (tracker.Enabled()) tracker.OnGenerateMipmap(target);
+    }
+
+    void TrackedBufferData(MemoryCategory category, GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+        glBufferData(target, size, data, usage);
+        MemoryTracker& tracker = MemoryTracker::Instance();
+        if (!tracker.Enabled()) return;
+        tracker.OnBufferData(category, target, static_cast<uint64_t>(std::max<GLsizeiptr>(size, 0)));
+    }
+
+    void TrackedRenderbufferStorage(MemoryCategory category, GLenum target, GLenum internalFormat, GLsizei width, GLsizei height) {
+        glRenderbufferStorage(target, internalFormat, width, height);
+        MemoryTracker& tracker = MemoryTracker::Instance();
+        if (!tracker.Enabled()) return;
+        tracker.OnRenderbufferStorage(category, ImageBytes(static_cast<GLint>(internalFormat), width, height));
+    }
+
+    void TrackedDeleteTextures(GLsizei n, const GLuint* ids) {
+        MemoryTracker& tracker = MemoryTracker::Instance();
+        if (tracker.Enabled()) tracker.OnDeleteTextures(n, ids);
+        glDeleteTextures(n, ids);
+    }
+
+    void TrackedDeleteBuffers(GLsizei n, const GLuint* ids) {
+        MemoryTracker& tracker = MemoryTracker::Instance();
+        if (tracker.Enabled()) tracker.OnDeleteBuffers(n, ids);
+        glDeleteBuffers(n, ids);
+    }
+
+    void TrackedDeleteRenderbuffers(GLsizei n, const GLuint* ids) {
+        MemoryTracker& tracker = MemoryTracker::Instance();
+        if (tracker.Enabled()) tracker.OnDeleteRenderbuffers(n, ids);
+        glDeleteRenderbuffers(n, ids);
+    }
+}
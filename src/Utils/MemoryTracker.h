@@ -0,0 +1,138 @@
+#pragma once
+
+namespace Utils {
+
+    // 显存记账类别
+    enum class MemoryCategory {
+        Texture,       // 模型材质贴图
+        Mesh,          // 顶点 / 索引缓冲
+        FrameBuffer,   // 离屏渲染目标 (PBRRenderer::SetupFBO、RenderTargets、覆盖 / 法线附件)
+        IBL,           // 环境贴图、辐照度 / 预滤波贴图、BRDF LUT
+        Other,         // 全屏四边形、立方体等辅助几何
+        Count
+    };
+
+    const char* MemoryCategoryName(MemoryCategory category);
+
+    // 单个模型的内存汇总 (EndModel 返回)
+    struct MemoryReport {
+        uint64_t peakHostBytes = 0;   // 进程常驻内存 (RSS) 峰值
+        uint64_t peakGpuBytes = 0;    // 已记账显存总量峰值
+        uint64_t peakGpuBytesByCategory[(int)MemoryCategory::Count] = {};
+        bool overBudget = false;
+        std::string budgetReason;
+    };
+
+    /**
+     * @brief 主机 / 显存记账与预算
+     * 显存: 所有纹理、缓冲与渲染缓冲的分配都经由下方 Tracked* 包装函数，按 GL 对象记录字节数
+     * (按内部格式估算，驱动的对齐与填充不计入)，删除时扣除。
+     * 主机: BeginModel 启动后台线程按固定间隔采样 RSS，采样本身不分配堆内存 (不会触发 ZeroAllocationScope)。
+     * 预算: 任一峰值超出预算后 OverBudget() 置位，调用方在阶段边界与每帧检查并中止当前模型。
+     * 显存记账只能在 GL 线程使用；OverBudget() 可在任意线程读取。
+     * 未启用时包装函数不记账 (也不查询绑定对象)，因此 Configure 需在第一次分配之前调用。
+     */
+    class MemoryTracker {
+    public:
+        static MemoryTracker& Instance() {
+            static MemoryTracker tracker;
+            return tracker;
+        }
+
+        MemoryTracker(const MemoryTracker&) = delete;
+        MemoryTracker& operator=(const MemoryTracker&) = delete;
+        ~MemoryTracker();
+
+        // 预算单位为字节，0 表示不限制
+        void Configure(bool enabled, uint64_t hostBudgetBytes, uint64_t gpuBudgetBytes, int sampleIntervalMs);
+        bool Enabled() const { return enabled; }
+
+        // 峰值从当前用量重新开始，启动 RSS 采样线程
+        void BeginModel();
+        // 停止采样并返回本模型的峰值
+        MemoryReport EndModel();
+
+        bool OverBudget() const { return overBudget.load(std::memory_order_relaxed); }
+
+        uint64_t GpuBytes() const { return gpuTotal; }
+        uint64_t GpuBytes(MemoryCategory category) const { return gpuCurrent[(int)category]; }
+        uint64_t PeakGpuBytes() const { return gpuPeak; }
+        uint64_t PeakHostBytes() const { return hostPeak.load(std::memory_order_relaxed); }
+
+        // 当前进程常驻内存 (Windows: 工作集；Linux: /proc/self/statm；其他平台返回 0)
+        static uint64_t CurrentHostBytes();
+
+        // --- 供 Tracked* 包装函数调用 ---
+        // 为当前绑定到 target 的纹理的一个 (面, 层级) 记账；同一 (面, 层级) 重新指定时替换旧值
+        void OnTextureImage(MemoryCategory category, GLenum target, GLint level, uint64_t bytes);
+        // glGenerateMipmap 之后: 每个面按基础层级的 1/3 补记 mip 链
+        void OnGenerateMipmap(GLenum target);
+        void OnBufferData(MemoryCategory category, GLenum target, uint64_t bytes);
+        void OnRenderbufferStorage(MemoryCategory category, uint64_t bytes);
+        void OnDeleteTextures(GLsizei n, const GLuint* ids);
+        void OnDeleteBuffers(GLsizei n, const GLuint* ids);
+        void OnDeleteRenderbuffers(GLsizei n, const GLuint* ids);
+
+    private:
+        MemoryTracker() = default;
+
+        struct Image {
+            GLenum target;
+            GLint level;     // -1 表示 glGenerateMipmap 生成的其余层级
+            uint64_t bytes;
+        };
+        struct TextureEntry {
+            MemoryCategory category = MemoryCategory::Texture;
+            std::vector<Image> images;
+        };
+        struct ObjectEntry {
+            MemoryCategory category = MemoryCategory::Other;
+            uint64_t bytes = 0;
+        };
+
+        void Add(MemoryCategory category, uint64_t bytes);
+        void Remove(MemoryCategory category, uint64_t bytes);
+        void CheckGpuBudget();
+        void SampleLoop();
+
+        bool enabled = false;
+        uint64_t hostBudget = 0;
+        uint64_t gpuBudget = 0;
+        int sampleIntervalMs = 10;
+
+        std::unordered_map<GLuint, TextureEntry> textures;
+        std::unordered_map<GLuint, ObjectEntry> buffers;
+        std::unordered_map<GLuint, ObjectEntry> renderbuffers;
+
+        uint64_t gpuCurrent[(int)MemoryCategory::Count] = {};
+        uint64_t gpuPeakByCategory[(int)MemoryCategory::Count] = {};
+        uint64_t gpuTotal = 0;
+        uint64_t gpuPeak = 0;
+
+        // 采样线程只写原子量；超预算原因在 EndModel 中格式化
+        std::atomic<uint64_t> hostPeak{0};
+        std::atomic<uint64_t> hostOverBytes{0};
+        std::atomic<bool> overBudget{false};
+        uint64_t gpuOverBytes = 0;
+
+        std::thread sampler;
+        std::mutex samplerMutex;
+        std::condition_variable samplerWake;
+        bool samplerStop = false;
+    };
+
+    // 按内部格式估算一个 width x height 图像的显存字节数 (块压缩格式按 4x4 块计；未知格式按 4 字节/像素)
+    uint64_t ImageBytes(GLint internalFormat, GLsizei width, GLsizei height);
+
+    // --- GL 分配包装: 参数与对应的 gl* 函数一致，额外指定记账类别 ---
+    void TrackedTexImage2D(MemoryCategory category, GLenum target, GLint level, GLint internalFormat,
+                           GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* data);
+    void TrackedCompressedTexImage2D(MemoryCategory category, GLenum target, GLint level, GLenum internalFormat,
+                                     GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data);
+    void TrackedGenerateMipmap(GLenum target);
+    void TrackedBufferData(MemoryCategory category, GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+    void TrackedRenderbufferStorage(MemoryCategory category, GLenum target, GLenum internalFormat, GLsizei width, GLsizei height);
+    void TrackedDeleteTextures(GLsizei n, const GLuint* ids);
+    void TrackedDeleteBuffers(GLsizei n, const GLuint* ids);
+    void TrackedDeleteRenderbuffers(GLsizei n, const GLuint* ids);
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+namespace Utils {
+
+    // 获取可用的工作线程数 (至少为 1)
+    inline unsigned int GetWorkerCount() {
+        unsigned int hw = std::thread::hardware_concurrency();
+        return hw == 0 ? 1u : hw;
+    }
+
+    /**
+     * @brief 常驻工作线程池 (进程内单例)
+     * 线程只在首次使用时创建一次，之后每次分发任务不再创建线程或分配堆内存。
+     * 同一时刻只执行一个任务；池忙碌或在工作线程内嵌套调用时，由调用线程串行执行。
+     */
+    class WorkerPool {
+    public:
+        using TaskFn = void (*)(void* context, size_t index);
+
+        static WorkerPool& Instance() {
+            static WorkerPool pool;
+            return pool;
+        }
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // 参与计算的线程总数 (工作线程 + 调用线程)
+        unsigned int Size() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+        // 将 [0, count) 分发给 threadCount 个线程 (含调用线程)，返回时全部完成
+        void Run(size_t count, TaskFn fn, void* context, unsigned int threadCount) {
+            if (IsWorkerThread() || threadCount <= 1 || !runMutex.try_lock()) {
+                for (size_t i = 0; i < count; ++i) fn(context, i);
+                return;
+            }
+            std::lock_guard<std::mutex> runLock(runMutex, std::adopt_lock);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                taskFn = fn;
+                taskContext = context;
+                taskCount = count;
+                taskThreads = std::min(threadCount, Size());
+                next.store(0);
+                pending = taskThreads - 1;
+                ++generation;
+            }
+            wake.notify_all();
+
+            Drain(fn, context, count);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [&]() { return pending == 0; });
+        }
+
+    private:
+        WorkerPool() {
+            unsigned int count = GetWorkerCount();
+            workers.reserve(count - 1);
+            for (unsigned int t = 1; t < count; ++t) {
+                workers.emplace_back([this, t]() { WorkerLoop(t - 1); });
+            }
+        }
+
+        ~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& th : workers) th.join();
+        }
+
+        static bool& IsWorkerThread() {
+            thread_local bool isWorker = false;
+            return isWorker;
+        }
+
+        void Drain(TaskFn fn, void* context, size_t count) {
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                fn(context, i);
+            }
+        }
+
+        void WorkerLoop(unsigned int index) {
+            IsWorkerThread() = true;
+            uint64_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+
+                // 只有前 taskThreads - 1 个工作线程参与本次任务 (maxThreads 限制)
+                if (index + 1 >= taskThreads) continue;
+                TaskFn fn = taskFn;
+                void* context = taskContext;
+                size_t count = taskCount;
+
+                lock.unlock();
+                Drain(fn, context, count);
+                lock.lock();
+
+                if (--pending == 0) done.notify_one();
+            }
+        }
+
+        std::vector<std::thread> workers;
+        std::mutex runMutex;            // 串行化 Run
+        std::mutex mutex;               // 保护下方任务状态
+        std::condition_variable wake;
+        std::condition_variable done;
+        bool stopping = false;
+        uint64_t generation = 0;
+        TaskFn taskFn = nullptr;
+        void* taskContext = nullptr;
+        size_t taskCount = 0;
+        unsigned int taskThreads = 0;
+        unsigned int pending = 0;
+        std::atomic<size_t> next{0};
+    };
+
+    // 将 [0, count) 的任务动态分发给多个工作线程执行
+    // 注意: fn 会被并发调用，必须保证线程安全；调用线程本身也参与计算
+    // fn 以模板参数传入并通过函数指针分发，不经过 std::function，调用本身不分配堆内存
+    template<typename Fn>
+    inline void ParallelFor(size_t count, Fn&& fn, unsigned int maxThreads = 0) {
+        if (count == 0) return;
+
+        WorkerPool& pool = WorkerPool::Instance();
+        unsigned int threadCount = pool.Size();
+        if (maxThreads > 0) threadCount = std::min(threadCount, maxThreads);
+        threadCount = static_cast<unsigned int>(std::min<size_t>(threadCount, count));
+
+        using FnType = typename std::remove_reference<Fn>::type;
+        pool.Run(count, [](void* context, size_t i) { (*static_cast<FnType*>(context))(i); },
+                 const_cast<void*>(static_cast<const void*>(&fn)), threadCount);
+    }
+}
@@ -0,0 +1,149 @@
+#include "Profiler.h"
+
+namespace Utils {
+
+    void Profiler::Configure(bool enable, bool gpu, size_t capacity) {
+        enabled = enable;
+        gpuTimers = gpu;
+        maxEvents = capacity;
+    }
+
+    void Profiler::BeginModel() {
+        if (!enabled) return;
+        events.clear();
+        events.reserve(maxEvents);
+        droppedEvents = 0;
+        readbackBytes = 0;
+        views = 0;
+        frames = 0;
+        contextView = -1;
+        contextPhase = "";
+        head = tail = 0;
+
+        if (gpuTimers && !queriesCreated) {
+            glGenQueries(QUERY_PAIRS * 2, queries);
+            queriesCreated = true;
+        }
+
+        // GPU 时间戳与 CPU 时钟的对应关系: 两者都取"当前时刻"，之后的 GPU 区间按同一偏移换算到 CPU 时间轴
+        cpuBase = Clock::now();
+        if (gpuTimers) {
+            GLint64 gpuNow = 0;
+            glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+            gpuBaseNs = static_cast<int64_t>(gpuNow);
+        }
+    }
+
+    void Profiler::PushEvent(const Event& e) {
+        if (events.size() < maxEvents) events.push_back(e);
+        else ++droppedEvents;
+    }
+
+    void Profiler::AddCpuEvent(const char* name, Clock::time_point begin, Clock::time_point end) {
+        if (!enabled) return;
+        PushEvent({ name, contextPhase,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(begin - cpuBase).count(),
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count(),
+                    contextView, false });
+    }
+
+    int Profiler::BeginGpu(const char* name) {
+        if (!enabled || !gpuTimers || !queriesCreated) return -1;
+        if (tail - head >= static_cast<size_t>(QUERY_PAIRS)) {
+            ++droppedEvents;
+            return -1;
+        }
+        int slot = static_cast<int>(tail % QUERY_PAIRS);
+        pending[slot] = { name, contextPhase, contextView, false };
+        glQueryCounter(queries[slot * 2], GL_TIMESTAMP);
+        ++tail;
+        return slot;
+    }
+
+    void Profiler::EndGpu(int slot) {
+        if (slot < 0) return;
+        glQueryCounter(queries[slot * 2 + 1], GL_TIMESTAMP);
+        pending[slot].ended = true;
+    }
+
+    void Profiler::CollectGpu(bool wait) {
+        if (!enabled || !queriesCreated) return;
+        // 查询按提交顺序完成，遇到第一个未完成的即可停止
+        while (head < tail) {
+            int slot = static_cast<int>(head % QUERY_PAIRS);
+            const GpuQuery& q = pending[slot];
+            if (!q.ended) break;
+            if (!wait) {
+                GLint available = 0;
+                glGetQueryObjectiv(queries[slot * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available) break;
+            }
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(queries[slot * 2], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(queries[slot * 2 + 1], GL_QUERY_RESULT, &end);
+            PushEvent({ q.name, q.phase, static_cast<int64_t>(begin) - gpuBaseNs,
+                        static_cast<int64_t>(end - begin), q.view, true });
+            ++head;
+        }
+    }
+
+    ProfileSummary Profiler::EndModel(const std::string& tracePath) {
+        ProfileSummary summary;
+        if (!enabled) return summary;
+        summary.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - cpuBase).count();
+
+        // 未结束的区间 (不应出现) 直接丢弃，其余等待 GPU 完成后取回
+        CollectGpu(true);
+        droppedEvents += tail - head;
+        head = tail;
+
+        summary.views = views;
+        summary.frames = frames;
+        summary.readbackBytes = readbackBytes;
+        summary.events = events.size();
+        summary.droppedEvents = droppedEvents;
+
+        std::map<std::pair<std::string, bool>, ProfileSummary::Stage> stages;
+        for (const Event& e : events) {
+            ProfileSummary::Stage& stage = stages[{ e.name, e.gpu }];
+            stage.name = e.name;
+            stage.gpu = e.gpu;
+            stage.count++;
+            stage.totalMs += e.durationNs * 1e-6;
+        }
+        for (auto& kv : stages) summary.stages.push_back(kv.second);
+        std::sort(summary.stages.begin(), summary.stages.end(),
+                  [](const ProfileSummary::Stage& a, const ProfileSummary::Stage& b) { return a.totalMs > b.totalMs; });
+
+        if (!tracePath.empty()) WriteTrace(tracePath);
+        return summary;
+    }
+
+    void Profiler::WriteTrace(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            std::cerr << "[Profile] Error: cannot write trace " << path << std::endl;
+            return;
+        }
+
+        // Chrome trace event 格式: 时间单位为微秒，CPU 与 GPU 分别放在两条轨道上
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU (GL thread)\"}},\n";
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+        out << std::fixed << std::setprecision(3);
+        for (const Event& e : events) {
+            out << ",\n{\"name\":\"" << e.name << "\",\"cat\":\"" << (e.gpu ? "gpu" : "cpu")
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (e.gpu ? 2 : 1)
+                << ",\"ts\":" << e.beginNs * 1e-3 << ",\"dur\":" << e.durationNs * 1e-3
+                << ",\"args\":{\"view\":" << e.view << ",\"phase\":\"" << e.phase << "\"}}";
+        }
+        out << "\n]}\n";
+    }
+
+    void Profiler::ReleaseGpu() {
+        if (!queriesCreated) return;
+        glDeleteQueries(QUERY_PAIRS * 2, queries);
+        queriesCreated = false;
+        head = tail = 0;
+    }
+}
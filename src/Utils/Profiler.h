@@ -0,0 +1,145 @@
+#pragma once
+
+namespace Utils {
+
+    // 单个模型的剖析汇总 (EndModel 返回)
+    struct ProfileSummary {
+        struct Stage {
+            std::string name;
+            bool gpu = false;
+            size_t count = 0;
+            double totalMs = 0.0;
+        };
+        double wallMs = 0.0;          // BeginModel ~ EndModel 的墙钟时间
+        size_t views = 0;             // 已评估的视角数 (每个阶段的每个视角计一次)
+        size_t frames = 0;
+        uint64_t readbackBytes = 0;   // GPU -> CPU 回读的总字节数
+        size_t events = 0;
+        size_t droppedEvents = 0;     // 事件缓冲或 GPU 查询池耗尽而丢弃的事件数
+        std::vector<Stage> stages;    // 按总耗时降序
+
+        double ViewsPerSecond() const { return wallMs > 0.0 ? views * 1000.0 / wallMs : 0.0; }
+    };
+
+    /**
+     * @brief 阶段级 CPU / GPU 计时，按模型导出 Chrome trace (Perfetto 可直接打开) 与汇总表
+     * CPU 阶段由 CpuProfileScope 记录 steady_clock 区间；GPU 阶段由 GpuProfileScope 在命令流中插入
+     * 一对 GL_TIMESTAMP 查询，结果在之后的帧中可用时才取回 (CollectGpu)，不会让 CPU 等待 GPU。
+     * 事件缓冲与查询池在 BeginModel 中一次性分配，写满后丢弃新事件并计数，渲染循环中不分配堆内存。
+     * 只能在 GL 线程使用；未启用时所有接口立即返回。
+     */
+    class Profiler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static Profiler& Instance() {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        void Configure(bool enabled, bool gpuTimers, size_t maxEvents);
+        bool Enabled() const { return enabled; }
+
+        // 清空事件并记录 CPU / GPU 时钟的对应关系
+        void BeginModel();
+        // 取回全部未完成的 GPU 查询并汇总；tracePath 非空时写出 Chrome trace JSON
+        ProfileSummary EndModel(const std::string& tracePath);
+
+        // 后续事件所属的视角 (原始编号) 与阶段名 (字符串常量)
+        void SetContext(int view, const char* phase) {
+            contextView = view;
+            contextPhase = phase;
+        }
+
+        void AddCpuEvent(const char* name, Clock::time_point begin, Clock::time_point end);
+        // 返回查询对编号 (未启用或查询池耗尽时为 -1)
+        int BeginGpu(const char* name);
+        void EndGpu(int slot);
+        // 取回已完成的 GPU 查询 (每帧调用一次；wait = true 时等待全部完成)
+        void CollectGpu(bool wait = false);
+
+        void AddReadback(size_t bytes) { if (enabled) readbackBytes += bytes; }
+        void AddView() { if (enabled) ++views; }
+        void AddFrame() { if (enabled) ++frames; }
+
+        // 释放 GPU 查询对象 (须在销毁 GL 上下文之前调用)
+        void ReleaseGpu();
+
+    private:
+        Profiler() = default;
+
+        struct Event {
+            const char* name;
+            const char* phase;
+            int64_t beginNs;   // 相对 BeginModel 的 CPU 时间
+            int64_t durationNs;
+            int view;
+            bool gpu;
+        };
+        struct GpuQuery {
+            const char* name = nullptr;
+            const char* phase = nullptr;
+            int view = -1;
+            bool ended = false;
+        };
+        static const int QUERY_PAIRS = 256; // 查询池大小 (同时在途的 GPU 区间数上限)
+
+        void PushEvent(const Event& e);
+        void WriteTrace(const std::string& path) const;
+
+        bool enabled = false;
+        bool gpuTimers = true;
+        size_t maxEvents = 0;
+
+        std::vector<Event> events;
+        size_t droppedEvents = 0;
+        Clock::time_point cpuBase;
+        int64_t gpuBaseNs = 0;
+        uint64_t readbackBytes = 0;
+        size_t views = 0;
+        size_t frames = 0;
+        int contextView = -1;
+        const char* contextPhase = "";
+
+        // GPU 查询环形队列: [head, tail) 为在途查询，按提交顺序完成
+        unsigned int queries[QUERY_PAIRS * 2] = {};
+        GpuQuery pending[QUERY_PAIRS];
+        size_t head = 0, tail = 0;
+        bool queriesCreated = false;
+    };
+
+    // CPU 区间计时 (析构时记录)
+    class CpuProfileScope {
+    public:
+        explicit CpuProfileScope(const char* name)
+            : name(name), active(Profiler::Instance().Enabled()),
+              begin(active ? Profiler::Clock::now() : Profiler::Clock::time_point()) {}
+        ~CpuProfileScope() {
+            if (active) Profiler::Instance().AddCpuEvent(name, begin, Profiler::Clock::now());
+        }
+
+        CpuProfileScope(const CpuProfileScope&) = delete;
+        CpuProfileScope& operator=(const CpuProfileScope&) = delete;
+
+    private:
+        const char* name;
+        bool active;
+        Profiler::Clock::time_point begin;
+    };
+
+    // GPU 区间计时 (构造与析构时各插入一个 GL_TIMESTAMP 查询)
+    class GpuProfileScope {
+    public:
+        explicit GpuProfileScope(const char* name) : slot(Profiler::Instance().BeginGpu(name)) {}
+        ~GpuProfileScope() { Profiler::Instance().EndGpu(slot); }
+
+        GpuProfileScope(const GpuProfileScope&) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+    private:
+        int slot;
+    };
+}
@@ -1,10 +1,52 @@
 #include "App/Config.h"
 #include "App/Application.h"
 #include "App/BatchProcessor.h"
+#include "App/BenchmarkRunner.h"
+#include "App/ErrorMapTool.h"
 
-int main() {
+int main(int argc, char** argv) {
     // 1. 配置阶段
     AppConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--benchmark") config.benchmark.enabled = true;
+        else if (arg == "--recolor" && hasValue) {
+            config.recolor.enabled = true;
+            config.recolor.input = argv[++i];
+        }
+        else if (arg == "--multiplier" && hasValue) {
+            // 整个参数都必须是有限的非负数 (0 = 沿用文件中记录的倍率)
+            const char* value = argv[++i];
+            char* end = nullptr;
+            const float multiplier = std::strtof(value, &end);
+            if (end == value || *end != '\0' || !std::isfinite(multiplier) || multiplier < 0.0f) {
+                std::cerr << "[Fatal] Invalid multiplier: " << value << " (expected a number >= 0, 0 = from file)" << std::endl;
+                return -1;
+            }
+            config.recolor.multiplier = multiplier;
+        }
+        else if (arg == "--palette" && hasValue) {
+            const std::string name = argv[++i];
+            if (!Metrics::ParseHeatmapPalette(name, config.recolor.palette)) {
+                std::cerr << "[Fatal] Unknown palette: " << name << " (default | gray | viridis)" << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    // 离线重新着色: 只读取 .vmerr 误差图，不创建窗口与 OpenGL 上下文
+    if (config.recolor.enabled) {
+        ErrorMapTool tool(config);
+        return tool.Run() > 0 ? 0 : -1;
+    }
+
+    // 端到端吞吐基准: 自行生成模型并按分辨率创建 Application，不经过批量目录扫描
+    if (config.benchmark.enabled) {
+        BenchmarkRunner benchmark(config);
+        benchmark.Run();
+        return 0;
+    }
 
     // 2. 核心对象实例化
     Application app(config);
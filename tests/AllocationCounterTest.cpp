@@ -0,0 +1,32 @@
+#include "TestFramework.h"
+#include "Utils/AllocationCounter.h"
+
+/**
+ * 调试分配计数: 普通与 std::align_val_t 对齐版本的 operator new 都被计入 (仅 Debug 构建替换全局 operator new)
+ */
+
+namespace {
+    struct alignas(64) AlignedBlock {
+        float values[16];
+    };
+}
+
+VM_TEST(AllocationCounterAligned) {
+    if (!Utils::AllocationCounter::Enabled()) return;
+
+    const uint64_t start = Utils::AllocationCounter::Count();
+    auto* plain = new int(7);
+    VM_CHECK_EQ(Utils::AllocationCounter::Count() - start, 1ull);
+
+    auto* block = new AlignedBlock();
+    auto* blocks = new AlignedBlock[3];
+    std::vector<AlignedBlock> vector(5);
+    VM_CHECK_EQ(Utils::AllocationCounter::Count() - start, 4ull);
+    VM_CHECK_EQ(reinterpret_cast<uintptr_t>(block) % 64, static_cast<uintptr_t>(0));
+    VM_CHECK_EQ(reinterpret_cast<uintptr_t>(blocks) % 64, static_cast<uintptr_t>(0));
+    VM_CHECK_EQ(reinterpret_cast<uintptr_t>(vector.data()) % 64, static_cast<uintptr_t>(0));
+
+    delete plain;
+    delete block;
+    delete[] blocks;
+}
@@ -0,0 +1,185 @@
+#include "TestFramework.h"
+#include "Metrics/ErrorMapFile.h"
+#include "Metrics/PixelPasses.h"
+#include "Metrics/SimdKernels.h"
+
+/**
+ * 误差图容器 (.vmerr) 的写入 / 读回: 游程与字面段在 32767 上限处正确切分，裁剪区域展开回整幅画面
+ */
+
+namespace {
+    using namespace Metrics;
+    namespace fs = std::filesystem;
+
+    constexpr size_t kMaxSegment = 0x7FFF;
+
+    struct ErrorView {
+        int viewIndex = 0;
+        FrameRegion region;
+        std::vector<uint16_t> frame;   // 整幅画面，区域外为背景
+    };
+
+    // 由区域内像素序列构造视角 (行序与区域一致)
+    ErrorView MakeView(int viewIndex, const FrameRegion& region, const std::vector<uint16_t>& pixels) {
+        ErrorView view{ viewIndex, region, std::vector<uint16_t>(static_cast<size_t>(region.frameWidth) * region.frameHeight, ERROR_MAP_BACKGROUND) };
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            const size_t row = i / region.width, col = i % region.width;
+            view.frame[(region.y + row) * region.frameWidth + region.x + col] = pixels[i];
+        }
+        return view;
+    }
+
+    // 长度恰好落在编码边界两侧的重复段与字面段
+    std::vector<uint16_t> BoundarySequence(std::mt19937& rng) {
+        std::vector<uint16_t> values;
+        auto run = [&](size_t n, uint16_t v) { values.insert(values.end(), n, v); };
+        auto literal = [&](size_t n) {
+            // 相邻值不同，不构成重复段
+            for (size_t k = 0; k < n; ++k) values.push_back(static_cast<uint16_t>((values.empty() ? 0 : values.back()) + 1 + rng() % 1000));
+        };
+        run(1, 0x3C00);
+        run(2, 0x3800);
+        run(3, 0x3400);
+        run(kMaxSegment, ERROR_MAP_BACKGROUND);
+        literal(1);
+        run(kMaxSegment + 1, 0);
+        literal(kMaxSegment);
+        run(3, 0x1234);
+        literal(kMaxSegment + 2);
+        run(2 * kMaxSegment + 5, ERROR_MAP_BACKGROUND);
+        literal(2);
+        return values;
+    }
+}
+
+VM_TEST(ErrorMapRoundTrip) {
+    const fs::path path = fs::temp_directory_path() / "vm_tests_error_map.vmerr";
+    std::mt19937 rng(49);
+
+    std::vector<ErrorView> expected;
+    Metrics::ErrorMapWriter writer;
+    VM_CHECK(writer.Open(path.string(), "Silhouette", 2.5f));
+
+    // 1. 整幅画面: 覆盖各边界长度 (段跨行，末行以背景补齐)
+    {
+        std::vector<uint16_t> values = BoundarySequence(rng);
+        const int w = 1000;
+        values.resize((values.size() + w - 1) / w * w, ERROR_MAP_BACKGROUND);
+        const FrameRegion region = FrameRegion::Full(w, static_cast<int>(values.size() / w));
+        writer.Append(3, region, ImageView(values, region.width, region.height, PixelFormat::R16F));
+        expected.push_back(MakeView(3, region, values));
+    }
+    // 2. 整幅画面: 背景游程跨行，中间一块随机误差
+    {
+        const int w = 300, h = 200;
+        std::vector<uint16_t> values(static_cast<size_t>(w) * h, ERROR_MAP_BACKGROUND);
+        for (int y = 80; y < 120; ++y) {
+            for (int x = 100; x < 190; ++x) values[static_cast<size_t>(y) * w + x] = Simd::FloatToHalf(static_cast<float>(rng() % 4096) / 4096.0f);
+        }
+        const FrameRegion region = FrameRegion::Full(w, h);
+        writer.Append(0, region, ImageView(values, w, h, PixelFormat::R16F));
+        expected.push_back(MakeView(0, region, values));
+    }
+    // 3. 裁剪区域，输入为带 stride 的视图 (区域外的列不应被读取)
+    {
+        const FrameRegion region = { 320, 240, 17, 9, 101, 57 };
+        const int paddedWidth = region.width + 13;
+        std::vector<uint16_t> padded(static_cast<size_t>(paddedWidth) * region.height, 0xDEAD);
+        std::vector<uint16_t> values;
+        for (int y = 0; y < region.height; ++y) {
+            for (int x = 0; x < region.width; ++x) {
+                const uint16_t v = (x / 7 + y) % 3 == 0 ? ERROR_MAP_BACKGROUND : static_cast<uint16_t>(rng() % 0x3C00);
+                padded[static_cast<size_t>(y) * paddedWidth + x] = v;
+                values.push_back(v);
+            }
+        }
+        writer.Append(-1, region, ImageView(padded.data(), region.width, region.height, PixelFormat::R16F, paddedWidth * sizeof(uint16_t)));
+        expected.push_back(MakeView(-1, region, values));
+    }
+    const uint64_t bytesWritten = writer.BytesWritten();
+    VM_CHECK(writer.RawBytes() > bytesWritten);
+    writer.Close();
+
+    // 统计的字节数含文件头，与文件大小一致
+    VM_CHECK_EQ(static_cast<uint64_t>(fs::file_size(path)), bytesWritten);
+
+    Metrics::ErrorMapReader reader;
+    VM_CHECK(reader.Open(path.string()));
+    VM_CHECK_EQ(reader.Phase(), std::string("Silhouette"));
+    VM_CHECK_EQ(reader.ErrorMultiplier(), 2.5f);
+    ErrorMapView view;
+    std::vector<uint16_t> frame;
+    for (size_t v = 0; v < expected.size(); ++v) {
+        Tests::TestTrace trace("view=" + std::to_string(v));
+        VM_CHECK(reader.Next(view, frame));
+        VM_CHECK_EQ(view.viewIndex, expected[v].viewIndex);
+        VM_CHECK_EQ(view.region.frameWidth, expected[v].region.frameWidth);
+        VM_CHECK_EQ(view.region.frameHeight, expected[v].region.frameHeight);
+        VM_CHECK_EQ(view.region.x, expected[v].region.x);
+        VM_CHECK_EQ(view.region.y, expected[v].region.y);
+        VM_CHECK_EQ(view.region.width, expected[v].region.width);
+        VM_CHECK_EQ(view.region.height, expected[v].region.height);
+        VM_CHECK(frame == expected[v].frame);
+    }
+    VM_CHECK(!reader.Next(view, frame));
+
+    // 截断的文件: 读到损坏的视角时返回 false，而不是展开不完整的数据
+    fs::resize_file(path, fs::file_size(path) - 6);
+    VM_CHECK(reader.Open(path.string()));
+    size_t complete = 0;
+    while (reader.Next(view, frame)) complete++;
+    VM_CHECK_EQ(complete, expected.size() - 1);
+
+    std::error_code ec;
+    fs::remove(path, ec);
+}
+
+VM_TEST(ErrorMapCorrupt) {
+    const fs::path path = fs::temp_directory_path() / "vm_tests_error_map_corrupt.vmerr";
+    const FrameRegion region = { 64, 48, 5, 6, 20, 10 };
+    std::vector<uint16_t> values(region.PixelCount());
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<uint16_t>(i % 7 == 0 ? ERROR_MAP_BACKGROUND : i);
+    {
+        Metrics::ErrorMapWriter writer;
+        VM_CHECK(writer.Open(path.string(), "PSNR", 1.0f));
+        writer.Append(0, region, ImageView(values, region.width, region.height, PixelFormat::R16F));
+        writer.Close();
+    }
+    std::string valid;
+    {
+        std::ifstream in(path, std::ios::binary);
+        valid.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    // 文件头 32 字节 + 阶段名 "PSNR" 4 字节之后是第一个视角块: int32 x 7，然后是 tokenCount
+    const size_t block = 36;
+    auto patched = [&](size_t offset, uint32_t value) {
+        std::string bytes = valid;
+        std::memcpy(&bytes[offset], &value, sizeof(value));
+        return bytes;
+    };
+    struct Case { const char* name; std::string bytes; };
+    const Case cases[] = {
+        { "token count beyond file", patched(block + 28, 0xFFFFFFF0u) },
+        { "token count beyond region", patched(block + 28, static_cast<uint32_t>(2 * region.PixelCount() + 2)) },
+        { "huge frame", patched(block + 4, 1u << 30) },
+        { "region overflows frame", patched(block + 12, 0x7FFFFFFFu) },
+        { "negative height", patched(block + 24, 0xFFFFFFFFu) },
+    };
+
+    Metrics::ErrorMapReader reader;
+    ErrorMapView view;
+    std::vector<uint16_t> frame;
+    VM_CHECK(reader.Open(path.string()));
+    VM_CHECK(reader.Next(view, frame));
+    for (const Case& c : cases) {
+        Tests::TestTrace trace(c.name);
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << c.bytes;
+        VM_CHECK(reader.Open(path.string()));
+        frame.clear();
+        VM_CHECK(!reader.Next(view, frame));
+        VM_CHECK(frame.empty());
+    }
+
+    std::error_code ec;
+    fs::remove(path, ec);
+}
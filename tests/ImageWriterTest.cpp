@@ -0,0 +1,190 @@
+#include "TestFramework.h"
+#include "Utils/ImageWriter.h"
+
+#include "stb_image.h"
+
+/**
+ * 截图编码器的往返: 各格式解码后与输入逐字节一致 (含翻转、RGB / RGBA 与长游程)
+ * QOI 按规范独立解码；PPM 直接解析；PNG 交给 stb_image
+ */
+
+namespace {
+    using Utils::ImageFormat;
+
+    struct Image {
+        int width = 0, height = 0, channels = 0;
+        std::vector<unsigned char> pixels;
+    };
+
+    // 渐变 + 噪声 + 跨行的长纯色段 (> 62 像素，QOI 的游程上限) + 随机 alpha 块
+    Image MakeImage(int w, int h, int channels, std::mt19937& rng) {
+        Image image{ w, h, channels, std::vector<unsigned char>(static_cast<size_t>(w) * h * channels) };
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                unsigned char* p = &image.pixels[(static_cast<size_t>(y) * w + x) * channels];
+                const size_t i = static_cast<size_t>(y) * w + x;
+                const bool flat = (i / 150) % 3 == 1;
+                const bool noisy = (i / 97) % 4 == 3;
+                p[0] = flat ? 200 : static_cast<unsigned char>(noisy ? rng() : x * 3 + y);
+                p[1] = flat ? 10 : static_cast<unsigned char>(noisy ? rng() : x + y * 2);
+                p[2] = flat ? 77 : static_cast<unsigned char>(noisy ? rng() : (x ^ y) + 1);
+                if (channels == 4) p[3] = flat ? 255 : static_cast<unsigned char>((i / 13) % 5 == 0 ? rng() : 255);
+            }
+        }
+        return image;
+    }
+
+    // 调用方期望的自顶向下行序 (flip 时输入为自底向上)
+    std::vector<unsigned char> TopDown(const Image& image, bool flip, int outChannels) {
+        std::vector<unsigned char> out;
+        out.reserve(static_cast<size_t>(image.width) * image.height * outChannels);
+        for (int row = 0; row < image.height; ++row) {
+            const int src = flip ? image.height - 1 - row : row;
+            for (int x = 0; x < image.width; ++x) {
+                const unsigned char* p = &image.pixels[(static_cast<size_t>(src) * image.width + x) * image.channels];
+                out.insert(out.end(), p, p + outChannels);
+            }
+        }
+        return out;
+    }
+
+    uint32_t ReadU32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 | static_cast<uint32_t>(p[2]) << 8 | p[3];
+    }
+
+    // QOI 参考解码 (https://qoiformat.org/qoi-specification.pdf)，输出 header 中声明的通道数；格式错误时返回 false
+    bool DecodeQoi(const std::vector<unsigned char>& data, Image& out) {
+        if (data.size() < 22 || std::memcmp(data.data(), "qoif", 4) != 0) return false;
+        out.width = static_cast<int>(ReadU32(&data[4]));
+        out.height = static_cast<int>(ReadU32(&data[8]));
+        out.channels = data[12];
+        if (out.channels != 3 && out.channels != 4) return false;
+        const size_t pixelCount = static_cast<size_t>(out.width) * out.height;
+        out.pixels.clear();
+        out.pixels.reserve(pixelCount * out.channels);
+
+        unsigned char index[64][4] = {};
+        unsigned char px[4] = { 0, 0, 0, 255 };
+        const size_t end = data.size() - 8;
+        size_t pos = 14;
+        for (size_t n = 0; n < pixelCount;) {
+            if (pos >= end) return false;
+            const unsigned char op = data[pos++];
+            int run = 1;
+            if (op == 0xFE) {
+                std::memcpy(px, &data[pos], 3);
+                pos += 3;
+            } else if (op == 0xFF) {
+                std::memcpy(px, &data[pos], 4);
+                pos += 4;
+            } else if ((op & 0xC0) == 0x00) {
+                std::memcpy(px, index[op], 4);
+            } else if ((op & 0xC0) == 0x40) {
+                px[0] = static_cast<unsigned char>(px[0] + ((op >> 4) & 3) - 2);
+                px[1] = static_cast<unsigned char>(px[1] + ((op >> 2) & 3) - 2);
+                px[2] = static_cast<unsigned char>(px[2] + (op & 3) - 2);
+            } else if ((op & 0xC0) == 0x80) {
+                const int dg = (op & 0x3F) - 32;
+                const unsigned char b2 = data[pos++];
+                px[0] = static_cast<unsigned char>(px[0] + dg - 8 + (b2 >> 4));
+                px[1] = static_cast<unsigned char>(px[1] + dg);
+                px[2] = static_cast<unsigned char>(px[2] + dg - 8 + (b2 & 0x0F));
+            } else {
+                run = (op & 0x3F) + 1;
+            }
+            const int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+            std::memcpy(index[hash], px, 4);
+            for (int r = 0; r < run && n < pixelCount; ++r, ++n) out.pixels.insert(out.pixels.end(), px, px + out.channels);
+        }
+        // 结束标记紧跟最后一个像素
+        static const unsigned char kEnd[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+        return pos == end && std::memcmp(&data[end], kEnd, 8) == 0;
+    }
+
+    bool DecodePpm(const std::vector<unsigned char>& data, Image& out) {
+        const std::string text(data.begin(), data.end());
+        std::istringstream header(text);
+        std::string magic;
+        int maxValue = 0;
+        header >> magic >> out.width >> out.height >> maxValue;
+        if (magic != "P6" || maxValue != 255 || !header) return false;
+        // 像素紧跟 maxValue 之后的单个空白
+        const size_t offset = static_cast<size_t>(header.tellg()) + 1;
+        out.channels = 3;
+        out.pixels.assign(data.begin() + offset, data.end());
+        return out.pixels.size() == static_cast<size_t>(out.width) * out.height * 3;
+    }
+}
+
+VM_TEST(ImageWriterRoundTrip) {
+    struct Case { int w, h, channels; };
+    // 单像素、奇数尺寸、长条 (游程跨行)、RGBA
+    const Case cases[] = { { 1, 1, 3 }, { 67, 33, 3 }, { 301, 2, 3 }, { 64, 64, 4 }, { 129, 17, 4 } };
+    const ImageFormat formats[] = { ImageFormat::Png, ImageFormat::FastPng, ImageFormat::Qoi, ImageFormat::Raw };
+
+    std::mt19937 rng(46);
+    Utils::ImageWriter writer;
+    for (const Case& c : cases) {
+        const Image image = MakeImage(c.w, c.h, c.channels, rng);
+        for (ImageFormat format : formats) {
+            for (bool flip : { false, true }) {
+                Tests::TestTrace trace(std::string(Utils::ImageFormatName(format)) + " " + std::to_string(c.w) + "x" + std::to_string(c.h) +
+                                       "x" + std::to_string(c.channels) + (flip ? " flipped" : ""));
+                VM_CHECK(writer.Encode(format, c.w, c.h, c.channels, image.pixels.data(), flip));
+                const std::vector<unsigned char>& encoded = writer.Buffer();
+
+                Image decoded;
+                bool ok = false;
+                int expectedChannels = c.channels;
+                if (format == ImageFormat::Qoi) {
+                    ok = DecodeQoi(encoded, decoded);
+                } else if (format == ImageFormat::Raw) {
+                    ok = DecodePpm(encoded, decoded);
+                    expectedChannels = 3;   // PPM 丢弃 alpha
+                } else {
+                    unsigned char* pixels = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()),
+                                                                  &decoded.width, &decoded.height, &decoded.channels, 0);
+                    ok = pixels != nullptr;
+                    if (ok) {
+                        decoded.pixels.assign(pixels, pixels + static_cast<size_t>(decoded.width) * decoded.height * decoded.channels);
+                        stbi_image_free(pixels);
+                    }
+                }
+                VM_CHECK(ok);
+                VM_CHECK_EQ(decoded.width, c.w);
+                VM_CHECK_EQ(decoded.height, c.h);
+                VM_CHECK_EQ(decoded.channels, expectedChannels);
+                VM_CHECK(decoded.pixels == TopDown(image, flip, expectedChannels));
+            }
+        }
+    }
+}
+
+VM_TEST(ImageWriterFile) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "vm_tests_image_writer";
+    std::filesystem::create_directories(dir);
+    std::mt19937 rng(47);
+    const Image image = MakeImage(40, 30, 4, rng);
+
+    Utils::ImageWriter writer;
+    Utils::ImageWriteStats stats;
+    // 写盘内容与 Encode 的缓冲一致，扩展名按格式追加；None 不产生文件
+    for (ImageFormat format : { ImageFormat::Png, ImageFormat::Qoi, ImageFormat::Raw, ImageFormat::None }) {
+        Tests::TestTrace trace(Utils::ImageFormatName(format));
+        const std::string base = (dir / "shot").string();
+        VM_CHECK(writer.Write(base, format, image.width, image.height, image.channels, image.pixels.data(), true, &stats));
+        if (format == ImageFormat::None) continue;
+        const std::filesystem::path path = base + Utils::ImageFormatExtension(format);
+        std::ifstream file(path, std::ios::binary);
+        const std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        VM_CHECK(writer.Encode(format, image.width, image.height, image.channels, image.pixels.data(), true));
+        VM_CHECK(bytes == writer.Buffer());
+    }
+    VM_CHECK_EQ(stats.images, static_cast<size_t>(3));
+    VM_CHECK(!std::filesystem::exists(dir / "shot"));
+
+    // 不支持的布局: 返回 false，不写文件
+    VM_CHECK(!writer.Encode(ImageFormat::Qoi, image.width, image.height, 2, image.pixels.data(), false));
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
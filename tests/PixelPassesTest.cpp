@@ -0,0 +1,139 @@
+#include "TestFramework.h"
+#include "Metrics/Evaluator.h"
+#include "Metrics/PixelPasses.h"
+#include "Metrics/SimdKernels.h"
+
+/**
+ * 融合像素内核与逐像素参考实现的比较
+ */
+
+namespace {
+    using namespace Metrics;
+
+    // 轮廓: 一个矩形块 + 稀疏噪点，画面中留有大片两侧均为背景的 64 像素字 (走整字填充路径)
+    std::vector<unsigned char> MakeSilhouette(int w, int h, int x0, int y0, int x1, int y1, std::mt19937& rng) {
+        std::vector<unsigned char> sil(static_cast<size_t>(w) * h, 0);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const bool inside = x >= x0 && x < x1 && y >= y0 && y < y1;
+                if (inside || rng() % 97 == 0) sil[static_cast<size_t>(y) * w + x] = 255;
+            }
+        }
+        return sil;
+    }
+
+    // 带 stride 的输出缓冲 (模拟图块 / 映射缓冲)，行尾填充字节不应被写入
+    struct StridedTarget {
+        std::vector<unsigned char> bytes;
+        MutableImageView view;
+
+        StridedTarget(int w, int h, PixelFormat format, size_t padding) {
+            const size_t stride = w * BytesPerPixel(format) + padding;
+            bytes.assign(stride * h, 0xCD);
+            view = MutableImageView(bytes.data(), w, h, format, stride);
+        }
+    };
+
+    bool SameColor(const unsigned char* px, const unsigned char* expected) {
+        return std::memcmp(px, expected, 4) == 0;
+    }
+}
+
+VM_TEST(SilhouettePass) {
+    const Color8 background = { 250, 240, 230 };
+    const Color8 silhouette = { 10, 20, 30 };
+    const Color8 heatmapBg = { 200, 201, 202 };
+    const unsigned char bgRgba[4] = { background.r, background.g, background.b, 255 };
+    const unsigned char silRgba[4] = { silhouette.r, silhouette.g, silhouette.b, 255 };
+    const unsigned char heatBgRgba[4] = { heatmapBg.r, heatmapBg.g, heatmapBg.b, 255 };
+    unsigned char matchRgba[4], mismatchRgba[4];
+    Evaluator::HeatmapColor(Evaluator::HeatmapLUT(), 0.0f, matchRgba);
+    Evaluator::HeatmapColor(Evaluator::HeatmapLUT(), 1.0f, mismatchRgba);
+
+    struct Case { int w, h; size_t padding; size_t backgroundPixels; };
+    // 宽度不是 64 的倍数 (字跨行)、单列、恰好整字，以及带行填充的输出
+    const Case cases[] = { { 67, 33, 0, 0 }, { 64, 4, 0, 0 }, { 1, 130, 0, 0 }, { 200, 150, 12, 5000 }, { 129, 517, 4, 0 } };
+
+    std::mt19937 rng(31);
+    for (const Case& c : cases) {
+        Tests::TestTrace trace(std::to_string(c.w) + "x" + std::to_string(c.h) + " padding=" + std::to_string(c.padding));
+        const std::vector<unsigned char> refSil = MakeSilhouette(c.w, c.h, c.w / 4, c.h / 4, c.w / 2 + 1, c.h / 2 + 1, rng);
+        const std::vector<unsigned char> optSil = MakeSilhouette(c.w, c.h, c.w / 4 + 1, c.h / 4, c.w / 2 + 2, c.h / 2, rng);
+        PackedMask refPacked, optPacked;
+        Evaluator::PackSilhouette(ImageView(refSil, c.w, c.h, PixelFormat::R8), refPacked);
+        Evaluator::PackSilhouette(ImageView(optSil, c.w, c.h, PixelFormat::R8), optPacked);
+
+        StridedTarget refOut(c.w, c.h, PixelFormat::RGBA8, c.padding);
+        StridedTarget optOut(c.w, c.h, PixelFormat::RGBA8, c.padding);
+        StridedTarget heatOut(c.w, c.h, PixelFormat::RGBA8, c.padding);
+        StridedTarget errOut(c.w, c.h, PixelFormat::R16F, c.padding);
+        PixelPassTargets targets;
+        targets.refDisplay = refOut.view;
+        targets.optDisplay = optOut.view;
+        targets.heatmap = heatOut.view;
+        targets.error = errOut.view;
+
+        const double error = PixelPasses::SilhouettePass(refPacked, optPacked, background, silhouette, heatmapBg, targets, c.backgroundPixels);
+
+        size_t mismatches = 0, wrongPixels = 0;
+        for (int y = 0; y < c.h; ++y) {
+            const unsigned char* refRow = refOut.view.Row<unsigned char>(y);
+            const unsigned char* optRow = optOut.view.Row<unsigned char>(y);
+            const unsigned char* heatRow = heatOut.view.Row<unsigned char>(y);
+            const uint16_t* errRow = errOut.view.Row<uint16_t>(y);
+            for (int x = 0; x < c.w; ++x) {
+                const bool a = refSil[static_cast<size_t>(y) * c.w + x] > 0;
+                const bool b = optSil[static_cast<size_t>(y) * c.w + x] > 0;
+                mismatches += a != b;
+                bool ok = SameColor(refRow + x * 4, a ? silRgba : bgRgba) && SameColor(optRow + x * 4, b ? silRgba : bgRgba);
+                if (!a && !b) {
+                    ok = ok && SameColor(heatRow + x * 4, heatBgRgba) && errRow[x] == ERROR_MAP_BACKGROUND;
+                } else {
+                    ok = ok && SameColor(heatRow + x * 4, a != b ? mismatchRgba : matchRgba) &&
+                         errRow[x] == Simd::FloatToHalf(a != b ? 1.0f : 0.0f);
+                }
+                wrongPixels += !ok;
+            }
+            // 行尾填充保持原样
+            for (size_t p = static_cast<size_t>(c.w) * 4; p < refOut.view.stride; ++p) {
+                wrongPixels += refRow[p] != 0xCD;
+            }
+        }
+        VM_CHECK_EQ(wrongPixels, static_cast<size_t>(0));
+        VM_CHECK_EQ(error, static_cast<double>(mismatches) / static_cast<double>(static_cast<size_t>(c.w) * c.h + c.backgroundPixels));
+    }
+}
+
+VM_TEST(PadToFrame) {
+    const Color8 fill = { 200, 201, 202 };
+    const unsigned char fillRgba[4] = { fill.r, fill.g, fill.b, 255 };
+    // 居中、贴左下角、贴右上角、整幅画面，以及跨多个行块的区域
+    const FrameRegion regions[] = {
+        { 67, 41, 10, 7, 30, 20 }, { 50, 40, 0, 0, 13, 9 }, { 50, 40, 37, 31, 13, 9 }, { 33, 17, 0, 0, 33, 17 }, { 300, 200, 5, 3, 290, 150 }
+    };
+
+    std::mt19937 rng(48);
+    for (const FrameRegion& r : regions) {
+        Tests::TestTrace trace(std::to_string(r.x) + "," + std::to_string(r.y) + " " + std::to_string(r.width) + "x" + std::to_string(r.height) +
+                               " in " + std::to_string(r.frameWidth) + "x" + std::to_string(r.frameHeight));
+        // 区域图像带行填充 (模拟复用的较大缓冲)
+        StridedTarget source(r.width, r.height, PixelFormat::RGBA8, 8);
+        for (int y = 0; y < r.height; ++y) {
+            unsigned char* row = source.view.Row<unsigned char>(y);
+            for (int x = 0; x < r.width * 4; ++x) row[x] = static_cast<unsigned char>(rng());
+        }
+        std::vector<unsigned char> frame(static_cast<size_t>(r.frameWidth) * r.frameHeight * 4, 0xCD);
+        PixelPasses::PadToFrame(ImageView(source.bytes.data(), r.width, r.height, PixelFormat::RGBA8, source.view.stride), r, fill,
+                                MutableImageView(frame, r.frameWidth, r.frameHeight, PixelFormat::RGBA8));
+
+        size_t wrongPixels = 0;
+        for (int y = 0; y < r.frameHeight; ++y) {
+            for (int x = 0; x < r.frameWidth; ++x) {
+                const unsigned char* px = &frame[(static_cast<size_t>(y) * r.frameWidth + x) * 4];
+                const bool inside = x >= r.x && x < r.x + r.width && y >= r.y && y < r.y + r.height;
+                wrongPixels += !SameColor(px, inside ? source.view.Row<unsigned char>(y - r.y) + (x - r.x) * 4 : fillRgba);
+            }
+        }
+        VM_CHECK_EQ(wrongPixels, static_cast<size_t>(0));
+    }
+}
@@ -0,0 +1,195 @@
+#include "TestFramework.h"
+#include "App/ResultSink.h"
+
+/**
+ * 结果输出缓冲: CSV 内容与逐行直接追加写出的结果一致，落盘经 .tmp + 重命名，列式文件可按文档布局读回
+ */
+
+namespace {
+    namespace fs = std::filesystem;
+
+    // 每个用例使用独立的临时目录
+    struct TempDir {
+        fs::path path;
+
+        explicit TempDir(const std::string& name) : path(fs::temp_directory_path() / ("vm_tests_" + name)) {
+            std::error_code ec;
+            fs::remove_all(path, ec);
+            fs::create_directories(path);
+        }
+        ~TempDir() {
+            std::error_code ec;
+            fs::remove_all(path, ec);
+        }
+    };
+
+    std::string ReadFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // 旧实现: 表头只在文件不存在时写入，之后每行直接追加
+    void AppendDirect(const fs::path& path, const std::string& header, const std::string& row) {
+        const bool exists = fs::exists(path);
+        std::ofstream file(path, std::ios::app | std::ios::binary);
+        if (!exists) file << header << "\n";
+        file << row << "\n";
+    }
+
+    size_t CountTmpFiles(const fs::path& dir) {
+        size_t count = 0;
+        for (const auto& entry : fs::recursive_directory_iterator(dir)) {
+            count += entry.path().extension() == ".tmp";
+        }
+        return count;
+    }
+
+    template<typename T>
+    T Get(const std::string& bytes, uint64_t offset) {
+        T value{};
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        return value;
+    }
+}
+
+VM_TEST(ResultSinkCsv) {
+    TempDir dir("result_sink_csv");
+    const fs::path expectedDir = dir.path / "expected";
+    fs::create_directories(expectedDir);
+
+    const std::string batchHeader = "ModelName,AvgError";
+    const std::string modelHeader = "ViewIndex,ErrorValue";
+    const fs::path batchPath = dir.path / "metrics_psnr.csv";
+    const fs::path appendPath = dir.path / "legacy.csv";
+
+    // 未声明的表保留已有内容
+    { std::ofstream(appendPath, std::ios::binary) << "Existing\n"; }
+    { std::ofstream(expectedDir / "legacy.csv", std::ios::binary) << "Existing\n"; }
+
+    ResultSink sink;
+    sink.BeginBatch(fs::path());
+    sink.DeclareTable(batchPath, batchHeader, ResultSink::TableScope::Batch);
+    // Batch 表声明后立即存在 (只有表头)
+    VM_CHECK_EQ(ReadFile(batchPath), batchHeader + "\n");
+
+    const char* models[] = { "bunny", "dragon" };
+    for (const char* model : models) {
+        Tests::TestTrace trace(model);
+        const fs::path modelPath = dir.path / (std::string(model) + "_metrics_psnr.csv");
+        const fs::path expectedModel = expectedDir / modelPath.filename();
+        sink.DeclareTable(modelPath, modelHeader, ResultSink::TableScope::Model);
+        sink.BeginModel(model, "opt.glb");
+        for (int view = 0; view < 5; ++view) {
+            const std::string row = std::to_string(view) + "," + std::to_string(30.0 + view * 0.25);
+            sink.AppendRow(modelPath, row);
+            AppendDirect(expectedModel, modelHeader, row);
+        }
+        const std::string summary = std::string(model) + ",31.5";
+        sink.AppendRow(batchPath, summary);
+        AppendDirect(expectedDir / batchPath.filename(), batchHeader, summary);
+        sink.AppendRow(appendPath, std::string(model) + ",legacy");
+        { std::ofstream(expectedDir / "legacy.csv", std::ios::app | std::ios::binary) << model << ",legacy\n"; }
+
+        // 落盘之前 Model 表尚不存在，Batch 表仍是上一次落盘的内容
+        VM_CHECK(!fs::exists(modelPath));
+        sink.FlushModel();
+
+        VM_CHECK_EQ(ReadFile(modelPath), ReadFile(expectedModel));
+        VM_CHECK_EQ(ReadFile(batchPath), ReadFile(expectedDir / batchPath.filename()));
+        VM_CHECK_EQ(ReadFile(appendPath), ReadFile(expectedDir / "legacy.csv"));
+        VM_CHECK_EQ(CountTmpFiles(dir.path), static_cast<size_t>(0));
+    }
+
+    // 再次落盘不改变内容 (Model 表已丢弃，未声明的表不重复追加)
+    sink.FlushModel();
+    VM_CHECK_EQ(ReadFile(appendPath), ReadFile(expectedDir / "legacy.csv"));
+
+    // 已有的旧文件被整体替换，而不是在其后追加
+    const fs::path stalePath = dir.path / "stale.csv";
+    { std::ofstream(stalePath, std::ios::binary) << "Old,Header\n1,2\n3,4\n5,6\n"; }
+    sink.DeclareTable(stalePath, modelHeader, ResultSink::TableScope::Model);
+    sink.AppendRow(stalePath, "0,1");
+    sink.FlushModel();
+    VM_CHECK_EQ(ReadFile(stalePath), modelHeader + "\n0,1\n");
+
+    // 重命名失败 (目标是目录) 时不留下 .tmp，目标保持原样
+    const fs::path blocked = dir.path / "blocked.csv";
+    fs::create_directories(blocked);
+    sink.DeclareTable(blocked, modelHeader, ResultSink::TableScope::Model);
+    sink.AppendRow(blocked, "0,1");
+    sink.FlushModel();
+    VM_CHECK(fs::is_directory(blocked));
+    VM_CHECK_EQ(CountTmpFiles(dir.path), static_cast<size_t>(0));
+    sink.EndBatch();
+}
+
+VM_TEST(ResultSinkColumnar) {
+    TempDir dir("result_sink_columnar");
+    const fs::path columnarPath = dir.path / "results.vmcol";
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    struct Row { const char* model; const char* method; int view; const char* metric; double value; double timeMs; };
+    const Row rows[] = {
+        { "bunny", "bunny_50.glb", 0, "PSNR", 31.25, 1.5 },
+        { "bunny", "bunny_50.glb", 1, "PSNR", 30.5, nan },
+        { "bunny", "bunny_50.glb", -1, "Hausdorff", 0.0125, 42.0 },
+        { "dragon", "dragon_10.glb", 7, "SSIM", 0.987654321, 3.25 },
+        { "dragon", "dragon_10.glb", 7, "PSNR", 28.0, 0.75 },
+    };
+    const size_t rowCount = sizeof(rows) / sizeof(rows[0]);
+
+    {
+        ResultSink sink;
+        sink.BeginBatch(columnarPath);
+        for (const Row& row : rows) {
+            sink.BeginModel(row.model, row.method);
+            sink.Record(row.view, row.metric, row.value, row.timeMs);
+        }
+        VM_CHECK_EQ(sink.RecordCount(), rowCount);
+        sink.EndBatch();
+    }
+    const std::string bytes = ReadFile(columnarPath);
+    VM_CHECK_EQ(CountTmpFiles(dir.path), static_cast<size_t>(0));
+    VM_CHECK(bytes.size() >= 64 && bytes.size() % 8 == 0);
+    if (bytes.size() < 64) return;
+
+    VM_CHECK_EQ(bytes.substr(0, 8), std::string("VMCOLS01"));
+    VM_CHECK_EQ(Get<uint32_t>(bytes, 8), 1u);
+    VM_CHECK_EQ(Get<uint32_t>(bytes, 12), 6u);
+    VM_CHECK_EQ(Get<uint64_t>(bytes, 16), static_cast<uint64_t>(rowCount));
+    const uint64_t stringCount = Get<uint64_t>(bytes, 24);
+    const uint64_t stringOffsets = Get<uint64_t>(bytes, 32);
+    const uint64_t stringData = Get<uint64_t>(bytes, 40);
+    const uint64_t columns = Get<uint64_t>(bytes, 48);
+    VM_CHECK_EQ(columns % 8, 0ull);
+
+    auto stringAt = [&](uint32_t index) {
+        VM_CHECK(index < stringCount);
+        const uint64_t begin = Get<uint64_t>(bytes, stringOffsets + index * 8);
+        const uint64_t end = Get<uint64_t>(bytes, stringOffsets + (index + 1) * 8);
+        return bytes.substr(stringData + begin, end - begin);
+    };
+
+    const char* names[] = { "model", "method", "view", "metric", "value", "timeMs" };
+    const uint32_t types[] = { 0, 0, 1, 0, 2, 2 };
+    uint64_t offsets[6];
+    for (int c = 0; c < 6; ++c) {
+        const uint64_t entry = columns + c * 32;
+        VM_CHECK_EQ(std::string(bytes.data() + entry), std::string(names[c]));
+        VM_CHECK_EQ(Get<uint32_t>(bytes, entry + 16), types[c]);
+        offsets[c] = Get<uint64_t>(bytes, entry + 24);
+        VM_CHECK_EQ(offsets[c] % 8, 0ull);
+        VM_CHECK(offsets[c] + rowCount * Get<uint32_t>(bytes, entry + 20) <= bytes.size());
+    }
+
+    for (size_t i = 0; i < rowCount; ++i) {
+        Tests::TestTrace trace("row=" + std::to_string(i));
+        VM_CHECK_EQ(stringAt(Get<uint32_t>(bytes, offsets[0] + i * 4)), std::string(rows[i].model));
+        VM_CHECK_EQ(stringAt(Get<uint32_t>(bytes, offsets[1] + i * 4)), std::string(rows[i].method));
+        VM_CHECK_EQ(Get<int32_t>(bytes, offsets[2] + i * 4), rows[i].view);
+        VM_CHECK_EQ(stringAt(Get<uint32_t>(bytes, offsets[3] + i * 4)), std::string(rows[i].metric));
+        VM_CHECK_EQ(Get<double>(bytes, offsets[4] + i * 8), rows[i].value);
+        const double timeMs = Get<double>(bytes, offsets[5] + i * 8);
+        VM_CHECK(std::isnan(rows[i].timeMs) ? std::isnan(timeMs) : timeMs == rows[i].timeMs);
+    }
+}
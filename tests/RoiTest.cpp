@@ -0,0 +1,225 @@
+#include "TestFramework.h"
+#include "Metrics/Evaluator.h"
+#include "Metrics/FlipEvaluator.h"
+#include "Metrics/PixelPasses.h"
+#include "Metrics/SsimEvaluator.h"
+
+/**
+ * 屏幕空间 ROI: 只在外扩后的物体矩形内计算，区域外的纯色背景解析地计入，结果应与整幅画面一致。
+ * PSNR 与轮廓误差逐位一致；法线 MSE / SSIM / FLIP 只允许求和顺序带来的舍入差异。
+ * 区域外扩与对齐按 Application::EvaluateView 中各阶段的取值 (物体矩形的投影由 GL 端计算，不在此测试)。
+ */
+
+namespace {
+    using namespace Metrics;
+
+    const Color8 kBackground = { 230, 228, 225 };
+
+    struct Rect {
+        int x0, y0, x1, y1;   // [x0, x1) x [y0, y1)
+        int Width() const { return x1 - x0; }
+        int Height() const { return y1 - y0; }
+    };
+
+    // 整幅画面: 纯色背景上的一个带纹理的物体，优化图在物体内叠加噪声并把轮廓挪动 1 像素
+    struct Frame {
+        int width = 0, height = 0;
+        Rect object{};
+        std::vector<unsigned char> refColor, optColor;   // RGB8
+        std::vector<unsigned char> refSil, optSil;       // R8
+        std::vector<float> refNormal, optNormal;         // RGB32F，背景为 (0,0,0)
+
+        bool InRef(int x, int y) const { return x >= object.x0 && x < object.x1 && y >= object.y0 && y < object.y1; }
+        bool InOpt(int x, int y) const { return x >= object.x0 + 1 && x < object.x1 && y >= object.y0 && y < object.y1 - 1; }
+
+        void Generate(int w, int h, Rect obj, uint32_t seed) {
+            width = w;
+            height = h;
+            object = obj;
+            const size_t pixels = static_cast<size_t>(w) * h;
+            refColor.resize(pixels * 3);
+            optColor.resize(pixels * 3);
+            refSil.assign(pixels, 0);
+            optSil.assign(pixels, 0);
+            refNormal.assign(pixels * 3, 0.0f);
+            optNormal.assign(pixels * 3, 0.0f);
+
+            std::mt19937 rng(seed);
+            std::uniform_int_distribution<int> noise(-9, 9);
+            std::uniform_real_distribution<float> normal(0.05f, 0.95f);
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    const size_t i = static_cast<size_t>(y) * w + x;
+                    const unsigned char base[3] = { static_cast<unsigned char>((x * 7 + y * 3) & 0xFF),
+                                                    static_cast<unsigned char>((x * 2 + y * 11) & 0xFF), 90 };
+                    for (int c = 0; c < 3; ++c) {
+                        const unsigned char bg = c == 0 ? kBackground.r : (c == 1 ? kBackground.g : kBackground.b);
+                        refColor[i * 3 + c] = InRef(x, y) ? base[c] : bg;
+                        optColor[i * 3 + c] = InOpt(x, y) ? static_cast<unsigned char>(std::clamp(base[c] + noise(rng), 0, 255)) : bg;
+                        if (InRef(x, y)) refNormal[i * 3 + c] = normal(rng);
+                        if (InOpt(x, y)) optNormal[i * 3 + c] = normal(rng);
+                    }
+                    refSil[i] = InRef(x, y) ? 255 : 0;
+                    optSil[i] = InOpt(x, y) ? 255 : 0;
+                }
+            }
+        }
+
+        // 与 Application::ViewRegion 相同: 物体矩形外扩 margin，起点向下、终点向上按 alignment 对齐 (终点越过画面边缘时该方向不裁剪)
+        FrameRegion Region(int margin, int alignment) const {
+            int x0 = std::max(0, object.x0 - margin), y0 = std::max(0, object.y0 - margin);
+            int x1 = std::min(width, object.x1 + margin), y1 = std::min(height, object.y1 + margin);
+            x0 -= x0 % alignment;
+            y0 -= y0 % alignment;
+            x1 = (x1 + alignment - 1) / alignment * alignment;
+            y1 = (y1 + alignment - 1) / alignment * alignment;
+            if (x1 > width) { x0 = 0; x1 = width; }
+            if (y1 > height) { y0 = 0; y1 = height; }
+            return { width, height, x0, y0, x1 - x0, y1 - y0 };
+        }
+    };
+
+    // 指向整幅画面中区域的视图 (带 stride，与 ROI 回读后的紧密缓冲内容相同)
+    template<typename T>
+    ImageView Crop(const std::vector<T>& full, int frameWidth, PixelFormat format, const FrameRegion& r) {
+        const size_t bpp = BytesPerPixel(format);
+        const unsigned char* base = reinterpret_cast<const unsigned char*>(full.data());
+        return ImageView(base + (static_cast<size_t>(r.y) * frameWidth + r.x) * bpp, r.width, r.height, format, frameWidth * bpp);
+    }
+
+    // 按区域打包的覆盖掩码 (轮廓 > 0 为覆盖)
+    void Coverage(const std::vector<unsigned char>& sil, int frameWidth, const FrameRegion& r, CoverageMask& out) {
+        out.Resize(r.width, r.height);
+        for (int y = 0; y < r.height; ++y) {
+            for (int x = 0; x < r.width; ++x) {
+                if (sil[static_cast<size_t>(r.y + y) * frameWidth + r.x + x]) {
+                    out.words[static_cast<size_t>(y) * out.rowWords + (x >> 5)] |= 1u << (x & 31);
+                }
+            }
+        }
+    }
+
+    void PackRegion(const std::vector<unsigned char>& sil, int frameWidth, const FrameRegion& r, PackedMask& out) {
+        std::vector<unsigned char> tight(r.PixelCount());
+        for (int y = 0; y < r.height; ++y) {
+            std::memcpy(&tight[static_cast<size_t>(y) * r.width], &sil[static_cast<size_t>(r.y + y) * frameWidth + r.x], r.width);
+        }
+        Evaluator::PackSilhouette(ImageView(tight, r.width, r.height, PixelFormat::R8), out);
+    }
+
+    bool Close(double a, double b, double tolerance) {
+        return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+    }
+}
+
+VM_TEST(RoiColorAndSilhouette) {
+    Frame frame;
+    frame.Generate(203, 157, { 80, 60, 121, 97 }, 40);
+    const FrameRegion full = FrameRegion::Full(frame.width, frame.height);
+    const Color8 heatmapBg = { 255, 255, 255 };
+
+    // PSNR: 外扩 1 像素 (与 EvaluateView 一致)
+    {
+        const FrameRegion roi = frame.Region(1, 1);
+        VM_CHECK(!roi.IsFull());
+        CoverageMask refFull, optFull, refRoi, optRoi;
+        Coverage(frame.refSil, frame.width, full, refFull);
+        Coverage(frame.optSil, frame.width, full, optFull);
+        Coverage(frame.refSil, frame.width, roi, refRoi);
+        Coverage(frame.optSil, frame.width, roi, optRoi);
+
+        PixelPassOutput fullOut, roiOut;
+        const double psnrFull = PixelPasses::ColorPass(
+                ImageView(frame.refColor, frame.width, frame.height, PixelFormat::RGB8), refFull,
+                ImageView(frame.optColor, frame.width, frame.height, PixelFormat::RGB8), optFull,
+                heatmapBg, heatmapBg, 2.5f, fullOut.Prepare(frame.width, frame.height, true));
+        const double psnrRoi = PixelPasses::ColorPass(
+                Crop(frame.refColor, frame.width, PixelFormat::RGB8, roi), refRoi,
+                Crop(frame.optColor, frame.width, PixelFormat::RGB8, roi), optRoi,
+                heatmapBg, heatmapBg, 2.5f, roiOut.Prepare(roi.width, roi.height, true), roi.BackgroundPixels());
+        VM_CHECK_EQ(psnrRoi, psnrFull);
+
+        // 区域内的热力图与逐像素误差和整幅画面中对应位置一致
+        size_t differing = 0;
+        for (int y = 0; y < roi.height; ++y) {
+            const size_t fullRow = static_cast<size_t>(roi.y + y) * frame.width + roi.x;
+            differing += std::memcmp(&roiOut.heatmap[static_cast<size_t>(y) * roi.width * 4], &fullOut.heatmap[fullRow * 4], roi.width * 4) != 0;
+            differing += std::memcmp(&roiOut.errorMap[static_cast<size_t>(y) * roi.width], &fullOut.errorMap[fullRow], roi.width * 2) != 0;
+        }
+        VM_CHECK_EQ(differing, static_cast<size_t>(0));
+    }
+
+    // 轮廓: 外扩 2 像素
+    {
+        const FrameRegion roi = frame.Region(2, 1);
+        PackedMask refFull, optFull, refRoi, optRoi;
+        PackRegion(frame.refSil, frame.width, full, refFull);
+        PackRegion(frame.optSil, frame.width, full, optFull);
+        PackRegion(frame.refSil, frame.width, roi, refRoi);
+        PackRegion(frame.optSil, frame.width, roi, optRoi);
+
+        PixelPassOutput fullOut, roiOut;
+        const double silFull = PixelPasses::SilhouettePass(refFull, optFull, kBackground, Color8(), heatmapBg,
+                                                           fullOut.Prepare(frame.width, frame.height));
+        const double silRoi = PixelPasses::SilhouettePass(refRoi, optRoi, kBackground, Color8(), heatmapBg,
+                                                          roiOut.Prepare(roi.width, roi.height), roi.BackgroundPixels());
+        VM_CHECK(silFull > 0.0);
+        VM_CHECK_EQ(silRoi, silFull);
+    }
+}
+
+VM_TEST(RoiNormalSsimFlip) {
+    Frame frame;
+    frame.Generate(512, 384, { 236, 176, 268, 203 }, 41);
+    const Color8 heatmapBg = { 255, 255, 255 };
+    const double tolerance = 1e-9;
+
+    // 法线 MSE 只统计被覆盖的像素，区域外扩 1 像素即可
+    {
+        const FrameRegion roi = frame.Region(1, 1);
+        // 展示用的法线颜色与误差无关，此处直接用颜色缓冲代替
+        PixelPassOutput fullOut, roiOut;
+        const double fullMse = PixelPasses::NormalPass(
+                ImageView(frame.refNormal, frame.width, frame.height, PixelFormat::RGB32F), ImageView(frame.refColor, frame.width, frame.height, PixelFormat::RGB8),
+                ImageView(frame.optNormal, frame.width, frame.height, PixelFormat::RGB32F), ImageView(frame.optColor, frame.width, frame.height, PixelFormat::RGB8),
+                kBackground, heatmapBg, fullOut.Prepare(frame.width, frame.height));
+        const double roiMse = PixelPasses::NormalPass(
+                Crop(frame.refNormal, frame.width, PixelFormat::RGB32F, roi), Crop(frame.refColor, frame.width, PixelFormat::RGB8, roi),
+                Crop(frame.optNormal, frame.width, PixelFormat::RGB32F, roi), Crop(frame.optColor, frame.width, PixelFormat::RGB8, roi),
+                kBackground, heatmapBg, roiOut.Prepare(roi.width, roi.height));
+        VM_CHECK(fullMse > 0.0);
+        VM_CHECK(Close(roiMse, fullMse, tolerance));
+    }
+
+    // SSIM / MS-SSIM: 外扩与对齐取 CropMargin / CropAlignment
+    {
+        const int scales = SsimEvaluator::MAX_SCALES;
+        const FrameRegion roi = frame.Region(SsimEvaluator::CropMargin(scales), SsimEvaluator::CropAlignment(scales));
+        VM_CHECK(!roi.IsFull());
+        SsimEvaluator evaluator;
+        evaluator.Reserve(frame.width, frame.height);
+        const SsimResult fullResult = evaluator.Compute(ImageView(frame.refColor, frame.width, frame.height, PixelFormat::RGB8),
+                                                        ImageView(frame.optColor, frame.width, frame.height, PixelFormat::RGB8), scales);
+        const SsimResult roiResult = evaluator.Compute(Crop(frame.refColor, frame.width, PixelFormat::RGB8, roi),
+                                                       Crop(frame.optColor, frame.width, PixelFormat::RGB8, roi), scales, &roi);
+        VM_CHECK(fullResult.ssim < 1.0);
+        VM_CHECK_EQ(roiResult.scales, fullResult.scales);
+        VM_CHECK(Close(roiResult.ssim, fullResult.ssim, tolerance));
+        VM_CHECK(Close(roiResult.msssim, fullResult.msssim, tolerance));
+    }
+
+    // FLIP: 外扩滤波半径 + 1
+    {
+        FlipEvaluator evaluator;
+        evaluator.Reserve(frame.width, frame.height);
+        const FrameRegion roi = frame.Region(evaluator.FilterRadius() + 1, 1);
+        VM_CHECK(!roi.IsFull());
+        const double fullFlip = evaluator.Compute(ImageView(frame.refColor, frame.width, frame.height, PixelFormat::RGB8),
+                                                  ImageView(frame.optColor, frame.width, frame.height, PixelFormat::RGB8));
+        const double roiFlip = evaluator.Compute(Crop(frame.refColor, frame.width, PixelFormat::RGB8, roi),
+                                                 Crop(frame.optColor, frame.width, PixelFormat::RGB8, roi),
+                                                 FlipEvaluator::DEFAULT_PIXELS_PER_DEGREE, roi.BackgroundPixels());
+        VM_CHECK(fullFlip > 0.0);
+        VM_CHECK(Close(roiFlip, fullFlip, tolerance));
+    }
+}
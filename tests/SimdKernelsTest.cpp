@@ -0,0 +1,166 @@
+#include "TestFramework.h"
+#include "Metrics/SimdKernels.h"
+
+/**
+ * 各指令集路径与标量路径逐位一致 (像素通道、ROI 与轮廓打包的结果均依赖这一点)
+ * 对每个 SetLevel 实际接受的等级 (超出 CPU 能力的等级被钳制，跳过)，以随机缓冲与标量结果逐一比较。
+ */
+
+namespace {
+    using namespace Metrics::Simd;
+
+    // 覆盖各向量宽度 (16 / 32 / 64) 的整块与奇数尾部
+    const size_t kSizes[] = { 0, 1, 2, 3, 7, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65, 127, 128, 129, 255, 257, 1000, 4099, 65537 };
+
+    // 大于一个 U8 批次 (AVX-512 下 4096 次迭代 x 64 字节) 的长度，检查 int32 批累加扩展到 64 位的过程
+    const size_t kLargeU8 = 3 * 4096 * 64 + 77;
+
+    const Level kLevels[] = { Level::Scalar, Level::SSE2, Level::AVX2, Level::AVX512 };
+
+    struct Buffers {
+        std::vector<uint8_t> u8A, u8B;
+        std::vector<float> f32A, f32B;       // 交错 RGB，约 1/4 的像素两侧同为 (0,0,0) 背景
+        std::vector<uint16_t> f16A, f16B;
+
+        void Generate(size_t n, std::mt19937& rng) {
+            std::uniform_int_distribution<int> byte(0, 255);
+            std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+            u8A.resize(n);
+            u8B.resize(n);
+            f16A.resize(n);
+            f16B.resize(n);
+            f32A.resize(n * 3);
+            f32B.resize(n * 3);
+            for (size_t i = 0; i < n; ++i) {
+                // 约一半为 0，覆盖掩码比较中的背景
+                u8A[i] = static_cast<uint8_t>(rng() % 2 ? byte(rng) : 0);
+                u8B[i] = static_cast<uint8_t>(rng() % 2 ? byte(rng) : 0);
+                f16A[i] = FloatToHalf(value(rng) * 4.0f);
+                f16B[i] = FloatToHalf(value(rng) * 4.0f);
+                const bool background = rng() % 4 == 0;
+                const bool oneSided = rng() % 8 == 0;
+                for (int c = 0; c < 3; ++c) {
+                    f32A[i * 3 + c] = background ? 0.0f : value(rng);
+                    f32B[i * 3 + c] = (background && !oneSided) ? 0.0f : value(rng);
+                }
+            }
+        }
+    };
+
+    struct Results {
+        uint64_t ssdU8 = 0;
+        double ssdF32 = 0.0;
+        double ssdF16 = 0.0;
+        double normal = 0.0;
+        size_t normalValid = 0;
+        size_t mismatch = 0;
+        std::vector<uint64_t> packedA, packedB;
+        size_t bitMismatch = 0;
+        std::vector<float> scaled;
+    };
+
+    Results Compute(const Buffers& b, size_t n) {
+        Results r;
+        r.ssdU8 = SumSquaredDiffU8(b.u8A.data(), b.u8B.data(), n);
+        r.ssdF32 = SumSquaredDiffF32(b.f32A.data(), b.f32B.data(), n * 3);
+        r.ssdF16 = SumSquaredDiffF16(b.f16A.data(), b.f16B.data(), n);
+        r.normal = NormalSquaredDiff(b.f32A.data(), b.f32B.data(), n, r.normalValid);
+        r.mismatch = CountMaskMismatch(b.u8A.data(), b.u8B.data(), n);
+
+        // 预填无关位，确认每个字 (含末尾补 0 的位) 都被完整写出
+        const size_t words = (n + 63) / 64;
+        r.packedA.assign(words, 0xA5A5A5A5A5A5A5A5ull);
+        r.packedB.assign(words, 0x5A5A5A5A5A5A5A5Aull);
+        PackMask(b.u8A.data(), n, r.packedA.data());
+        PackMask(b.u8B.data(), n, r.packedB.data());
+        r.bitMismatch = CountBitMismatch(r.packedA.data(), r.packedB.data(), words);
+
+        // 可分离滤波的单个抽头 (SSIM / FLIP)：不允许收缩为 FMA
+        r.scaled.assign(b.f32A.begin(), b.f32A.end());
+        ScaledAdd(r.scaled.data(), b.f32B.data(), 0.3125f, r.scaled.size());
+        return r;
+    }
+
+    // 依次切换到每个可用等级执行 fn；结束后恢复检测到的等级
+    template<typename Fn>
+    void ForEachLevel(Fn&& fn) {
+        for (Level level : kLevels) {
+            SetLevel(level);
+            if (GetLevel() != level) {
+                std::cout << "  [Skip] " << LevelName(level) << " not supported by this CPU" << std::endl;
+                continue;
+            }
+            Tests::TestTrace trace(std::string("level=") + LevelName(level));
+            fn(level);
+        }
+        SetLevel(DetectLevel());
+    }
+}
+
+VM_TEST(SimdKernels) {
+    std::mt19937 rng(20240229);
+    for (size_t n : kSizes) {
+        Buffers buffers;
+        buffers.Generate(n, rng);
+        SetLevel(Level::Scalar);
+        const Results expected = Compute(buffers, n);
+        // 掩码不一致数与打包后的 popcount 必须相同
+        VM_CHECK_EQ(expected.mismatch, expected.bitMismatch);
+
+        ForEachLevel([&](Level) {
+            Tests::TestTrace trace("n=" + std::to_string(n));
+            const Results actual = Compute(buffers, n);
+            VM_CHECK_EQ(actual.ssdU8, expected.ssdU8);
+            VM_CHECK_EQ(actual.ssdF32, expected.ssdF32);
+            VM_CHECK_EQ(actual.ssdF16, expected.ssdF16);
+            VM_CHECK_EQ(actual.normal, expected.normal);
+            VM_CHECK_EQ(actual.normalValid, expected.normalValid);
+            VM_CHECK_EQ(actual.mismatch, expected.mismatch);
+            VM_CHECK(actual.packedA == expected.packedA);
+            VM_CHECK(actual.packedB == expected.packedB);
+            VM_CHECK_EQ(actual.bitMismatch, expected.bitMismatch);
+            VM_CHECK(actual.scaled == expected.scaled);
+        });
+    }
+}
+
+VM_TEST(SimdU8LargeBatch) {
+    // 最坏情况 (每个差值都是 255) 下逐批累加仍精确；结果可解析求出
+    std::vector<uint8_t> a(kLargeU8, 255), b(kLargeU8, 0);
+    const uint64_t worst = static_cast<uint64_t>(kLargeU8) * 255u * 255u;
+
+    std::mt19937 rng(7);
+    std::vector<uint8_t> c(kLargeU8), d(kLargeU8);
+    for (size_t i = 0; i < kLargeU8; ++i) {
+        c[i] = static_cast<uint8_t>(rng());
+        d[i] = static_cast<uint8_t>(rng());
+    }
+    SetLevel(Level::Scalar);
+    const uint64_t random = SumSquaredDiffU8(c.data(), d.data(), kLargeU8);
+
+    ForEachLevel([&](Level) {
+        VM_CHECK_EQ(SumSquaredDiffU8(a.data(), b.data(), kLargeU8), worst);
+        VM_CHECK_EQ(SumSquaredDiffU8(b.data(), a.data(), kLargeU8), worst);
+        VM_CHECK_EQ(SumSquaredDiffU8(c.data(), d.data(), kLargeU8), random);
+    });
+}
+
+
+VM_TEST(HalfConversion) {
+    // 每个有限 half 经 float 往返后不变；NaN 保持为 NaN
+    for (uint32_t h = 0; h <= 0xFFFFu; ++h) {
+        const uint16_t half = static_cast<uint16_t>(h);
+        const float f = HalfToFloat(half);
+        if ((half & 0x7C00u) == 0x7C00u && (half & 0x3FFu) != 0) {
+            VM_CHECK(std::isnan(f));
+            VM_CHECK((FloatToHalf(f) & 0x7FFFu) > 0x7C00u);
+            continue;
+        }
+        VM_CHECK_EQ(FloatToHalf(f), half);
+    }
+    // 就近舍入到偶数与溢出饱和
+    VM_CHECK_EQ(FloatToHalf(1.0f + 1.0f / 2048.0f), static_cast<uint16_t>(0x3C00u));
+    VM_CHECK_EQ(FloatToHalf(1.0f + 3.0f / 2048.0f), static_cast<uint16_t>(0x3C02u));
+    VM_CHECK_EQ(FloatToHalf(65520.0f), static_cast<uint16_t>(0x7C00u));
+    VM_CHECK_EQ(FloatToHalf(-1e9f), static_cast<uint16_t>(0xFC00u));
+}
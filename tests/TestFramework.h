@@ -0,0 +1,67 @@
+#pragma once
+
+/**
+ * VisualMetricsTests 使用的极简测试框架
+ *
+ * VM_TEST(Name) 定义并注册一个用例；`VisualMetricsTests [用例名...]` 只运行指定用例 (ctest 按用例逐个注册)，
+ * 不带参数时运行全部。检查失败时打印位置、表达式与当前 TestTrace 上下文后继续执行，进程返回失败用例数。
+ */
+namespace Tests {
+
+    using TestFn = void (*)();
+
+    struct TestCase {
+        const char* name;
+        TestFn fn;
+    };
+
+    std::vector<TestCase>& Registry();
+
+    struct Registrar {
+        Registrar(const char* name, TestFn fn) { Registry().push_back({ name, fn }); }
+    };
+
+    // 记录一次失败 (附带当前的 TestTrace 上下文)
+    void ReportFailure(const char* file, int line, const std::string& message);
+    // 当前用例至今的失败次数
+    int FailureCount();
+
+    // 作用域内的上下文说明 (如 "level=AVX2 n=17")，失败信息中一并打印
+    class TestTrace {
+    public:
+        explicit TestTrace(std::string text);
+        ~TestTrace();
+        TestTrace(const TestTrace&) = delete;
+        TestTrace& operator=(const TestTrace&) = delete;
+    };
+
+    // 浮点按 17 位有效数字输出，逐位比较失败时能看出差异
+    template<typename T>
+    std::string Describe(const T& value) {
+        std::ostringstream out;
+        out << std::setprecision(17) << value;
+        return out.str();
+    }
+    inline std::string Describe(uint8_t value) { return std::to_string(value); }
+}
+
+#define VM_TEST(name)                                                        \
+    static void name##_Test();                                               \
+    static const Tests::Registrar name##_Registrar(#name, &name##_Test);     \
+    static void name##_Test()
+
+#define VM_CHECK(cond)                                                       \
+    do {                                                                     \
+        if (!(cond)) Tests::ReportFailure(__FILE__, __LINE__, #cond);        \
+    } while (0)
+
+// 用 == 比较 (浮点即逐位一致)，失败时打印两侧的值
+#define VM_CHECK_EQ(a, b)                                                    \
+    do {                                                                     \
+        const auto vmLhs_ = (a);                                             \
+        const auto vmRhs_ = (b);                                             \
+        if (!(vmLhs_ == vmRhs_)) {                                           \
+            Tests::ReportFailure(__FILE__, __LINE__, std::string(#a " == " #b "  (") + \
+                                 Tests::Describe(vmLhs_) + " vs " + Tests::Describe(vmRhs_) + ")"); \
+        }                                                                    \
+    } while (0)
@@ -0,0 +1,61 @@
+#include "TestFramework.h"
+
+namespace Tests {
+
+    namespace {
+        int g_failures = 0;
+        std::vector<std::string> g_traces;
+    }
+
+    std::vector<TestCase>& Registry() {
+        static std::vector<TestCase> cases;
+        return cases;
+    }
+
+    void ReportFailure(const char* file, int line, const std::string& message) {
+        g_failures++;
+        std::cerr << "  " << std::filesystem::path(file).filename().string() << ":" << line << ": check failed: " << message;
+        for (const std::string& trace : g_traces) std::cerr << " [" << trace << "]";
+        std::cerr << std::endl;
+    }
+
+    int FailureCount() {
+        return g_failures;
+    }
+
+    TestTrace::TestTrace(std::string text) {
+        g_traces.push_back(std::move(text));
+    }
+
+    TestTrace::~TestTrace() {
+        g_traces.pop_back();
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<Tests::TestCase> selected;
+    for (int i = 1; i < argc; ++i) {
+        auto it = std::find_if(Tests::Registry().begin(), Tests::Registry().end(),
+                               [&](const Tests::TestCase& c) { return argv[i] == std::string(c.name); });
+        if (it == Tests::Registry().end()) {
+            std::cerr << "[Tests] Unknown test: " << argv[i] << std::endl;
+            return 1;
+        }
+        selected.push_back(*it);
+    }
+    if (argc < 2) selected = Tests::Registry();
+
+    int failedCases = 0;
+    for (const Tests::TestCase& test : selected) {
+        std::cout << "[ RUN    ] " << test.name << std::endl;
+        const int before = Tests::FailureCount();
+        auto start = std::chrono::steady_clock::now();
+        test.fn();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const bool passed = Tests::FailureCount() == before;
+        if (!passed) failedCases++;
+        std::cout << (passed ? "[     OK ] " : "[ FAILED ] ") << test.name << " (" << std::fixed << std::setprecision(1) << ms << " ms)" << std::endl;
+    }
+    std::cout << "[Tests] " << selected.size() - failedCases << " / " << selected.size() << " passed" << std::endl;
+    return failedCases;
+}
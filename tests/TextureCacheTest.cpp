@@ -0,0 +1,122 @@
+#include "TestFramework.h"
+#include "Resources/TextureCache.h"
+
+/**
+ * 纹理磁盘缓存 (.vmtex) 的读取: 完整的条目按层级读回；截断或字段被篡改的条目视为未命中并被删除
+ */
+
+namespace {
+    namespace fs = std::filesystem;
+
+    struct Level {
+        int32_t width, height;
+        uint64_t size;
+        size_t payload;   // 实际写入的字节数 (可与 size 不同，用于构造损坏的条目)
+    };
+
+    template<typename T>
+    void Put(std::string& bytes, T value) {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // 按 TextureCache::Write 的布局拼出一个缓存条目 (未压缩)
+    std::string MakeEntry(int32_t channels, uint32_t levelCount, const std::vector<Level>& levels) {
+        std::string bytes("VMTX", 4);
+        Put<uint32_t>(bytes, 1);
+        Put<int32_t>(bytes, channels);
+        Put<uint32_t>(bytes, 0);
+        Put<int32_t>(bytes, 0);
+        Put<uint64_t>(bytes, 0);
+        Put<uint32_t>(bytes, levelCount);
+        for (const Level& lv : levels) {
+            Put<int32_t>(bytes, lv.width);
+            Put<int32_t>(bytes, lv.height);
+            Put<uint64_t>(bytes, lv.size);
+            for (size_t i = 0; i < lv.payload; ++i) bytes.push_back(static_cast<char>(i * 7 + lv.width));
+        }
+        return bytes;
+    }
+
+    // 完整 Mip 链 w x h -> 1x1
+    std::vector<Level> Chain(int w, int h, int channels) {
+        std::vector<Level> levels;
+        while (true) {
+            const uint64_t size = static_cast<uint64_t>(w) * h * channels;
+            levels.push_back({ w, h, size, static_cast<size_t>(size) });
+            if (w == 1 && h == 1) break;
+            w = std::max(1, w / 2);
+            h = std::max(1, h / 2);
+        }
+        return levels;
+    }
+
+    void WriteFile(const fs::path& path, const std::string& bytes) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+    }
+}
+
+VM_TEST(TextureCacheRead) {
+    const fs::path dir = fs::temp_directory_path() / "vm_tests_texture_cache";
+    fs::create_directories(dir);
+    const fs::path path = dir / "entry.vmtex";
+    Resources::TextureCache cache(Resources::TextureLoadOptions{});
+
+    // 1. 完整条目: 层级尺寸与像素逐字节读回
+    {
+        const std::vector<Level> chain = Chain(13, 6, 3);
+        const std::string bytes = MakeEntry(3, static_cast<uint32_t>(chain.size()), chain);
+        WriteFile(path, bytes);
+        Resources::TextureImage image;
+        VM_CHECK(cache.Read(path.string(), image));
+        VM_CHECK(image.fromCache);
+        VM_CHECK_EQ(image.channels, 3);
+        VM_CHECK_EQ(image.levels.size(), chain.size());
+        for (size_t l = 0; l < std::min(image.levels.size(), chain.size()); ++l) {
+            Tests::TestTrace trace("level=" + std::to_string(l));
+            VM_CHECK_EQ(image.levels[l].width, chain[l].width);
+            VM_CHECK_EQ(image.levels[l].height, chain[l].height);
+            VM_CHECK_EQ(static_cast<uint64_t>(image.levels[l].data.size()), chain[l].size);
+        }
+        VM_CHECK(fs::exists(path));
+    }
+
+    // 2. 损坏的条目: 返回未命中，不按文件中的尺寸分配内存，并删除该条目以便重建
+    struct Corrupt { const char* name; std::string bytes; };
+    std::vector<Corrupt> cases;
+    {
+        std::vector<Level> chain = Chain(16, 16, 4);
+        const uint32_t count = static_cast<uint32_t>(chain.size());
+        const std::string valid = MakeEntry(4, count, chain);
+        cases.push_back({ "truncated", valid.substr(0, valid.size() - 5) });
+        cases.push_back({ "huge level count", MakeEntry(4, 0xFFFFFFFFu, chain) });
+        cases.push_back({ "levels beyond file", MakeEntry(4, 31, chain) });
+        cases.push_back({ "bad channels", MakeEntry(7, count, chain) });
+
+        std::vector<Level> huge = chain;
+        huge[0].size = 1ull << 40;
+        cases.push_back({ "huge size", MakeEntry(4, count, huge) });
+
+        std::vector<Level> mismatch = chain;
+        mismatch[2].size -= 4;
+        mismatch[2].payload -= 4;
+        cases.push_back({ "size does not match dimensions", MakeEntry(4, count, mismatch) });
+
+        std::vector<Level> wrongHalf = chain;
+        wrongHalf[1] = { 9, 8, 9 * 8 * 4, 9 * 8 * 4 };
+        cases.push_back({ "level is not half of previous", MakeEntry(4, count, wrongHalf) });
+
+        std::vector<Level> giant = { { 1 << 30, 1 << 30, 4, 4 } };
+        cases.push_back({ "oversized dimensions", MakeEntry(4, 1, giant) });
+    }
+    for (const Corrupt& c : cases) {
+        Tests::TestTrace trace(c.name);
+        WriteFile(path, c.bytes);
+        Resources::TextureImage image;
+        VM_CHECK(!cache.Read(path.string(), image));
+        VM_CHECK(image.levels.empty());
+        VM_CHECK(!fs::exists(path));
+    }
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}